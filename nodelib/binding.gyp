@@ -14,24 +14,42 @@
         "../semattack/src/StrangerAutomaton.cpp",
         "../semattack/src/AttackContext.cpp",
         "../semattack/src/ImageComputer.cpp",
+        "../semattack/src/FixPointEngine.cpp",
         "../semattack/src/PerfInfo.cpp",
+        "../semattack/src/DepGraphSource.cpp",
+        "../semattack/src/ShardResults.cpp",
         "../semattack/src/depgraph/DepGraph.cpp",
+        "../semattack/src/depgraph/DepGraphArena.cpp",
         "../semattack/src/depgraph/DepGraphSccNode.cpp",
         "../semattack/src/depgraph/DepGraphNode.cpp",
         "../semattack/src/depgraph/Metadata.cpp",
+        "../semattack/src/depgraph/StringPool.cpp",
         "../semattack/src/depgraph/DepGraphUninitNode.cpp",
         "../semattack/src/depgraph/DepGraphNormalNode.cpp",
         "../semattack/src/depgraph/DepGraphOpNode.cpp",
+        "../semattack/src/depgraph/OpKind.cpp",
         "../semattack/src/main_attack.cpp",
         "../semattack/src/SemRepairDebugger.cpp",
         "../semattack/src/ValidationImageComputer.cpp",
         # "../semattack/src/automatonify.cpp",
         "../semattack/src/AutomatonGroups.cpp",
+        "../semattack/src/GroupStatistics.cpp",
         "../semattack/src/SemAttack.cpp",
+        "../semattack/src/InputIndependentResult.cpp",
+        "../semattack/src/MultiInputAttack.cpp",
         "../semattack/src/exceptions/StrangerException.cpp",
         "../semattack/src/exceptions/AnalysisError.cpp",
         "../semattack/src/SemAttackBw.cpp",
         "../semattack/src/AnalysisResult.cpp",
+        "../semattack/src/WitnessEnumerator.cpp",
+        "../semattack/src/ConcreteInterpreter.cpp",
+        "../semattack/src/RegExpCompiler.cpp",
+        "../semattack/src/AlphabetPartition.cpp",
+        "../semattack/src/PhaseProfiler.cpp",
+        "../semattack/src/AutomatonFingerprint.cpp",
+        "../semattack/src/ClassificationLattice.cpp",
+        "../semattack/src/FunctionModels.cpp",
+        "../semattack/src/SemRepairBatch.cpp",
         # "../semattack/src/main_multi_attack.cpp",
         # "../semattack/src/main.cpp",
       ],
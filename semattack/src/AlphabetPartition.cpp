@@ -0,0 +1,319 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * AlphabetPartition.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "AlphabetPartition.hpp"
+
+#include <cctype>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <set>
+
+#include "AttackPatterns.hpp"
+#include "depgraph/Constant.hpp"
+#include "depgraph/Literal.hpp"
+#include "depgraph/RegExpNode.hpp"
+#include "exceptions/StrangerException.hpp"
+
+// Characters written or matched by the function models. Escaped characters
+// and the characters of their replacements must be single classes, as the
+// models map them to fixed strings.
+static const std::map<std::string, std::string> model_chars = {
+  { "addslashes", std::string("'\"\\") + '\0' },
+  { "stripslashes", "\\" },
+  { "mysql_escape_string", std::string("'\"\\\n\r\x1a") + '\0' },
+  { "mysql_real_escape_string", std::string("'\"\\\n\r\x1a") + '\0' },
+  { "htmlspecialchars", "&<>\"'/amp;ltgquos#x2F" },
+  { "encodeAttrString", "&\"amp;quot" },
+  { "encodeTextFragment", "&<>amp;ltg" },
+  { "nl2br", "\n\r<br />" },
+  { "trim", " " },
+  { "ltrim", " " },
+  { "rtrim", " " },
+  { "JSON.stringify", "\\\"btnfru0123456789abcdef" },
+};
+
+// Characters left alone by the percent encoding models, as in ConcreteInterpreter
+static const std::map<std::string, std::string> percent_unescaped = {
+  { "encodeURIComponent", "!'()*-._~" },
+  { "encodeURI", "!\"#$&'()*+,-./:;=?@_~" },
+  { "escape", "*+-./:;=?@_" },
+};
+
+// Functions whose arguments alone tell the characters apart
+static const std::set<std::string> transparent_functions = {
+  ".", "concat", "substr", "preg_replace", "ereg_replace", "str_replace",
+  "str_replace_once", "split", "regex_match", "regex_exec", "md5"
+};
+
+AlphabetPartition::AlphabetPartition()
+  : m_classes(256, 0)
+  , m_class_count(0)
+{
+  // The reserved characters never occur in strings
+  m_classes[254] = 1;
+  m_classes[255] = 2;
+  renumber();
+}
+
+AlphabetPartition::~AlphabetPartition()
+{
+}
+
+void AlphabetPartition::renumber()
+{
+  std::map<int, int> ids;
+  for (auto& cls : m_classes) {
+    auto iter = ids.insert(std::make_pair(cls, (int) ids.size()));
+    cls = iter.first->second;
+  }
+  m_class_count = ids.size();
+}
+
+void AlphabetPartition::refine(const CharSet& chars)
+{
+  // Classes are split by membership, so a class k becomes 2k and 2k + 1
+  for (unsigned int c = 0; c < 256; c++) {
+    m_classes[c] = 2 * m_classes[c] + (chars.test(c) ? 1 : 0);
+  }
+  renumber();
+}
+
+void AlphabetPartition::refine(const std::string& literal)
+{
+  std::vector<int> singles(m_classes);
+  for (unsigned char c : literal) {
+    singles[c] = 256 + c;
+  }
+  // Keep the remaining characters in their classes
+  m_classes.swap(singles);
+  renumber();
+}
+
+void AlphabetPartition::refine(const StrangerAutomaton* automaton)
+{
+  if (automaton != nullptr) {
+    m_class_count = automaton->refineCharClasses(m_classes);
+  }
+}
+
+void AlphabetPartition::addFunctionModel(const std::string& opName)
+{
+  if (transparent_functions.count(opName) > 0) {
+    if (opName == "md5") {
+      CharSet hex;
+      for (unsigned char c : std::string("0123456789abcdef")) {
+        hex.set(c);
+      }
+      refine(hex);
+    }
+    return;
+  }
+  if (opName.find("__vlab_restrict") != std::string::npos) {
+    return;
+  }
+
+  auto chars = model_chars.find(opName);
+  if (chars != model_chars.end()) {
+    refine(chars->second);
+    if (opName == "JSON.stringify") {
+      // Other control characters become \u00XX
+      std::string controls;
+      for (int c = 0; c < 0x20; c++) {
+        controls.push_back((char) c);
+      }
+      refine(controls);
+    }
+    return;
+  }
+
+  if ((opName == "strtoupper") || (opName == "strtolower")) {
+    std::string letters;
+    for (int c = 0; c < 256; c++) {
+      if (std::isalpha(c)) {
+        letters.push_back((char) c);
+      }
+    }
+    refine(letters);
+    return;
+  }
+
+  auto unescaped = percent_unescaped.find(opName);
+  if (unescaped != percent_unescaped.end()) {
+    // Each escaped character becomes its own %XX sequence
+    std::string escaped("%0123456789ABCDEF");
+    for (int c = 0; c < 254; c++) {
+      if (!std::isalnum(c) && (unescaped->second.find((char) c) == std::string::npos)) {
+        escaped.push_back((char) c);
+      }
+    }
+    refine(escaped);
+    return;
+  }
+
+  // Decoders and unknown functions can produce any character from a
+  // sequence of others, nothing can be merged
+  std::string all;
+  for (int c = 0; c < 254; c++) {
+    all.push_back((char) c);
+  }
+  refine(all);
+}
+
+void AlphabetPartition::addDepGraph(DepGraph& depGraph)
+{
+  for (auto node : depGraph.getNodes()) {
+    const DepGraphOpNode* opNode = dynamic_cast<const DepGraphOpNode*>(node);
+    if (opNode != nullptr) {
+      addFunctionModel(opNode->getName());
+      continue;
+    }
+    const DepGraphNormalNode* normalNode = dynamic_cast<const DepGraphNormalNode*>(node);
+    if ((normalNode == nullptr) || !depGraph.getSuccessors(node).empty()) {
+      continue;
+    }
+    TacPlace* place = normalNode->getPlace();
+    std::string value = place->toString();
+    if (dynamic_cast<RegExpNode*>(place) != nullptr) {
+      // As ImageComputer::getLiteralorConstantNodeAuto, without the anchors
+      if ((value.length() > 2) && (value.front() == '/') && (value.back() == '/')) {
+        std::string regString = value.substr(1, value.length() - 2);
+        if ((regString.find_first_of('^') == 0) &&
+            (regString.find_last_of('$') == regString.length() - 1)) {
+          regString = regString.substr(1, regString.length() - 2);
+        }
+        try {
+          std::unique_ptr<StrangerAutomaton> regExpAuto(
+            StrangerAutomaton::regExToAuto("/" + regString + "/", true, node->getID()));
+          refine(regExpAuto.get());
+        } catch (StrangerException const &e) {
+          // The analysis fails on this graph anyway, keep the literal apart
+          refine(value);
+        }
+      } else {
+        refine(value);
+      }
+    } else if ((dynamic_cast<Literal*>(place) != nullptr) || (dynamic_cast<Constant*>(place) != nullptr)) {
+      refine((value == "NUL") ? std::string(1, '\0') : value);
+    }
+  }
+}
+
+void AlphabetPartition::addAttackContext(AttackContext context)
+{
+  std::unique_ptr<StrangerAutomaton> pattern(AttackPatterns::getAttackPatternForContext(context));
+  refine(pattern.get());
+}
+
+AlphabetPartition::CharSet AlphabetPartition::getMembers(int cls) const
+{
+  CharSet members;
+  for (unsigned int c = 0; c < 256; c++) {
+    if (m_classes[c] == cls) {
+      members.set(c);
+    }
+  }
+  return members;
+}
+
+unsigned char AlphabetPartition::getRepresentative(int cls) const
+{
+  for (unsigned int c = 0; c < 256; c++) {
+    if (m_classes[c] == cls) {
+      return (unsigned char) c;
+    }
+  }
+  throw StrangerException(AnalysisError::InvalidArgument,
+                          stringbuilder() << "No character class " << cls);
+}
+
+std::string AlphabetPartition::compress(const std::string& s) const
+{
+  // The smallest member of each class
+  std::vector<int> representatives(m_class_count, -1);
+  for (unsigned int c = 0; c < 256; c++) {
+    if (representatives[m_classes[c]] < 0) {
+      representatives[m_classes[c]] = (int) c;
+    }
+  }
+  std::string retMe(s);
+  for (auto& c : retMe) {
+    c = (char) representatives[m_classes[(unsigned char) c]];
+  }
+  return retMe;
+}
+
+StrangerAutomaton* AlphabetPartition::makeRepresentativeStrings(int id) const
+{
+  // A single accepting state with a loop for each representative
+  std::vector<bool> seen(m_class_count, false);
+  std::vector<transition> transitions;
+  for (unsigned int c = 0; c < 254; c++) {
+    if (seen[m_classes[c]]) {
+      continue;
+    }
+    seen[m_classes[c]] = true;
+    transition t;
+    t.source = 0;
+    t.dest = 0;
+    t.first = (unsigned char) c;
+    t.last = (unsigned char) c;
+    transitions.push_back(t);
+  }
+  return StrangerAutomaton::makeFromTransitions(1, transitions, "+", id);
+}
+
+unsigned int AlphabetPartition::getBits() const
+{
+  unsigned int bits = 0;
+  while ((1u << bits) < m_class_count) {
+    bits++;
+  }
+  return bits;
+}
+
+void AlphabetPartition::print(std::ostream& os) const
+{
+  os << m_class_count << " character classes, " << getBits() << " bits" << std::endl;
+  for (unsigned int cls = 0; cls < m_class_count; cls++) {
+    CharSet members = getMembers(cls);
+    os << std::setw(4) << cls << " (" << members.count() << "):";
+    // Print members as ranges of character codes
+    for (unsigned int c = 0; c < 256; c++) {
+      if (!members.test(c)) {
+        continue;
+      }
+      unsigned int last = c;
+      while ((last + 1 < 256) && members.test(last + 1)) {
+        last++;
+      }
+      os << " " << c;
+      if (last > c) {
+        os << "-" << last;
+      }
+      c = last;
+    }
+    os << std::endl;
+  }
+}
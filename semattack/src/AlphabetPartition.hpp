@@ -0,0 +1,91 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * AlphabetPartition.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef ALPHABET_PARTITION_HPP_
+#define ALPHABET_PARTITION_HPP_
+
+#include <bitset>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AttackContext.hpp"
+#include "StrangerAutomaton.hpp"
+#include "depgraph/DepGraph.hpp"
+
+// Splits the byte alphabet into classes of characters which are treated
+// the same by every literal, regular expression and function model of a
+// dependency graph and by the attack patterns.
+//
+// Most sanitizers only tell apart a handful of characters (markup, quotes,
+// escapes and everything else), getBits() is the number of BDD variables
+// such an alphabet would need instead of the 8 used by all automata.
+//
+// Replacing every character by the representative of its class does not
+// change any verdict, so the analysis can be restricted to strings of
+// representatives (makeRepresentativeStrings()), with patterns mapped by
+// compress(). The automata are still built over bytes, but only use one
+// character per class.
+class AlphabetPartition {
+
+public:
+  typedef std::bitset<256> CharSet;
+
+  // Starts with one class for all characters but the reserved ones
+  AlphabetPartition();
+  virtual ~AlphabetPartition();
+
+  // Split so that chars and the other characters are in different classes
+  void refine(const CharSet& chars);
+  // Every character of a literal gets a class of its own
+  void refine(const std::string& literal);
+  void refine(const StrangerAutomaton* automaton);
+
+  // Literals, regular expressions and function models of the graph. Unknown
+  // functions split the alphabet into single characters.
+  void addDepGraph(DepGraph& depGraph);
+  void addAttackContext(AttackContext context);
+
+  unsigned int getClassCount() const { return m_class_count; }
+  int getClass(unsigned char c) const { return m_classes[c]; }
+  CharSet getMembers(int cls) const;
+  unsigned char getRepresentative(int cls) const;
+  // The string with every character replaced by its representative
+  std::string compress(const std::string& s) const;
+  // Automaton accepting all strings of representatives
+  StrangerAutomaton* makeRepresentativeStrings(int id) const;
+  // Number of bits needed to number the classes
+  unsigned int getBits() const;
+
+  void print(std::ostream& os) const;
+
+private:
+  void addFunctionModel(const std::string& opName);
+  void renumber();
+
+  std::vector<int> m_classes;
+  unsigned int m_class_count;
+};
+
+#endif /* ALPHABET_PARTITION_HPP_ */
@@ -23,9 +23,42 @@
 
 #include "AnalysisResult.hpp"
 
+#include <stdexcept>
+
+#include "StringBuilder.hpp"
+
+AnalysisResultConstIterator::AnalysisResultConstIterator(const AnalysisResultSlots* slots, int node)
+    : m_slots(slots)
+    , m_entry(node, nullptr)
+{
+    skipEmpty();
+}
+
+AnalysisResultConstIterator& AnalysisResultConstIterator::operator++()
+{
+    ++m_entry.first;
+    skipEmpty();
+    return *this;
+}
+
+AnalysisResultConstIterator AnalysisResultConstIterator::operator++(int)
+{
+    AnalysisResultConstIterator old(*this);
+    ++(*this);
+    return old;
+}
+
+void AnalysisResultConstIterator::skipEmpty()
+{
+    int size = static_cast<int>(m_slots->size());
+    while (m_entry.first < size && !(*m_slots)[m_entry.first]) {
+        ++m_entry.first;
+    }
+    m_entry.second = (m_entry.first < size) ? (*m_slots)[m_entry.first].get() : nullptr;
+}
 
 AnalysisResult::AnalysisResult()
-    : m_map()
+    : m_slots()
 {
 }
 
@@ -35,45 +68,70 @@ AnalysisResult::~AnalysisResult()
     clear();
 }
 
+void AnalysisResult::reserve(int nodes)
+{
+    if (nodes > static_cast<int>(m_slots.size())) {
+        m_slots.resize(nodes);
+    }
+}
+
 const StrangerAutomaton* AnalysisResult::get(int node) const
 {
-    if (m_map.count(node) > 0) {
-        return m_map.at(node);
+    if (node >= 0 && node < static_cast<int>(m_slots.size())) {
+        return m_slots[node].get();
     }
     return nullptr;
 }
 
 void AnalysisResult::set(int node, const StrangerAutomaton* a)
 {
-    if (m_map[node] != nullptr) {
-        delete m_map[node];
+    set(node, std::unique_ptr<const StrangerAutomaton>(a));
+}
+
+void AnalysisResult::set(int node, std::unique_ptr<const StrangerAutomaton> a)
+{
+    if (node < 0) {
+        throw std::out_of_range(stringbuilder() << "Invalid node ID " << node << " for analysis result");
     }
-    m_map[node] = a;
+    // Stored results are compared and reused, so they are always minimal,
+    // see StrangerAutomaton::setDeferredMinimization
+    if (a && !a->isMinimized()) {
+        a.reset(a->minimize());
+    }
+    reserve(node + 1);
+    m_slots[node] = std::move(a);
 }
 
 void AnalysisResult::clear()
 {
-    for (auto a : m_map) {
-        if (a.second != nullptr) {
-            delete a.second;
-            a.second = nullptr;
+    m_slots.clear();
+}
+
+std::size_t AnalysisResult::get_memory_estimate() const
+{
+    std::size_t total = m_slots.capacity() * sizeof(AnalysisResultSlots::value_type);
+    for (const auto& slot : m_slots) {
+        if (slot) {
+            total += slot->get_memory_estimate();
         }
     }
-    m_map.clear();
+    return total;
 }
 
 AnalysisResultConstIterator AnalysisResult::find(int node) const
 {
-    return m_map.find(node);
+    if (get(node) != nullptr) {
+        return AnalysisResultConstIterator(&m_slots, node);
+    }
+    return end();
 }
 
 AnalysisResultConstIterator AnalysisResult::begin() const
 {
-    return m_map.begin();
+    return AnalysisResultConstIterator(&m_slots, 0);
 }
 
 AnalysisResultConstIterator AnalysisResult::end() const
 {
-    return m_map.end();
+    return AnalysisResultConstIterator(&m_slots, static_cast<int>(m_slots.size()));
 }
-
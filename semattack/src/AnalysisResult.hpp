@@ -28,8 +28,48 @@
 
 #include "StrangerAutomaton.hpp"
 
-typedef std::map<int, const StrangerAutomaton*>::iterator AnalysisResultIterator;
-typedef std::map<int, const StrangerAutomaton*>::const_iterator AnalysisResultConstIterator;
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Node IDs handed out by DepGraph::parseStream are dense and start at zero, so
+// the results are kept in a flat vector indexed by node ID. Empty slots hold
+// a null pointer and are skipped during iteration. Entries are usually
+// handles created with StrangerAutomaton::share(), which alias the DFA of
+// another node instead of copying it.
+typedef std::vector<std::unique_ptr<const StrangerAutomaton> > AnalysisResultSlots;
+
+class AnalysisResultConstIterator {
+
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::pair<int, const StrangerAutomaton*> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    AnalysisResultConstIterator(const AnalysisResultSlots* slots, int node);
+
+    reference operator*() const { return m_entry; }
+    pointer operator->() const { return &m_entry; }
+
+    AnalysisResultConstIterator& operator++();
+    AnalysisResultConstIterator operator++(int);
+
+    bool operator==(const AnalysisResultConstIterator& other) const {
+        return m_slots == other.m_slots && m_entry.first == other.m_entry.first;
+    }
+    bool operator!=(const AnalysisResultConstIterator& other) const {
+        return !(*this == other);
+    }
+
+private:
+    void skipEmpty();
+
+    const AnalysisResultSlots* m_slots;
+    value_type m_entry;
+};
 
 class AnalysisResult {
 
@@ -46,16 +86,24 @@ public:
     AnalysisResult(const AnalysisResult&) = delete;
     AnalysisResult& operator=(const AnalysisResult&) = delete;
 
+    // Pre-size the store so that node IDs below nodes do not reallocate
+    void reserve(int nodes);
+
+    // Takes ownership of a, any previous automaton for node is deleted
     void set(int node, const StrangerAutomaton* a);
+    void set(int node, std::unique_ptr<const StrangerAutomaton> a);
     const StrangerAutomaton* get(int node) const;
     void clear();
 
+    // Sum of the memory estimates of all stored automata
+    std::size_t get_memory_estimate() const;
+
     AnalysisResultConstIterator find(int node) const;
     AnalysisResultConstIterator begin() const;
     AnalysisResultConstIterator end() const;
 
 private:
-    std::map<int, const StrangerAutomaton*> m_map;
+    AnalysisResultSlots m_slots;
 };
 
 #endif /* ANALYSISRESULT_HPP_ */
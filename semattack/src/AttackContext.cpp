@@ -34,6 +34,14 @@ const char* AttackContextHelper::getName(AttackContext c)
   return AttackContextName[static_cast<int>(c)];
 }
 
+const std::vector<AttackContext>& AttackContextHelper::getContexts()
+{
+#define MAKE_CONTEXT(VAR) AttackContext::VAR,
+  static const std::vector<AttackContext> contexts = { SOME_ENUM(MAKE_CONTEXT) };
+#undef MAKE_CONTEXT
+  return contexts;
+}
+
 bool AttackContextHelper::isUrlAttribute(const std::string& attribute)
 {
   return ((attribute == "href")  ||
@@ -25,6 +25,8 @@
 #ifndef ATTACK_CONTEXT_HPP_
 #define ATTACK_CONTEXT_HPP_
 
+#include <vector>
+
 #include "depgraph/Metadata.hpp"
 
 #define SOME_ENUM(DO)                  \
@@ -73,6 +75,8 @@ class AttackContextHelper {
 
 public:
   static const char* getName(AttackContext c);
+  // Every context, in declaration order
+  static const std::vector<AttackContext>& getContexts();
   static AttackContext getContextFromMetadata(const Metadata& metadata);
 
 private:
@@ -0,0 +1,137 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * AutomatonFingerprint.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "AutomatonFingerprint.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+std::mutex CanonicalFormStore::store_mutex;
+std::unordered_multimap<std::size_t, std::weak_ptr<const CanonicalFormStore::Form> > CanonicalFormStore::store;
+std::size_t CanonicalFormStore::purge_at = 1024;
+
+std::atomic<bool> AutomatonFingerprint::canonical_forms(false);
+
+std::size_t CanonicalFormStore::hash(const Form& form)
+{
+  std::size_t h = form.size();
+  for (int value : form) {
+    h ^= std::hash<int>()(value) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  }
+  return h;
+}
+
+std::shared_ptr<const CanonicalFormStore::Form> CanonicalFormStore::intern(Form&& form)
+{
+  std::size_t h = hash(form);
+  std::lock_guard<std::mutex> lock(store_mutex);
+  auto range = store.equal_range(h);
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    std::shared_ptr<const Form> existing = iter->second.lock();
+    if (existing && (*existing == form)) {
+      return existing;
+    }
+  }
+  // Drop the forms nobody refers to any more once the store has grown
+  if (store.size() >= purge_at) {
+    for (auto iter = store.begin(); iter != store.end(); ) {
+      iter = iter->second.expired() ? store.erase(iter) : std::next(iter);
+    }
+    purge_at = std::max<std::size_t>(1024, 2 * store.size());
+  }
+  std::shared_ptr<const Form> interned = std::make_shared<const Form>(std::move(form));
+  store.insert(std::make_pair(h, std::weak_ptr<const Form>(interned)));
+  return interned;
+}
+
+std::size_t CanonicalFormStore::size()
+{
+  std::lock_guard<std::mutex> lock(store_mutex);
+  return store.size();
+}
+
+AutomatonFingerprint::AutomatonFingerprint()
+  : m_null(true)
+  , m_empty_string(false)
+  , m_states(0)
+  , m_chars()
+  , m_canonical()
+{
+}
+
+AutomatonFingerprint::AutomatonFingerprint(const StrangerAutomaton* automaton)
+  : m_null((automaton == nullptr) || automaton->isNull())
+  , m_empty_string(false)
+  , m_states(0)
+  , m_chars()
+  , m_canonical()
+{
+  if (!m_null) {
+    // The state count only tells languages apart for minimal automata
+    std::unique_ptr<StrangerAutomaton> minimal;
+    if (!automaton->isMinimized()) {
+      minimal.reset(automaton->minimize());
+      automaton = minimal.get();
+    }
+    m_empty_string = automaton->checkEmptyString();
+    m_states = automaton->get_num_of_states();
+    m_chars = automaton->getUsedChars();
+    if (canonical_forms) {
+      m_canonical = CanonicalFormStore::intern(automaton->getCanonicalForm());
+    }
+  }
+}
+
+bool AutomatonFingerprint::mayEqual(const AutomatonFingerprint& other) const
+{
+  // Minimal automata of the same language have the same number of states
+  return (m_null == other.m_null) && (m_empty_string == other.m_empty_string) &&
+    (m_states == other.m_states) && (m_chars == other.m_chars);
+}
+
+bool AutomatonFingerprint::mustEqual(const AutomatonFingerprint& other) const
+{
+  return m_canonical && (m_canonical == other.m_canonical);
+}
+
+bool AutomatonFingerprint::mayBeIncludedIn(const AutomatonFingerprint& other) const
+{
+  if (m_null || other.m_null) {
+    return false;
+  }
+  if (m_empty_string && !other.m_empty_string) {
+    return false;
+  }
+  // Every character of a string in L(this) must occur in L(other)
+  return (m_chars & ~other.m_chars).none();
+}
+
+std::size_t AutomatonFingerprint::hash() const
+{
+  std::size_t h = std::hash<CharSet>()(m_chars);
+  h ^= std::hash<int>()(m_states) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  h ^= (m_null ? 1 : 0) | (m_empty_string ? 2 : 0);
+  return h;
+}
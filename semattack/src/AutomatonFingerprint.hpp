@@ -0,0 +1,100 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * AutomatonFingerprint.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef AUTOMATON_FINGERPRINT_HPP_
+#define AUTOMATON_FINGERPRINT_HPP_
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "StrangerAutomaton.hpp"
+
+// Hash-consed canonical forms of automata (see dfaCanonicalForm). Equal
+// forms are interned as the same object, so two interned forms are compared
+// by pointer. A form is freed with the last fingerprint referring to it.
+class CanonicalFormStore {
+
+public:
+  typedef std::vector<int> Form;
+
+  static std::shared_ptr<const Form> intern(Form&& form);
+  // Number of forms currently interned
+  static std::size_t size();
+
+private:
+  static std::size_t hash(const Form& form);
+
+  static std::mutex store_mutex;
+  static std::unordered_multimap<std::size_t, std::weak_ptr<const Form> > store;
+  static std::size_t purge_at;
+};
+
+// Cheap invariants of the language of a minimal automaton, used to rule out
+// equivalence and inclusion checks before running them on the automata.
+// Equal languages always have equal fingerprints.
+class AutomatonFingerprint {
+
+public:
+  typedef std::bitset<256> CharSet;
+
+  // Fingerprint of the null automaton
+  AutomatonFingerprint();
+  explicit AutomatonFingerprint(const StrangerAutomaton* automaton);
+
+  // False if the languages are certainly different
+  bool mayEqual(const AutomatonFingerprint& other) const;
+  // False if L(this) is certainly not a subset of L(other)
+  bool mayBeIncludedIn(const AutomatonFingerprint& other) const;
+  // True if the languages are certainly equal, which is only known if both
+  // automata have the same canonical form
+  bool mustEqual(const AutomatonFingerprint& other) const;
+
+  std::size_t hash() const;
+
+  bool isNull() const { return m_null; }
+  int getStates() const { return m_states; }
+  const CharSet& getChars() const { return m_chars; }
+
+  // Intern the canonical form of every automaton fingerprinted from now on.
+  // Minimized automata of the same language then compare equal in constant
+  // time, other automata still need an equivalence check.
+  static void setCanonicalForms(bool c) { canonical_forms = c; }
+  static bool hasCanonicalForms() { return canonical_forms; }
+
+private:
+  bool m_null;
+  bool m_empty_string;
+  int m_states;
+  CharSet m_chars;
+  std::shared_ptr<const CanonicalFormStore::Form> m_canonical;
+
+  static std::atomic<bool> canonical_forms;
+};
+
+#endif /* AUTOMATON_FINGERPRINT_HPP_ */
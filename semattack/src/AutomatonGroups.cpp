@@ -24,8 +24,9 @@
  */
 
 #include "AutomatonGroups.hpp"
+#include "SemAttack.hpp"
 
-
+#include <algorithm>
 #include <iostream>
 
 std::vector<AttackContext> AutomatonGroup::m_sink_contexts = {
@@ -42,7 +43,11 @@ std::vector<AttackContext> AutomatonGroup::m_sink_contexts = {
 
 AutomatonGroup::AutomatonGroup(const StrangerAutomaton* automaton, const std::string& name, int id)
   : m_automaton(automaton)
+  , m_fingerprint(automaton)
+  , m_tightest()
   , m_graphs()
+  , m_graph_statistics()
+  , m_statistics()
   , m_name(name)
   , m_id(id)
 {
@@ -51,7 +56,11 @@ AutomatonGroup::AutomatonGroup(const StrangerAutomaton* automaton, const std::st
 
 AutomatonGroup::AutomatonGroup(const StrangerAutomaton* automaton, int id)
   : m_automaton(automaton)
+  , m_fingerprint(automaton)
+  , m_tightest()
   , m_graphs()
+  , m_graph_statistics()
+  , m_statistics()
   , m_name(std::to_string(id))
   , m_id(id)
 {
@@ -78,12 +87,20 @@ const StrangerAutomaton* AutomatonGroup::getAutomaton() const
   return m_automaton;
 }
 
-void AutomatonGroup::addCombinedAnalysisResult(const CombinedAnalysisResult* graph) {
+void AutomatonGroup::addCombinedAnalysisResult(const SanitizerResult* graph, const ResultStatistics& statistics) {
   m_graphs.emplace_back(graph);
+  m_graph_statistics.push_back(statistics);
+  m_statistics.add(statistics);
+}
+
+void AutomatonGroup::updateCombinedAnalysisResult(size_t index, const ResultStatistics& statistics) {
+  m_statistics.remove(m_graph_statistics.at(index));
+  m_graph_statistics.at(index) = statistics;
+  m_statistics.add(statistics);
 }
 
 void AutomatonGroup::printHeaders(std::ostream& os, const std::vector<AttackContext>& contexts) const {
-  os << "id, name, entries, deduplicated, unique hash, domains, validated";
+  os << "id, name, tightest group, entries, deduplicated, unique hash, domains, validated";
   for (auto c : m_sink_contexts) {
     os << ", " << AttackContextHelper::getName(c) << " sink entries";
     os << ", " << AttackContextHelper::getName(c) << " sink validated";
@@ -99,6 +116,7 @@ void AutomatonGroup::printHeaders(std::ostream& os, const std::vector<AttackCont
 void AutomatonGroup::printSummary(std::ostream& os) const {
   os << m_id << ", "
      << getName() << ", "
+     << getTightestGroup() << ", "
      << getEntriesWithDuplicates() << ", "
      << getNonUniqueEntries() << ", "
      << getEntries() << ", "
@@ -134,169 +152,36 @@ void AutomatonGroup::printGeneratedPayloads(std::ostream& os) const {
   }
 }
 
-unsigned int AutomatonGroup::getSuccessfulValidated() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += iter->getMetadata().is_exploit_successful() ? 1 : 0;
-  }
-  return total;
-}
-
-unsigned int AutomatonGroup::getErrored() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += iter->getFwAnalysis().isErrored() ? 1 : 0;
-  }
-  return total;
-}
-
-unsigned int AutomatonGroup::getSanitizersForPayload() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += (!iter->getFwAnalysis().isErrored()) ? 1 : 0;
-  }
-  return total;
-}
-
-unsigned int AutomatonGroup::getSanitizersWithPayload() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += (iter->hasAtLeastOnePayload() && !iter->getFwAnalysis().isErrored()) ? 1 : 0;
-  }
-  return total;
-}
-
-unsigned int AutomatonGroup::getVulnerableSanitizersWithPayload() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    if (iter->hasAtLeastOnePayload() && !iter->getFwAnalysis().isErrored()) {
-      total += iter->hasAtLeastOneVulnerablePayload() ? 1 : 0;
-    }
-  }
-  return total;
-}
-
-unsigned int AutomatonGroup::getVulnerableSanitizersWithBypass() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += iter->hasAtLeastOneBypass() ? 1 : 0;
-  }
-  return total;
-}
-
-std::set<std::string> AutomatonGroup::getDomainsForPayload() const {
-  std::set<std::string> set;
-  for (auto iter : m_graphs) {
-    if (!iter->getFwAnalysis().isErrored()) {
-      std::set<std::string> s = iter->getUniqueDomains();
-      set.insert(s.begin(), s.end());
-    }
-  }
-  return set;
-}
-
-std::set<std::string> AutomatonGroup::getDomainsWithPayload() const {
-  std::set<std::string> set;
-  for (auto iter : m_graphs) {
-    if (!iter->getFwAnalysis().isErrored()) {
-      std::set<std::string> s = iter->getUniqueDomainsWithPayload();
-      set.insert(s.begin(), s.end());
-    }
-  }
-  return set;
-}
-
-std::set<std::string> AutomatonGroup::getVulnerableDomainsWithPayload() const {
-  std::set<std::string> set;
-  for (auto iter : m_graphs) {
-    if (!iter->getFwAnalysis().isErrored() && iter->hasAtLeastOneVulnerablePayload()) {
-      std::set<std::string> s = iter->getVulnerableDomainsWithPayload();
-      set.insert(s.begin(), s.end());
-    }
-  }
-  return set;
-}
-
-unsigned int AutomatonGroup::getErroredSanitizersWithPayload() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    if (iter->hasAtLeastOnePayload() && !iter->getFwAnalysis().isErrored()) {
-      total += iter->hasAllErroredPayloads() ? 1 : 0;
-    }
-  }
-  return total;
-}
-
 unsigned int AutomatonGroup::getEntriesForSinkContext(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += iter->isSinkContext(context) ? 1 : 0;
-  }
-  return total;
+  return m_statistics.getEntriesForSinkContext(context);
 }
 
 unsigned int AutomatonGroup::getErrorsForSinkContext(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    if (iter->isSinkContext(context) && iter->getFwAnalysis().isErrored()) {
-      total++;
-    }
-  }
-  return total;
+  return m_statistics.getErrorsForSinkContext(context);
 }
 
 unsigned int AutomatonGroup::getErrorsForSinkContextAndErrorType(const AttackContext& context, const AnalysisError& error) const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    if (iter->isSinkContext(context) && iter->getFwAnalysis().isErrored()) {
-      if (iter->getFwAnalysis().getError() == error) {
-        total++;
-      }
-    }
-  }
-  return total;
+  return m_statistics.getErrorsForSinkContextAndErrorType(context, error);
 }
 
 unsigned int AutomatonGroup::getEntriesForSinkContextWeighted(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += iter->isSinkContext(context) ? iter->getCountWithDuplicates() : 0;
-  }
-  return total;
+  return m_statistics.getEntriesForSinkContextWeighted(context);
 }
 
 unsigned int AutomatonGroup::getEntriesForSinkContextDeduplicated(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += iter->isSinkContext(context) ? iter->getCount() : 0;
-  }
-  return total;
+  return m_statistics.getEntriesForSinkContextDeduplicated(context);
 }
 
 unsigned int AutomatonGroup::getValidatedEntriesForSinkContext(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    if (iter->isSinkContext(context) && iter->getMetadata().is_exploit_successful()) {
-      total += 1;
-    }
-  }
-  return total;
+  return m_statistics.getValidatedEntriesForSinkContext(context);
 }
 
-std::vector<std::set<std::string> > AutomatonGroup::getUniqueDomains() const {
-  std::vector<std::set<std::string> > domains;
-  for (auto g : m_graphs) {
-    domains.push_back(g->getUniqueDomains());
+std::vector<size_t> AutomatonGroup::getUniqueDomainsSizes() const {
+  std::vector<size_t> sizes;
+  for (const auto& s : m_graph_statistics) {
+    sizes.push_back(s.domains.size());
   }
-  return domains;
-}
-
-int AutomatonGroup::getUniqueDomainsSize() const {
-  int n = 0;
-  for (auto& s: getUniqueDomains()) {
-    n += s.size();
-  }
-  return n;
+  return sizes;
 }
 
 std::vector<std::set<int> > AutomatonGroup::getUniqueInjectionPoints() const {
@@ -307,28 +192,12 @@ std::vector<std::set<int> > AutomatonGroup::getUniqueInjectionPoints() const {
   return ips;
 }
 
-unsigned int AutomatonGroup::getNonUniqueEntries() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += iter->getCount();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroup::getEntriesWithDuplicates() const {
-  unsigned int total = 0;
-  for (auto iter : m_graphs) {
-    total += iter->getCountWithDuplicates();
-  }
-  return total;
-}
-
 unsigned int AutomatonGroup::getSuccessfulEntriesForContext(const AttackContext& context) const {
   unsigned int entries = this->getEntries();
   unsigned int total = 0;
   if (m_graphs.size() > 0) {
     // Get the first result in the group
-    const CombinedAnalysisResult* result = m_graphs.at(0);
+    const SanitizerResult* result = m_graphs.at(0);
     total = (result->isFilterSuccessful(context) ? 1 : 0) * entries;
   }
   //std::cout << "Getting successful entries for: " << AttackContextHelper::getName(context) << " " << this->getName() << ": " << total << std::endl;
@@ -340,7 +209,7 @@ unsigned int AutomatonGroup::getContainedEntriesForContext(const AttackContext&
   unsigned int total = 0;
   if (m_graphs.size() > 0) {
     // Get the first result in the group
-    const CombinedAnalysisResult* result = m_graphs.at(0);
+    const SanitizerResult* result = m_graphs.at(0);
     total = (result->isFilterContained(context) ? 1 : 0) * entries;
   }
   return total;
@@ -349,6 +218,13 @@ unsigned int AutomatonGroup::getContainedEntriesForContext(const AttackContext&
 AutomatonGroups::AutomatonGroups()
   : m_groups()
   , m_id(0)
+  , m_non_zero_groups(0)
+  , m_statistics()
+  , m_domains()
+  , m_positions()
+  , m_changed()
+  , m_fingerprints()
+  , m_lattice()
 {
 
 }
@@ -366,17 +242,21 @@ AutomatonGroup* AutomatonGroups::createGroup(const StrangerAutomaton* automaton,
     // Group already present, just change the name
     group->setName(name);
   } else {
-    group = addGroup(automaton);
+    group = newGroup(automaton);
     group->setName(name);
   }
+  if (automaton != nullptr) {
+    m_lattice.add(group->getId(), automaton, group->getFingerprint());
+    group->m_tightest = name;
+  }
   return group;
 }
 
-AutomatonGroup* AutomatonGroups::addAutomaton(const StrangerAutomaton* automaton, const CombinedAnalysisResult* graph)
+AutomatonGroup* AutomatonGroups::addAutomaton(const StrangerAutomaton* automaton, const SanitizerResult* graph)
 {
   AutomatonGroup* existingGroup = getGroupForAutomaton(automaton);
   if (existingGroup) {
-    existingGroup->addCombinedAnalysisResult(graph);
+    addResult(existingGroup, graph);
   } else {
     existingGroup = addNewEntry(automaton, graph);
   }
@@ -384,55 +264,110 @@ AutomatonGroup* AutomatonGroups::addAutomaton(const StrangerAutomaton* automaton
 }
 
 AutomatonGroup* AutomatonGroups::addGroup(const StrangerAutomaton* automaton) {
- AutomatonGroup group(automaton, m_id);
+  AutomatonGroup* group = newGroup(automaton);
+  int tightest = m_lattice.classify(automaton, group->getFingerprint());
+  if (tightest >= 0) {
+    group->m_tightest = m_groups.at(tightest).getName();
+  }
+  return group;
+}
+
+AutomatonGroup* AutomatonGroups::newGroup(const StrangerAutomaton* automaton) {
+  AutomatonGroup group(automaton, m_id);
   m_id++;
   m_groups.push_back(group);
-  return &m_groups.back(); 
+  m_fingerprints.insert(std::make_pair(group.getFingerprint().hash(), group.getId()));
+  return &m_groups.back();
 }
 
-AutomatonGroup* AutomatonGroups::addNewEntry(const StrangerAutomaton* automaton, const CombinedAnalysisResult* graph)
+AutomatonGroup* AutomatonGroups::addNewEntry(const StrangerAutomaton* automaton, const SanitizerResult* graph)
 {
   AutomatonGroup* group = addGroup(automaton);
-  group->addCombinedAnalysisResult(graph);
+  addResult(group, graph);
   return group;
 }
 
+void AutomatonGroups::addResult(AutomatonGroup* group, const SanitizerResult* result)
+{
+  ResultStatistics statistics(result, m_domains);
+  if (group->getEntries() == 0) {
+    m_non_zero_groups++;
+  }
+  m_positions[result] = std::make_pair(group->getId(), group->getEntries());
+  group->addCombinedAnalysisResult(result, statistics);
+  m_statistics.add(statistics);
+}
+
+void AutomatonGroups::markChanged(const SanitizerResult* result)
+{
+  if (m_positions.find(result) != m_positions.end()) {
+    m_changed.insert(result);
+  }
+}
+
+void AutomatonGroups::refresh()
+{
+  for (const SanitizerResult* result : m_changed) {
+    const auto& position = m_positions.at(result);
+    AutomatonGroup& group = m_groups.at(position.first);
+    ResultStatistics statistics(result, m_domains);
+    m_statistics.remove(group.m_graph_statistics.at(position.second));
+    m_statistics.add(statistics);
+    group.updateCombinedAnalysisResult(position.second, statistics);
+  }
+  m_changed.clear();
+}
+
+std::vector<int> AutomatonGroups::getCandidates(const AutomatonFingerprint& fingerprint) const
+{
+  // Groups with the same fingerprint in the order they were created
+  std::vector<int> candidates;
+  auto range = m_fingerprints.equal_range(fingerprint.hash());
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    if (m_groups.at(iter->second).getFingerprint().mayEqual(fingerprint)) {
+      candidates.push_back(iter->second);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  return candidates;
+}
+
 AutomatonGroup* AutomatonGroups::getGroupForAutomaton(const StrangerAutomaton* automaton)
 {
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    const StrangerAutomaton* existing = iter->getAutomaton();
-    // std::cout << "Comparing insertion automaton (nstates: "
-    //           << ((automaton != nullptr) ? automaton->get_num_of_states() : -2)
-    //           <<" to group: " << iter->getName() << " with states: "
-    //           << ((existing != nullptr) ? existing->get_num_of_states() : -2)
-    //           << std::endl;
+  const AutomatonGroups* self = this;
+  return const_cast<AutomatonGroup*>(self->getGroupForAutomaton(automaton));
+}
+
+const AutomatonGroup* AutomatonGroups::getGroupForAutomaton(const StrangerAutomaton* automaton) const
+{
+  AutomatonFingerprint fingerprint(automaton);
+  for (int id : getCandidates(fingerprint)) {
+    const AutomatonGroup& group = m_groups.at(id);
+    const StrangerAutomaton* existing = group.getAutomaton();
     // Both are null, found a match!
     if ((automaton == nullptr) && (existing == nullptr)) {
-      return &(*iter);
+      return &group;
     }
     // If one is null, but the other not don't match
     if ((automaton == nullptr) || (existing == nullptr)) {
       continue;
     }
     // Otherwise check
-    if ((automaton == existing) ||
-        ((automaton->get_num_of_states()  == existing->get_num_of_states())
-         && automaton->equals(existing))) {
-      return &(*iter);
+    if ((automaton == existing) || fingerprint.mustEqual(group.getFingerprint()) ||
+        automaton->equals(existing)) {
+      return &group;
     }
   }
   return nullptr;
 }
 
-const AutomatonGroup* AutomatonGroups::getGroupForAutomaton(const StrangerAutomaton* automaton) const
+const AutomatonGroup* AutomatonGroups::getGroupForResult(const SanitizerResult* result) const
 {
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    const StrangerAutomaton* existing = iter->getAutomaton();
-    if (automaton->equals(existing)) {
-      return &(*iter);
-    }
+  auto search = m_positions.find(result);
+  if (search == m_positions.end()) {
+    return nullptr;
   }
-  return nullptr;
+  return &m_groups.at(search->second.first);
 }
 
 void AutomatonGroups::printStatus(std::ostream& os) const
@@ -467,7 +402,7 @@ void AutomatonGroups::printGroups(std::ostream& os, bool printAll, const std::ve
     m_groups.at(0).printHeaders(os, contexts);
   }
   this->printTotals(os, contexts);
-  for (auto iter : m_groups) {
+  for (const auto& iter : m_groups) {
     iter.printMembers(os, printAll, contexts);
   }
 }
@@ -489,23 +424,11 @@ void AutomatonGroups::printErrorSummary(std::ostream& os) const
   for (auto s : AutomatonGroup::m_sink_contexts) {
     os << AttackContextHelper::getName(s) << ",";
 
-    // Total
-    unsigned int total = 0;
-    unsigned int errors = 0;
-    // Loop over each group
-    for (auto g : m_groups) {
-      total += g.getEntriesForSinkContext(s);
-      errors += g.getErrorsForSinkContext(s);
-    }
-    os << total << ", " << errors << ", ";
+    os << getEntriesForSinkContext(s) << ", " << getErrorsForSinkContext(s) << ", ";
 
     // Loop over each error
     for (auto e : AnalysisErrorHelper::getAllEnums()) {
-      errors = 0;
-      for (auto& g : m_groups) {
-        errors += g.getErrorsForSinkContextAndErrorType(s, e);
-      }
-      os << errors << ", ";     
+      os << getErrorsForSinkContextAndErrorType(s, e) << ", ";
     }
     
     os << std::endl;
@@ -548,9 +471,8 @@ void AutomatonGroups::printDomainHistogram(std::ostream& os) const
   std::vector<size_t> domains;
   size_t max = 0;
   for (auto& g: m_groups) {
-    for (auto& s: g.getUniqueDomains()) {
-      // Set of domains for this sanitizer
-      size_t p = s.size();
+    for (size_t p : g.getUniqueDomainsSizes()) {
+      // Number of domains for this sanitizer
       domains.push_back(p);
       max = std::max(max, p);
     }
@@ -585,20 +507,13 @@ void AutomatonGroups::printOverlapSummary(std::ostream& os, const std::vector<At
   for (auto s : AutomatonGroup::m_sink_contexts) {
     os << AttackContextHelper::getName(s) << ",";
 
-    // Total
-    unsigned int total = 0;
-    unsigned int errors = 0;
-    // Loop over each group
-    for (auto g : m_groups) {
-      total += g.getEntriesForSinkContext(s);
-      errors += g.getErrorsForSinkContext(s);
-    }
-    os << total << ", " << errors << ", ";
+    unsigned int total = getEntriesForSinkContext(s);
+    os << total << ", " << getErrorsForSinkContext(s) << ", ";
 
     for (auto a : contexts) {
       unsigned int i = 0;
       // Loop over each group
-      for (auto g : m_groups) {
+      for (const auto& g : m_groups) {
         if (g.getSuccessfulEntriesForContext(a) > 0) {
           i += g.getEntriesForSinkContext(s);
         }
@@ -620,10 +535,10 @@ void AutomatonGroups::printTotals(std::ostream& os, const std::vector<AttackCont
   unsigned int exploited = getSuccessfulValidated();
   unsigned int duplicates = getEntriesWithDuplicates();
   unsigned int nonunique = getNonUniqueEntries();
-  unsigned int domains = getUniqueDomains().size();
+  unsigned int domains = getUniqueDomainsSize();
 
   os << "-3, ";
-  os << "total entries, ";
+  os << "total entries, , ";
   os << duplicates << ", " << nonunique << ", " << entries << ", " << domains << ", " << exploited << ", ";
 
   for (auto c : AutomatonGroup::m_sink_contexts) {
@@ -641,7 +556,7 @@ void AutomatonGroups::printTotals(std::ostream& os, const std::vector<AttackCont
   os << ", " << std::endl;
 
   os << "-2, ";
-  os << "deduplicated entries, ";
+  os << "deduplicated entries, , ";
   os << duplicates << ", " << nonunique << ", " << entries << ", " << domains << ", " << exploited << ", ";
 
   for (auto c : AutomatonGroup::m_sink_contexts) {
@@ -659,7 +574,7 @@ void AutomatonGroups::printTotals(std::ostream& os, const std::vector<AttackCont
   os << ", " << std::endl;
 
   os << "-1, ";
-  os << "unique total, ";
+  os << "unique total, , ";
   os << duplicates << ", " << nonunique << ", " << entries << ", " << domains << ", " << exploited << ", ";
   for (auto c : AutomatonGroup::m_sink_contexts) {
     os << getEntriesForSinkContext(c) << ", ";
@@ -708,162 +623,4 @@ unsigned int AutomatonGroups::getSuccessfulGroupsForContext(const AttackContext&
   return total;
 }
 
-unsigned int AutomatonGroups::getEntries() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getEntries();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getNonUniqueEntries() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getNonUniqueEntries();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getEntriesWithDuplicates() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getEntriesWithDuplicates();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getNonZeroGroups() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    if (iter->getEntries() > 0) {
-      total++;
-    }
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getSuccessfulValidated() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getSuccessfulValidated();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getErrored() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getErrored();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getSanitizersForPayload() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getSanitizersForPayload();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getSanitizersWithPayload() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getSanitizersWithPayload();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getVulnerableSanitizersWithPayload() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getVulnerableSanitizersWithPayload();
-  }
-  return total;
-}
 
-unsigned int AutomatonGroups::getDomainsForPayload() const {
-  std::set<std::string> domains;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    std::set<std::string> s = iter->getDomainsForPayload();
-    domains.insert(s.begin(), s.end());
-  }
-  return domains.size();
-}
-
-unsigned int AutomatonGroups::getDomainsWithPayload() const {
-  std::set<std::string> domains;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    std::set<std::string> s = iter->getDomainsWithPayload();
-    domains.insert(s.begin(), s.end());
-  }
-  return domains.size();
-}
-
-unsigned int AutomatonGroups::getVulnerableDomainsWithPayload() const {
-  std::set<std::string> domains;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    std::set<std::string> s = iter->getVulnerableDomainsWithPayload();
-    domains.insert(s.begin(), s.end());
-  }
-  return domains.size();
-}
-
-
-unsigned int AutomatonGroups::getVulnerableSanitizersWithBypass() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getVulnerableSanitizersWithBypass();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getErroredSanitizersWithPayload() const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getErroredSanitizersWithPayload();
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getEntriesForSinkContext(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getEntriesForSinkContext(context);
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getEntriesForSinkContextWeighted(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getEntriesForSinkContextWeighted(context);
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getEntriesForSinkContextDeduplicated(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getEntriesForSinkContextDeduplicated(context);
-  }
-  return total;
-}
-
-unsigned int AutomatonGroups::getValidatedEntriesForSinkContext(const AttackContext& context) const {
-  unsigned int total = 0;
-  for (auto iter = m_groups.begin(); iter != m_groups.end(); ++iter) {
-    total += iter->getValidatedEntriesForSinkContext(context);
-  }
-  return total;
-}
-
-std::set<std::string> AutomatonGroups::getUniqueDomains() const {
-  std::set<std::string> domains;
-  for (auto g : m_groups) {
-    for (auto& s : g.getUniqueDomains()) {
-      domains.insert(s.begin(), s.end());
-    }
-  }
-  return domains;
-}
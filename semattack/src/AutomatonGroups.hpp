@@ -27,10 +27,16 @@
 
 #include <ostream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "AutomatonFingerprint.hpp"
+#include "ClassificationLattice.hpp"
+#include "GroupStatistics.hpp"
 #include "StrangerAutomaton.hpp"
-#include "SemAttack.hpp"
+#include "SanitizerResult.hpp"
+#include "depgraph/StringPool.hpp"
 #include "exceptions/AnalysisError.hpp"
 
 // Create a class to group equal Automata
@@ -46,30 +52,35 @@ public:
     void setName(const std::string& name);
     std::string getName() const;
     const StrangerAutomaton* getAutomaton() const;
-    void addCombinedAnalysisResult(const CombinedAnalysisResult* graph);
+    const AutomatonFingerprint& getFingerprint() const { return m_fingerprint; }
+    // Name of the smallest named group whose postimage includes this one
+    const std::string& getTightestGroup() const { return m_tightest; }
+    int getId() const { return m_id; }
+    const std::vector<const SanitizerResult*>& getMembers() const { return m_graphs; }
+    const GroupStatistics& getStatistics() const { return m_statistics; }
     size_t getEntries() const { return m_graphs.size(); }
-    unsigned int getEntriesWithDuplicates() const;
-    unsigned int getNonUniqueEntries() const;
+    unsigned int getEntriesWithDuplicates() const { return m_statistics.getEntriesWithDuplicates(); }
+    unsigned int getNonUniqueEntries() const { return m_statistics.getNonUniqueEntries(); }
     unsigned int getSuccessfulEntriesForContext(const AttackContext& context) const;
     unsigned int getContainedEntriesForContext(const AttackContext& context) const;
-    unsigned int getSuccessfulValidated() const;
-    unsigned int getErrored() const;
-    unsigned int getSanitizersForPayload() const;
-    unsigned int getSanitizersWithPayload() const;
-    unsigned int getVulnerableSanitizersWithPayload() const;
-    std::set<std::string> getDomainsForPayload() const;
-    std::set<std::string> getDomainsWithPayload() const;
-    std::set<std::string> getVulnerableDomainsWithPayload() const;
-    unsigned int getVulnerableSanitizersWithBypass() const;
-    unsigned int getErroredSanitizersWithPayload() const;
+    unsigned int getSuccessfulValidated() const { return m_statistics.getSuccessfulValidated(); }
+    unsigned int getErrored() const { return m_statistics.getErrored(); }
+    unsigned int getSanitizersForPayload() const { return m_statistics.getSanitizersForPayload(); }
+    unsigned int getSanitizersWithPayload() const { return m_statistics.getSanitizersWithPayload(); }
+    unsigned int getVulnerableSanitizersWithPayload() const { return m_statistics.getVulnerableSanitizersWithPayload(); }
+    unsigned int getDomainsForPayload() const { return m_statistics.getDomainsForPayload(); }
+    unsigned int getDomainsWithPayload() const { return m_statistics.getDomainsWithPayload(); }
+    unsigned int getVulnerableDomainsWithPayload() const { return m_statistics.getVulnerableDomainsWithPayload(); }
+    unsigned int getVulnerableSanitizersWithBypass() const { return m_statistics.getVulnerableSanitizersWithBypass(); }
+    unsigned int getErroredSanitizersWithPayload() const { return m_statistics.getErroredSanitizersWithPayload(); }
     unsigned int getEntriesForSinkContext(const AttackContext& context) const;
     unsigned int getValidatedEntriesForSinkContext(const AttackContext& context) const;
     unsigned int getEntriesForSinkContextDeduplicated(const AttackContext& context) const;
     unsigned int getEntriesForSinkContextWeighted(const AttackContext& context) const;
     unsigned int getErrorsForSinkContext(const AttackContext& context) const;
     unsigned int getErrorsForSinkContextAndErrorType(const AttackContext& context, const AnalysisError& error) const;
-    std::vector<std::set<std::string> > getUniqueDomains() const;
-    int getUniqueDomainsSize() const;
+    std::vector<size_t> getUniqueDomainsSizes() const;
+    int getUniqueDomainsSize() const { return m_statistics.getDomainCount(); }
     std::vector<std::set<int> > getUniqueInjectionPoints() const;
   
     void printMembers(std::ostream& os, bool printAll, const std::vector<AttackContext>& contexts) const;
@@ -77,8 +88,17 @@ public:
     void printHeaders(std::ostream& os, const std::vector<AttackContext>& contexts) const;
     void printGeneratedPayloads(std::ostream& os) const;
 private:
+    // Members are added and updated through AutomatonGroups, which keeps the overall totals
+    void addCombinedAnalysisResult(const SanitizerResult* graph, const ResultStatistics& statistics);
+    void updateCombinedAnalysisResult(size_t index, const ResultStatistics& statistics);
+
     const StrangerAutomaton* m_automaton;
-    std::vector<const CombinedAnalysisResult*> m_graphs;
+    AutomatonFingerprint m_fingerprint;
+    std::string m_tightest;
+    std::vector<const SanitizerResult*> m_graphs;
+    // Statistics of each member as last seen, in the same order as m_graphs
+    std::vector<ResultStatistics> m_graph_statistics;
+    GroupStatistics m_statistics;
     std::string m_name;
     int m_id;
 
@@ -91,39 +111,55 @@ public:
     AutomatonGroups();
     virtual ~AutomatonGroups();
 
-    // Create an empty group with a name
+    // Create an empty group with a name, named groups with an automaton are
+    // used to classify the postimages of all other groups
     AutomatonGroup* createGroup(const StrangerAutomaton* automaton, const std::string& name);
     // If automaton exists in the group, add the depgraph to that grouping
     // otherwise add a new group with the automaton and graph
-    AutomatonGroup* addAutomaton(const StrangerAutomaton* automaton, const CombinedAnalysisResult* graph);
+    AutomatonGroup* addAutomaton(const StrangerAutomaton* automaton, const SanitizerResult* graph);
 
+    // Add an empty group and find the tightest named group including it
     AutomatonGroup* addGroup(const StrangerAutomaton* automaton);
+    // Add a result to an existing group
+    void addResult(AutomatonGroup* group, const SanitizerResult* result);
+
+    // Results which are already grouped can still change, e.g. gain
+    // duplicates or finish the backward analysis. Changed results are marked
+    // cheaply and their statistics recomputed once on the next refresh.
+    void markChanged(const SanitizerResult* result);
+    void refresh();
 
     AutomatonGroup* getGroupForAutomaton(const StrangerAutomaton* automaton);
     const AutomatonGroup* getGroupForAutomaton(const StrangerAutomaton* automaton) const;
-
-    unsigned int getEntriesWithDuplicates() const;
-    unsigned int getNonZeroGroups() const;
-    unsigned int getEntries() const;
-    unsigned int getNonUniqueEntries() const;
+    // The group a result was added to, or nullptr
+    const AutomatonGroup* getGroupForResult(const SanitizerResult* result) const;
+    const std::vector<AutomatonGroup>& getGroups() const { return m_groups; }
+
+    // The totals are maintained incrementally, see GroupStatistics
+    unsigned int getEntriesWithDuplicates() const { return m_statistics.getEntriesWithDuplicates(); }
+    unsigned int getNonZeroGroups() const { return m_non_zero_groups; }
+    unsigned int getEntries() const { return m_statistics.getEntries(); }
+    unsigned int getNonUniqueEntries() const { return m_statistics.getNonUniqueEntries(); }
     unsigned int getSuccessfulEntriesForContext(const AttackContext& context) const;
     unsigned int getContainedEntriesForContext(const AttackContext& context) const;
     unsigned int getSuccessfulGroupsForContext(const AttackContext& context) const;
-    unsigned int getSuccessfulValidated() const;
-    unsigned int getErrored() const;
-    unsigned int getSanitizersForPayload() const;
-    unsigned int getSanitizersWithPayload() const;
-    unsigned int getVulnerableSanitizersWithPayload() const;
-    unsigned int getDomainsForPayload() const;
-    unsigned int getDomainsWithPayload() const;
-    unsigned int getVulnerableDomainsWithPayload() const;
-    unsigned int getVulnerableSanitizersWithBypass() const;
-    unsigned int getErroredSanitizersWithPayload() const;
-    unsigned int getEntriesForSinkContext(const AttackContext& context) const;
-    unsigned int getEntriesForSinkContextDeduplicated(const AttackContext& context) const;
-    unsigned int getEntriesForSinkContextWeighted(const AttackContext& context) const;
-    unsigned int getValidatedEntriesForSinkContext(const AttackContext& context) const;
-    std::set<std::string> getUniqueDomains() const;
+    unsigned int getSuccessfulValidated() const { return m_statistics.getSuccessfulValidated(); }
+    unsigned int getErrored() const { return m_statistics.getErrored(); }
+    unsigned int getSanitizersForPayload() const { return m_statistics.getSanitizersForPayload(); }
+    unsigned int getSanitizersWithPayload() const { return m_statistics.getSanitizersWithPayload(); }
+    unsigned int getVulnerableSanitizersWithPayload() const { return m_statistics.getVulnerableSanitizersWithPayload(); }
+    unsigned int getDomainsForPayload() const { return m_statistics.getDomainsForPayload(); }
+    unsigned int getDomainsWithPayload() const { return m_statistics.getDomainsWithPayload(); }
+    unsigned int getVulnerableDomainsWithPayload() const { return m_statistics.getVulnerableDomainsWithPayload(); }
+    unsigned int getVulnerableSanitizersWithBypass() const { return m_statistics.getVulnerableSanitizersWithBypass(); }
+    unsigned int getErroredSanitizersWithPayload() const { return m_statistics.getErroredSanitizersWithPayload(); }
+    unsigned int getEntriesForSinkContext(const AttackContext& context) const { return m_statistics.getEntriesForSinkContext(context); }
+    unsigned int getEntriesForSinkContextDeduplicated(const AttackContext& context) const { return m_statistics.getEntriesForSinkContextDeduplicated(context); }
+    unsigned int getEntriesForSinkContextWeighted(const AttackContext& context) const { return m_statistics.getEntriesForSinkContextWeighted(context); }
+    unsigned int getValidatedEntriesForSinkContext(const AttackContext& context) const { return m_statistics.getValidatedEntriesForSinkContext(context); }
+    unsigned int getErrorsForSinkContext(const AttackContext& context) const { return m_statistics.getErrorsForSinkContext(context); }
+    unsigned int getErrorsForSinkContextAndErrorType(const AttackContext& context, const AnalysisError& error) const { return m_statistics.getErrorsForSinkContextAndErrorType(context, error); }
+    unsigned int getUniqueDomainsSize() const { return m_statistics.getUniqueDomains(); }
 
     void printGroups(std::ostream& os, bool printAll, const std::vector<AttackContext>& contexts) const;
     void printStatus(std::ostream& os) const;
@@ -140,7 +176,20 @@ private:
 
     std::vector<AutomatonGroup> m_groups;
     int m_id;
-    AutomatonGroup* addNewEntry(const StrangerAutomaton* automaton, const CombinedAnalysisResult* graph);
+    unsigned int m_non_zero_groups;
+    GroupStatistics m_statistics;
+    // Interned domain names of all results
+    StringPool m_domains;
+    // Position of each result (group id, index in the group)
+    std::unordered_map<const SanitizerResult*, std::pair<int, size_t> > m_positions;
+    std::unordered_set<const SanitizerResult*> m_changed;
+    // Group ids by fingerprint hash, only groups with equal fingerprints are compared
+    std::unordered_multimap<std::size_t, int> m_fingerprints;
+    // Inclusion order of the named groups
+    ClassificationLattice m_lattice;
+    AutomatonGroup* newGroup(const StrangerAutomaton* automaton);
+    std::vector<int> getCandidates(const AutomatonFingerprint& fingerprint) const;
+    AutomatonGroup* addNewEntry(const StrangerAutomaton* automaton, const SanitizerResult* graph);
     void printTotals(std::ostream& os, const std::vector<AttackContext>& contexts) const;
     void printHistogram(std::ostream& os, const std::vector<size_t>& data, size_t max) const;
 };
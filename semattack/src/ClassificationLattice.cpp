@@ -0,0 +1,173 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * ClassificationLattice.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "ClassificationLattice.hpp"
+
+ClassificationLattice::ClassificationLattice()
+  : m_nodes()
+  , m_roots()
+  , m_built(true)
+  , m_inclusion_checks(0)
+  , m_skipped_checks(0)
+{
+}
+
+ClassificationLattice::~ClassificationLattice()
+{
+}
+
+void ClassificationLattice::add(int id, const StrangerAutomaton* automaton, const AutomatonFingerprint& fingerprint)
+{
+  if ((automaton == nullptr) || contains(id)) {
+    return;
+  }
+  m_nodes.push_back({ id, automaton, fingerprint, std::vector<int>() });
+  m_built = false;
+}
+
+bool ClassificationLattice::contains(int id) const
+{
+  for (const auto& node : m_nodes) {
+    if (node.id == id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ClassificationLattice::includes(const Node& node, const StrangerAutomaton* automaton,
+                                     const AutomatonFingerprint& fingerprint)
+{
+  if ((node.automaton == automaton) || fingerprint.mustEqual(node.fingerprint)) {
+    return true;
+  }
+  if (!fingerprint.mayBeIncludedIn(node.fingerprint)) {
+    m_skipped_checks++;
+    return false;
+  }
+  m_inclusion_checks++;
+  return automaton->checkInclusion(node.automaton);
+}
+
+void ClassificationLattice::build()
+{
+  std::size_t n = m_nodes.size();
+  // less[i][j]: L(i) is a strict subset of L(j), ties between equal
+  // languages are broken by insertion order to keep the order acyclic
+  std::vector<std::vector<bool> > less(n, std::vector<bool>(n, false));
+  std::vector<std::vector<bool> > included(n, std::vector<bool>(n, false));
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < n; j++) {
+      if (i != j) {
+        included[i][j] = includes(m_nodes[j], m_nodes[i].automaton, m_nodes[i].fingerprint);
+      }
+    }
+  }
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < n; j++) {
+      less[i][j] = included[i][j] && (!included[j][i] || (i > j));
+    }
+  }
+
+  // Keep only the covering pairs, i.e. no known automaton lies in between
+  m_roots.clear();
+  for (std::size_t j = 0; j < n; j++) {
+    m_nodes[j].children.clear();
+    bool root = true;
+    for (std::size_t i = 0; i < n; i++) {
+      if (less[j][i]) {
+        root = false;
+      }
+      if (!less[i][j]) {
+        continue;
+      }
+      bool covered = true;
+      for (std::size_t k = 0; k < n && covered; k++) {
+        if (less[i][k] && less[k][j]) {
+          covered = false;
+        }
+      }
+      if (covered) {
+        m_nodes[j].children.push_back(i);
+      }
+    }
+    if (root) {
+      m_roots.push_back(j);
+    }
+  }
+  m_built = true;
+}
+
+int ClassificationLattice::classify(const StrangerAutomaton* automaton, const AutomatonFingerprint& fingerprint)
+{
+  if ((automaton == nullptr) || fingerprint.isNull()) {
+    return -1;
+  }
+  if (!m_built) {
+    build();
+  }
+
+  // Every known automaton including this one lies below a root including it
+  // and is reached through nodes which include it as well
+  std::vector<int> state(m_nodes.size(), 0); // 0 unknown, 1 includes, 2 does not
+  std::vector<int> pending;
+  for (int root : m_roots) {
+    state[root] = includes(m_nodes[root], automaton, fingerprint) ? 1 : 2;
+    if (state[root] == 1) {
+      pending.push_back(root);
+    }
+  }
+  int tightest = -1;
+  while (!pending.empty()) {
+    int current = pending.back();
+    pending.pop_back();
+    bool minimal = true;
+    for (int child : m_nodes[current].children) {
+      if (state[child] == 0) {
+        state[child] = includes(m_nodes[child], automaton, fingerprint) ? 1 : 2;
+        if (state[child] == 1) {
+          pending.push_back(child);
+        }
+      }
+      if (state[child] == 1) {
+        minimal = false;
+      }
+    }
+    if (minimal && ((tightest < 0) || (current < tightest))) {
+      tightest = current;
+    }
+  }
+  return (tightest < 0) ? -1 : m_nodes[tightest].id;
+}
+
+void ClassificationLattice::print(std::ostream& os) const
+{
+  for (const auto& node : m_nodes) {
+    os << node.id << ":";
+    for (int child : node.children) {
+      os << " " << m_nodes[child].id;
+    }
+    os << std::endl;
+  }
+}
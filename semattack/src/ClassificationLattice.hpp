@@ -0,0 +1,80 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * ClassificationLattice.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef CLASSIFICATION_LATTICE_HPP_
+#define CLASSIFICATION_LATTICE_HPP_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AutomatonFingerprint.hpp"
+#include "StrangerAutomaton.hpp"
+
+// Orders a fixed set of known automata by language inclusion, e.g. the
+// common sanitizer outputs HTMLEscape<>&"'/ below HTMLEscape<>&"' below
+// HTMLEscape<>&, and finds the tightest known automaton enclosing a new
+// one. The order is
+// computed once, a new automaton is then placed by descending from the
+// largest automata and only checking the children of those which include
+// it. Fingerprints rule out most inclusion checks without touching the DFAs.
+class ClassificationLattice {
+
+public:
+  ClassificationLattice();
+  virtual ~ClassificationLattice();
+
+  // Adds a known automaton, the order is recomputed on the next classify()
+  void add(int id, const StrangerAutomaton* automaton, const AutomatonFingerprint& fingerprint);
+  bool contains(int id) const;
+
+  // Id of the smallest known automaton including automaton, or -1 if there
+  // is none. Of several incomparable ones the first one added is returned.
+  int classify(const StrangerAutomaton* automaton, const AutomatonFingerprint& fingerprint);
+
+  unsigned long getInclusionChecks() const { return m_inclusion_checks; }
+  unsigned long getSkippedChecks() const { return m_skipped_checks; }
+
+  // The direct subsets of each known automaton, by id
+  void print(std::ostream& os) const;
+
+private:
+  struct Node {
+    int id;
+    const StrangerAutomaton* automaton;
+    AutomatonFingerprint fingerprint;
+    std::vector<int> children;
+  };
+
+  void build();
+  bool includes(const Node& node, const StrangerAutomaton* automaton, const AutomatonFingerprint& fingerprint);
+
+  std::vector<Node> m_nodes;
+  std::vector<int> m_roots;
+  bool m_built;
+  unsigned long m_inclusion_checks;
+  unsigned long m_skipped_checks;
+};
+
+#endif /* CLASSIFICATION_LATTICE_HPP_ */
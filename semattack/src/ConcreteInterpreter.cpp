@@ -0,0 +1,627 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * ConcreteInterpreter.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#include "ConcreteInterpreter.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <stack>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "StringBuilder.hpp"
+#include "depgraph/Constant.hpp"
+#include "depgraph/Literal.hpp"
+#include "depgraph/RegExpNode.hpp"
+#include "exceptions/StrangerException.hpp"
+
+// Characters left alone by the percent encoders, in addition to letters and
+// digits. These mirror the tables of dfaEncodeUriComponent, dfaEncodeUri and
+// dfaEscape in the stranger library.
+static const char* uri_component_unescaped = "!'()*-._~";
+static const char* uri_unescaped = "!\"#$&'()*+,-./:;=?@_~";
+static const char* escape_unescaped = "*+-./:;=?@_";
+
+const std::size_t ConcreteInterpreter::max_values = 256;
+
+ConcreteInterpreter::ConcreteInterpreter()
+  : m_input_node(nullptr)
+  , m_input()
+  , m_url_on_lhs(false)
+  , m_url_on_rhs(false)
+  , m_values()
+  , m_active()
+  , m_regexes()
+{
+}
+
+ConcreteInterpreter::~ConcreteInterpreter()
+{
+}
+
+ConcreteInterpreter::Values ConcreteInterpreter::evaluate(
+  const DepGraph& depGraph, const DepGraphNode* inputNode, const std::string& input)
+{
+  m_input_node = inputNode;
+  m_input = input;
+  m_values.clear();
+  m_active.clear();
+
+  const Metadata& m = depGraph.get_metadata();
+  m_url_on_lhs = m.is_initialized() && m.has_url_on_lhs_of_replace();
+  m_url_on_rhs = m.is_initialized() && m.has_url_on_rhs_of_replace();
+
+  const DepGraphNode* root = depGraph.getRoot();
+  if (root == nullptr) {
+    throw StrangerException(AnalysisError::MalformedDepgraph, "Cannot evaluate a depgraph without a root");
+  }
+
+  // Post-order dfs with an explicit stack, a successor which is still on the
+  // stack closes a cycle
+  std::stack<std::pair<const DepGraphNode*, std::size_t> > process_stack;
+  process_stack.push(std::make_pair(root, 0));
+  m_active.insert(root->getID());
+  while (!process_stack.empty()) {
+    const DepGraphNode* curr = process_stack.top().first;
+    std::size_t next = process_stack.top().second;
+    NodesList successors = depGraph.getSuccessors(curr);
+    if (next < successors.size()) {
+      process_stack.top().second++;
+      const DepGraphNode* succ = successors[next];
+      if ((succ->getID() == curr->getID()) || (m_values.find(succ->getID()) != m_values.end())) {
+        // Simple loops are skipped, as in the forward analysis
+        continue;
+      }
+      if (!m_active.insert(succ->getID()).second) {
+        throw StrangerException(AnalysisError::NotImplemented,
+                                stringbuilder() << "Cannot evaluate cycle through node: " << succ->getID());
+      }
+      process_stack.push(std::make_pair(succ, 0));
+    } else {
+      evaluateNode(depGraph, curr);
+      m_active.erase(curr->getID());
+      process_stack.pop();
+    }
+  }
+
+  return m_values.at(root->getID());
+}
+
+const ConcreteInterpreter::Values& ConcreteInterpreter::evaluateNode(const DepGraph& depGraph, const DepGraphNode* node)
+{
+  Values values;
+  NodesList successors = depGraph.getSuccessors(node);
+  const DepGraphNormalNode* normalNode;
+  const DepGraphOpNode* opNode;
+  if ((normalNode = dynamic_cast<const DepGraphNormalNode*>(node)) != nullptr) {
+    if (successors.empty()) {
+      TacPlace* place = normalNode->getPlace();
+      if (dynamic_cast<RegExpNode*>(place) != nullptr) {
+        // Only used as a pattern, kept as written
+        insert(values, place->toString());
+      } else if ((dynamic_cast<Literal*>(place) != nullptr) || (dynamic_cast<Constant*>(place) != nullptr)) {
+        std::string value = place->toString();
+        insert(values, (value == "NUL") ? std::string(1, '\0') : value);
+      } else {
+        throw StrangerException(AnalysisError::MalformedDepgraph,
+                                stringbuilder() << "Unhandled node type, node id: " << node->getID());
+      }
+    } else {
+      // An interior node joins the values of all its successors
+      for (auto succ_node : successors) {
+        if (succ_node->getID() == node->getID()) {
+          continue;
+        }
+        for (const auto& value : m_values.at(succ_node->getID())) {
+          insert(values, value);
+        }
+      }
+    }
+  } else if ((opNode = dynamic_cast<const DepGraphOpNode*>(node)) != nullptr) {
+    try {
+      values = evaluateOp(depGraph, opNode);
+    } catch (std::runtime_error const &e) {
+      // Raised by boost::regex for matches which take too long
+      throw StrangerException(AnalysisError::Other,
+                              stringbuilder() << "Cannot evaluate " << opNode->getName() << ": " << e.what());
+    }
+  } else if (dynamic_cast<const DepGraphUninitNode*>(node) != nullptr) {
+    // Other inputs are bottom, as in SemAttack::computeTargetFWAnalysis
+    if (node == m_input_node) {
+      insert(values, m_input);
+    }
+  } else {
+    throw StrangerException(AnalysisError::MalformedDepgraph,
+                            stringbuilder() << "Cannot figure out node type!, node id: " << node->getID());
+  }
+  return m_values[node->getID()] = values;
+}
+
+ConcreteInterpreter::Values ConcreteInterpreter::evaluateOp(const DepGraph& depGraph, const DepGraphOpNode* opNode)
+{
+  NodesList successors = depGraph.getSuccessors(opNode);
+  const std::string opName = opNode->getName();
+  const OpKind kind = opNode->getKind();
+  Values retMe;
+
+  if (kind == OpKind::VlabRestrict) {
+    if (successors.size() != 3) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << "__vlab_restrict invalid number of arguments: " << opNode->getID());
+    }
+    bool anchored = false;
+    const boost::regex* pattern = getRegex(successors[0], anchored);
+    std::string complementString = getSingleValue(successors[2]);
+    bool complement = (complementString.find("false") == std::string::npos) &&
+      (complementString.find("FALSE") == std::string::npos);
+    for (const auto& subject : m_values.at(successors[1]->getID())) {
+      // An unanchored pattern restricts to strings containing a match
+      bool matched = anchored ? boost::regex_match(subject, *pattern) : boost::regex_search(subject, *pattern);
+      if (matched != complement) {
+        insert(retMe, subject);
+      }
+    }
+
+  } else if (kind == OpKind::Concat) {
+    insert(retMe, "");
+    for (auto succ_node : successors) {
+      Values concatenated;
+      for (const auto& left : retMe) {
+        for (const auto& right : m_values.at(succ_node->getID())) {
+          insert(concatenated, left + right);
+        }
+      }
+      retMe.swap(concatenated);
+    }
+
+  } else if ((kind == OpKind::Replace) || (kind == OpKind::StrReplaceOnce) || (kind == OpKind::Split)) {
+    // split is modeled by replacing the separator with the empty string
+    bool split = (kind == OpKind::Split);
+    if (successors.size() != (split ? 2u : 3u)) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << "replace invalid number of arguments: " << opNode->getID());
+    }
+    const DepGraphNode* patternNode = successors[0];
+    const DepGraphNode* subjectNode = successors.back();
+    Values patterns = m_values.at(patternNode->getID());
+    if (m_url_on_lhs) {
+      // The forward analysis replaces the input itself in this case
+      patterns.clear();
+      insert(patterns, m_input);
+      patternNode = nullptr;
+    }
+    Values replacements;
+    if (split) {
+      insert(replacements, "");
+    } else {
+      replacements = m_values.at(successors[1]->getID());
+    }
+    for (const auto& pattern : patterns) {
+      for (const auto& replacement : replacements) {
+        if (m_url_on_rhs && (replacement.length() > 10)) {
+          throw StrangerException(AnalysisError::UrlInReplaceString,
+                                  stringbuilder() << "URL found in replace string: " << replacement);
+        }
+        for (const auto& subject : m_values.at(subjectNode->getID())) {
+          insert(retMe, replace(patternNode, pattern, replacement, subject, kind == OpKind::StrReplaceOnce));
+        }
+      }
+    }
+
+  } else if (kind == OpKind::RegexMatch) {
+    if (successors.size() != 3) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << "match invalid number of arguments: " << opNode->getID());
+    }
+    // Modeled as the subject intersected with the pattern
+    bool anchored = false;
+    const boost::regex* pattern = getRegex(successors[0], anchored);
+    for (const auto& subject : m_values.at(successors[2]->getID())) {
+      if (boost::regex_match(subject, *pattern)) {
+        insert(retMe, subject);
+      }
+    }
+
+  } else if ((kind == OpKind::Addslashes) || (kind == OpKind::MysqlEscapeString)) {
+    if (successors.empty() || successors.size() > 2) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << opName << " wrong number of arguments: " << opNode->getID());
+    }
+    std::string chars = (kind == OpKind::Addslashes) ? "'\"" : std::string("'\"\n\r\x1a");
+    for (const auto& subject : m_values.at(successors[0]->getID())) {
+      insert(retMe, escape(subject, chars));
+    }
+
+  } else if (kind == OpKind::Htmlspecialchars) {
+    if (successors.empty()) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << "htmlspecialchars wrong number of arguments: " << opNode->getID());
+    }
+    std::string flag = "ENT_COMPAT";
+    if (successors.size() > 1) {
+      flag = getSingleValue(successors[1]);
+    }
+    std::map<char, std::string> replacements = { { '&', "&amp;" }, { '<', "&lt;" }, { '>', "&gt;" } };
+    if ((flag == "ENT_COMPAT") || (flag == "ENT_QUOTES") || (flag == "ENT_SLASH")) {
+      replacements['"'] = "&quot;";
+    }
+    if ((flag == "ENT_QUOTES") || (flag == "ENT_SLASH")) {
+      replacements['\''] = "&apos;";
+    }
+    if (flag == "ENT_SLASH") {
+      replacements['/'] = "&#x2F;";
+    } else if ((flag != "ENT_COMPAT") && (flag != "ENT_QUOTES") && (flag != "ENT_NOQUOTES")) {
+      throw StrangerException(AnalysisError::InvalidArgument,
+                              stringbuilder() << "htmlspecialchar is not supporting the flag: " << flag);
+    }
+    for (const auto& subject : m_values.at(successors[0]->getID())) {
+      insert(retMe, replaceChars(subject, replacements));
+    }
+
+  } else if ((kind == OpKind::EncodeAttrString) || (kind == OpKind::EncodeTextFragment)) {
+    if (successors.empty() || successors.size() > 2) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << opName << " wrong number of arguments: " << opNode->getID());
+    }
+    std::map<char, std::string> replacements = { { '&', "&amp;" } };
+    if (kind == OpKind::EncodeAttrString) {
+      replacements['"'] = "&quot;";
+    } else {
+      replacements['<'] = "&lt;";
+      replacements['>'] = "&gt;";
+    }
+    for (const auto& subject : m_values.at(successors[0]->getID())) {
+      insert(retMe, replaceChars(subject, replacements));
+    }
+
+  } else if (kind == OpKind::Substr) {
+    if (successors.size() < 2) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << "SNH: substr invalid number of arguments: " << opNode->getID());
+    }
+    int start = std::stoi(getSingleValue(successors[1]));
+    int length = -1;
+    if (successors.size() >= 3) {
+      length = std::stoi(getSingleValue(successors[2]));
+      if (length < 0) {
+        throw StrangerException(AnalysisError::InvalidArgument, "current substr model does not support negative parameters!!!");
+      }
+    }
+    if (start < 0) {
+      throw StrangerException(AnalysisError::InvalidArgument, "current substr model does not support negative parameters!!!");
+    }
+    for (const auto& subject : m_values.at(successors[0]->getID())) {
+      std::size_t first = std::min(subject.length(), static_cast<std::size_t>(start));
+      insert(retMe, (length < 0) ? subject.substr(first) : subject.substr(first, length));
+    }
+
+  } else if ((kind == OpKind::Strtoupper) || (kind == OpKind::Strtolower)) {
+    if (successors.size() != 1) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << opName << " has more than one successor in depgraph");
+    }
+    for (std::string subject : m_values.at(successors[0]->getID())) {
+      for (auto& c : subject) {
+        c = (kind == OpKind::Strtoupper) ? std::toupper(static_cast<unsigned char>(c)) : std::tolower(static_cast<unsigned char>(c));
+      }
+      insert(retMe, subject);
+    }
+
+  } else if ((kind == OpKind::Trim) || (kind == OpKind::Rtrim) || (kind == OpKind::Ltrim)) {
+    if (successors.empty() || successors.size() > 2) {
+      throw StrangerException(AnalysisError::MalformedDepgraph,
+                              stringbuilder() << opName << " has more than one successor in depgraph");
+    }
+    // Only spaces are trimmed by the models, the second parameter is ignored
+    for (const auto& subject : m_values.at(successors[0]->getID())) {
+      std::size_t first = (kind == OpKind::Rtrim) ? 0 : subject.find_first_not_of(' ');
+      if (first == std::string::npos) {
+        insert(retMe, "");
+        continue;
+      }
+      std::size_t last = (kind == OpKind::Ltrim) ? subject.length() - 1 : subject.find_last_not_of(' ');
+      insert(retMe, (last == std::string::npos) ? "" : subject.substr(first, last - first + 1));
+    }
+
+  } else if (kind == OpKind::Md5) {
+    // Any digest is accepted by the model, all of them are equally harmless
+    insert(retMe, std::string(32, '0'));
+
+  } else if ((kind == OpKind::EncodeURIComponent) || (kind == OpKind::EncodeURI) || (kind == OpKind::Escape)) {
+    const char* unescaped = (kind == OpKind::EncodeURIComponent) ? uri_component_unescaped :
+      ((kind == OpKind::EncodeURI) ? uri_unescaped : escape_unescaped);
+    for (const auto& subject : m_values.at(successors.at(0)->getID())) {
+      insert(retMe, percentEncode(subject, unescaped));
+    }
+
+  } else if ((kind == OpKind::DecodeURIComponent) || (kind == OpKind::DecodeURI) || (kind == OpKind::Unescape)) {
+    // decodeURI leaves sequences alone which encodeURI cannot produce
+    const char* unescaped = (kind == OpKind::DecodeURI) ? uri_unescaped : nullptr;
+    for (const auto& subject : m_values.at(successors.at(0)->getID())) {
+      insert(retMe, percentDecode(subject, unescaped));
+    }
+
+  } else if (kind == OpKind::JsonStringify) {
+    for (const auto& subject : m_values.at(successors.at(0)->getID())) {
+      insert(retMe, jsonStringify(subject));
+    }
+
+  } else if (kind == OpKind::JsonParse) {
+    // Strings with invalid escapes are dropped, JSON.parse throws for them
+    for (const auto& subject : m_values.at(successors.at(0)->getID())) {
+      std::string parsed;
+      if (jsonParse(subject, parsed)) {
+        insert(retMe, parsed);
+      }
+    }
+
+  } else {
+    throw StrangerException(AnalysisError::NotImplemented, stringbuilder() << "Unknown function " << opName);
+  }
+
+  return retMe;
+}
+
+std::string ConcreteInterpreter::getSingleValue(const DepGraphNode* node)
+{
+  const Values& values = m_values.at(node->getID());
+  if (values.size() != 1) {
+    throw StrangerException(AnalysisError::InvalidArgument,
+                            stringbuilder() << "Expected a single value for argument, node id: " << node->getID());
+  }
+  return *values.begin();
+}
+
+const boost::regex* ConcreteInterpreter::getRegex(const DepGraphNode* node, bool& anchored)
+{
+  const DepGraphNormalNode* normalNode = dynamic_cast<const DepGraphNormalNode*>(node);
+  if ((normalNode == nullptr) || (dynamic_cast<RegExpNode*>(normalNode->getPlace()) == nullptr)) {
+    throw StrangerException(AnalysisError::MalformedDepgraph,
+                            stringbuilder() << "Expected a regexp node, node id: " << node->getID());
+  }
+  std::string value = normalNode->getPlace()->toString();
+  auto lastSlash = value.find_last_of('/');
+  if ((value.find_first_of('/') != 0) || (lastSlash == 0) ||
+      (lastSlash != (value.length() - 1)) || (value.length() <= 2)) {
+    throw StrangerException(AnalysisError::MalformedDepgraph,
+                            stringbuilder() << "Malformed Regex in regexp node, node id: " << node->getID());
+  }
+  std::string regString = value.substr(1, value.length() - 2);
+  anchored = (regString.find_first_of('^') == 0) && (regString.find_last_of('$') == (regString.length() - 1));
+  if (anchored) {
+    regString = regString.substr(1, regString.length() - 2);
+  }
+
+  auto it = m_regexes.find(regString);
+  if (it == m_regexes.end()) {
+    try {
+      it = m_regexes.insert(std::make_pair(regString, boost::regex(regString))).first;
+    } catch (boost::regex_error const &e) {
+      throw StrangerException(AnalysisError::RegExpParseError,
+                              stringbuilder() << "Cannot parse regex: " << regString << ": " << e.what());
+    }
+  }
+  return &it->second;
+}
+
+std::string ConcreteInterpreter::replace(const DepGraphNode* patternNode, const std::string& pattern,
+                                         const std::string& replacement, const std::string& subject, bool once)
+{
+  const DepGraphNormalNode* normalNode = dynamic_cast<const DepGraphNormalNode*>(patternNode);
+  if ((normalNode != nullptr) && (dynamic_cast<RegExpNode*>(normalNode->getPlace()) != nullptr)) {
+    // The replacement is a literal string and empty matches are never replaced
+    bool anchored = false;
+    const boost::regex* regex = getRegex(patternNode, anchored);
+    boost::match_flag_type flags = boost::regex_constants::format_literal | boost::match_not_null;
+    if (once) {
+      flags |= boost::format_first_only;
+    }
+    return boost::regex_replace(subject, *regex, replacement, flags);
+  }
+
+  if (pattern.empty()) {
+    return subject;
+  }
+  std::string retMe;
+  std::size_t pos = 0;
+  std::size_t found;
+  while ((found = subject.find(pattern, pos)) != std::string::npos) {
+    retMe.append(subject, pos, found - pos);
+    retMe.append(replacement);
+    pos = found + pattern.length();
+    if (once) {
+      break;
+    }
+  }
+  retMe.append(subject, pos, std::string::npos);
+  return retMe;
+}
+
+void ConcreteInterpreter::insert(Values& values, const std::string& value)
+{
+  values.insert(value);
+  if (values.size() > max_values) {
+    throw StrangerException(AnalysisError::Other,
+                            stringbuilder() << "More than " << max_values << " concrete values for a node");
+  }
+}
+
+std::string ConcreteInterpreter::escape(const std::string& s, const std::string& chars)
+{
+  std::string retMe;
+  retMe.reserve(s.length());
+  for (char c : s) {
+    if (chars.find(c) != std::string::npos) {
+      retMe.push_back('\\');
+    }
+    retMe.push_back(c);
+  }
+  return retMe;
+}
+
+std::string ConcreteInterpreter::replaceChars(const std::string& s, const std::map<char, std::string>& replacements)
+{
+  std::string retMe;
+  retMe.reserve(s.length());
+  for (char c : s) {
+    auto it = replacements.find(c);
+    if (it != replacements.end()) {
+      retMe.append(it->second);
+    } else {
+      retMe.push_back(c);
+    }
+  }
+  return retMe;
+}
+
+static bool isPercentEncoded(unsigned char c, const char* unescaped)
+{
+  // The models never encode 0xFF
+  if (c == 0xFF) {
+    return false;
+  } else if ((c < 0x20) || (c >= 0x7F) || (c == '%')) {
+    return true;
+  }
+  return !std::isalnum(c) && (std::strchr(unescaped, c) == nullptr);
+}
+
+std::string ConcreteInterpreter::percentEncode(const std::string& s, const char* unescaped)
+{
+  std::string retMe;
+  retMe.reserve(s.length());
+  for (char c : s) {
+    unsigned char u = static_cast<unsigned char>(c);
+    if (isPercentEncoded(u, unescaped)) {
+      char percent[4];
+      std::snprintf(percent, sizeof(percent), "%%%02X", u);
+      retMe.append(percent);
+    } else {
+      retMe.push_back(c);
+    }
+  }
+  return retMe;
+}
+
+static int upperHexValue(char c)
+{
+  if ((c >= '0') && (c <= '9')) {
+    return c - '0';
+  } else if ((c >= 'A') && (c <= 'F')) {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+std::string ConcreteInterpreter::percentDecode(const std::string& s, const char* unescaped)
+{
+  // Only the upper case sequences produced by the encoders are decoded
+  std::string retMe;
+  retMe.reserve(s.length());
+  for (std::size_t i = 0; i < s.length(); i++) {
+    int high = ((s[i] == '%') && (i + 2 < s.length())) ? upperHexValue(s[i + 1]) : -1;
+    int low = (high >= 0) ? upperHexValue(s[i + 2]) : -1;
+    unsigned char c = static_cast<unsigned char>(high * 16 + low);
+    if ((low >= 0) && (c != 0xFF) &&
+        ((unescaped == nullptr) || ((c != '%') && isPercentEncoded(c, unescaped)))) {
+      retMe.push_back(static_cast<char>(c));
+      i += 2;
+    } else {
+      retMe.push_back(s[i]);
+    }
+  }
+  return retMe;
+}
+
+std::string ConcreteInterpreter::jsonStringify(const std::string& s)
+{
+  // Escapes as dfaJsonStringify, the surrounding quotes are not added
+  std::string retMe;
+  retMe.reserve(s.length());
+  for (char c : s) {
+    unsigned char u = static_cast<unsigned char>(c);
+    switch (c) {
+    case '\\': retMe.append("\\\\"); break;
+    case '"': retMe.append("\\\""); break;
+    case '\b': retMe.append("\\b"); break;
+    case '\t': retMe.append("\\t"); break;
+    case '\n': retMe.append("\\n"); break;
+    case '\f': retMe.append("\\f"); break;
+    case '\r': retMe.append("\\r"); break;
+    default:
+      if (u < 0x20) {
+        char encoded[8];
+        std::snprintf(encoded, sizeof(encoded), "\\u00%02x", u);
+        retMe.append(encoded);
+      } else {
+        retMe.push_back(c);
+      }
+    }
+  }
+  return retMe;
+}
+
+bool ConcreteInterpreter::jsonParse(const std::string& s, std::string& parsed)
+{
+  parsed.clear();
+  parsed.reserve(s.length());
+  for (std::size_t i = 0; i < s.length(); i++) {
+    if (s[i] != '\\') {
+      parsed.push_back(s[i]);
+      continue;
+    }
+    if (++i == s.length()) {
+      return false;
+    }
+    switch (s[i]) {
+    case '"': parsed.push_back('"'); break;
+    case '\\': parsed.push_back('\\'); break;
+    case '/': parsed.push_back('/'); break;
+    case 'b': parsed.push_back('\b'); break;
+    case 'f': parsed.push_back('\f'); break;
+    case 'n': parsed.push_back('\n'); break;
+    case 'r': parsed.push_back('\r'); break;
+    case 't': parsed.push_back('\t'); break;
+    case 'u': {
+      // Only single byte code points are modeled
+      if ((i + 4 >= s.length()) || (s.compare(i + 1, 2, "00") != 0)) {
+        return false;
+      }
+      int high = std::isxdigit(static_cast<unsigned char>(s[i + 3])) ? std::stoi(s.substr(i + 3, 1), nullptr, 16) : -1;
+      int low = std::isxdigit(static_cast<unsigned char>(s[i + 4])) ? std::stoi(s.substr(i + 4, 1), nullptr, 16) : -1;
+      if ((high < 0) || (low < 0) || (high > 7)) {
+        return false;
+      }
+      parsed.push_back(static_cast<char>(high * 16 + low));
+      i += 4;
+      break;
+    }
+    default:
+      return false;
+    }
+  }
+  return true;
+}
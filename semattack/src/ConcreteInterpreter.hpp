@@ -0,0 +1,91 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * ConcreteInterpreter.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef CONCRETE_INTERPRETER_HPP_
+#define CONCRETE_INTERPRETER_HPP_
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <boost/regex.hpp>
+
+#include "depgraph/DepGraph.hpp"
+
+// Runs a dependency graph on a concrete input string instead of an automaton.
+// The operations follow the models used by ImageComputer for the forward
+// analysis, so a string accepted by a post-image can be checked in
+// microseconds without any automaton work.
+//
+// A normal node with several successors joins their values, as the forward
+// analysis unions their automata, so every node evaluates to a set of
+// strings. Uninitialized nodes other than the input have no value, cycles
+// and unmodeled functions throw a StrangerException.
+class ConcreteInterpreter {
+
+public:
+  typedef std::set<std::string> Values;
+
+  ConcreteInterpreter();
+  virtual ~ConcreteInterpreter();
+
+  // Values of the root of depGraph if inputNode is set to input
+  Values evaluate(const DepGraph& depGraph, const DepGraphNode* inputNode, const std::string& input);
+
+  // Upper bound on the number of values of a single node
+  static const std::size_t max_values;
+
+private:
+  const Values& evaluateNode(const DepGraph& depGraph, const DepGraphNode* node);
+  Values evaluateOp(const DepGraph& depGraph, const DepGraphOpNode* opNode);
+
+  // Value of a literal or constant argument, such as a flag or an index
+  std::string getSingleValue(const DepGraphNode* node);
+
+  // Regular expression of a regexp node, anchors are dropped as done by
+  // ImageComputer::getLiteralorConstantNodeAuto
+  const boost::regex* getRegex(const DepGraphNode* node, bool& anchored);
+
+  std::string replace(const DepGraphNode* patternNode, const std::string& pattern,
+                      const std::string& replacement, const std::string& subject, bool once);
+
+  static void insert(Values& values, const std::string& value);
+
+  static std::string escape(const std::string& s, const std::string& chars);
+  static std::string replaceChars(const std::string& s, const std::map<char, std::string>& replacements);
+  static std::string percentEncode(const std::string& s, const char* unescaped);
+  static std::string percentDecode(const std::string& s, const char* unescaped);
+  static std::string jsonStringify(const std::string& s);
+  static bool jsonParse(const std::string& s, std::string& parsed);
+
+  const DepGraphNode* m_input_node;
+  std::string m_input;
+  bool m_url_on_lhs;
+  bool m_url_on_rhs;
+  std::map<int, Values> m_values;
+  std::set<int> m_active;
+  std::map<std::string, boost::regex> m_regexes;
+};
+
+#endif /* CONCRETE_INTERPRETER_HPP_ */
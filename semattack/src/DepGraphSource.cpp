@@ -0,0 +1,442 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * DepGraphSource.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#include "DepGraphSource.hpp"
+#include "StringBuilder.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+namespace io = boost::iostreams;
+
+const std::string DepGraphSource::dot_extension = ".dot";
+
+DepGraph DepGraphInput::parse() const
+{
+  if (in_memory) {
+    std::istringstream iss(contents);
+    return DepGraph::parseStream(iss);
+  }
+  return DepGraph::parseDotFile(path.string());
+}
+
+std::unique_ptr<DepGraphSource> DepGraphSource::create(const fs::path& target)
+{
+  if (!fs::exists(target)) {
+    throw std::runtime_error(stringbuilder() << "Dependency graph input " << target.string() << " does not exist");
+  }
+  std::string name = target.filename().string();
+  if (fs::is_directory(target) || target.extension() == dot_extension) {
+    return std::unique_ptr<DepGraphSource>(new DirectoryDepGraphSource(target));
+  } else if (boost::algorithm::ends_with(name, ".tar") ||
+             boost::algorithm::ends_with(name, ".tar.gz") ||
+             boost::algorithm::ends_with(name, ".tgz")) {
+    return std::unique_ptr<DepGraphSource>(new TarDepGraphSource(target));
+  } else if (boost::algorithm::ends_with(name, ".zip")) {
+    return std::unique_ptr<DepGraphSource>(new ZipDepGraphSource(target));
+  }
+  const std::string extension = target.extension().string();
+  if ((extension == ".txt") || (extension == ".lst") || (extension == ".list") || (extension == ".manifest")) {
+    return std::unique_ptr<DepGraphSource>(new ManifestDepGraphSource(target));
+  }
+  throw std::runtime_error(stringbuilder() << "Unknown dependency graph input " << target.string()
+                           << ": expected a directory, a .dot file, a .tar, .tar.gz, .tgz or .zip bundle"
+                           << " or a .txt, .lst, .list or .manifest manifest");
+}
+
+//  *********************************************************************************
+
+DirectoryDepGraphSource::DirectoryDepGraphSource(const fs::path& root)
+  : m_single_file()
+  , m_iter()
+{
+  if (fs::is_directory(root)) {
+    m_iter = fs::recursive_directory_iterator(root);
+  } else {
+    m_single_file = root;
+  }
+}
+
+bool DirectoryDepGraphSource::next(DepGraphInput& input)
+{
+  input.contents.clear();
+  input.in_memory = false;
+  if (!m_single_file.empty()) {
+    input.path = m_single_file;
+    m_single_file.clear();
+    return true;
+  }
+  // The iterator caches the file status from the directory scan where the
+  // platform allows it, so this avoids a stat per file on remote storage
+  for (; m_iter != fs::recursive_directory_iterator(); ++m_iter) {
+    const fs::directory_entry& entry = *m_iter;
+    if (entry.path().extension() == dot_extension && fs::is_regular_file(entry.status())) {
+      input.path = entry.path();
+      ++m_iter;
+      return true;
+    }
+  }
+  return false;
+}
+
+//  *********************************************************************************
+
+ManifestDepGraphSource::ManifestDepGraphSource(const fs::path& manifest)
+  : m_base(manifest.parent_path())
+  , m_ifs(manifest.string())
+{
+  if (!m_ifs.is_open()) {
+    throw std::runtime_error(stringbuilder() << "Can not open manifest file " << manifest.string());
+  }
+}
+
+bool ManifestDepGraphSource::next(DepGraphInput& input)
+{
+  std::string line;
+  while (std::getline(m_ifs, line)) {
+    boost::algorithm::trim(line);
+    // Skip blank lines and comments
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    fs::path p(line);
+    input.path = p.is_absolute() ? p : (m_base / p);
+    input.contents.clear();
+    input.in_memory = false;
+    return true;
+  }
+  return false;
+}
+
+//  *********************************************************************************
+
+namespace {
+
+const std::size_t tar_block_size = 512;
+
+std::string tarField(const char* block, std::size_t offset, std::size_t length)
+{
+  const char* start = block + offset;
+  std::size_t n = 0;
+  while (n < length && start[n] != '\0') {
+    n++;
+  }
+  return std::string(start, n);
+}
+
+std::size_t tarSize(const char* block)
+{
+  const unsigned char* field = reinterpret_cast<const unsigned char*>(block + 124);
+  std::size_t size = 0;
+  // GNU base-256 encoding for large members
+  if (field[0] & 0x80) {
+    for (std::size_t i = 1; i < 12; i++) {
+      size = (size << 8) | field[i];
+    }
+    return size;
+  }
+  for (std::size_t i = 0; i < 12; i++) {
+    if (field[i] >= '0' && field[i] <= '7') {
+      size = (size << 3) | (field[i] - '0');
+    } else if (size > 0) {
+      break;
+    }
+  }
+  return size;
+}
+
+// Extract the path from pax extended header records ("<len> path=<value>\n")
+std::string paxPath(const std::string& data)
+{
+  std::size_t pos = 0;
+  while (pos < data.size()) {
+    std::size_t space = data.find(' ', pos);
+    if (space == std::string::npos) {
+      break;
+    }
+    std::size_t len = std::stoul(data.substr(pos, space - pos));
+    if (len == 0 || pos + len > data.size()) {
+      break;
+    }
+    std::string record = data.substr(space + 1, pos + len - space - 2);
+    if (boost::algorithm::starts_with(record, "path=")) {
+      return record.substr(5);
+    }
+    pos += len;
+  }
+  return "";
+}
+
+}
+
+TarDepGraphSource::TarDepGraphSource(const fs::path& archive)
+  : m_archive(archive)
+  , m_file(archive.string(), std::ios_base::in | std::ios_base::binary)
+  , m_stream()
+{
+  if (!m_file.is_open()) {
+    throw std::runtime_error(stringbuilder() << "Can not open tar archive " << archive.string());
+  }
+  std::string name = archive.filename().string();
+  if (boost::algorithm::ends_with(name, ".gz") || boost::algorithm::ends_with(name, ".tgz")) {
+    io::filtering_istream* in = new io::filtering_istream();
+    in->push(io::gzip_decompressor());
+    in->push(m_file);
+    m_stream.reset(in);
+  }
+}
+
+bool TarDepGraphSource::readBlock(char* block)
+{
+  std::istream& in = m_stream ? *m_stream : m_file;
+  in.read(block, tar_block_size);
+  return in.gcount() == (std::streamsize) tar_block_size;
+}
+
+void TarDepGraphSource::readData(std::string& data, std::size_t size)
+{
+  std::istream& in = m_stream ? *m_stream : m_file;
+  data.resize(size);
+  if (size > 0) {
+    in.read(&data[0], size);
+    if (in.gcount() != (std::streamsize) size) {
+      throw std::runtime_error(stringbuilder() << "Truncated tar archive " << m_archive.string());
+    }
+  }
+  std::size_t padding = (tar_block_size - (size % tar_block_size)) % tar_block_size;
+  in.ignore(padding);
+}
+
+void TarDepGraphSource::skipData(std::size_t size)
+{
+  std::istream& in = m_stream ? *m_stream : m_file;
+  std::size_t padded = ((size + tar_block_size - 1) / tar_block_size) * tar_block_size;
+  in.ignore(padded);
+}
+
+bool TarDepGraphSource::next(DepGraphInput& input)
+{
+  char block[tar_block_size];
+  std::string long_name;
+  while (readBlock(block)) {
+    // An all zero block marks the end of the archive
+    if (block[0] == '\0') {
+      return false;
+    }
+    std::size_t size = tarSize(block);
+    char type = block[156];
+    if (type == 'L') {
+      // GNU long name for the following member
+      readData(long_name, size);
+      long_name = tarField(long_name.c_str(), 0, long_name.size());
+      continue;
+    } else if (type == 'x') {
+      // pax extended header for the following member
+      std::string pax;
+      readData(pax, size);
+      long_name = paxPath(pax);
+      continue;
+    } else if (type != '0' && type != '\0' && type != '7') {
+      skipData(size);
+      long_name.clear();
+      continue;
+    }
+
+    std::string name = long_name;
+    if (name.empty()) {
+      name = tarField(block, 0, 100);
+      // ustar splits long names into prefix and name
+      if (tarField(block, 257, 5) == "ustar") {
+        std::string prefix = tarField(block, 345, 155);
+        if (!prefix.empty()) {
+          name = prefix + "/" + name;
+        }
+      }
+    }
+    long_name.clear();
+    while (boost::algorithm::starts_with(name, "./")) {
+      name.erase(0, 2);
+    }
+
+    fs::path member(name);
+    if (member.extension() != dot_extension) {
+      skipData(size);
+      continue;
+    }
+    input.path = m_archive.filename() / member;
+    readData(input.contents, size);
+    input.in_memory = true;
+    return true;
+  }
+  return false;
+}
+
+//  *********************************************************************************
+
+namespace {
+
+const unsigned int zip_end_of_central_directory = 0x06054b50;
+const unsigned int zip_central_directory_header = 0x02014b50;
+const unsigned int zip_local_file_header = 0x04034b50;
+const std::size_t zip_end_of_central_directory_size = 22;
+
+unsigned int readLE16(const char* p)
+{
+  const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+  return u[0] | (u[1] << 8);
+}
+
+unsigned int readLE32(const char* p)
+{
+  const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+  return u[0] | (u[1] << 8) | (u[2] << 16) | ((unsigned int) u[3] << 24);
+}
+
+}
+
+ZipDepGraphSource::ZipDepGraphSource(const fs::path& archive)
+  : m_archive(archive)
+  , m_file(archive.string(), std::ios_base::in | std::ios_base::binary)
+  , m_central_directory()
+  , m_offset(0)
+  , m_remaining(0)
+{
+  if (!m_file.is_open()) {
+    throw std::runtime_error(stringbuilder() << "Can not open zip archive " << archive.string());
+  }
+  readCentralDirectory();
+}
+
+// The central directory is small compared to the archive, read it once and
+// then visit the members in archive order
+void ZipDepGraphSource::readCentralDirectory()
+{
+  m_file.seekg(0, std::ios_base::end);
+  std::streamoff file_size = m_file.tellg();
+  // The end record is followed by a comment of at most 64k
+  std::streamoff tail_size = std::min<std::streamoff>(file_size, zip_end_of_central_directory_size + 0xffff);
+  std::vector<char> tail(tail_size);
+  m_file.seekg(file_size - tail_size);
+  m_file.read(tail.data(), tail_size);
+
+  std::streamoff pos = tail_size - (std::streamoff) zip_end_of_central_directory_size;
+  for (; pos >= 0; pos--) {
+    if (readLE32(&tail[pos]) == zip_end_of_central_directory) {
+      break;
+    }
+  }
+  if (pos < 0) {
+    throw std::runtime_error(stringbuilder() << "No central directory found in zip archive " << m_archive.string());
+  }
+  unsigned int entries = readLE16(&tail[pos + 10]);
+  unsigned int cd_size = readLE32(&tail[pos + 12]);
+  unsigned int cd_offset = readLE32(&tail[pos + 16]);
+  if (entries == 0xffff || cd_size == 0xffffffff || cd_offset == 0xffffffff) {
+    throw std::runtime_error(stringbuilder() << "Zip64 archives are not supported: " << m_archive.string());
+  }
+
+  m_central_directory.resize(cd_size);
+  m_file.seekg(cd_offset);
+  m_file.read(m_central_directory.data(), cd_size);
+  if (m_file.gcount() != (std::streamsize) cd_size) {
+    throw std::runtime_error(stringbuilder() << "Truncated zip archive " << m_archive.string());
+  }
+  m_remaining = entries;
+  m_offset = 0;
+}
+
+bool ZipDepGraphSource::next(DepGraphInput& input)
+{
+  while (m_remaining > 0) {
+    if (m_offset + 46 > m_central_directory.size() ||
+        readLE32(&m_central_directory[m_offset]) != zip_central_directory_header) {
+      throw std::runtime_error(stringbuilder() << "Corrupt central directory in zip archive " << m_archive.string());
+    }
+    const char* header = &m_central_directory[m_offset];
+    unsigned int method = readLE16(header + 10);
+    unsigned int compressed_size = readLE32(header + 20);
+    unsigned int uncompressed_size = readLE32(header + 24);
+    unsigned int name_length = readLE16(header + 28);
+    unsigned int extra_length = readLE16(header + 30);
+    unsigned int comment_length = readLE16(header + 32);
+    unsigned int local_offset = readLE32(header + 42);
+    std::string name(header + 46, name_length);
+
+    m_offset += 46 + name_length + extra_length + comment_length;
+    m_remaining--;
+
+    fs::path member(name);
+    if (member.extension() != dot_extension) {
+      continue;
+    }
+    if (method != 0 && method != 8) {
+      std::cerr << "Skipping " << name << " in " << m_archive.string()
+                << ": unsupported compression method " << method << std::endl;
+      continue;
+    }
+
+    // Local header has its own name and extra field lengths
+    char local[30];
+    m_file.seekg(local_offset);
+    m_file.read(local, sizeof(local));
+    if (m_file.gcount() != (std::streamsize) sizeof(local) || readLE32(local) != zip_local_file_header) {
+      throw std::runtime_error(stringbuilder() << "Corrupt local header for " << name << " in zip archive " << m_archive.string());
+    }
+    m_file.seekg(readLE16(local + 26) + readLE16(local + 28), std::ios_base::cur);
+
+    std::vector<char> data(compressed_size);
+    m_file.read(data.data(), compressed_size);
+    if (m_file.gcount() != (std::streamsize) compressed_size) {
+      throw std::runtime_error(stringbuilder() << "Truncated zip archive " << m_archive.string());
+    }
+
+    if (method == 0) {
+      input.contents.assign(data.begin(), data.end());
+    } else {
+      // Zip stores raw deflate streams without zlib header
+      io::zlib_params params;
+      params.noheader = true;
+      io::filtering_istream in;
+      in.push(io::zlib_decompressor(params));
+      in.push(io::array_source(data.data(), data.size()));
+      input.contents.clear();
+      input.contents.reserve(uncompressed_size);
+      input.contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    input.path = m_archive.filename() / member;
+    input.in_memory = true;
+    return true;
+  }
+  return false;
+}
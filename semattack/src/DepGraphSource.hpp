@@ -0,0 +1,128 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * DepGraphSource.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef DEPGRAPH_SOURCE_HPP_
+#define DEPGRAPH_SOURCE_HPP_
+
+#define BOOST_FILESYSTEM_VERSION 3
+#define BOOST_FILESYSTEM_NO_DEPRECATED
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "depgraph/DepGraph.hpp"
+
+namespace fs = boost::filesystem;
+
+// A single dependency graph handed from a source to the parser workers.
+// Graphs read from a bundle are carried in memory, graphs on disk are only
+// referenced by path and opened by the worker.
+struct DepGraphInput {
+  fs::path path;
+  std::string contents;
+  bool in_memory = false;
+
+  DepGraph parse() const;
+};
+
+// Lazily enumerates dependency graphs, one at a time, so that parsing can
+// start before the whole input has been discovered.
+class DepGraphSource {
+
+public:
+  virtual ~DepGraphSource() {}
+
+  // Fills in the next input, returns false once the source is exhausted
+  virtual bool next(DepGraphInput& input) = 0;
+
+  // Picks the source for a target:
+  //   directory            -> all .dot files below it
+  //   *.dot                -> the single file
+  //   *.tar, *.tar.gz, *.tgz -> .dot members of the tar archive
+  //   *.zip                -> .dot members of the zip archive
+  //   *.txt, *.lst, *.list, *.manifest -> manifest, one dot file path per line
+  // Throws std::runtime_error for anything else
+  static std::unique_ptr<DepGraphSource> create(const fs::path& target);
+
+  static const std::string dot_extension;
+};
+
+class DirectoryDepGraphSource : public DepGraphSource {
+
+public:
+  explicit DirectoryDepGraphSource(const fs::path& root);
+  bool next(DepGraphInput& input) override;
+
+private:
+  fs::path m_single_file;
+  fs::recursive_directory_iterator m_iter;
+};
+
+class ManifestDepGraphSource : public DepGraphSource {
+
+public:
+  explicit ManifestDepGraphSource(const fs::path& manifest);
+  bool next(DepGraphInput& input) override;
+
+private:
+  fs::path m_base;
+  std::ifstream m_ifs;
+};
+
+class TarDepGraphSource : public DepGraphSource {
+
+public:
+  explicit TarDepGraphSource(const fs::path& archive);
+  bool next(DepGraphInput& input) override;
+
+private:
+  bool readBlock(char* block);
+  void readData(std::string& data, std::size_t size);
+  void skipData(std::size_t size);
+
+  fs::path m_archive;
+  std::ifstream m_file;
+  std::unique_ptr<std::istream> m_stream;
+};
+
+class ZipDepGraphSource : public DepGraphSource {
+
+public:
+  explicit ZipDepGraphSource(const fs::path& archive);
+  bool next(DepGraphInput& input) override;
+
+private:
+  void readCentralDirectory();
+
+  fs::path m_archive;
+  std::ifstream m_file;
+  std::vector<char> m_central_directory;
+  std::size_t m_offset;
+  unsigned int m_remaining;
+};
+
+#endif /* DEPGRAPH_SOURCE_HPP_ */
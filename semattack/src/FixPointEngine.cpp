@@ -0,0 +1,277 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * FixPointEngine.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "FixPointEngine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <set>
+#include <utility>
+
+#include "exceptions/StrangerException.hpp"
+
+WideningLimits FixPointEngine::widening_limits;
+bool FixPointEngine::record_statistics = false;
+std::mutex FixPointEngine::statistics_mutex;
+std::vector<SccStatistics> FixPointEngine::statistics;
+
+static thread_local std::string thread_label;
+
+FixPointEngine::FixPointEngine(const DepGraph& depGraph, int scc_id, Direction direction)
+  : m_depGraph(depGraph)
+  , m_scc_id(scc_id)
+  , m_direction(direction)
+  , m_nodes(depGraph.getSCCNodes(scc_id))
+  , m_rank()
+  , m_order()
+  , m_version()
+  , m_seen()
+  , m_statistics()
+{
+  m_statistics.label = thread_label;
+  m_statistics.direction = (direction == Direction::Forward) ? "forward" : "backward";
+  m_statistics.scc_id = scc_id;
+  m_statistics.nodes = m_nodes.size();
+  m_statistics.iterations = 0;
+  m_statistics.skipped = 0;
+  m_statistics.updates = 0;
+  m_statistics.widenings = 0;
+  m_statistics.converged = false;
+  m_statistics.ms = 0.0;
+}
+
+FixPointEngine::~FixPointEngine()
+{
+}
+
+NodesList FixPointEngine::getSources(const DepGraphNode* node) const
+{
+  // In a depgraph successors are the arguments of a node
+  return (m_direction == Direction::Forward) ? m_depGraph.getSuccessors(node) : m_depGraph.getPredecessors(node);
+}
+
+NodesList FixPointEngine::getUsers(const DepGraphNode* node) const
+{
+  return (m_direction == Direction::Forward) ? m_depGraph.getPredecessors(node) : m_depGraph.getSuccessors(node);
+}
+
+bool FixPointEngine::isInComponent(const DepGraphNode* node) const
+{
+  return m_depGraph.isSCCElement(node) && (m_depGraph.getSCCID(node) == m_scc_id);
+}
+
+void FixPointEngine::computeRanks(DepGraphNode* first)
+{
+  NodesList roots;
+  for (auto node : m_nodes) {
+    for (auto source : getSources(node)) {
+      if (!isInComponent(source)) {
+        roots.push_back(node);
+        break;
+      }
+    }
+  }
+  roots.push_back(first);
+  // Nodes only reachable through a cycle of the component
+  roots.insert(roots.end(), m_nodes.begin(), m_nodes.end());
+
+  std::set<const DepGraphNode*> visited;
+  NodesList postorder;
+  for (auto root : roots) {
+    if (!visited.insert(root).second) {
+      continue;
+    }
+    std::vector<std::pair<DepGraphNode*, NodesList> > stack;
+    stack.push_back(std::make_pair(root, getUsers(root)));
+    while (!stack.empty()) {
+      NodesList& users = stack.back().second;
+      if (users.empty()) {
+        postorder.push_back(stack.back().first);
+        stack.pop_back();
+        continue;
+      }
+      DepGraphNode* user = users.back();
+      users.pop_back();
+      if (isInComponent(user) && visited.insert(user).second) {
+        stack.push_back(std::make_pair(user, getUsers(user)));
+      }
+    }
+  }
+
+  m_order.assign(postorder.rbegin(), postorder.rend());
+  for (std::size_t i = 0; i < m_order.size(); i++) {
+    m_rank[m_order[i]->getID()] = i;
+  }
+}
+
+bool FixPointEngine::evaluate(DepGraphNode* node, AnalysisResult& result, const Transfer& transfer, const Refine& refine)
+{
+  int id = node->getID();
+  std::map<int, int>& seen = m_seen[id];
+  NodesList changed;
+  for (auto source : getSources(node)) {
+    if (source == node) {
+      // ignore simple self loop
+      continue;
+    }
+    auto version = m_version.find(source->getID());
+    int current = (version == m_version.end()) ? 0 : version->second;
+    auto last = seen.find(source->getID());
+    if ((last == seen.end()) || (last->second != current)) {
+      seen[source->getID()] = current;
+      changed.push_back(source);
+    }
+  }
+  if (changed.empty()) {
+    m_statistics.skipped++;
+    return false;
+  }
+
+  std::unique_ptr<StrangerAutomaton> new_auto;
+  if ((m_direction == Direction::Forward) && (dynamic_cast<const DepGraphOpNode*>(node) != nullptr)) {
+    new_auto.reset(transfer(node, nullptr));
+    if (new_auto == nullptr) {
+      throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Could not calculate the corresponding automaton!, node id: " << id);
+    }
+  } else if ((dynamic_cast<const DepGraphNormalNode*>(node) != nullptr) || (dynamic_cast<const DepGraphOpNode*>(node) != nullptr)) {
+    for (auto source : changed) {
+      std::unique_ptr<StrangerAutomaton> contribution(transfer(node, source));
+      if (contribution == nullptr) {
+        continue;
+      }
+      if (new_auto == nullptr) {
+        new_auto = std::move(contribution);
+      } else {
+        new_auto.reset(new_auto->union_(contribution.get(), id));
+      }
+    }
+  } else {
+    throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Node cannot be an element of SCC component!, node id: " << id);
+  }
+  if (new_auto == nullptr) {
+    return false;
+  }
+
+  const StrangerAutomaton* prev_auto = result.get(id);
+  new_auto.reset(new_auto->union_(prev_auto, id));
+
+  // decide whether to do widening operations
+  int new_version = m_version[id] + 1;
+  if (new_version > widening_limits.coarse) {
+    new_auto.reset(prev_auto->coarseWiden(new_auto.get(), id));
+    m_statistics.widenings++;
+  } else if (new_version > widening_limits.precise) {
+    new_auto.reset(prev_auto->preciseWiden(new_auto.get(), id));
+    m_statistics.widenings++;
+  }
+
+  if (new_auto->checkInclusion(prev_auto, new_auto->getID(), prev_auto->getID())) {
+    return false;
+  }
+  if (refine) {
+    new_auto.reset(refine(node, new_auto.get()));
+  }
+  result.set(id, std::move(new_auto));
+  m_version[id] = new_version;
+  m_statistics.updates++;
+  return true;
+}
+
+void FixPointEngine::run(AnalysisResult& result, const Transfer& transfer, const Refine& refine)
+{
+  auto start = std::chrono::steady_clock::now();
+  if (m_nodes.empty()) {
+    return;
+  }
+
+  // initialize all scc_nodes to phi
+  for (auto node : m_nodes) {
+    result.set(node->getID(), StrangerAutomaton::makePhi(node->getID()));
+    m_version[node->getID()] = 0;
+  }
+  computeRanks(m_nodes.front());
+
+  // Ranks of the nodes to evaluate, the entries of the component first
+  std::set<int> worklist;
+  for (auto node : m_nodes) {
+    for (auto source : getSources(node)) {
+      if (!isInComponent(source)) {
+        worklist.insert(m_rank[node->getID()]);
+        break;
+      }
+    }
+  }
+  if (worklist.empty()) {
+    for (std::size_t i = 0; i < m_order.size(); i++) {
+      worklist.insert(i);
+    }
+  }
+
+  int max_version = 0;
+  while (!worklist.empty() && (max_version < widening_limits.max_updates)) {
+    DepGraphNode* node = m_order[*worklist.begin()];
+    worklist.erase(worklist.begin());
+    m_statistics.iterations++;
+    if (!evaluate(node, result, transfer, refine)) {
+      continue;
+    }
+    max_version = std::max(max_version, m_version[node->getID()]);
+    for (auto user : getUsers(node)) {
+      if ((user != node) && isInComponent(user)) {
+        worklist.insert(m_rank[user->getID()]);
+      }
+    }
+  }
+
+  m_statistics.converged = worklist.empty();
+  m_statistics.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  if (record_statistics) {
+    std::lock_guard<std::mutex> lock(statistics_mutex);
+    statistics.push_back(m_statistics);
+  }
+}
+
+void FixPointEngine::setThreadLabel(const std::string& label)
+{
+  thread_label = label;
+}
+
+const std::string& FixPointEngine::getThreadLabel()
+{
+  return thread_label;
+}
+
+void FixPointEngine::writeStatistics(std::ostream& os)
+{
+  std::lock_guard<std::mutex> lock(statistics_mutex);
+  os << "label,direction,scc,nodes,iterations,skipped,updates,widenings,converged,ms" << std::endl;
+  os << std::fixed << std::setprecision(3);
+  for (const auto& s : statistics) {
+    os << s.label << "," << s.direction << "," << s.scc_id << "," << s.nodes << ","
+       << s.iterations << "," << s.skipped << "," << s.updates << "," << s.widenings << ","
+       << (s.converged ? 1 : 0) << "," << s.ms << std::endl;
+  }
+}
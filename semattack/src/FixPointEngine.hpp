@@ -0,0 +1,140 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * FixPointEngine.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef FIX_POINT_ENGINE_HPP_
+#define FIX_POINT_ENGINE_HPP_
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AnalysisResult.hpp"
+#include "StrangerAutomaton.hpp"
+#include "depgraph/DepGraph.hpp"
+
+// Widening thresholds of the loop analysis, counted in updates of a node
+struct WideningLimits {
+  WideningLimits() : precise(5), coarse(20), max_updates(30000) {}
+  // New values are widened precisely after this many updates
+  int precise;
+  // and coarsely after this many updates
+  int coarse;
+  // The computation stops once a node was updated this often
+  int max_updates;
+};
+
+// Counters of one fix-point computation
+struct SccStatistics {
+  std::string label;
+  std::string direction;
+  int scc_id;
+  int nodes;
+  // Nodes taken from the worklist
+  int iterations;
+  // Of those, nodes whose sources did not change since their last evaluation
+  int skipped;
+  // Evaluations which changed the value of a node
+  int updates;
+  int widenings;
+  bool converged;
+  double ms;
+};
+
+// Computes the values of the nodes of one strongly connected component of a
+// depgraph. Nodes are taken from the worklist in reverse postorder of the
+// data flow inside the component, so a node is usually evaluated after the
+// nodes it reads from. Every node keeps the version of each source it read
+// at its last evaluation: a node whose sources did not change is skipped,
+// and only the values of the changed sources are joined with the previous
+// value of the node (delta propagation). Operations in forward direction
+// read all of their arguments and are recomputed instead.
+class FixPointEngine {
+
+public:
+  enum class Direction { Forward, Backward };
+
+  // Value flowing from source into node, or the value of node computed from
+  // all of its arguments if source is nullptr. Returns nullptr if the source
+  // does not contribute to node.
+  typedef std::function<StrangerAutomaton*(DepGraphNode* node, DepGraphNode* source)> Transfer;
+  // Applied to changed values before they are stored, e.g. to intersect
+  // pre-images with the post-images
+  typedef std::function<StrangerAutomaton*(DepGraphNode* node, const StrangerAutomaton* value)> Refine;
+
+  FixPointEngine(const DepGraph& depGraph, int scc_id, Direction direction);
+  virtual ~FixPointEngine();
+
+  // Sets all nodes of the component to phi and iterates until no value
+  // changes or a node reaches WideningLimits::max_updates
+  void run(AnalysisResult& result, const Transfer& transfer, const Refine& refine = Refine());
+
+  const SccStatistics& getStatistics() const { return m_statistics; }
+
+  // Limits for all following computations, set before starting threads
+  static void setLimits(const WideningLimits& limits) { widening_limits = limits; }
+  static const WideningLimits& getLimits() { return widening_limits; }
+
+  // Keep the statistics of every computation, labelled with the label of the
+  // calling thread (e.g. the depgraph it analyses)
+  static void setRecordStatistics(bool record) { record_statistics = record; }
+  static void setThreadLabel(const std::string& label);
+  static const std::string& getThreadLabel();
+  // One row per computation
+  static void writeStatistics(std::ostream& os);
+
+private:
+  // Sources are the nodes a node reads from in the analysis direction,
+  // users the nodes reading from it
+  NodesList getSources(const DepGraphNode* node) const;
+  NodesList getUsers(const DepGraphNode* node) const;
+  bool isInComponent(const DepGraphNode* node) const;
+  // Reverse postorder of the data flow, starting at the nodes with a
+  // source outside of the component
+  void computeRanks(DepGraphNode* first);
+  // Returns true if the value of node changed
+  bool evaluate(DepGraphNode* node, AnalysisResult& result, const Transfer& transfer, const Refine& refine);
+
+  const DepGraph& m_depGraph;
+  const int m_scc_id;
+  const Direction m_direction;
+  NodesList m_nodes;
+  // Position of a node in m_order by node ID
+  std::map<int, int> m_rank;
+  NodesList m_order;
+  // Number of updates of each node, nodes outside the component keep version 0
+  std::map<int, int> m_version;
+  // Versions of the sources at the last evaluation of a node
+  std::map<int, std::map<int, int> > m_seen;
+  SccStatistics m_statistics;
+
+  static WideningLimits widening_limits;
+  static bool record_statistics;
+  static std::mutex statistics_mutex;
+  static std::vector<SccStatistics> statistics;
+};
+
+#endif /* FIX_POINT_ENGINE_HPP_ */
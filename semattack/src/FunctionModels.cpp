@@ -0,0 +1,78 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * FunctionModels.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "FunctionModels.hpp"
+
+#include <iostream>
+#include <map>
+
+// Inverting the encoding of large automata is too expensive, keep them as
+// an over-approximation of the pre-image
+static StrangerAutomaton* pre_decodeURIComponent(const StrangerAutomaton* automaton, int id)
+{
+  if (automaton->get_num_of_states() > 1000) {
+    std::cout << "Approximating BW analysis for decodeURIComponent nStates: " << automaton->get_num_of_states() << std::endl;
+    return automaton->share();
+  }
+  return StrangerAutomaton::encodeURIComponent(automaton, id);
+}
+
+static const std::map<OpKind, FunctionModels::UnaryModel> unary_models = {
+  { OpKind::Addslashes, { &StrangerAutomaton::addslashes, &StrangerAutomaton::pre_addslashes } },
+  { OpKind::MysqlEscapeString, { &StrangerAutomaton::mysql_escape_string, &StrangerAutomaton::pre_mysql_escape_string } },
+  { OpKind::MysqlRealEscapeString, { &StrangerAutomaton::mysql_real_escape_string, &StrangerAutomaton::pre_mysql_real_escape_string } },
+  { OpKind::Nl2br, { &StrangerAutomaton::nl2br, nullptr } },
+  { OpKind::Strtoupper, {
+      [](const StrangerAutomaton* a, int id) { return a->toUpperCase(id); },
+      [](const StrangerAutomaton* a, int id) { return a->preToUpperCase(id); } } },
+  { OpKind::Strtolower, {
+      [](const StrangerAutomaton* a, int id) { return a->toLowerCase(id); },
+      [](const StrangerAutomaton* a, int id) { return a->preToLowerCase(id); } } },
+  { OpKind::Trim, {
+      [](const StrangerAutomaton* a, int id) { return a->trimSpaces(id); },
+      [](const StrangerAutomaton* a, int id) { return a->preTrimSpaces(id); } } },
+  { OpKind::Rtrim, {
+      [](const StrangerAutomaton* a, int id) { return a->trimSpacesRight(id); },
+      [](const StrangerAutomaton* a, int id) { return a->preTrimSpacesRigth(id); } } },
+  { OpKind::Ltrim, {
+      [](const StrangerAutomaton* a, int id) { return a->trimSpacesLeft(id); },
+      [](const StrangerAutomaton* a, int id) { return a->preTrimSpacesLeft(id); } } },
+  // The encodings are invertible, the pre-image is the inverse function
+  { OpKind::EncodeURIComponent, { &StrangerAutomaton::encodeURIComponent, &StrangerAutomaton::decodeURIComponent } },
+  { OpKind::DecodeURIComponent, { &StrangerAutomaton::decodeURIComponent, &pre_decodeURIComponent } },
+  { OpKind::EncodeURI, { &StrangerAutomaton::encodeURI, &StrangerAutomaton::decodeURI } },
+  { OpKind::DecodeURI, { &StrangerAutomaton::decodeURI, &StrangerAutomaton::encodeURI } },
+  { OpKind::Escape, { &StrangerAutomaton::escape, &StrangerAutomaton::unescape } },
+  { OpKind::Unescape, { &StrangerAutomaton::unescape, &StrangerAutomaton::escape } },
+  { OpKind::JsonStringify, { &StrangerAutomaton::jsonStringify, &StrangerAutomaton::jsonParse } },
+  { OpKind::JsonParse, { &StrangerAutomaton::jsonParse, &StrangerAutomaton::jsonStringify } },
+  { OpKind::EncodeTextFragment, { &StrangerAutomaton::encodeTextFragment, &StrangerAutomaton::pre_encodeTextFragment } },
+  { OpKind::EncodeAttrString, { &StrangerAutomaton::encodeAttrString, &StrangerAutomaton::pre_encodeAttrString } },
+};
+
+const FunctionModels::UnaryModel* FunctionModels::getUnaryModel(OpKind kind)
+{
+  auto iter = unary_models.find(kind);
+  return (iter != unary_models.end()) ? &iter->second : nullptr;
+}
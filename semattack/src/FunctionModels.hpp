@@ -0,0 +1,52 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * FunctionModels.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef FUNCTION_MODELS_HPP_
+#define FUNCTION_MODELS_HPP_
+
+#include "StrangerAutomaton.hpp"
+#include "depgraph/OpKind.hpp"
+
+// Models of the operations which map their first argument to the result
+// without looking at the others. The forward analysis, the backward analysis
+// and the validation patch computation all dispatch through this table
+// instead of each comparing operation names.
+class FunctionModels {
+
+public:
+  typedef StrangerAutomaton* (*Model)(const StrangerAutomaton* automaton, int id);
+
+  struct UnaryModel {
+    // Image of the first argument
+    Model forward;
+    // Pre-image of the result, nullptr if there is no model for it
+    Model preimage;
+  };
+
+  // nullptr if the operation has other arguments which matter, or no model
+  static const UnaryModel* getUnaryModel(OpKind kind);
+
+};
+
+#endif /* FUNCTION_MODELS_HPP_ */
@@ -0,0 +1,200 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * GroupStatistics.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#include "GroupStatistics.hpp"
+
+ResultStatistics::ResultStatistics()
+  : count_with_duplicates(0)
+  , count(0)
+  , errored(false)
+  , error(AnalysisError::None)
+  , exploit_successful(false)
+  , sink_context(AttackContext::None)
+  , payload(false)
+  , vulnerable_payload(false)
+  , all_errored_payloads(false)
+  , bypass(false)
+  , domains()
+  , domains_with_payload()
+  , vulnerable_domains_with_payload()
+{
+}
+
+ResultStatistics::ResultStatistics(const SanitizerResult* result, StringPool& pool)
+  : count_with_duplicates(result->getCountWithDuplicates())
+  , count(result->getCount())
+  , errored(result->isErrored())
+  , error(result->getError())
+  , exploit_successful(result->isExploitSuccessful())
+  , sink_context(result->getSinkContext())
+  , payload(result->hasAtLeastOnePayload() && !errored)
+  , vulnerable_payload(payload && result->hasAtLeastOneVulnerablePayload())
+  , all_errored_payloads(payload && result->hasAllErroredPayloads())
+  , bypass(result->hasAtLeastOneBypass())
+  , domains()
+  , domains_with_payload()
+  , vulnerable_domains_with_payload()
+{
+  for (const auto& domain : result->getUniqueDomains()) {
+    domains.push_back(pool.intern(domain));
+  }
+  if (!errored) {
+    for (const auto& domain : result->getUniqueDomainsWithPayload()) {
+      domains_with_payload.push_back(pool.intern(domain));
+    }
+    if (result->hasAtLeastOneVulnerablePayload()) {
+      for (const auto& domain : result->getVulnerableDomainsWithPayload()) {
+        vulnerable_domains_with_payload.push_back(pool.intern(domain));
+      }
+    }
+  }
+}
+
+GroupStatistics::SinkStatistics::SinkStatistics()
+  : entries(0)
+  , weighted(0)
+  , deduplicated(0)
+  , validated(0)
+  , errors(0)
+  , errors_by_type()
+{
+}
+
+GroupStatistics::GroupStatistics()
+  : m_entries(0)
+  , m_count_with_duplicates(0)
+  , m_count(0)
+  , m_exploit_successful(0)
+  , m_errored(0)
+  , m_payload(0)
+  , m_vulnerable_payload(0)
+  , m_all_errored_payloads(0)
+  , m_bypass(0)
+  , m_domain_count(0)
+  , m_sinks()
+  , m_domains()
+  , m_domains_for_payload()
+  , m_domains_with_payload()
+  , m_vulnerable_domains_with_payload()
+{
+}
+
+void GroupStatistics::add(const ResultStatistics& result)
+{
+  update(result, 1);
+}
+
+void GroupStatistics::remove(const ResultStatistics& result)
+{
+  update(result, -1);
+}
+
+void GroupStatistics::update(const ResultStatistics& result, int sign)
+{
+  m_entries += sign;
+  m_count_with_duplicates += sign * result.count_with_duplicates;
+  m_count += sign * result.count;
+  m_exploit_successful += result.exploit_successful ? sign : 0;
+  m_errored += result.errored ? sign : 0;
+  m_payload += result.payload ? sign : 0;
+  m_vulnerable_payload += result.vulnerable_payload ? sign : 0;
+  m_all_errored_payloads += result.all_errored_payloads ? sign : 0;
+  m_bypass += result.bypass ? sign : 0;
+  m_domain_count += sign * result.domains.size();
+
+  SinkStatistics& sink = m_sinks[result.sink_context];
+  sink.entries += sign;
+  sink.weighted += sign * result.count_with_duplicates;
+  sink.deduplicated += sign * result.count;
+  sink.validated += result.exploit_successful ? sign : 0;
+  if (result.errored) {
+    sink.errors += sign;
+    sink.errors_by_type[result.error] += sign;
+  }
+
+  updateDomains(m_domains, result.domains, sign);
+  if (!result.errored) {
+    updateDomains(m_domains_for_payload, result.domains, sign);
+  }
+  updateDomains(m_domains_with_payload, result.domains_with_payload, sign);
+  updateDomains(m_vulnerable_domains_with_payload, result.vulnerable_domains_with_payload, sign);
+}
+
+void GroupStatistics::updateDomains(DomainCounts& counts, const std::vector<StringPool::Handle>& domains, int sign)
+{
+  for (auto domain : domains) {
+    unsigned int& count = counts[domain];
+    count += sign;
+    if (count == 0) {
+      counts.erase(domain);
+    }
+  }
+}
+
+const GroupStatistics::SinkStatistics* GroupStatistics::getSink(const AttackContext& context) const
+{
+  auto search = m_sinks.find(context);
+  return (search != m_sinks.end()) ? &search->second : nullptr;
+}
+
+unsigned int GroupStatistics::getEntriesForSinkContext(const AttackContext& context) const
+{
+  const SinkStatistics* sink = getSink(context);
+  return sink ? sink->entries : 0;
+}
+
+unsigned int GroupStatistics::getEntriesForSinkContextWeighted(const AttackContext& context) const
+{
+  const SinkStatistics* sink = getSink(context);
+  return sink ? sink->weighted : 0;
+}
+
+unsigned int GroupStatistics::getEntriesForSinkContextDeduplicated(const AttackContext& context) const
+{
+  const SinkStatistics* sink = getSink(context);
+  return sink ? sink->deduplicated : 0;
+}
+
+unsigned int GroupStatistics::getValidatedEntriesForSinkContext(const AttackContext& context) const
+{
+  const SinkStatistics* sink = getSink(context);
+  return sink ? sink->validated : 0;
+}
+
+unsigned int GroupStatistics::getErrorsForSinkContext(const AttackContext& context) const
+{
+  const SinkStatistics* sink = getSink(context);
+  return sink ? sink->errors : 0;
+}
+
+unsigned int GroupStatistics::getErrorsForSinkContextAndErrorType(const AttackContext& context, const AnalysisError& error) const
+{
+  const SinkStatistics* sink = getSink(context);
+  if (sink == nullptr) {
+    return 0;
+  }
+  auto search = sink->errors_by_type.find(error);
+  return (search != sink->errors_by_type.end()) ? search->second : 0;
+}
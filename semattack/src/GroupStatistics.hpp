@@ -0,0 +1,132 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * GroupStatistics.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef GROUP_STATISTICS_HPP_
+#define GROUP_STATISTICS_HPP_
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "AttackContext.hpp"
+#include "SanitizerResult.hpp"
+#include "depgraph/StringPool.hpp"
+#include "exceptions/AnalysisError.hpp"
+
+// The contribution of a single sanitizer result to the reported totals.
+// Domains are kept as handles into a StringPool shared by all results.
+class ResultStatistics {
+
+public:
+  ResultStatistics();
+  ResultStatistics(const SanitizerResult* result, StringPool& domains);
+
+  unsigned int count_with_duplicates;
+  unsigned int count;
+  bool errored;
+  AnalysisError error;
+  bool exploit_successful;
+  AttackContext sink_context;
+  bool payload;
+  bool vulnerable_payload;
+  bool all_errored_payloads;
+  bool bypass;
+  std::vector<StringPool::Handle> domains;
+  std::vector<StringPool::Handle> domains_with_payload;
+  std::vector<StringPool::Handle> vulnerable_domains_with_payload;
+};
+
+// Running totals over a set of sanitizer results, so that status lines and
+// summaries do not need to visit every result. A result which changes is
+// accounted for by removing its old contribution and adding the new one.
+class GroupStatistics {
+
+public:
+  GroupStatistics();
+
+  void add(const ResultStatistics& result);
+  void remove(const ResultStatistics& result);
+
+  unsigned int getEntries() const { return m_entries; }
+  unsigned int getEntriesWithDuplicates() const { return m_count_with_duplicates; }
+  unsigned int getNonUniqueEntries() const { return m_count; }
+  unsigned int getSuccessfulValidated() const { return m_exploit_successful; }
+  unsigned int getErrored() const { return m_errored; }
+  unsigned int getSanitizersForPayload() const { return m_entries - m_errored; }
+  unsigned int getSanitizersWithPayload() const { return m_payload; }
+  unsigned int getVulnerableSanitizersWithPayload() const { return m_vulnerable_payload; }
+  unsigned int getVulnerableSanitizersWithBypass() const { return m_bypass; }
+  unsigned int getErroredSanitizersWithPayload() const { return m_all_errored_payloads; }
+
+  unsigned int getEntriesForSinkContext(const AttackContext& context) const;
+  unsigned int getEntriesForSinkContextWeighted(const AttackContext& context) const;
+  unsigned int getEntriesForSinkContextDeduplicated(const AttackContext& context) const;
+  unsigned int getValidatedEntriesForSinkContext(const AttackContext& context) const;
+  unsigned int getErrorsForSinkContext(const AttackContext& context) const;
+  unsigned int getErrorsForSinkContextAndErrorType(const AttackContext& context, const AnalysisError& error) const;
+
+  // Number of domains per result, summed over all results
+  unsigned int getDomainCount() const { return m_domain_count; }
+  // Number of distinct domains over all results
+  unsigned int getUniqueDomains() const { return m_domains.size(); }
+  unsigned int getDomainsForPayload() const { return m_domains_for_payload.size(); }
+  unsigned int getDomainsWithPayload() const { return m_domains_with_payload.size(); }
+  unsigned int getVulnerableDomainsWithPayload() const { return m_vulnerable_domains_with_payload.size(); }
+
+private:
+  struct SinkStatistics {
+    SinkStatistics();
+    unsigned int entries;
+    unsigned int weighted;
+    unsigned int deduplicated;
+    unsigned int validated;
+    unsigned int errors;
+    std::map<AnalysisError, unsigned int> errors_by_type;
+  };
+
+  typedef std::unordered_map<StringPool::Handle, unsigned int> DomainCounts;
+
+  void update(const ResultStatistics& result, int sign);
+  static void updateDomains(DomainCounts& counts, const std::vector<StringPool::Handle>& domains, int sign);
+  const SinkStatistics* getSink(const AttackContext& context) const;
+
+  unsigned int m_entries;
+  unsigned int m_count_with_duplicates;
+  unsigned int m_count;
+  unsigned int m_exploit_successful;
+  unsigned int m_errored;
+  unsigned int m_payload;
+  unsigned int m_vulnerable_payload;
+  unsigned int m_all_errored_payloads;
+  unsigned int m_bypass;
+  unsigned int m_domain_count;
+  std::map<AttackContext, SinkStatistics> m_sinks;
+  // Reference counts of the domains, a domain is present while its count is positive
+  DomainCounts m_domains;
+  DomainCounts m_domains_for_payload;
+  DomainCounts m_domains_with_payload;
+  DomainCounts m_vulnerable_domains_with_payload;
+};
+
+#endif /* GROUP_STATISTICS_HPP_ */
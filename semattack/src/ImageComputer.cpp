@@ -24,6 +24,16 @@
  */
 
 #include "ImageComputer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include <boost/asio.hpp>
+
+#include "FixPointEngine.hpp"
+#include "FunctionModels.hpp"
 #include "exceptions/StrangerException.hpp"
 #include "depgraph/RegExpNode.hpp"
 
@@ -63,6 +73,57 @@ ImageComputer::~ImageComputer() {
 
 PerfInfo* ImageComputer::perfInfo = &PerfInfo::getInstance();
 
+unsigned int ImageComputer::backward_threads = 1;
+std::unique_ptr<boost::asio::thread_pool> ImageComputer::backward_pool;
+
+void ImageComputer::setBackwardThreads(unsigned int threads) {
+    backward_threads = std::max(1u, threads);
+    backward_pool.reset((backward_threads > 1) ? new boost::asio::thread_pool(backward_threads) : nullptr);
+}
+
+unsigned int ImageComputer::getBackwardThreads() {
+    return backward_threads;
+}
+
+void ImageComputer::runBackwardTasks(std::vector<std::function<void()> >& tasks) {
+    if (!backward_pool || (tasks.size() < 2)) {
+        for (auto& task : tasks) {
+            task();
+        }
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t pending = tasks.size();
+    std::vector<std::exception_ptr> errors(tasks.size());
+    // Statistics of fix points computed by the pool belong to the caller's depgraph
+    const std::string label = FixPointEngine::getThreadLabel();
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        boost::asio::post(*backward_pool, [&, i]() {
+            FixPointEngine::setThreadLabel(label);
+            try {
+                tasks[i]();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) {
+                finished.notify_all();
+            }
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]() { return pending == 0; });
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
 /*******************************************************************************************************************************/
 /*********** SANITIZATION PATCH EXTRACTION METHODS *****************************************************************************/
 /*******************************************************************************************************************************/
@@ -135,11 +196,10 @@ void ImageComputer::doPostImageComputation_SingleInput(
 
                 const StrangerAutomaton *succAuto = analysisResult.get(succ_node->getID());
                 if (newAuto == nullptr) {
-                    newAuto = succAuto->clone(node->getID());
+                    newAuto = succAuto->share(node->getID());
                 } else {
-                    StrangerAutomaton* temp = newAuto;
-                    newAuto = newAuto->union_(succAuto, node->getID());
-                    delete temp;
+                    std::unique_ptr<StrangerAutomaton> temp(newAuto);
+                    newAuto = temp->union_(succAuto, node->getID());
                 }
             }
     	}
@@ -151,7 +211,7 @@ void ImageComputer::doPostImageComputation_SingleInput(
     	if (analysisResult.find(node->getID()) == analysisResult.end()){
             throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "input node id(" << uninitNode->getID() << ") automaton must be initizalized before analysis begins!");
     	}
-    	newAuto = analysisResult.get(node->getID())->clone();
+    	newAuto = analysisResult.get(node->getID())->share();
     } else {
     	throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Cannot figure out node type!, node id: " << node->getID());
     }
@@ -175,49 +235,93 @@ void ImageComputer::doPostImageComputation_SingleInput(
 AnalysisResult ImageComputer::doBackwardAnalysis_GeneralCase(
     const DepGraph& origDepGraph, const DepGraph& depGraph, const StrangerAutomaton* initialAuto, const AnalysisResult& fwAnalysisResult) {
 
-    queue<const DepGraphNode*> process_queue;
-    set<const DepGraphNode*> visited;
-    set<int> processed_SCCs;
-
     AnalysisResult bwAnalysisResult;
+    bwAnalysisResult.reserve(origDepGraph.getMaxNodeID() + 1);
 
-    try {
-        // initialize root node
-        bwAnalysisResult.set(depGraph.getRoot()->getID(), initialAuto->clone());
-
-        process_queue.push(depGraph.getRoot());
-        while (!process_queue.empty()) {
+    // initialize root node
+    bwAnalysisResult.set(depGraph.getRoot()->getID(), initialAuto->share());
 
-            const DepGraphNode *curr = process_queue.front();
-            if (depGraph.isSCCElement(curr)) { // handle cycles
-                // do not compute a scc more than once
-                auto isNotProcessed = processed_SCCs.insert(depGraph.getSCCID(curr));
-                if (isNotProcessed.second) {
-                    doPreImageComputationForSCC_GeneralCase(origDepGraph, curr, bwAnalysisResult, fwAnalysisResult);
-                }
+    std::vector<BackwardStep> steps = getBackwardOrder(depGraph);
+    if (!backward_pool) {
+        for (const auto& step : steps) {
+            if (step.scc) {
+                doPreImageComputationForSCC_GeneralCase(origDepGraph, step.node, bwAnalysisResult, fwAnalysisResult);
             } else {
-                doPreImageComputation_GeneralCase(origDepGraph, curr, bwAnalysisResult, fwAnalysisResult);
+                doPreImageComputation_GeneralCase(origDepGraph, step.node, bwAnalysisResult, fwAnalysisResult);
             }
+        }
+        return bwAnalysisResult;
+    }
 
-            process_queue.pop();
-
-            NodesList successors = depGraph.getSuccessors(curr);
-            if (!successors.empty()) {
-                for (auto succ_node : successors) {
-                    auto isNotVisited = visited.insert(succ_node);
-                    if (isNotVisited.second) {
-                        process_queue.push(succ_node);
-                    }
+    // Cut the BFS order into waves, a node starts a new wave if one of its
+    // users is in the current one. Loops are computed on their own.
+    std::vector<const DepGraphNode*> wave;
+    set<const DepGraphNode*> inWave;
+    for (const auto& step : steps) {
+        bool dependent = step.scc;
+        if (!dependent) {
+            for (auto pred_node : origDepGraph.getPredecessors(step.node)) {
+                if ((pred_node != step.node) && (inWave.count(pred_node) > 0)) {
+                    dependent = true;
+                    break;
                 }
             }
         }
-    } catch (...) {
-        throw;
+        if (dependent && !wave.empty()) {
+            doPreImageComputationForWave_GeneralCase(origDepGraph, wave, bwAnalysisResult, fwAnalysisResult);
+            wave.clear();
+            inWave.clear();
+        }
+        if (step.scc) {
+            doPreImageComputationForSCC_GeneralCase(origDepGraph, step.node, bwAnalysisResult, fwAnalysisResult);
+        } else {
+            wave.push_back(step.node);
+            inWave.insert(step.node);
+        }
+    }
+    if (!wave.empty()) {
+        doPreImageComputationForWave_GeneralCase(origDepGraph, wave, bwAnalysisResult, fwAnalysisResult);
     }
-    
     return bwAnalysisResult;
 }
 
+/**
+ * The nodes in the order of a BFS from the root of depGraph. A SCC is one step
+ * at its first node.
+ */
+std::vector<ImageComputer::BackwardStep> ImageComputer::getBackwardOrder(const DepGraph& depGraph) const {
+    std::vector<BackwardStep> steps;
+    queue<const DepGraphNode*> process_queue;
+    set<const DepGraphNode*> visited;
+    set<int> processed_SCCs;
+
+    process_queue.push(depGraph.getRoot());
+    while (!process_queue.empty()) {
+
+        const DepGraphNode *curr = process_queue.front();
+        if (depGraph.isSCCElement(curr)) { // handle cycles
+            // do not compute a scc more than once
+            auto isNotProcessed = processed_SCCs.insert(depGraph.getSCCID(curr));
+            if (isNotProcessed.second) {
+                steps.push_back({ curr, true });
+            }
+        } else {
+            steps.push_back({ curr, false });
+        }
+
+        process_queue.pop();
+
+        NodesList successors = depGraph.getSuccessors(curr);
+        for (auto succ_node : successors) {
+            auto isNotVisited = visited.insert(succ_node);
+            if (isNotVisited.second) {
+                process_queue.push(succ_node);
+            }
+        }
+    }
+    return steps;
+}
+
 /**
  *
  */
@@ -228,12 +332,12 @@ void ImageComputer::doPreImageComputation_GeneralCase(
 	NodesList predecessors = origDepGraph.getPredecessors(node);
 	NodesList successors = origDepGraph.getSuccessors(node);
 	const DepGraphNormalNode* normalNode = nullptr;
-	StrangerAutomaton *newAuto = nullptr, *tempAuto = nullptr;
+	StrangerAutomaton *newAuto = nullptr;
 
 	if (dynamic_cast<const DepGraphNormalNode*>(node) || dynamic_cast<const DepGraphUninitNode*>(node) || dynamic_cast<const DepGraphOpNode*>(node)) {
 		if (predecessors.empty()) {
 			// root is already initialized
-                    newAuto = bwAnalysisResult.get(node->getID())->clone();
+                    newAuto = bwAnalysisResult.get(node->getID())->share();
 		} else if (successors.empty() && (normalNode = dynamic_cast<const DepGraphNormalNode*>(node))) {
                         newAuto = getLiteralorConstantNodeAuto(normalNode, false);
 		} else {
@@ -245,7 +349,7 @@ void ImageComputer::doPreImageComputation_GeneralCase(
 					// ignore simple self loop (check correctness)
 					continue;
 				} else if (dynamic_cast<const DepGraphNormalNode*>(pred_node)) {
-                                    predAuto = bwAnalysisResult.get(pred_node->getID())->clone(node->getID());
+                                    predAuto = bwAnalysisResult.get(pred_node->getID())->share(node->getID());
 				} else if (dynamic_cast<const DepGraphOpNode*>(pred_node)) {
                                     predAuto = makePreImageForOpChild_GeneralCase(origDepGraph,dynamic_cast<const DepGraphOpNode*>(pred_node), node,
                                                                                   bwAnalysisResult, fwAnalysisResult);
@@ -255,14 +359,13 @@ void ImageComputer::doPreImageComputation_GeneralCase(
 					continue;
 				}
 
+				std::unique_ptr<StrangerAutomaton> ownedPredAuto(predAuto);
 				if (newAuto == nullptr) {
-					newAuto = predAuto->clone(node->getID());
-                                        delete predAuto;
+					newAuto = ownedPredAuto.release();
+					newAuto->setID(node->getID());
 				} else {
-					tempAuto = newAuto;
-					newAuto = newAuto->union_(predAuto, node->getID());
-					delete tempAuto;
-					delete predAuto;
+					std::unique_ptr<StrangerAutomaton> ownedNewAuto(newAuto);
+					newAuto = ownedNewAuto->union_(ownedPredAuto.get(), node->getID());
 				}
 			}
 
@@ -270,9 +373,8 @@ void ImageComputer::doPreImageComputation_GeneralCase(
 				throw StrangerException(AnalysisError::MalformedDepgraph, "Cannot calculate backward auto, fix me\nndoBackwardNodeComputation_RegularPhase()");
 			}
 
-			tempAuto = newAuto;
-			newAuto = forwardAuto->intersect(newAuto, node->getID());
-			delete tempAuto;
+			std::unique_ptr<StrangerAutomaton> unionAuto(newAuto);
+			newAuto = forwardAuto->intersect(unionAuto.get(), node->getID());
 		}
 
 	} else {
@@ -288,91 +390,164 @@ void ImageComputer::doPreImageComputation_GeneralCase(
 }
 
 /**
- * Pre Image Computation for cycles (loops)
+ * Same as doPreImageComputation_GeneralCase for each node of the wave, but the
+ * pre-images for the users of all nodes are computed at once, then unioned
+ * pairwise and intersected with the forward results in parallel. MONA marks
+ * the BDD nodes of a DFA while reading it, so every automaton a task reads
+ * is a deep copy made on this thread.
  */
-void ImageComputer::doPreImageComputationForSCC_GeneralCase(const DepGraph& origDepGraph, const DepGraphNode* node, AnalysisResult& bwAnalysisResult, const AnalysisResult& fwAnalysisResult) {
-	// TODO add to command line options as an optional parameter
-	int precise_widening_limit = 5;
-	int coarse_widening_limit = 20;
-
-	int scc_id = origDepGraph.getSCCID(node);
-
-	map<int, int> visit_count;
-	NodesList current_scc_nodes = origDepGraph.getSCCNodes(scc_id);
+void ImageComputer::doPreImageComputationForWave_GeneralCase(
+    const DepGraph& origDepGraph, const std::vector<const DepGraphNode*>& wave,
+    AnalysisResult& bwAnalysisResult, const AnalysisResult& fwAnalysisResult) {
 
-	queue<DepGraphNode*> worklist;
-	set<DepGraphNode*> visited;
+	struct Contribution {
+		const DepGraphOpNode* opNode;
+		AnalysisResult bw;
+		AnalysisResult fw;
+	};
+	struct NodeWork {
+		const DepGraphNode* node;
+		std::unique_ptr<StrangerAutomaton> forward;
+		std::vector<std::unique_ptr<Contribution> > contributions;
+		std::vector<std::unique_ptr<StrangerAutomaton> > parts;
+		std::vector<std::unique_ptr<StrangerAutomaton> > merged;
+		std::unique_ptr<StrangerAutomaton> result;
+	};
+
+	std::vector<std::unique_ptr<NodeWork> > work;
+	for (auto node : wave) {
+		NodesList predecessors = origDepGraph.getPredecessors(node);
+		NodesList successors = origDepGraph.getSuccessors(node);
+		bool known = (dynamic_cast<const DepGraphNormalNode*>(node) || dynamic_cast<const DepGraphUninitNode*>(node) || dynamic_cast<const DepGraphOpNode*>(node));
+		if (!known || predecessors.empty() || (successors.empty() && dynamic_cast<const DepGraphNormalNode*>(node))) {
+			// the root, literals and constants do not depend on other pre-images
+			doPreImageComputation_GeneralCase(origDepGraph, node, bwAnalysisResult, fwAnalysisResult);
+			continue;
+		}
 
-	// initialize all scc_nodes to phi
-	for (auto& scc_node : current_scc_nodes) {
-            bwAnalysisResult.set(scc_node->getID(), StrangerAutomaton::makePhi(scc_node->getID()));
-		visit_count[scc_node->getID()] = 0;
+		std::unique_ptr<NodeWork> nodeWork(new NodeWork());
+		nodeWork->node = node;
+		nodeWork->forward.reset(fwAnalysisResult.find(node->getID())->second->clone(node->getID()));
+		for (auto pred_node : predecessors) {
+			if (pred_node == node) {
+				// ignore simple self loop (check correctness)
+				continue;
+			} else if (dynamic_cast<const DepGraphNormalNode*>(pred_node)) {
+				nodeWork->parts.emplace_back(bwAnalysisResult.get(pred_node->getID())->clone(node->getID()));
+			} else if (dynamic_cast<const DepGraphOpNode*>(pred_node)) {
+				std::unique_ptr<Contribution> contribution(new Contribution());
+				contribution->opNode = dynamic_cast<const DepGraphOpNode*>(pred_node);
+				const StrangerAutomaton* opAuto = bwAnalysisResult.get(pred_node->getID());
+				if (opAuto != nullptr) {
+					contribution->bw.set(pred_node->getID(), opAuto->clone());
+				}
+				for (auto arg_node : origDepGraph.getSuccessors(pred_node)) {
+					AnalysisResultConstIterator it = fwAnalysisResult.find(arg_node->getID());
+					if (it != fwAnalysisResult.end()) {
+						contribution->fw.set(arg_node->getID(), it->second->clone());
+					}
+				}
+				nodeWork->contributions.push_back(std::move(contribution));
+			}
+		}
+		work.push_back(std::move(nodeWork));
 	}
 
-	// add the predecessors to the worklist
-	for ( auto pred_node : origDepGraph.getPredecessors(node)) {
-		worklist.push(pred_node);
-		visited.insert(pred_node);
+	// pre-images of the users
+	std::vector<std::function<void()> > tasks;
+	for (auto& nodeWork : work) {
+		NodeWork* w = nodeWork.get();
+		std::size_t first = w->parts.size();
+		w->parts.resize(first + w->contributions.size());
+		for (std::size_t i = 0; i < w->contributions.size(); i++) {
+			Contribution* c = w->contributions[i].get();
+			std::unique_ptr<StrangerAutomaton>* part = &w->parts[first + i];
+			tasks.push_back([this, &origDepGraph, w, c, part]() {
+				part->reset(makePreImageForOpChild_GeneralCase(origDepGraph, c->opNode, w->node, c->bw, c->fw));
+			});
+		}
+	}
+	runBackwardTasks(tasks);
+
+	for (auto& nodeWork : work) {
+		nodeWork->contributions.clear();
+		auto& parts = nodeWork->parts;
+		parts.erase(std::remove(parts.begin(), parts.end(), nullptr), parts.end());
+		if (parts.empty()) {
+			throw StrangerException(AnalysisError::MalformedDepgraph, "Cannot calculate backward auto, fix me\nndoBackwardNodeComputation_RegularPhase()");
+		}
 	}
 
-	int iteration = 0;
-
-	do {
-		DepGraphNode* curr_node = worklist.front();
-		worklist.pop();
-		// calculate the values for predecessors (in a depgraph predecessors are children during forward analysis)
-		for (auto succ_node : origDepGraph.getSuccessors(curr_node)) {
-			// ignore nodes that are not part of the current scc
-			if (!origDepGraph.isSCCElement(succ_node) || origDepGraph.getSCCID(succ_node) != scc_id)
+	// union of the users' pre-images, one level of the tree per round
+	bool reduced = false;
+	while (!reduced) {
+		reduced = true;
+		tasks.clear();
+		for (auto& nodeWork : work) {
+			NodeWork* w = nodeWork.get();
+			if (w->parts.size() < 2) {
 				continue;
-
-			const StrangerAutomaton* forward_auto = fwAnalysisResult.find(succ_node->getID())->second;
-			const StrangerAutomaton* prev_auto = bwAnalysisResult.get(succ_node->getID());
-			StrangerAutomaton* tmp_auto = nullptr;
-			StrangerAutomaton* new_auto = nullptr;
-
-			if (dynamic_cast<const DepGraphNormalNode*>(curr_node) != nullptr) {
-                            tmp_auto = bwAnalysisResult.get(curr_node->getID())->clone(); // may need clone
-			} else if (dynamic_cast<const DepGraphOpNode*>(curr_node) != nullptr) {
-				tmp_auto = makePreImageForOpChild_GeneralCase(origDepGraph, dynamic_cast<const DepGraphOpNode*>(curr_node), succ_node,
-						bwAnalysisResult, fwAnalysisResult);
-			} else {
-				throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Node cannot be an element of SCC component!, node id: " << node->getID());
 			}
-
-			if (tmp_auto == nullptr) {
-				throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Could not calculate the corresponding automaton!, node id: " << node->getID());
+			reduced = false;
+			std::size_t pairs = w->parts.size() / 2;
+			w->merged.clear();
+			w->merged.resize(pairs);
+			if (w->parts.size() % 2 == 1) {
+				w->merged.push_back(std::move(w->parts.back()));
 			}
-
-			new_auto = tmp_auto->union_(prev_auto, succ_node->getID());
-
-			int new_visit_count = visit_count[succ_node->getID()] + 1;
-			if (new_visit_count > iteration)
-				iteration = new_visit_count;
-
-			// decide whether to do widening operations
-			if (new_visit_count > coarse_widening_limit) {
-				new_auto = prev_auto->coarseWiden(new_auto, succ_node->getID());
-			} else if (new_visit_count > precise_widening_limit) {
-				new_auto = prev_auto->preciseWiden(new_auto, succ_node->getID());
+			for (std::size_t i = 0; i < pairs; i++) {
+				tasks.push_back([w, i]() {
+					w->merged[i].reset(w->parts[2 * i]->union_(w->parts[2 * i + 1].get(), w->node->getID()));
+				});
 			}
+		}
+		runBackwardTasks(tasks);
+		for (auto& nodeWork : work) {
+			if (!nodeWork->merged.empty()) {
+				nodeWork->parts.swap(nodeWork->merged);
+				nodeWork->merged.clear();
+			}
+		}
+	}
 
-			if (!new_auto->checkInclusion(prev_auto, new_auto->getID(), prev_auto->getID())) {
-				auto isVisited = visited.insert(succ_node);
-				if (isVisited.second) {
-					worklist.push(succ_node);
-				}
+	// intersect with the forward analysis results
+	tasks.clear();
+	for (auto& nodeWork : work) {
+		NodeWork* w = nodeWork.get();
+		tasks.push_back([w]() {
+			w->result.reset(w->forward->intersect(w->parts.front().get(), w->node->getID()));
+		});
+	}
+	runBackwardTasks(tasks);
 
-				tmp_auto = new_auto;
-				new_auto = forward_auto->intersect(new_auto, node->getID());
-				delete tmp_auto;
+	for (auto& nodeWork : work) {
+		bwAnalysisResult.set(nodeWork->node->getID(), nodeWork->result.release());
+	}
+}
 
-				bwAnalysisResult.set(succ_node->getID(), new_auto);
-				visit_count[succ_node->getID()] = new_visit_count;
+/**
+ * Pre Image Computation for cycles (loops)
+ */
+void ImageComputer::doPreImageComputationForSCC_GeneralCase(const DepGraph& origDepGraph, const DepGraphNode* node, AnalysisResult& bwAnalysisResult, const AnalysisResult& fwAnalysisResult) {
+	FixPointEngine engine(origDepGraph, origDepGraph.getSCCID(node), FixPointEngine::Direction::Backward);
+	// calculate the values for successors (in a depgraph predecessors are parents during backward analysis)
+	engine.run(bwAnalysisResult,
+		[&](DepGraphNode* succ_node, DepGraphNode* curr_node) -> StrangerAutomaton* {
+			if (bwAnalysisResult.find(curr_node->getID()) == bwAnalysisResult.end()) {
+				// not on a path to the sink
+				return nullptr;
+			} else if (dynamic_cast<const DepGraphNormalNode*>(curr_node) != nullptr) {
+				return bwAnalysisResult.get(curr_node->getID())->share();
+			} else if (dynamic_cast<const DepGraphOpNode*>(curr_node) != nullptr) {
+				return makePreImageForOpChild_GeneralCase(origDepGraph, dynamic_cast<const DepGraphOpNode*>(curr_node), succ_node,
+						bwAnalysisResult, fwAnalysisResult);
 			}
-		}
-
-	} while( !worklist.empty() && iteration < 30000 );
+			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Node cannot be an element of SCC component!, node id: " << node->getID());
+		},
+		[&](DepGraphNode* succ_node, const StrangerAutomaton* new_auto) {
+			const StrangerAutomaton* forward_auto = fwAnalysisResult.find(succ_node->getID())->second;
+			return forward_auto->intersect(new_auto, node->getID());
+		});
 }
 
 /**
@@ -386,11 +561,11 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 	NodesList successors = depGraph.getSuccessors(opNode);
 	const StrangerAutomaton* opAuto = bwAnalysisResult.get(opNode->getID());
 	string opName = opNode->getName();
-
-
+	OpKind kind = opNode->getKind();
+	const FunctionModels::UnaryModel* model = FunctionModels::getUnaryModel(kind);
 
 	// __vlab_restrict
-	if (opName.find("__vlab_restrict") != string::npos) {
+	if (kind == OpKind::VlabRestrict) {
 		boost::posix_time::ptime start_time = perfInfo->current_time();
 		if (successors.size() != 3) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "__vlab_restrict invalid number of arguments");
@@ -401,7 +576,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 		DepGraphNode* complementNode = successors[2];
 
 		if (childNode->equals(subjectNode)){
-			retMe = opAuto->clone(childNode->getID());
+			retMe = opAuto->share(childNode->getID());
 		} else if (childNode->equals(patternNode) || childNode->equals(complementNode)) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "child node (" << childNode->getID() << ") of __vlab_restrict (" << opNode->getID() << ") should not be on the backward path");
 		} else {
@@ -410,7 +585,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 		perfInfo->pre_vlab_restrict_total_time += perfInfo->current_time() - start_time;
 		perfInfo->number_of_pre_vlab_restrict++;
 
-	} else if ((opName == ".") || (opName == "concat")) {
+	} else if (kind == OpKind::Concat) {
 		if (successors.size() < 2)
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "less than two successors for concat node " << opNode->getID());
 
@@ -427,7 +602,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 				throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Should not visit left node(" << leftSibling->getID() << ") in concat");
 			} else if (rightIt == fwAnalysisResult.end()) {
 				// we can just clone the previous auto, in that case actual concat operation is not done during forward analysis
-				retMe = concatAuto->clone(childNode->getID());
+				retMe = concatAuto->share(childNode->getID());
 			} else {
 				if (isLiteralOrConstant(rightSibling, depGraph.getSuccessors(rightSibling))) {
                                     // Check if we need to do concats
@@ -435,7 +610,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 					string value = getLiteralOrConstantValue(rightSibling);
 					retMe = concatAuto->leftPreConcatConst(value, childNode->getID());
                                     } else {
-                                        retMe = concatAuto->clone(childNode->getID());
+                                        retMe = concatAuto->share(childNode->getID());
                                     }
 				} else {
                                         const StrangerAutomaton* rightSiblingAuto = fwAnalysisResult.find(rightSibling->getID())->second;
@@ -449,7 +624,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 				throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Should not visit right node(" << leftSibling->getID() << ") in concat");
 			} else if (leftIt == fwAnalysisResult.end()) {
 				// we can just clone the previous auto, in that case actual concat operation is not done during forward analysis
-				retMe = concatAuto->clone(childNode->getID());
+				retMe = concatAuto->share(childNode->getID());
 			} else {
 				if (isLiteralOrConstant(leftSibling, depGraph.getSuccessors(leftSibling))){
                                     // Check if we need to do concats
@@ -457,7 +632,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 					string value = getLiteralOrConstantValue(leftSibling);
 					retMe = concatAuto->rightPreConcatConst(value, childNode->getID());
                                     } else {
-                                        retMe = concatAuto->clone(childNode->getID());
+                                        retMe = concatAuto->share(childNode->getID());
                                     }
 				} else {
                                         const StrangerAutomaton* leftSiblingAuto = fwAnalysisResult.find(leftSibling->getID())->second;
@@ -469,35 +644,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "child (" << childNode->getID() << ") of concat (" << opNode->getID() << ") is not equal to any of the two successors.");
 		}
 
-	} else if (opName == "addslashes") {
-		// only has one parameter ==>  string addslashes  ( string $str  )
-		retMe = StrangerAutomaton::pre_addslashes(opAuto,childNode->getID());
-
-	} else if (opName == "encodeAttrString") {
-        // only has one parameter ==>  string encodeAttrString  ( string $str  )
-        retMe = StrangerAutomaton::pre_encodeAttrString(opAuto,childNode->getID());
-    } else if (opName == "encodeTextFragment") {
-        // only has one parameter ==>  string addslashes  ( string $str  )
-        retMe = StrangerAutomaton::pre_encodeTextFragment(opAuto,childNode->getID());
-    } else if (opName == "trim" ) {
-		// only has one parameter ==>  string trim  ( string $str  )
-		retMe = opAuto->preTrimSpaces(childNode->getID());
-	} else if (opName == "rtrim" ) {
-		// only has one parameter ==>  string trim  ( string $str  )
-		retMe = opAuto->preTrimSpacesRigth(childNode->getID());
-	} else if (opName == "ltrim" ) {
-		// only has one parameter ==>  string trim  ( string $str  )
-		retMe = opAuto->preTrimSpacesLeft(childNode->getID());
-
-	}  else if (opName == "strtoupper" ) {
-		// only has one parameter ==>  string strtoupper  ( string $str  )
-		retMe = opAuto->preToUpperCase(childNode->getID());
-
-	}  else if (opName == "strtolower" ) {
-		// only has one parameter ==>  string strtolower  ( string $str  )
-		retMe = opAuto->preToLowerCase(childNode->getID());
-
-	} else if (opName == "htmlspecialchars") {
+	} else if (kind == OpKind::Htmlspecialchars) {
 		if (childNode->equals(successors[0])) {
 			string flagString = "ENT_COMPAT";
 			if (successors.size() > 1) {
@@ -509,15 +656,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 		} else {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "SNH: child node (" << childNode->getID() << ") of htmlspecialchars (" << opNode->getID() << ") is not in backward path");
 		}
-	} else if (opName == "mysql_escape_string") {
-		// has one parameter
-		retMe = StrangerAutomaton::pre_mysql_escape_string(opAuto, childNode->getID());
-
-	}  else if (opName == "mysql_real_escape_string") {
-		// has one parameter
-		retMe = StrangerAutomaton::pre_mysql_real_escape_string(opAuto, childNode->getID());
-
-	} else if (opName == "preg_replace" || opName == "ereg_replace" || opName == "str_replace") {
+	} else if (kind == OpKind::Replace) {
 
 		if (successors.size() != 3) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "replace invalid number of arguments");
@@ -547,7 +686,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 		} else {
 			retMe = subjectAuto->preReplace(patternAuto, replaceStr, childNode->getID());
 		}
-        } else if (opName == "str_replace_once") {
+        } else if (kind == OpKind::StrReplaceOnce) {
             if (successors.size() != 3) {
                 throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "replace invalid number of arguments");
             }
@@ -561,7 +700,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
             string replaceStr = replaceAuto->getStr();
             retMe = subjectAuto->preReplaceOnce(patternAuto, replaceStr, childNode->getID());
 
-	} else if ((opName == "regex_match") || (opName == "regex_exec")) {
+	} else if (kind == OpKind::RegexMatch) {
 
 		if (successors.size() != 3) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "replace invalid number of arguments");
@@ -579,7 +718,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
                 int group = stoi(groupValue);
 
                 retMe = subjectAuto->preMatch(patternAuto, group, childNode->getID());
-	} else if (opName == "split") {
+	} else if (kind == OpKind::Split) {
                 // Model split as simply replacing the split character with an empty string
 		if (successors.size() != 2) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "replace invalid number of arguments: " << opNode->getID());
@@ -592,7 +731,7 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
 
 		retMe = subjectAuto->preReplace(patternAuto,"", childNode->getID());
 
-	} else if (opName == "substr"){
+	} else if (kind == OpKind::Substr) {
 
 		if (successors.size() < 2) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "substr invalid number of arguments");
@@ -623,40 +762,14 @@ StrangerAutomaton* ImageComputer::makePreImageForOpChild_GeneralCase(
                     }
                 } else {
                     //std::cout << "Ignoring substr operation" << std::endl;
-                    retMe = subjectAuto->clone(opNode->getID());
+                    retMe = subjectAuto->share(opNode->getID());
                 }
 
-	} else if (opName == "md5") {
+	} else if (kind == OpKind::Md5) {
 		retMe = StrangerAutomaton::makeAnyString(opNode->getID());
-	} else if (opName == "encodeURIComponent") {
-                // Backwards analysis, so perform the inversion function
-                retMe = StrangerAutomaton::decodeURIComponent(opAuto, opNode->getID());
-	} else if (opName == "decodeURIComponent") {
-                // Backwards analysis, so perform the inversion function
-            if (opAuto->get_num_of_states() > 1000) {
-                std::cout << "Approximating BW analysis for " << opName << " nStates: " << opAuto->get_num_of_states() << std::endl;
-                retMe = opAuto->clone();
-            } else {
-		retMe = StrangerAutomaton::encodeURIComponent(opAuto, opNode->getID());
-            }
-	} else if (opName == "encodeURI") {
-                // Backwards analysis, so perform the inversion function
-                retMe = StrangerAutomaton::decodeURI(opAuto, opNode->getID());
-	} else if (opName == "decodeURI") {
-                // Backwards analysis, so perform the inversion function
-               retMe = StrangerAutomaton::encodeURI(opAuto, opNode->getID());
-	} else if (opName == "escape") {
-                // Backwards analysis, so perform the inversion function
-                retMe = StrangerAutomaton::unescape(opAuto, opNode->getID());
-	} else if (opName == "unescape") {
-                // Backwards analysis, so perform the inversion function
-               retMe = StrangerAutomaton::escape(opAuto, opNode->getID());
-	} else if (opName == "JSON.stringify") {
-                // Backwards analysis, so perform the inversion function
-                retMe = StrangerAutomaton::jsonParse(opAuto, opNode->getID());
-	} else if (opName == "JSON.parse") {
-                // Backwards analysis, so perform the inversion function
-                retMe = StrangerAutomaton::jsonStringify(opAuto, opNode->getID());
+	} else if ((model != nullptr) && (model->preimage != nullptr)) {
+		// only the first parameter is on the backward path
+		retMe = model->preimage(opAuto, childNode->getID());
 	} else {
 		throw StrangerException(AnalysisError::NotImplemented,  "Not implemented yet for regular validation phase: " + opName);
 	}
@@ -803,18 +916,17 @@ void ImageComputer::doPostImageComputation_GeneralCase(DepGraph& depGraph, DepGr
 
 				const StrangerAutomaton *succAuto = analysisResult.get(succ_node->getID());
 				if (newAuto == nullptr) {
-					newAuto = succAuto->clone(node->getID());
+					newAuto = succAuto->share(node->getID());
 				} else {
-					StrangerAutomaton* temp = newAuto;
-					newAuto = newAuto->union_(succAuto, node->getID());
-					delete temp;
+					std::unique_ptr<StrangerAutomaton> temp(newAuto);
+					newAuto = temp->union_(succAuto, node->getID());
 				}
 			}
 		}
 	} else if ((opNode = dynamic_cast<DepGraphOpNode*>(node)) != nullptr) {
 		newAuto = makePostImageForOp_GeneralCase(depGraph, opNode, analysisResult);
 	} else if ((uninitNode = dynamic_cast<DepGraphUninitNode*>(node)) != nullptr) {
-		newAuto = ImageComputer::uninit_node_default_initialization->clone(node->getID());
+		newAuto = ImageComputer::uninit_node_default_initialization->share(node->getID());
 	} else {
 		throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Cannot figure out node type!, node id: " << node->getID());
 	}
@@ -829,82 +941,19 @@ void ImageComputer::doPostImageComputation_GeneralCase(DepGraph& depGraph, DepGr
  * Post Image computation for cycles (loops)
  */
 void ImageComputer::doPostImageComputationForSCC_GeneralCase(DepGraph& depGraph, DepGraphNode* node, AnalysisResult& analysisResult) {
-
-	// TODO add to command line options as an optional parameter
-	int precise_widening_limit = 5;
-	int coarse_widening_limit = 20;
-
-	int scc_id = depGraph.getSCCID(node);
-
-	map<int, int> visit_count;
-	NodesList current_scc_nodes = depGraph.getSCCNodes(scc_id);
-
-	queue<DepGraphNode*> worklist;
-	set<DepGraphNode*> visited;
-
-	// initialize all scc_nodes to phi
-	for (auto& scc_node : current_scc_nodes) {
-            analysisResult.set(scc_node->getID(), StrangerAutomaton::makePhi(scc_node->getID()));
-            visit_count[scc_node->getID()] = 0;
-	}
-
-	// add the successors to the worklist (in a depgraph successors are parents during forward analysis)
-	for ( auto succ_node : depGraph.getSuccessors(node)) {
-		worklist.push(succ_node);
-		visited.insert(succ_node);
-	}
-
-	int iteration = 0;
-
-	do {
-		DepGraphNode* curr_node = worklist.front();
-		worklist.pop();
-		// calculate the values for predecessors (in a depgraph predecessors are children during forward analysis)
-		for (auto pred_node : depGraph.getPredecessors(curr_node)) {
-			// ignore nodes that are not part of the current scc
-			if (!depGraph.isSCCElement(pred_node) || depGraph.getSCCID(pred_node) != scc_id)
-				continue;
-
-			const StrangerAutomaton* prev_auto = analysisResult.get(pred_node->getID()); // may need clone
-			StrangerAutomaton* tmp_auto = nullptr;
-			StrangerAutomaton* new_auto = nullptr;
-
-			if (dynamic_cast<DepGraphNormalNode*>(pred_node) != nullptr) {
-                            tmp_auto = analysisResult.get(curr_node->getID())->clone(); // may need clone
-			} else if (dynamic_cast<DepGraphOpNode*>(pred_node) != nullptr) {
-                            tmp_auto = makePostImageForOp_GeneralCase(depGraph, dynamic_cast<DepGraphOpNode*>(pred_node), analysisResult);
-			} else {
-                            throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Node cannot be an element of SCC component!, node id: " << node->getID());
+	FixPointEngine engine(depGraph, depGraph.getSCCID(node), FixPointEngine::Direction::Forward);
+	// calculate the values for predecessors (in a depgraph predecessors are children during forward analysis)
+	engine.run(analysisResult,
+		[&](DepGraphNode* pred_node, DepGraphNode* curr_node) -> StrangerAutomaton* {
+			if (curr_node == nullptr) {
+				// operations read all of their arguments
+				return makePostImageForOp_GeneralCase(depGraph, dynamic_cast<DepGraphOpNode*>(pred_node), analysisResult);
 			}
-
-			if (tmp_auto == nullptr) {
-                            throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Could not calculate the corresponding automaton!, node id: " << node->getID());
+			if (analysisResult.find(curr_node->getID()) == analysisResult.end()) {
+				doForwardAnalysis_GeneralCase(depGraph, curr_node, analysisResult);
 			}
-
-			new_auto = tmp_auto->union_(prev_auto, pred_node->getID());
-
-			int new_visit_count = visit_count[pred_node->getID()] + 1;
-			if (new_visit_count > iteration)
-				iteration = new_visit_count;
-
-			// decide whether to do widening operations
-			if (new_visit_count > coarse_widening_limit) {
-				new_auto = prev_auto->coarseWiden(new_auto, pred_node->getID());
-			} else if (new_visit_count > precise_widening_limit) {
-				new_auto = prev_auto->preciseWiden(new_auto, pred_node->getID());
-			}
-
-			if (!new_auto->checkInclusion(prev_auto, new_auto->getID(), prev_auto->getID())) {
-				auto isVisited = visited.insert(pred_node);
-				if (isVisited.second) {
-					worklist.push(pred_node);
-				}
-				analysisResult.set(pred_node->getID(), new_auto);
-				visit_count[pred_node->getID()] = new_visit_count;
-			}
-		}
-
-	} while( !worklist.empty() && iteration < 30000 );
+			return analysisResult.get(curr_node->getID())->share();
+		});
 }
 
 /**
@@ -915,9 +964,11 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
 	NodesList successors = depGraph.getSuccessors(opNode);
 	StrangerAutomaton* retMe = nullptr;
 	string opName = opNode->getName();
+	OpKind kind = opNode->getKind();
+	const FunctionModels::UnaryModel* model = FunctionModels::getUnaryModel(kind);
         //cout << "Computing : " << opName << endl;
 	// __vlab_restrict
-	if (opName.find("__vlab_restrict") != string::npos) {
+	if (kind == OpKind::VlabRestrict) {
 		boost::posix_time::ptime start_time = perfInfo->current_time();
 		if (successors.size() != 3) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "__vlab_restrict invalid number of arguments: " << opNode->getID());
@@ -956,7 +1007,7 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
 		perfInfo->vlab_restrict_total_time += perfInfo->current_time() - start_time;
 		perfInfo->number_of_vlab_restrict++;
 
-	} else if ((opName == ".") || (opName == "concat")) {
+	} else if (kind == OpKind::Concat) {
 		// TODO add option to ignore concats (heuristic)
 		for (auto succ_node : successors){
 			if (analysisResult.find(succ_node->getID()) == analysisResult.end()) {
@@ -968,7 +1019,7 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
                             //std::cout << "Ignoring concat of string value: " << value << std::endl;
                         } else {
                             if (retMe == nullptr) {
-                                retMe = succAuto->clone(opNode->getID());
+                                retMe = succAuto->share(opNode->getID());
                             } else {
                                 //std::cout << "Doing concat with node " << succ_node->getID() << std::endl;
                                 StrangerAutomaton* temp = retMe;
@@ -981,7 +1032,7 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "Check successors of concatenation: " << opNode->getID());
 		}
 
-	} else if (opName == "preg_replace" || opName == "ereg_replace" || opName == "str_replace") {
+	} else if (kind == OpKind::Replace) {
 		if (successors.size() != 3) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "replace invalid number of arguments: " << opNode->getID());
 		}
@@ -1030,7 +1081,7 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
 
 		retMe = StrangerAutomaton::general_replace(patternAuto,replaceAuto,subjectAuto, opNode->getID());
 
-	} else if (opName == "str_replace_once") {
+	} else if (kind == OpKind::StrReplaceOnce) {
 		if (successors.size() != 3) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "replace invalid number of arguments: " << opNode->getID());
 		}
@@ -1079,7 +1130,7 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
 
 		retMe = StrangerAutomaton::str_replace_once(patternAuto,replaceAuto,subjectAuto, opNode->getID());
 
-	} else if ((opName == "regex_match") || (opName == "regex_exec")) {
+	} else if (kind == OpKind::RegexMatch) {
 		if (successors.size() != 3) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "match invalid number of arguments: " << opNode->getID());
 		}
@@ -1109,7 +1160,7 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
                 
 		retMe = StrangerAutomaton::match(patternAuto, group, subjectAuto, opNode->getID());
 
-	} else if (opName == "split") {
+	} else if (kind == OpKind::Split) {
                 // Model split as simply replacing the split character with an empty string
 		if (successors.size() != 2) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "replace invalid number of arguments: " << opNode->getID());
@@ -1133,37 +1184,10 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
 
                 delete replaceAuto;
 
-	} else if (opName == "addslashes") {
-		if (successors.size() != 1) {
-			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "addslashes should have one child: " << opNode->getID());
-		}
-
-		const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* slashesAuto = StrangerAutomaton::addslashes(paramAuto, opNode->getID());
-		retMe = slashesAuto;
-
-	} else if (opName == "stripslashes") {
+	} else if (kind == OpKind::Stripslashes) {
 		throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "stripslashes is not handled yet: " << opNode->getID());
 
-	} else if (opName == "mysql_escape_string") {
-		if (successors.size() < 1 || successors.size() > 2) {
-			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "mysql_escape_string wrong number of arguments: " << opNode->getID());
-		}
-		//we only care about the first parameter
-		const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* mysqlEscapeAuto = StrangerAutomaton::mysql_escape_string(paramAuto, opNode->getID());
-		retMe = mysqlEscapeAuto;
-
-	} else if (opName == "mysql_real_escape_string") {
-		if (successors.size() < 1 || successors.size() > 2) {
-			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "mysql_real_escape_string wrong number of arguments: " << opNode->getID());
-		}
-		//we only care about the first parameter
-		const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* mysqlEscapeAuto = StrangerAutomaton::mysql_real_escape_string(paramAuto, opNode->getID());
-		retMe = mysqlEscapeAuto;
-
-	} else if (opName == "htmlspecialchars") {
+	} else if (kind == OpKind::Htmlspecialchars) {
                 const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
 		string flagString = "ENT_COMPAT";
 		if (successors.size() > 1) {
@@ -1176,16 +1200,7 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
 		StrangerAutomaton* htmlSpecAuto = StrangerAutomaton::htmlSpecialChars(paramAuto, flagString, opNode->getID());
 		retMe = htmlSpecAuto;
 
-	} else if (opName == "nl2br"){
-		if (successors.size() < 1 || successors.size() > 2) {
-			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "nl2br wrong number of arguments: " << opNode->getID());
-		}
-
-		const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* nl2brAuto = StrangerAutomaton::nl2br(paramAuto, opNode->getID());
-		retMe = nl2brAuto;
-
-	}  else if (opName == "substr"){
+	} else if (kind == OpKind::Substr) {
 		if (successors.size() < 2) {
 			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "SNH: substr invalid number of arguments: " << opNode->getID());
 		}
@@ -1223,100 +1238,20 @@ StrangerAutomaton* ImageComputer::makePostImageForOp_GeneralCase(DepGraph& depGr
                     }
                 } else {
                     //std::cout << "Ignoring substr operation" << std::endl;
-                    retMe = subjectAuto->clone(opNode->getID());
+                    retMe = subjectAuto->share(opNode->getID());
                 }
-	} else if (opName == "strtoupper" || opName == "strtolower") {
-		if (successors.size() != 1) {
-			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << opName << " has more than one successor in depgraph" );
-		}
-
-		const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		if (opName == "strtoupper") {
-			retMe = paramAuto->toUpperCase(opNode->getID());
-		}
-		else if (opName == "strtolower") {
-			retMe = paramAuto->toLowerCase(opNode->getID());
-		}
-
-	} else if (opName == "trim" || opName == "rtrim" || opName == "ltrim") {
-		if (successors.size() > 2) {
-			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << opName << " has more than one successor in depgraph" );
-		} else if (successors.size() == 2) {
-			cout << "!!! Second parameter of " << opName << " ignored!!!. If it is not whitespace, modify implementation to handle that situation" << endl;
-//			if (analysisResult.find(successors[1]->getID()) == analysisResult.end()) {
-//				doForwardAnalysis_GeneralCase(depGraph, successors[1], analysisResult);
-//			}
-			// get trim char from automaton
-		}
-
-		const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		if (opName == "trim")
-			retMe = paramAuto->trimSpaces(opNode->getID());
-		else if (opName == "rtrim") {
-			retMe = paramAuto->trimSpacesRight(opNode->getID());
-		}
-		else if (opName == "ltrim") {
-			retMe = paramAuto->trimSpacesLeft(opNode->getID());
-		}
-
-	} else if (opName == "md5") {
+	} else if (kind == OpKind::Md5) {
 		//conservative desicion
 		retMe = StrangerAutomaton::regExToAuto("/[aAbBcCdDeEfF0-9]{32,32}/",true, opNode->getID());
-	} else if (opName == "encodeURIComponent") {
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* uriAuto = StrangerAutomaton::encodeURIComponent(paramAuto, opNode->getID());
-		retMe = uriAuto;
-
-	} else if (opName == "decodeURIComponent") {
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* uriAuto = StrangerAutomaton::decodeURIComponent(paramAuto, opNode->getID());
-		retMe = uriAuto;
-
-	} else if (opName == "encodeURI") {
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* uriAuto = StrangerAutomaton::encodeURI(paramAuto, opNode->getID());
-		retMe = uriAuto;
-
-	} else if (opName == "decodeURI") {
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* uriAuto = StrangerAutomaton::decodeURI(paramAuto, opNode->getID());
-		retMe = uriAuto;
-
-	} else if (opName == "escape") {
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* uriAuto = StrangerAutomaton::escape(paramAuto, opNode->getID());
-		retMe = uriAuto;
-
-	} else if (opName == "unescape") {
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* uriAuto = StrangerAutomaton::unescape(paramAuto, opNode->getID());
-		retMe = uriAuto;
-
-	} else if (opName == "JSON.stringify") {
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* json = StrangerAutomaton::jsonStringify(paramAuto, opNode->getID());
-		retMe = json;
-	} else if (opName == "JSON.parse") {
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-		StrangerAutomaton* json = StrangerAutomaton::jsonParse(paramAuto, opNode->getID());
-		retMe = json;
-	} else if (opName == "encodeTextFragment") {
-                if (successors.size() < 1 || successors.size() > 2) {
-                    throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "encodeTextFragment wrong number of arguments: " << opNode->getID());
-                }
-                const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
-
-                StrangerAutomaton* encodedAuto = StrangerAutomaton::encodeTextFragment(paramAuto, opNode->getID());
-                retMe = encodedAuto;
-        } else if (opName == "encodeAttrString") {
-            if (successors.size() < 1 || successors.size() > 2) {
-                throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << "encodeAttrString wrong number of arguments: " << opNode->getID());
-            }
-            const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
+	} else if (model != nullptr) {
+		if (successors.empty()) {
+			throw StrangerException(AnalysisError::MalformedDepgraph, stringbuilder() << opName << " has no arguments: " << opNode->getID());
+		}
+		// Functions of their first argument only
+		const StrangerAutomaton* paramAuto = analysisResult.get(successors[0]->getID());
+		retMe = model->forward(paramAuto, opNode->getID());
 
-        StrangerAutomaton* encodedAuto = StrangerAutomaton::encodeAttrString(paramAuto, opNode->getID());
-        retMe = encodedAuto;
-    } else {
+	} else {
             cout << "!!! Warning: Unmodeled builtin general function : " << opName << endl;
             f_unmodeled.push_back(opNode);
 
@@ -26,10 +26,16 @@
 #ifndef IMAGECOMPUTER_HPP_
 #define IMAGECOMPUTER_HPP_
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include "AnalysisResult.hpp"
 #include "StrangerAutomaton.hpp"
 #include "depgraph/DepGraph.hpp"
 
+namespace boost { namespace asio { class thread_pool; } }
+
 class ImageComputer {
 public:
     ImageComputer();
@@ -52,6 +58,16 @@ public:
     void doPreImageComputation_GeneralCase(const DepGraph& origDepGraph, const DepGraphNode* node, AnalysisResult& bwAnalysisResult, const AnalysisResult& fwAnalysisResult);
     StrangerAutomaton* makePreImageForOpChild_GeneralCase(const DepGraph& depGraph, const DepGraphOpNode* opNode, const DepGraphNode* childNode,AnalysisResult& bwAnalysisResult, const AnalysisResult& fwAnalysisResult);
     void doPreImageComputationForSCC_GeneralCase(const DepGraph& origDepGraph, const DepGraphNode* node, AnalysisResult& bwAnalysisResult, const AnalysisResult& fwAnalysisResult);
+    // Nodes of the backward BFS of which none uses another, computed together
+    void doPreImageComputationForWave_GeneralCase(const DepGraph& origDepGraph, const std::vector<const DepGraphNode*>& wave, AnalysisResult& bwAnalysisResult, const AnalysisResult& fwAnalysisResult);
+
+    // Size of the thread pool shared by all backward analyses of the process,
+    // set before any analysis starts. With more than one thread the
+    // pre-images of independent nodes and of all users of a node are computed
+    // in parallel and merged by a tree of unions. 1 (the default) runs the
+    // backward analysis on the calling thread only.
+    static void setBackwardThreads(unsigned int threads);
+    static unsigned int getBackwardThreads();
     /****************************************************************************************************/
     /*********** GENERAL POST-IMAGE COMPUTATION METHODS ************************************************************************/
     /****************************************************************************************************/
@@ -74,6 +90,20 @@ protected:
 
 private:
 
+    // A node of the backward BFS, or the SCC the BFS enters at node
+    struct BackwardStep {
+        const DepGraphNode* node;
+        bool scc;
+    };
+    std::vector<BackwardStep> getBackwardOrder(const DepGraph& depGraph) const;
+
+    // Runs tasks on the backward pool and waits for all of them, the first
+    // exception thrown by a task is rethrown
+    static void runBackwardTasks(std::vector<std::function<void()> >& tasks);
+
+    static unsigned int backward_threads;
+    static std::unique_ptr<boost::asio::thread_pool> backward_pool;
+
     StrangerAutomaton* uninit_node_default_initialization;
     StrangerAutomaton* m_inputAuto;
     NodesList f_unmodeled;
@@ -0,0 +1,126 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * InputIndependentResult.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "InputIndependentResult.hpp"
+
+#include <deque>
+#include <iterator>
+#include <iostream>
+
+#include "ImageComputer.hpp"
+#include "depgraph/DepGraphOpNode.hpp"
+#include "exceptions/StrangerException.hpp"
+
+InputIndependentResult::InputIndependentResult(DepGraph& depGraph, bool doConcat)
+  : m_independent()
+  , m_excluded()
+  , m_result()
+  , m_size(0)
+  , m_mutex()
+{
+  findInputIndependentNodes(depGraph);
+
+  // A URL in the pattern of a replace is substituted by the input automaton
+  const Metadata& m = depGraph.get_metadata();
+  if (m.is_initialized() && m.has_url_on_lhs_of_replace()) {
+    return;
+  }
+
+  m_result.reserve(depGraph.getMaxNodeID() + 1);
+  ImageComputer analyzer(doConcat, false, nullptr);
+  for (auto node : depGraph.getNodes()) {
+    if (!isInputIndependent(node) || (m_result.find(node->getID()) != m_result.end())) {
+      continue;
+    }
+    // Only start at the nodes an input dependent node refers to, the
+    // traversal computes everything below them
+    bool frontier = false;
+    for (auto pred : depGraph.getPredecessors(node)) {
+      frontier = frontier || !isInputIndependent(pred);
+    }
+    if (!frontier) {
+      continue;
+    }
+    try {
+      analyzer.doForwardAnalysis_GeneralCase(depGraph, node, m_result);
+    } catch (StrangerException const &e) {
+      // Left to the analysis of each input, which fails in the same way
+      std::cout << "Input independent node " << node->getID() << " not cached: " << e.what() << std::endl;
+    }
+  }
+  m_size = std::distance(m_result.begin(), m_result.end());
+}
+
+InputIndependentResult::~InputIndependentResult()
+{
+}
+
+void InputIndependentResult::findInputIndependentNodes(DepGraph& depGraph)
+{
+  m_independent.assign(depGraph.getMaxNodeID() + 1, true);
+
+  // Everything an input flows into, edges point from the sink to the inputs
+  std::deque<DepGraphNode*> queue;
+  for (auto uninit : depGraph.getUninitNodes()) {
+    m_independent[uninit->getID()] = false;
+    queue.push_back(uninit);
+  }
+  while (!queue.empty()) {
+    DepGraphNode* node = queue.front();
+    queue.pop_front();
+    for (auto pred : depGraph.getPredecessors(node)) {
+      if (m_independent[pred->getID()]) {
+        m_independent[pred->getID()] = false;
+        queue.push_back(pred);
+      }
+    }
+  }
+
+  for (auto node : depGraph.getNodes()) {
+    const DepGraphOpNode* opNode = dynamic_cast<const DepGraphOpNode*>(node);
+    if ((opNode != nullptr) && (opNode->getKind() == OpKind::VlabRestrict)) {
+      NodesList successors = depGraph.getSuccessors(node);
+      if (!successors.empty()) {
+        m_excluded.insert(successors[0]->getID());
+      }
+    }
+  }
+}
+
+bool InputIndependentResult::isInputIndependent(const DepGraphNode* node) const
+{
+  int id = node->getID();
+  return (id >= 0) && (id < (int) m_independent.size()) && m_independent[id] &&
+    (m_excluded.count(id) == 0);
+}
+
+void InputIndependentResult::seed(AnalysisResult& result) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto& entry : m_result) {
+    if ((m_excluded.count(entry.first) == 0) && (result.find(entry.first) == result.end())) {
+      result.set(entry.first, entry.second->clone());
+    }
+  }
+}
@@ -0,0 +1,67 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * InputIndependentResult.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef INPUT_INDEPENDENT_RESULT_HPP_
+#define INPUT_INDEPENDENT_RESULT_HPP_
+
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "AnalysisResult.hpp"
+#include "depgraph/DepGraph.hpp"
+
+// Forward images of the nodes of a dependency graph which no input flows
+// into: literals, regular expressions and operations on them only, such as
+// the patterns and replacements of replace calls. They are the same for the
+// analysis of every input field, so they are computed once and seeded into
+// the analysis result of each input.
+class InputIndependentResult {
+
+public:
+  // doConcat must be the same as for the analyses which are seeded
+  InputIndependentResult(DepGraph& depGraph, bool doConcat = false);
+  virtual ~InputIndependentResult();
+
+  // Copies the cached automata into result, nodes which are set already are
+  // kept. MONA automata cannot be read by several threads at once, so the
+  // copies are deep and made under a lock.
+  void seed(AnalysisResult& result) const;
+
+  bool isInputIndependent(const DepGraphNode* node) const;
+  // Number of cached automata
+  std::size_t size() const { return m_size; }
+
+private:
+  void findInputIndependentNodes(DepGraph& depGraph);
+
+  std::vector<bool> m_independent;
+  // Patterns of __vlab_restrict are not computed as other literals
+  std::set<int> m_excluded;
+  AnalysisResult m_result;
+  std::size_t m_size;
+  mutable std::mutex m_mutex;
+};
+
+#endif /* INPUT_INDEPENDENT_RESULT_HPP_ */
@@ -25,8 +25,12 @@
 
 #include "SemAttack.hpp"
 #include "AttackPatterns.hpp"
+#include "FixPointEngine.hpp"
 #include "MultiAttack.hpp"
+#include "ShardResults.hpp"
 #include "StrangerAutomaton.hpp"
+#include "StringBuilder.hpp"
+#include "WitnessEnumerator.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -42,20 +46,35 @@ MultiAttack::MultiAttack(const std::string& graph_directory, const std::string&
   : m_graph_directory(graph_directory)
   , m_output_directory(output_dir)
   , m_input_name(input_field_name)
-  , m_dot_paths()
+  , m_dot_count(0)
   , m_results()
   , m_result_hash_map()
+  , m_done(0)
+  , m_resident()
+  , m_resident_bytes(0)
+  , m_memory_budget(0)
+  , m_loading(false)
+  , m_pipelined()
+  , m_late_metadata()
+  , m_late_results()
   , m_automata()
   , m_groups()
   , m_analyzed_contexts()
   , results_mutex()
-  , m_nThreads(boost::thread::hardware_concurrency())
+  , m_profiler()
   , m_max(max)
+  , m_nThreads(boost::thread::hardware_concurrency())
+  , m_nParserThreads(std::max(1u, m_nThreads / 2))
   , m_concats(0)
   , m_compute_preimage(true)
   , m_output_dotfiles(true)
   , m_attack_forward(false)
   , m_no_exploit_match(true)
+  , m_alphabet_analysis(false)
+  , m_compress_alphabet(false)
+  , m_witnesses(0)
+  , m_shard(0)
+  , m_shards(1)
   , m_input_automaton(nullptr)
 {
   if (input_auto == nullptr) {
@@ -63,7 +82,7 @@ MultiAttack::MultiAttack(const std::string& graph_directory, const std::string&
   } else {
     m_input_automaton = input_auto->clone();
   }
-  fillCommonPatterns();
+  fillCommonPatterns(m_groups, m_automata);
 }
 
 MultiAttack::~MultiAttack() {
@@ -79,82 +98,113 @@ MultiAttack::~MultiAttack() {
   m_automata.clear();
 }
 
+void MultiAttack::setShard(unsigned int i, unsigned int n) {
+  if (n == 0 || i >= n) {
+    throw std::invalid_argument(stringbuilder() << "Invalid shard " << i << "/" << n);
+  }
+  m_shard = i;
+  m_shards = n;
+}
+
+std::vector<const SanitizerResult*> MultiAttack::getResults() const {
+  return std::vector<const SanitizerResult*>(m_results.begin(), m_results.end());
+}
+
 void MultiAttack::writeResultsToFile() const {
-  fs::path output(m_output_directory / fs::path("semattack_groups.csv"));
+  if (m_shards > 1) {
+    // Partial results, combined into the reports by multiattack-merge
+    std::cout << "Writing results of shard " << m_shard << "/" << m_shards << " to " << m_output_directory.string() << std::endl;
+    ShardResults::write(m_output_directory, m_shard, m_shards, m_groups, getResults(),
+                        m_analyzed_contexts, m_dot_count, m_nThreads);
+    return;
+  }
+  writeResultsToFile(m_output_directory, m_groups, getResults(), m_analyzed_contexts, m_dot_count, m_nThreads);
+}
+
+void MultiAttack::writeResultsToFile(const fs::path& dir, const AutomatonGroups& groups,
+                                     const std::vector<const SanitizerResult*>& results,
+                                     const std::vector<AttackContext>& contexts,
+                                     unsigned int dot_count, unsigned int threads) {
+  fs::path output(dir / fs::path("semattack_groups.csv"));
   std::ofstream ofs;
   ofs.open (output.string(), std::ofstream::out);
-  printResults(ofs, true);
+  printResults(ofs, groups, contexts, dot_count, threads, true);
   ofs.close();
 
-  fs::path output_files(m_output_directory / fs::path("semattack_files.csv"));
+  fs::path output_files(dir / fs::path("semattack_files.csv"));
   std::ofstream ofs_files;
   ofs_files.open (output_files.string(), std::ofstream::out);
-  printFiles(ofs_files);
+  printFiles(ofs_files, results, contexts);
   ofs_files.close();
 
-  fs::path output_sum(m_output_directory / fs::path("semattack_summary.csv"));
+  fs::path output_sum(dir / fs::path("semattack_summary.csv"));
   std::ofstream ofs_sum;
   ofs_sum.open (output_sum.string(), std::ofstream::out);
-  m_groups.printOverlapSummary(ofs_sum, m_analyzed_contexts);
+  groups.printOverlapSummary(ofs_sum, contexts);
   ofs_sum.close();
 
-  fs::path output_sum_pc(m_output_directory / fs::path("semattack_summary_percent.csv"));
+  fs::path output_sum_pc(dir / fs::path("semattack_summary_percent.csv"));
   std::ofstream ofs_sum_pc;
   ofs_sum_pc.open (output_sum_pc.string(), std::ofstream::out);
-  m_groups.printOverlapSummary(ofs_sum_pc, m_analyzed_contexts, true);
+  groups.printOverlapSummary(ofs_sum_pc, contexts, true);
   ofs_sum_pc.close();
 
-  fs::path output_err_sum(m_output_directory / fs::path("semattack_error_summary.csv"));
+  fs::path output_err_sum(dir / fs::path("semattack_error_summary.csv"));
   std::ofstream ofs_err_sum;
   ofs_err_sum.open (output_err_sum.string(), std::ofstream::out);
-  m_groups.printErrorSummary(ofs_err_sum);
+  groups.printErrorSummary(ofs_err_sum);
   ofs_err_sum.close();
 
-  fs::path output_gen_payloads(m_output_directory / fs::path("semattack_generated_payloads.csv"));
+  fs::path output_gen_payloads(dir / fs::path("semattack_generated_payloads.csv"));
   std::ofstream ofs_gen;
   ofs_gen.open (output_gen_payloads.string(), std::ofstream::out);
-  m_groups.printGeneratedPayloads(ofs_gen);
+  groups.printGeneratedPayloads(ofs_gen);
   ofs_gen.close();
 
-  fs::path output_injection_histo(m_output_directory / fs::path("semattack_injection_histo.csv"));
+  fs::path output_injection_histo(dir / fs::path("semattack_injection_histo.csv"));
   std::ofstream ofs_inj_histo;
   ofs_inj_histo.open (output_injection_histo.string(), std::ofstream::out);
-  m_groups.printInjectionPointHistogram(ofs_inj_histo);
+  groups.printInjectionPointHistogram(ofs_inj_histo);
   ofs_inj_histo.close();
 
-  fs::path output_domain_histo(m_output_directory / fs::path("semattack_domain_histo.csv"));
+  fs::path output_domain_histo(dir / fs::path("semattack_domain_histo.csv"));
   std::ofstream ofs_domain_histo;
   ofs_domain_histo.open (output_domain_histo.string(), std::ofstream::out);
-  m_groups.printDomainHistogram(ofs_domain_histo);
+  groups.printDomainHistogram(ofs_domain_histo);
   ofs_domain_histo.close();
 
-  fs::path output_sanitizers_per_group_histo(m_output_directory / fs::path("semattack_sanitizers_per_group_histo.csv"));
+  fs::path output_sanitizers_per_group_histo(dir / fs::path("semattack_sanitizers_per_group_histo.csv"));
   std::ofstream ofs_sanitizers_per_group_histo;
   ofs_sanitizers_per_group_histo.open (output_sanitizers_per_group_histo.string(), std::ofstream::out);
-  m_groups.printSanitizersPerGroupHistogram(ofs_sanitizers_per_group_histo);
+  groups.printSanitizersPerGroupHistogram(ofs_sanitizers_per_group_histo);
   ofs_sanitizers_per_group_histo.close();
 
-  fs::path output_missing_payloads(m_output_directory / fs::path("semattack_missing_payloads.txt"));
+  fs::path output_missing_payloads(dir / fs::path("semattack_missing_payloads.txt"));
   std::ofstream ofs_miss;
   ofs_miss.open (output_missing_payloads.string(), std::ofstream::out);
-  for (auto& r : m_results) {
+  for (auto r : results) {
     r->printUnmatchedUuids(ofs_miss);
   }
   ofs_miss.close();
 }
 
 void MultiAttack::printFiles(std::ostream& os) const {
+  printFiles(os, getResults(), m_analyzed_contexts);
+}
+
+void MultiAttack::printFiles(std::ostream& os, const std::vector<const SanitizerResult*>& results,
+                             const std::vector<AttackContext>& contexts) {
   os << "Printing files:" << std::endl;
   int i = 0;
-  for (auto result : m_results) {
+  for (auto result : results) {
     if (result->isDone()) {
       os << i << ", ";
       os << result->getFileName() << ", ";
       os << result->getCountWithDuplicates() << ", ";
       os << result->getCount() << ", ";
-      os << (result->getFwAnalysis().isErrored() ? "ERROR!" : "OK") << ", ";
-      os << AnalysisErrorHelper::getName(result->getFwAnalysis().getError()) << ", ";
-      result->printResult(os, true, m_analyzed_contexts);
+      os << (result->isErrored() ? "ERROR!" : "OK") << ", ";
+      os << AnalysisErrorHelper::getName(result->getError()) << ", ";
+      result->printResult(os, true, contexts);
       os << std::endl;
       ++i;
     }
@@ -163,21 +213,22 @@ void MultiAttack::printFiles(std::ostream& os) const {
 
 void MultiAttack::printResults(std::ostream& os, bool printFiles) const
 {
-  os << "# Found " << this->m_dot_paths.size() << " dot files" << std::endl;
-  os << "# Computed images with pool of " << m_nThreads << " threads." << std::endl;
+  printResults(os, m_groups, m_analyzed_contexts, m_dot_count, m_nThreads, printFiles);
+}
+
+void MultiAttack::printResults(std::ostream& os, const AutomatonGroups& groups,
+                               const std::vector<AttackContext>& contexts,
+                               unsigned int dot_count, unsigned int threads, bool printFiles)
+{
+  os << "# Found " << dot_count << " dot files" << std::endl;
+  os << "# Computed images with pool of " << threads << " threads." << std::endl;
   os << "# Printing Groups:" << std::endl;
-  m_groups.printGroups(os, printFiles, m_analyzed_contexts);
+  groups.printGroups(os, printFiles, contexts);
 }
 
 int MultiAttack::countDone() const
 {
-  int done = 0;
-  for (auto& result : m_results) {
-    if (result->isDone()) {
-      done++;
-    }
-  }
-  return done;
+  return m_done;
 }
   
 void MultiAttack::printStatus(bool printGroups) const
@@ -186,6 +237,10 @@ void MultiAttack::printStatus(bool printGroups) const
   int total = m_results.size();
   double percent = total > 0 ? ((double) done / (double) total) * 100.0 : 0.0;
   std::cout << "Status: completed " << done << "/" << total << "(" << percent << "%)" << std::endl;
+  if (m_memory_budget > 0) {
+    std::cout << "Resident forward analysis automata: " << (m_resident_bytes >> 20)
+              << " MB (budget " << (m_memory_budget >> 20) << " MB)" << std::endl;
+  }
   if (printGroups) {
     m_groups.printStatus(std::cout);
   }
@@ -202,9 +257,19 @@ void MultiAttack::computeAttackPatternOverlap(CombinedAnalysisResult* result, At
     fs::path dir(m_output_directory / result->getAttack()->getFile());
     BackwardAnalysisResult* bw = result->addBackwardAnalysis(context);
     bw->doAnalysis(m_compute_preimage, m_singleton_intersection, m_attack_forward);
+    m_profiler.addAutomaton(file, bw->getIntersection());
+    m_profiler.addAutomaton(file, bw->getPreImage());
     if (m_output_dotfiles) {
+      PhaseProfiler::Scope scope(m_profiler, file, "write");
       bw->writeResultsToFile(dir);
     }
+    if ((m_witnesses > 0) && bw->isVulnerable() && (bw->getPreImage() != nullptr)) {
+      PhaseProfiler::Scope scope(m_profiler, file, "write");
+      WitnessEnumerator enumerator(bw->getPreImage());
+      fs::create_directories(dir);
+      std::ofstream ofs((dir / fs::path("pre_image_" + bw->getName() + "_witnesses.txt")).string(), std::ofstream::out);
+      WitnessEnumerator::write(ofs, enumerator.diverse(m_witnesses));
+    }
     bw->finishAnalysis();
   } catch (...) {
     std::cout << "EXCEPTION! In BW analysis file: " << file << " for context: " << AttackContextHelper::getName(context) << std::endl;
@@ -221,16 +286,39 @@ void MultiAttack::computeAttackPatternOverlapForMetadata(CombinedAnalysisResult*
   result->doMetadataSpecificAnalysis(dir, true, m_singleton_intersection, m_output_dotfiles, m_attack_forward);
 }
 
+bool MultiAttack::isInShard(const fs::path& file, const DepGraph& target_dep_graph) const {
+  if (m_shards <= 1) {
+    return true;
+  }
+  // Shard by sanitizer hash so that all duplicates end up in the same shard,
+  // legacy depgraphs without the hash are sharded by file name
+  const Metadata& metadata = target_dep_graph.get_metadata();
+  std::size_t key = metadata.is_initialized() ?
+    static_cast<unsigned int>(metadata.get_sanitizer_hash()) : std::hash<std::string>()(file.string());
+  return (key % m_shards) == m_shard;
+}
+
 CombinedAnalysisResult* MultiAttack::findOrCreateResult(const fs::path& file, DepGraph& target_dep_graph, boost::asio::thread_pool &pool) {
   // Find the result for the given hash
-  const std::lock_guard<std::mutex> lock(this->results_mutex);
+  const std::unique_lock<std::mutex> lock(m_profiler.lock(this->results_mutex, file.string()));
   CombinedAnalysisResult* result = nullptr;
+  if (!isInShard(file, target_dep_graph)) {
+    return result;
+  }
   if (target_dep_graph.get_metadata().has_correct_exploit_match() || this->m_no_exploit_match) {
     int hash = target_dep_graph.get_metadata().get_sanitizer_hash();
     auto search = this->m_result_hash_map.find(hash);
     if(target_dep_graph.get_metadata().is_initialized() && // Legacy failsafe to support depgraphs without the hash field
        search != this->m_result_hash_map.end()) {
-      if (search->second->addMetadata(target_dep_graph.get_metadata())) {
+      if (m_pipelined.find(search->second) != m_pipelined.end()) {
+        // The backward analysis may be running, add the metadata later
+        m_late_metadata[search->second].push_back(target_dep_graph.get_metadata());
+        return result;
+      }
+      bool isNew = search->second->addMetadata(target_dep_graph.get_metadata());
+      // The duplicate count changes in any case
+      this->m_groups.markChanged(search->second);
+      if (isNew) {
         // std::cout << "Incremeted count to " << search->second->getCount() << " for " << search->second->getFileName() << std::endl;
       } else {
         // This is a bit too verbose
@@ -239,7 +327,7 @@ CombinedAnalysisResult* MultiAttack::findOrCreateResult(const fs::path& file, De
     } else {
       result = new CombinedAnalysisResult(file, target_dep_graph, m_input_name, m_input_automaton);
       // Start the forward analysis
-      asio::post(pool, std::bind(&MultiAttack::doFwAnalysis, this, result));
+      post(pool, &MultiAttack::doFwAnalysis, result);
       this->m_results.push_back(result);
       if (((m_results.size() % 1000) == 0)) {
         std::cout << "Added " << m_results.size() << " sanitizers to worker queue." << std::endl;
@@ -253,6 +341,15 @@ CombinedAnalysisResult* MultiAttack::findOrCreateResult(const fs::path& file, De
   return result;
 }
 
+void MultiAttack::post(boost::asio::thread_pool &pool, void (MultiAttack::*task)(CombinedAnalysisResult*),
+                       CombinedAnalysisResult* result) {
+  m_profiler.taskQueued();
+  asio::post(pool, [this, task, result]() {
+      m_profiler.taskStarted();
+      (this->*task)(result);
+    });
+}
+
 void MultiAttack::doFwAnalysis(CombinedAnalysisResult* result) {
   if (result == nullptr) {
     return;
@@ -263,16 +360,45 @@ void MultiAttack::doFwAnalysis(CombinedAnalysisResult* result) {
   const std::string file = result->getFileName();
   fs::path dir(m_output_directory / result->getInputPath());
   std::cout << "Analysing file: " << file << std::endl;
+  FixPointEngine::setThreadLabel(file);
 
   // Reduce debug prints
   result->getAttack()->setPrint(false);
 
   try {
     // Forward Analysis
-    result->getAttack()->init();
-    result->getFwAnalysis().doAnalysis(m_concats);
+    {
+      PhaseProfiler::Scope scope(m_profiler, file, "init");
+      result->getAttack()->init();
+    }
+    if (m_alphabet_analysis || m_compress_alphabet) {
+      PhaseProfiler::Scope scope(m_profiler, file, "alphabet");
+      AlphabetPartition alphabet = result->getAttack()->computeAlphabet(m_analyzed_contexts);
+      alphabet.refine(m_input_automaton);
+      if (m_alphabet_analysis) {
+        std::cout << "Alphabet of " << file << ": " << alphabet.getClassCount() << " character classes, "
+                  << alphabet.getBits() << " bits" << std::endl;
+        fs::create_directories(dir);
+        std::ofstream ofs((dir / fs::path("alphabet.txt")).string(), std::ofstream::out);
+        alphabet.print(ofs);
+      }
+      if (m_compress_alphabet) {
+        result->getFwAnalysis().compressAlphabet(alphabet);
+      }
+    }
+    {
+      PhaseProfiler::Scope scope(m_profiler, file, "forward");
+      result->getFwAnalysis().doAnalysis(m_concats);
+    }
     postImage = result->getFwAnalysis().getPostImage();
+    if (m_profiler.isEnabled()) {
+      for (const auto& entry : result->getFwAnalysis().getFwAnalysisResult()) {
+        m_profiler.addAutomaton(file, entry.second);
+      }
+      m_profiler.addAutomaton(file, postImage);
+    }
     if (m_output_dotfiles) {
+      PhaseProfiler::Scope scope(m_profiler, file, "write");
       result->getAttack()->writeResultsToFile(dir);
       result->getFwAnalysis().writeResultsToFile(dir);
     }
@@ -288,18 +414,42 @@ void MultiAttack::doFwAnalysis(CombinedAnalysisResult* result) {
   // Tidy up on error
   if (errored) {
     if (postImage != nullptr) {
-      delete postImage;
+      // The forward analysis finished, but writing its results did not
+      result->getFwAnalysis().markErrored(AnalysisError::Other);
+      result->getFwAnalysis().releasePostImage();
       postImage = nullptr;
     }
   }
 
   // Mutex Lock
   std::cout << "Finished analysis of " << file << std::endl;
-  const std::lock_guard<std::mutex> lock(this->results_mutex);
-  std::cout << "Inserting results into groups for " << file << std::endl;
-  this->m_groups.addAutomaton(postImage, result);
-  std::cout << "Finished inserting results into groups for " << file << std::endl;
-  printStatus();
+  bool pipeline = false;
+  {
+    const std::unique_lock<std::mutex> lock(m_profiler.lock(this->results_mutex, file));
+    PhaseProfiler::Scope scope(m_profiler, file, "groups");
+    std::cout << "Inserting results into groups for " << file << std::endl;
+    this->m_groups.addAutomaton(postImage, result);
+    std::cout << "Finished inserting results into groups for " << file << std::endl;
+    this->m_groups.refresh();
+    if (m_memory_budget > 0) {
+      // Keep the forward analysis for the backward phase while within the
+      // budget, otherwise finish this result straight away
+      std::size_t size = result->getFwAnalysis().getMemoryEstimate();
+      if (m_resident_bytes + size > m_memory_budget) {
+        pipeline = true;
+        if (m_loading) {
+          m_pipelined.insert(result);
+        }
+      } else {
+        m_resident.insert(std::make_pair(result, size));
+        m_resident_bytes += size;
+      }
+    }
+    printStatus();
+  }
+  if (pipeline) {
+    doBwAnalysis(result);
+  }
 }
 
 void MultiAttack::doBwAnalysis(CombinedAnalysisResult* result) {
@@ -307,48 +457,168 @@ void MultiAttack::doBwAnalysis(CombinedAnalysisResult* result) {
     return;
   }
   const std::string file = result->getFileName();
+  FixPointEngine::setThreadLabel(file);
 
   // Backward analysis
   for (auto c : m_analyzed_contexts) {
+      PhaseProfiler::Scope scope(m_profiler, file, "backward", AttackContextHelper::getName(c));
       computeAttackPatternOverlap(result, c);
   }
 
   // Additional backward analysis for generated payloads
   if (m_payload_analysis) {
+    PhaseProfiler::Scope scope(m_profiler, file, "payload");
     computeAttackPatternOverlapForMetadata(result);
   }
 
-  // Finish up (delete the semattack object)
-  result->finishAnalysis();
+  // Finish up (delete the semattack object). While loading, the attack is
+  // kept in case duplicates with new metadata are found. m_loading is only
+  // reset once the loading pool has finished all tasks.
+  if (m_loading) {
+    result->releaseAutomata();
+  } else {
+    result->finishAnalysis();
+  }
 
-  std::cout << "Finised backward analysis for " << file << std::endl;
+  std::cout << "Finised backward analysis for " << file << " ("
+            << result->getFwAnalysis().getPreImageReuses() << " pre-images reused)" << std::endl;
+  const std::unique_lock<std::mutex> lock(m_profiler.lock(this->results_mutex, file));
+  PhaseProfiler::Scope scope(m_profiler, file, "groups");
+  m_done++;
+  this->m_groups.markChanged(result);
+  this->m_groups.refresh();
+  if (m_memory_budget > 0) {
+    releaseAutomata(result);
+  }
   printStatus();
 }
 
+void MultiAttack::doLateMetadataAnalysis(CombinedAnalysisResult* result) {
+  const std::string file = result->getFileName();
+  FixPointEngine::setThreadLabel(file);
+
+  // Payloads which were analysed before are reused, the forward analysis is
+  // only repeated for new ones
+  if (result->needsForwardAnalysisForMetadata() && !result->getFwAnalysis().isErrored()) {
+    try {
+      PhaseProfiler::Scope scope(m_profiler, file, "forward");
+      result->getFwAnalysis().doAnalysis(m_concats);
+    } catch (std::exception const &e) {
+      std::cout << "EXCEPTION! In FW analysis for late metadata: " << file << " message: " << e.what() << std::endl;
+    }
+  }
+  {
+    PhaseProfiler::Scope scope(m_profiler, file, "payload");
+    computeAttackPatternOverlapForMetadata(result);
+  }
+  result->finishAnalysis();
+
+  const std::unique_lock<std::mutex> lock(m_profiler.lock(this->results_mutex, file));
+  PhaseProfiler::Scope scope(m_profiler, file, "groups");
+  this->m_groups.markChanged(result);
+  this->m_groups.refresh();
+  releaseAutomata(result);
+}
+
+void MultiAttack::addLateMetadata() {
+  const std::unique_lock<std::mutex> lock(this->results_mutex);
+  for (auto& entry : m_late_metadata) {
+    for (const auto& metadata : entry.second) {
+      entry.first->addMetadata(metadata);
+    }
+    this->m_groups.markChanged(entry.first);
+    if (m_payload_analysis && entry.first->needsMetadataAnalysis()) {
+      m_late_results.push_back(entry.first);
+    }
+  }
+  m_late_metadata.clear();
+  // Results without new metadata are finished
+  for (auto result : m_results) {
+    if ((m_pipelined.find(result) != m_pipelined.end()) &&
+        (std::find(m_late_results.begin(), m_late_results.end(), result) == m_late_results.end())) {
+      result->finishAnalysis();
+    }
+  }
+  m_pipelined.clear();
+  this->m_groups.refresh();
+}
+
+void MultiAttack::releaseAutomata(CombinedAnalysisResult* result) {
+  auto search = m_resident.find(result);
+  if (search != m_resident.end()) {
+    m_resident_bytes -= search->second;
+    m_resident.erase(search);
+  }
+  // Only group representatives are needed for the reports, the verdicts and
+  // examples of the other results are already recorded
+  const AutomatonGroup* group = m_groups.getGroupForResult(result);
+  if ((group == nullptr) || (group->getAutomaton() != result->getFwAnalysis().getPostImage())) {
+    result->getFwAnalysis().releasePostImage();
+  }
+}
+
+void MultiAttack::parseDepGraphs(BoundedQueue<DepGraphInput>& queue, boost::asio::thread_pool &pool) {
+  DepGraphInput input;
+  while (queue.pop(input)) {
+    try {
+      DepGraph target_dep_graph;
+      {
+        PhaseProfiler::Scope scope(m_profiler, input.path.string(), "parse");
+        target_dep_graph = input.parse();
+      }
+      this->findOrCreateResult(input.path, target_dep_graph, pool);
+    } catch(std::exception& e) {
+      cerr << "Error parsing " << input.path.string() << ": " << e.what() << "\n";
+    }
+  }
+}
+
 void MultiAttack::loadDepGraphs() {
-  findDotFiles();
-  boost::asio::thread_pool pool(this->m_nThreads);
+  m_loading = true;
+  // The parsers run next to the pool, together they use the hardware threads
+  unsigned int analysis_threads = (m_nThreads > m_nParserThreads) ? (m_nThreads - m_nParserThreads) : 1;
+  boost::asio::thread_pool pool(analysis_threads);
+  // Keep enough parsed inputs queued to keep the parsers busy, but do not
+  // hold more than a few per thread in memory (bundle members carry their contents)
+  BoundedQueue<DepGraphInput> queue(this->m_nParserThreads * 16);
+
+  std::cout << "Parsing dependency graphs with " << m_nParserThreads << " parser threads and "
+            << analysis_threads << " analysis threads..." << std::endl;
+  std::vector<std::thread> parsers;
+  for (unsigned int i = 0; i < this->m_nParserThreads; i++) {
+    parsers.emplace_back(&MultiAttack::parseDepGraphs, this, std::ref(queue), std::ref(pool));
+  }
 
-  std::cout << "Parsing dependency graphs..." << std::endl;
-  // Add all files first
-  int n = 0;
-  for (const auto& file : this->m_dot_paths) {
-    n++;
-    if ((m_max > 0) && (n > m_max)) {
-      break;
+  // Enumerate inputs lazily, parsing starts as soon as the first file is found
+  DepGraphInput input;
+  try {
+    std::unique_ptr<DepGraphSource> source = DepGraphSource::create(this->m_graph_directory);
+    while ((m_max <= 0) || (m_dot_count < (unsigned int) m_max)) {
+      // The walk time of a file is known once it was found
+      PhaseProfiler::Clock::time_point start = PhaseProfiler::Clock::now();
+      double cpu_start = PhaseProfiler::threadCpuTime();
+      if (!source->next(input)) {
+        break;
+      }
+      m_profiler.addPhase(input.path.string(), "walk", start, cpu_start);
+      m_dot_count++;
+      queue.push(std::move(input));
+      input = DepGraphInput();
     }
-    asio::post(pool, [this, &pool, file]() {
-        try {
-          DepGraph target_dep_graph = DepGraph::parseDotFile(file.string());
-          {
-            this->findOrCreateResult(file, target_dep_graph, pool);
-          }
-        } catch(std::exception& e) {
-          cerr << "Error parsing " << file.string() << ": " << e.what() << "\n";
-        }
-      });
+  } catch(std::exception& e) {
+    cerr << "Error reading dependency graphs from " << m_graph_directory.string() << ": " << e.what() << "\n";
+  }
+  queue.close();
+  std::cout << "Found " << m_dot_count << " dependency graph files." << std::endl;
+
+  for (auto& parser : parsers) {
+    parser.join();
   }
   pool.join();
+  // No more duplicates are added, results finished while loading get the
+  // metadata of their later duplicates
+  m_loading = false;
+  addLateMetadata();
   printStatus();
 }
 
@@ -359,19 +629,56 @@ void MultiAttack::doAnalysis() {
   // std::sort(m_results.begin(), m_results.end());
 
   std::cout << "Computing post images with pool of " << m_nThreads << " threads." << std::endl;
-  // Start the analysis
+  // Start the analysis, results over the memory budget are already done
   for (auto& result : m_results) {
-    asio::post(pool, std::bind(&MultiAttack::doBwAnalysis, this, result));
+    if (!result->isDone()) {
+      post(pool, &MultiAttack::doBwAnalysis, result);
+    }
+  }
+  for (auto result : m_late_results) {
+    post(pool, &MultiAttack::doLateMetadataAnalysis, result);
   }
+  m_late_results.clear();
   pool.join();
   std::cout << "Forward analysis finished!" << std::endl;
+  m_groups.refresh();
   printStatus();
-  this->writeResultsToFile();  
+  {
+    PhaseProfiler::Scope scope(m_profiler, "", "report");
+    this->writeResultsToFile();
+  }
 }
-  
+
+void MultiAttack::writeProfile() const {
+  if (!m_profiler.isEnabled()) {
+    return;
+  }
+  fs::create_directories(m_output_directory);
+  fs::path output_csv(m_output_directory / fs::path("semattack_profile.csv"));
+  std::ofstream ofs_csv;
+  ofs_csv.open (output_csv.string(), std::ofstream::out);
+  m_profiler.writeCsv(ofs_csv);
+  ofs_csv.close();
+
+  fs::path output_trace(m_output_directory / fs::path("semattack_trace.json"));
+  std::ofstream ofs_trace;
+  ofs_trace.open (output_trace.string(), std::ofstream::out);
+  m_profiler.writeTrace(ofs_trace);
+  ofs_trace.close();
+
+  fs::path output_scc(m_output_directory / fs::path("semattack_scc.csv"));
+  std::ofstream ofs_scc;
+  ofs_scc.open (output_scc.string(), std::ofstream::out);
+  FixPointEngine::writeStatistics(ofs_scc);
+  ofs_scc.close();
+  std::cout << "Wrote profile to " << output_csv.string() << ", " << output_trace.string()
+            << " and " << output_scc.string() << std::endl;
+}
+
 void MultiAttack::compute() {
   loadDepGraphs();
   doAnalysis();
+  writeProfile();
 }
 
 void MultiAttack::addAttackPattern(AttackContext context)
@@ -379,133 +686,97 @@ void MultiAttack::addAttackPattern(AttackContext context)
   m_analyzed_contexts.push_back(context);
 }
 
-void MultiAttack::fillCommonPatterns() {
+void MultiAttack::fillCommonPatterns(AutomatonGroups& groups, std::vector<StrangerAutomaton*>& automata) {
 
   StrangerAutomaton* a = nullptr;
 
   // Add NULL
-  m_groups.createGroup(nullptr, "NULL");
+  groups.createGroup(nullptr, "NULL");
 
   // Add empty automaton
   a = StrangerAutomaton::makeEmptyString();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "Empty");
+  automata.push_back(a);
+  groups.createGroup(a, "Empty");
 
   // Add all strings
   a = StrangerAutomaton::makeAnyString();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "SigmaStar");
+  automata.push_back(a);
+  groups.createGroup(a, "SigmaStar");
 
   // HTML Escaped
   a = AttackPatterns::getHtmlEscaped();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLEscaped");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLEscaped");
 
   // HTML Escape < >
   a = AttackPatterns::getEncodeHtmlTagsOnly();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLEscapeTags");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLEscapeTags");
 
   // Allowed characters in innerHTML, excludes ">", "<", "'", """,
   // "&" is only considered harmful if it is not escaped
   a = AttackPatterns::getHtmlNoSlashesPattern();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLEscapeNoSlashes");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLEscapeNoSlashes");
 
   // Allowed characters in innerHTML, excludes ">", "<", "'", """, "`"
   // "&" is only considered harmful if it is not escaped
   a = AttackPatterns::getHtmlBacktickPattern();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLEscapeBacktick");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLEscapeBacktick");
 
   // HTML Removed
   a = AttackPatterns::getHtmlRemoved();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLRemoved");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLRemoved");
 
   // HTML Removed with slashes allowed
   a = AttackPatterns::getHtmlRemovedNoSlash();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLRemovedNoSlash");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLRemovedNoSlash");
 
   // HTML Escape < > &
   a = AttackPatterns::getEncodeHtmlCompat();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLEscape<>&");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLEscape<>&");
 
   // HTML Escape < > & "
   a = AttackPatterns::getEncodeHtmlNoQuotes();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLEscape<>&\"");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLEscape<>&\"");
 
   // HTML Escape < > & " '
   a = AttackPatterns::getEncodeHtmlQuotes();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLEscape<>&\"'");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLEscape<>&\"'");
 
   // HTML Escape < > & " /
   a = AttackPatterns::getEncodeHtmlSlash();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLEscape<>&\"'/");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLEscape<>&\"'/");
 
   // HTML Attribute Escaped
   a = AttackPatterns::getHtmlAttrEscaped();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "HTMLAttrEscaped");
+  automata.push_back(a);
+  groups.createGroup(a, "HTMLAttrEscaped");
 
   // Javascript Escaped
   a = AttackPatterns::getJavascriptEscaped();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "Javascript");
+  automata.push_back(a);
+  groups.createGroup(a, "Javascript");
 
   // URL Escaped
   a = AttackPatterns::getUrlEscaped();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "URL");
+  automata.push_back(a);
+  groups.createGroup(a, "URL");
 
   // After UriComponentEncode
   a = AttackPatterns::getUrlComponentEncoded();
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "UriComponentEncoded");
+  automata.push_back(a);
+  groups.createGroup(a, "UriComponentEncoded");
 
   // Double UriComponentEncode
   a = StrangerAutomaton::encodeURIComponent(a);
-  m_automata.push_back(a);
-  m_groups.createGroup(a, "DoubleUriComponentEncoded");
-}
-
-void MultiAttack::findDotFiles() {
-  this->m_dot_paths = getDotFilesInDir(this->m_graph_directory);
-  std::cout << "Found " << this->m_dot_paths.size() << " dependency graph files." << std::endl;
-}
-
-std::vector<fs::path> MultiAttack::getDotFilesInDir(fs::path const &dir)
-{
-  return getFilesInPath(dir, ".dot");
-}
-
-/**
- * \brief   Return the filenames of all files that have the specified extension
- *          in the specified directory and all subdirectories.
- */
-std::vector<fs::path> MultiAttack::getFilesInPath(fs::path const & root, std::string const & ext)
-{
-  std::vector<fs::path> paths;
-
-  if (fs::exists(root)) {
-    // Recurse into directories
-    if (fs::is_directory(root)) {
-      for (auto const & entry : fs::recursive_directory_iterator(root)) {
-        if (fs::is_regular_file(entry) && entry.path().extension() == ext) {
-          paths.emplace_back(entry.path());
-        }
-      }
-    // Single file
-    } else {
-      if (root.extension() == ext) {
-          paths.emplace_back(root);
-      }
-    }
-  }
-  return paths;
+  automata.push_back(a);
+  groups.createGroup(a, "DoubleUriComponentEncoded");
 }
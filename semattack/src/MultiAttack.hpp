@@ -25,6 +25,10 @@
 #define MULTIATTACK_HPP_
 
 #include "AutomatonGroups.hpp"
+#include "BoundedQueue.hpp"
+#include "DepGraphSource.hpp"
+#include "PhaseProfiler.hpp"
+#include "SemAttack.hpp"
 #include "StrangerAutomaton.hpp"
 
 #define BOOST_FILESYSTEM_VERSION 3
@@ -32,13 +36,16 @@
 #include <boost/filesystem.hpp>
 #include <boost/asio.hpp>
 
+#include <atomic>
 #include <ostream>
+#include <set>
 #include <thread>
 #include <vector>
 
 namespace fs = boost::filesystem;
 
-// Perform attack analysis on all dot files in the given directory
+// Perform attack analysis on all dot files in the given directory, manifest
+// file or tar/zip bundle
 class MultiAttack {
 
 public:
@@ -57,21 +64,52 @@ public:
     void setPayloadAnalysis(bool a) { m_payload_analysis = a; }
     void setDotFiles(bool d) { m_output_dotfiles = d; }
     void setDoForwardAnalysisWithAttackPattern(bool f) { m_attack_forward = f; }
+    void setParserThreads(unsigned int n) { m_nParserThreads = n > 0 ? n : 1; }
+    // Bound the automata kept between the forward and backward analysis (0 is unlimited)
+    void setMemoryBudget(std::size_t bytes) { m_memory_budget = bytes; }
+    // Write the character classes each sanitizer distinguishes to alphabet.txt
+    void setAlphabetAnalysis(bool a) { m_alphabet_analysis = a; }
+    // Analyse only strings of one representative character per class
+    void setCompressAlphabet(bool c) { m_compress_alphabet = c; }
+    // Write up to k diverse examples of each pre-image, 0 writes none
+    void setWitnesses(unsigned int k) { m_witnesses = k; }
+    // Record the time per phase and write semattack_profile.csv, semattack_trace.json
+    // and the statistics of the loop analysis to semattack_scc.csv
+    void setProfile(bool p) { m_profiler.setEnabled(p); }
+    // Only analyse the sanitizers whose hash falls into shard i of n
+    void setShard(unsigned int i, unsigned int n);
+
+    // Shared with multiattack-merge, which reports on merged shard results
+    static void fillCommonPatterns(AutomatonGroups& groups, std::vector<StrangerAutomaton*>& automata);
+    static void writeResultsToFile(const fs::path& dir, const AutomatonGroups& groups,
+                                   const std::vector<const SanitizerResult*>& results,
+                                   const std::vector<AttackContext>& contexts,
+                                   unsigned int dot_count, unsigned int threads);
+    static void printResults(std::ostream& os, const AutomatonGroups& groups,
+                             const std::vector<AttackContext>& contexts,
+                             unsigned int dot_count, unsigned int threads, bool printFiles);
+    static void printFiles(std::ostream& os, const std::vector<const SanitizerResult*>& results,
+                           const std::vector<AttackContext>& contexts);
 private:
     void printResults(std::ostream& os, bool printFiles = false) const;
     void printFiles(std::ostream& os) const;
-    void fillCommonPatterns();
-    void findDotFiles();
+    std::vector<const SanitizerResult*> getResults() const;
+    bool isInShard(const fs::path& file, const DepGraph& target_dep_graph) const;
     CombinedAnalysisResult* findOrCreateResult(const fs::path& file, DepGraph& target_dep_graph, boost::asio::thread_pool &pool);
+    // Posts task for result to the pool, counting the queued tasks
+    void post(boost::asio::thread_pool &pool, void (MultiAttack::*task)(CombinedAnalysisResult*),
+              CombinedAnalysisResult* result);
     void doFwAnalysis(CombinedAnalysisResult* result);
     void doBwAnalysis(CombinedAnalysisResult* result);
+    void doLateMetadataAnalysis(CombinedAnalysisResult* result);
+    void addLateMetadata();
+    void releaseAutomata(CombinedAnalysisResult* result);
     void computeAttackPatternOverlap(CombinedAnalysisResult* result, AttackContext context);
     void computeAttackPatternOverlapForMetadata(CombinedAnalysisResult* result);
-    static std::vector<fs::path> getDotFilesInDir(fs::path const &dir);
-    static std::vector<fs::path> getFilesInPath(fs::path const & root, std::string const & ext);
-
+    void parseDepGraphs(BoundedQueue<DepGraphInput>& queue, boost::asio::thread_pool &pool);
     void loadDepGraphs();
     void doAnalysis();
+    void writeProfile() const;
     
     int countDone() const;
 
@@ -79,11 +117,25 @@ private:
     fs::path m_output_directory;
 
     std::string m_input_name;
-    std::vector<fs::path> m_dot_paths;
+    std::atomic<unsigned int> m_dot_count;
     // A list of all the results
     std::vector<CombinedAnalysisResult*> m_results;
     // A map of depgraph hashes to their results
     std::map<int, CombinedAnalysisResult*> m_result_hash_map;
+    // Number of results which finished the backward analysis
+    int m_done;
+    // Estimated size of the forward analysis automata waiting for the backward analysis
+    std::map<const CombinedAnalysisResult*, std::size_t> m_resident;
+    std::size_t m_resident_bytes;
+    std::size_t m_memory_budget;
+    // Duplicates may still be found while the depgraphs are loaded. Results
+    // over the budget are finished during loading, the metadata of their
+    // later duplicates is kept aside and analysed once loading is finished.
+    bool m_loading;
+    std::set<const CombinedAnalysisResult*> m_pipelined;
+    std::map<CombinedAnalysisResult*, std::vector<Metadata> > m_late_metadata;
+    // Results with new metadata after their backward analysis
+    std::vector<CombinedAnalysisResult*> m_late_results;
     // A list of all post images
     std::vector<StrangerAutomaton*> m_automata;
     // Results grouped by post image
@@ -91,10 +143,12 @@ private:
     std::vector<AttackContext> m_analyzed_contexts;
 
     std::mutex results_mutex;
+    PhaseProfiler m_profiler;
 
     // Configuration
     int m_max;
     unsigned int m_nThreads;
+    unsigned int m_nParserThreads;
     bool m_concats;
     bool m_singleton_intersection;
     bool m_compute_preimage;
@@ -102,6 +156,11 @@ private:
     bool m_output_dotfiles;
     bool m_attack_forward;
     bool m_no_exploit_match;
+    bool m_alphabet_analysis;
+    bool m_compress_alphabet;
+    unsigned int m_witnesses;
+    unsigned int m_shard;
+    unsigned int m_shards;
     StrangerAutomaton* m_input_automaton;
 };
 
@@ -0,0 +1,163 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * MultiInputAttack.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "MultiInputAttack.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include <boost/asio.hpp>
+
+#include "depgraph/DepGraphNormalNode.hpp"
+#include "depgraph/Variable.hpp"
+#include "exceptions/StrangerException.hpp"
+
+namespace asio = boost::asio;
+
+typedef std::chrono::steady_clock Clock;
+
+MultiInputAttack::MultiInputAttack(const fs::path& target_dep_graph_file_name, const DepGraph& target_dep_graph,
+                                   unsigned int threads)
+  : m_file(target_dep_graph_file_name)
+  , m_dep_graph(target_dep_graph)
+  , m_threads(std::max(1u, threads))
+  , m_contexts()
+  , m_concats(false)
+  , m_compute_preimage(true)
+  , m_shared()
+  , m_inputs()
+{
+}
+
+MultiInputAttack::~MultiInputAttack()
+{
+  // The backward results refer to the forward results
+  for (auto& input : m_inputs) {
+    input->bw.clear();
+  }
+}
+
+std::string MultiInputAttack::getInputName(DepGraph& depGraph, const DepGraphUninitNode* node)
+{
+  for (auto pred : depGraph.getPredecessors(node)) {
+    const DepGraphNormalNode* varNode = dynamic_cast<const DepGraphNormalNode*>(pred);
+    if (varNode != nullptr) {
+      const Variable* var = dynamic_cast<const Variable*>(varNode->getPlace());
+      if (var != nullptr) {
+        return var->getName();
+      }
+    }
+  }
+  return stringbuilder() << "input_" << node->getID();
+}
+
+const std::vector<std::unique_ptr<MultiInputAttack::Input> >& MultiInputAttack::compute()
+{
+  m_inputs.clear();
+  for (auto uninit : m_dep_graph.getUninitNodes()) {
+    std::unique_ptr<Input> input(new Input());
+    input->node_id = uninit->getID();
+    input->name = getInputName(m_dep_graph, uninit);
+    input->ms = 0.0;
+    // Copying the graph is not thread safe, the results are created here
+    std::unique_ptr<StrangerAutomaton> sigmaStar(StrangerAutomaton::makeAnyString(uninit->getID()));
+    input->fw.reset(new ForwardAnalysisResult(m_file, input->name, m_dep_graph, sigmaStar.get()));
+    m_inputs.push_back(std::move(input));
+  }
+
+  Clock::time_point start = Clock::now();
+  m_shared.reset(new InputIndependentResult(m_dep_graph, m_concats));
+  std::cout << "Cached " << m_shared->size() << " input independent automata in "
+            << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+
+  asio::thread_pool pool(m_threads);
+  std::cout << "Analysing " << m_inputs.size() << " inputs with pool of " << m_threads << " threads." << std::endl;
+  for (auto& input : m_inputs) {
+    Input* i = input.get();
+    asio::post(pool, [this, i]() { analyze(i); });
+  }
+  pool.join();
+
+  std::sort(m_inputs.begin(), m_inputs.end(), [](const std::unique_ptr<Input>& a, const std::unique_ptr<Input>& b) {
+      return a->node_id < b->node_id;
+    });
+  return m_inputs;
+}
+
+void MultiInputAttack::analyze(Input* input)
+{
+  Clock::time_point start = Clock::now();
+  SemAttack* attack = input->fw->getAttack();
+  attack->setPrint(false);
+  attack->setInputNodeID(input->node_id);
+  attack->setInputIndependentResult(m_shared.get());
+  try {
+    attack->init();
+    input->fw->doAnalysis(m_concats);
+    for (auto context : m_contexts) {
+      std::unique_ptr<BackwardAnalysisResult> bw(new BackwardAnalysisResult(*input->fw, context));
+      try {
+        bw->doAnalysis(m_compute_preimage);
+      } catch (StrangerException const &e) {
+        std::cout << "EXCEPTION! In BW analysis of input: " << input->name << " for context: "
+                  << AttackContextHelper::getName(context) << std::endl;
+      }
+      bw->finishAnalysis();
+      input->bw.push_back(std::move(bw));
+    }
+  } catch (StrangerException const &e) {
+    std::cerr << "Error analysing input " << input->name << ": " << e.what() << std::endl;
+  } catch (std::exception const &e) {
+    std::cerr << "Error analysing input " << input->name << ": " << e.what() << std::endl;
+  }
+  input->fw->finishAnalysis();
+  input->ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  std::cout << "Finished analysis of input " << input->name << " (node " << input->node_id << ")" << std::endl;
+}
+
+void MultiInputAttack::printResults(std::ostream& os) const
+{
+  os << "input,node,error,";
+  for (auto context : m_contexts) {
+    os << AttackContextHelper::getName(context) << ",inclusion,post,pre,";
+  }
+  os << "ms" << std::endl;
+  os << std::fixed << std::setprecision(3);
+  for (const auto& input : m_inputs) {
+    os << input->name << "," << input->node_id << ",";
+    if (input->fw && input->fw->isErrored()) {
+      os << AnalysisErrorHelper::getName(input->fw->getError()) << ",";
+      for (std::size_t i = 0; i < m_contexts.size(); i++) {
+        os << "error,error,error,error,";
+      }
+    } else {
+      os << "none,";
+      for (const auto& bw : input->bw) {
+        bw->printResult(os, false);
+      }
+    }
+    os << input->ms << std::endl;
+  }
+}
@@ -0,0 +1,82 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * MultiInputAttack.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef MULTI_INPUT_ATTACK_HPP_
+#define MULTI_INPUT_ATTACK_HPP_
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AttackContext.hpp"
+#include "InputIndependentResult.hpp"
+#include "SemAttack.hpp"
+
+// Analyses every input node of one dependency graph (e.g. a URL, a cookie
+// and the referrer flowing into the same sink). The automata of the input
+// independent nodes are computed once, then the forward and backward
+// analyses of the inputs run in parallel, each seeded with copies of them.
+class MultiInputAttack {
+
+public:
+  struct Input {
+    int node_id;
+    std::string name;
+    std::unique_ptr<ForwardAnalysisResult> fw;
+    std::vector<std::unique_ptr<BackwardAnalysisResult> > bw;
+    double ms;
+  };
+
+  MultiInputAttack(const fs::path& target_dep_graph_file_name, const DepGraph& target_dep_graph,
+                   unsigned int threads);
+  virtual ~MultiInputAttack();
+
+  void addAttackPattern(AttackContext context) { m_contexts.push_back(context); }
+  void setConcats(bool c) { m_concats = c; }
+  void setComputePreimage(bool c) { m_compute_preimage = c; }
+
+  // Runs all inputs, then returns them sorted by node ID
+  const std::vector<std::unique_ptr<Input> >& compute();
+  void printResults(std::ostream& os) const;
+
+  // Name of the variable an input is assigned to, or its node ID
+  static std::string getInputName(DepGraph& depGraph, const DepGraphUninitNode* node);
+
+private:
+  void analyze(Input* input);
+
+  fs::path m_file;
+  DepGraph m_dep_graph;
+  unsigned int m_threads;
+  std::vector<AttackContext> m_contexts;
+  bool m_concats;
+  bool m_compute_preimage;
+
+  std::unique_ptr<InputIndependentResult> m_shared;
+  std::vector<std::unique_ptr<Input> > m_inputs;
+};
+
+#endif /* MULTI_INPUT_ATTACK_HPP_ */
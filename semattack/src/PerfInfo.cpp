@@ -57,6 +57,9 @@ void PerfInfo::reset() {
 //    concat, union, intersection, closure, replace...
 
 	 intersect_total_time = boost::posix_time::microseconds(0);
+	 intersect_check_total_time = boost::posix_time::microseconds(0);
+	 inclusion_check_total_time = boost::posix_time::microseconds(0);
+	 equivalence_check_total_time = boost::posix_time::microseconds(0);
 	 union_total_time = boost::posix_time::microseconds(0);
 	 closure_total_time = boost::posix_time::microseconds(0);
 	 complement_total_time = boost::posix_time::microseconds(0);
@@ -67,6 +70,7 @@ void PerfInfo::reset() {
 	 const_pre_concat_total_time = boost::posix_time::microseconds(0);
 	 replace_total_time = boost::posix_time::microseconds(0);
 	 pre_replace_total_time = boost::posix_time::microseconds(0);
+	 minimize_total_time = boost::posix_time::microseconds(0);
 
 	 performance_time = boost::posix_time::microseconds(0);
 
@@ -98,6 +102,9 @@ void PerfInfo::reset() {
 
 
 	num_of_intersect = 0;
+	num_of_intersect_check = 0;
+	num_of_inclusion_check = 0;
+	num_of_equivalence_check = 0;
 	num_of_union = 0;
 	num_of_closure = 0;
 	num_of_complement = 0;
@@ -108,6 +115,7 @@ void PerfInfo::reset() {
 	num_of_const_pre_concat = 0;
 	num_of_replace = 0;
 	num_of_pre_replace = 0;
+	num_of_minimize = 0;
 
 	number_of_vlab_restrict = 0;
 	number_of_pre_vlab_restrict = 0;
@@ -141,6 +149,22 @@ boost::posix_time::ptime PerfInfo::current_time() {
 	return boost::posix_time::microsec_clock::local_time();
 }
 
+void PerfInfo::add_extraction_times(const PerfInfo& other) {
+	validation_target_backward_time += other.validation_target_backward_time;
+	validation_reference_backward_time += other.validation_reference_backward_time;
+	validation_comparison_time += other.validation_comparison_time;
+	validation_patch_extraction_total_time += other.validation_patch_extraction_total_time;
+
+	sanitization_target_first_forward_time += other.sanitization_target_first_forward_time;
+	sanitization_reference_first_forward_time += other.sanitization_reference_first_forward_time;
+	sanitization_length_issue_check_time += other.sanitization_length_issue_check_time;
+	sanitization_length_backward_time += other.sanitization_length_backward_time;
+	sanitization_length_patch_extraction_total_time += other.sanitization_length_patch_extraction_total_time;
+	sanitization_patch_backward_time += other.sanitization_patch_backward_time;
+	sanitization_comparison_time += other.sanitization_comparison_time;
+	sanitization_patch_extraction_total_time += other.sanitization_patch_extraction_total_time;
+}
+
 void PerfInfo::calculate_total_validation_extraction_time() {
 	validation_patch_extraction_total_time = validation_target_backward_time + validation_reference_backward_time + validation_comparison_time;
 }
@@ -180,6 +204,9 @@ void PerfInfo::print_operations_info() {
 
 	cout << endl <<"\t Stranger Automaton Operations Info" << endl;
 	cout << "\t intersection : #" << num_of_intersect << " : " << intersect_total_time.total_microseconds() << endl;
+	cout << "\t intersection check : #" << num_of_intersect_check << " : " << intersect_check_total_time.total_microseconds() << endl;
+	cout << "\t inclusion check : #" << num_of_inclusion_check << " : " << inclusion_check_total_time.total_microseconds() << endl;
+	cout << "\t equivalence check : #" << num_of_equivalence_check << " : " << equivalence_check_total_time.total_microseconds() << endl;
 	cout << "\t union : #" << num_of_union << " : " << union_total_time.total_microseconds() << endl;
 	cout << "\t closure : #" << num_of_closure << " : " << closure_total_time.total_microseconds() << endl;
 	cout << "\t complement : #" << num_of_complement << " : " << complement_total_time.total_microseconds() << endl;
@@ -190,6 +217,7 @@ void PerfInfo::print_operations_info() {
 	cout << "\t const_pre_concat : #" << num_of_const_pre_concat << " : " << const_pre_concat_total_time.total_microseconds() << endl;
 	cout << "\t replace : #" << num_of_replace << " : " << replace_total_time.total_microseconds() << endl;
 	cout << "\t pre_replace : #" << num_of_pre_replace << " : " << pre_replace_total_time.total_microseconds() << endl;
+	cout << "\t minimize : #" << num_of_minimize << " : " << minimize_total_time.total_microseconds() << endl;
 	cout << "\t vlab_restrict : #" << number_of_vlab_restrict << " : " << vlab_restrict_total_time.total_microseconds() << endl;
 	cout << "\t pre_vlab_restrict : #" << number_of_pre_vlab_restrict << " : " << pre_vlab_restrict_total_time.total_microseconds() << endl;
 	cout << "\t addslahses : #" << number_of_addslashes << " : " << addslashes_total_time.total_microseconds() << endl;
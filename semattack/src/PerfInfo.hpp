@@ -32,13 +32,19 @@
 class PerfInfo {
 public:
 
-    // Make PerfInfo a singleton
+    // Shared instance, tasks running in parallel keep their own and add
+    // them to it once finished
     static PerfInfo & getInstance() {
         static PerfInfo instance;
         return instance;
     }
 
+    PerfInfo();
+    virtual ~PerfInfo();
+
 	 void reset();
+	 // Adds the validation and sanitization extraction times of other
+	 void add_extraction_times(const PerfInfo& other);
 
 	 boost::posix_time::ptime current_time();
 
@@ -72,6 +78,9 @@ public:
 //    concat, union, intersection, closure, replace...
 
 	 boost::posix_time::time_duration intersect_total_time;
+	 boost::posix_time::time_duration intersect_check_total_time;
+	 boost::posix_time::time_duration inclusion_check_total_time;
+	 boost::posix_time::time_duration equivalence_check_total_time;
          boost::posix_time::time_duration product_total_time;
 	 boost::posix_time::time_duration union_total_time;
 	 boost::posix_time::time_duration closure_total_time;
@@ -83,11 +92,15 @@ public:
 	 boost::posix_time::time_duration const_pre_concat_total_time;
 	 boost::posix_time::time_duration replace_total_time;
 	 boost::posix_time::time_duration pre_replace_total_time;
+	 boost::posix_time::time_duration minimize_total_time;
 
 	 boost::posix_time::time_duration performance_time;
 
 
 	 unsigned int num_of_intersect;
+	 unsigned int num_of_intersect_check;
+	 unsigned int num_of_inclusion_check;
+	 unsigned int num_of_equivalence_check;
     	 unsigned int num_of_product;
 	 unsigned int num_of_union;
 	 unsigned int num_of_closure;
@@ -99,6 +112,7 @@ public:
 	 unsigned int num_of_const_pre_concat;
 	 unsigned int num_of_replace;
 	 unsigned int num_of_pre_replace;
+	 unsigned int num_of_minimize;
 
 
 //    Composed string operations
@@ -165,11 +179,7 @@ public:
     unsigned int number_of_pre_encodetextfragment;
     unsigned int number_of_escapehtmltags;
     unsigned int number_of_pre_escapehtmltags;
-protected:
-    virtual ~PerfInfo();
-
 private:
-    PerfInfo();
     PerfInfo(PerfInfo const &)  = delete;
     void operator=(PerfInfo const &) = delete;
 
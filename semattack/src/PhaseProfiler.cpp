@@ -0,0 +1,214 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * PhaseProfiler.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "PhaseProfiler.hpp"
+#include "StringBuilder.hpp"
+
+#include <time.h>
+
+#include <iomanip>
+#include <sstream>
+
+const std::vector<std::string> PhaseProfiler::phases = {
+  "walk", "parse", "init", "forward", "alphabet", "groups", "backward", "payload", "write"
+};
+
+PhaseProfiler::Scope::Scope(PhaseProfiler& profiler, const std::string& file, const std::string& phase,
+                            const std::string& detail)
+  : m_profiler(profiler)
+  , m_file()
+  , m_phase()
+  , m_detail()
+  , m_start()
+  , m_cpu_start(0.0)
+{
+  if (m_profiler.isEnabled()) {
+    m_file = file;
+    m_phase = phase;
+    m_detail = detail;
+    m_start = Clock::now();
+    m_cpu_start = threadCpuTime();
+  }
+}
+
+PhaseProfiler::Scope::~Scope()
+{
+  m_profiler.addPhase(m_file, m_phase, m_start, m_cpu_start, m_detail);
+}
+
+PhaseProfiler::PhaseProfiler()
+  : m_enabled(false)
+  , m_start(Clock::now())
+  , m_queued(0)
+  , m_files()
+  , m_events()
+  , m_threads()
+  , m_mutex()
+{
+}
+
+PhaseProfiler::~PhaseProfiler()
+{
+}
+
+double PhaseProfiler::threadCpuTime()
+{
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return 0.0;
+  }
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+double PhaseProfiler::toTraceTime(Clock::time_point t) const
+{
+  return std::chrono::duration<double, std::micro>(t - m_start).count();
+}
+
+int PhaseProfiler::getThread()
+{
+  auto iter = m_threads.insert(std::make_pair(std::this_thread::get_id(), (int) m_threads.size() + 1));
+  return iter.first->second;
+}
+
+std::unique_lock<std::mutex> PhaseProfiler::lock(std::mutex& mutex, const std::string& file)
+{
+  if (!m_enabled) {
+    return std::unique_lock<std::mutex>(mutex);
+  }
+  Clock::time_point start = Clock::now();
+  std::unique_lock<std::mutex> retMe(mutex);
+  Clock::time_point end = Clock::now();
+
+  const std::lock_guard<std::mutex> guard(m_mutex);
+  double wait = std::chrono::duration<double, std::micro>(end - start).count();
+  m_files[file].lock_wait_us += wait;
+  m_events.push_back({ "lock wait", file, 'X', getThread(), toTraceTime(start), wait, 0 });
+  return retMe;
+}
+
+void PhaseProfiler::addPhase(const std::string& file, const std::string& phase, Clock::time_point start,
+                             double cpu_start, const std::string& detail)
+{
+  if (!m_enabled) {
+    return;
+  }
+  double cpu_us = threadCpuTime() - cpu_start;
+  Clock::time_point end = Clock::now();
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  double wall = std::chrono::duration<double, std::micro>(end - start).count();
+  if (!file.empty()) {
+    FileProfile& profile = m_files[file];
+    profile.wall_us[phase] += wall;
+    profile.cpu_us[phase] += cpu_us;
+  }
+  std::string name = detail.empty() ? phase : phase + " " + detail;
+  m_events.push_back({ name, file, 'X', getThread(), toTraceTime(start), wall, 0 });
+}
+
+void PhaseProfiler::addCounter(const std::string& name, long value)
+{
+  m_events.push_back({ name, "", 'C', 0, toTraceTime(Clock::now()), 0.0, value });
+}
+
+void PhaseProfiler::taskQueued()
+{
+  if (m_enabled) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    addCounter("pool queue", ++m_queued);
+  }
+}
+
+void PhaseProfiler::taskStarted()
+{
+  if (m_enabled) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    addCounter("pool queue", --m_queued);
+  }
+}
+
+void PhaseProfiler::addAutomaton(const std::string& file, const StrangerAutomaton* automaton)
+{
+  if (!m_enabled || (automaton == nullptr) || automaton->isNull()) {
+    return;
+  }
+  int states = automaton->get_num_of_states();
+  unsigned nodes = automaton->get_num_of_bdd_nodes();
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  FileProfile& profile = m_files[file];
+  if (states > profile.peak_states) {
+    profile.peak_states = states;
+  }
+  if (nodes > profile.peak_bdd_nodes) {
+    profile.peak_bdd_nodes = nodes;
+  }
+}
+
+void PhaseProfiler::writeCsv(std::ostream& os) const
+{
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  os << "file";
+  for (const auto& phase : phases) {
+    os << ", " << phase << "_wall_ms, " << phase << "_cpu_ms";
+  }
+  os << ", total_wall_ms, total_cpu_ms, lock_wait_ms, peak_states, peak_bdd_nodes" << std::endl;
+  os << std::fixed << std::setprecision(3);
+  for (const auto& entry : m_files) {
+    const FileProfile& profile = entry.second;
+    double total_wall = 0.0;
+    double total_cpu = 0.0;
+    os << csv_escape(entry.first);
+    for (const auto& phase : phases) {
+      auto wall = profile.wall_us.find(phase);
+      auto cpu = profile.cpu_us.find(phase);
+      double wall_us = (wall != profile.wall_us.end()) ? wall->second : 0.0;
+      double cpu_us = (cpu != profile.cpu_us.end()) ? cpu->second : 0.0;
+      total_wall += wall_us;
+      total_cpu += cpu_us;
+      os << ", " << wall_us / 1e3 << ", " << cpu_us / 1e3;
+    }
+    os << ", " << total_wall / 1e3 << ", " << total_cpu / 1e3
+       << ", " << profile.lock_wait_us / 1e3
+       << ", " << profile.peak_states << ", " << profile.peak_bdd_nodes << std::endl;
+  }
+}
+
+void PhaseProfiler::writeTrace(std::ostream& os) const
+{
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+  os << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"multiattack\"}}";
+  for (const auto& event : m_events) {
+    os << "," << std::endl << "{\"name\": \"" << json_escape(event.name) << "\", \"ph\": \"" << event.type
+       << "\", \"pid\": 1, \"tid\": " << event.thread << ", \"ts\": " << event.start_us;
+    if (event.type == 'C') {
+      os << ", \"args\": {\"depth\": " << event.value << "}}";
+    } else {
+      os << ", \"dur\": " << event.duration_us
+         << ", \"args\": {\"file\": \"" << json_escape(event.file) << "\"}}";
+    }
+  }
+  os << std::endl << "]}" << std::endl;
+}
@@ -0,0 +1,135 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * PhaseProfiler.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef PHASE_PROFILER_HPP_
+#define PHASE_PROFILER_HPP_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "StrangerAutomaton.hpp"
+
+// Records where the time of a multiattack run goes: wall and CPU time of
+// every phase per depgraph, time spent waiting for the results lock, the
+// number of tasks waiting in the thread pool and the largest automata of
+// each depgraph. All methods are thread safe and do nothing unless the
+// profiler is enabled.
+class PhaseProfiler {
+
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  // Times one phase from construction to destruction on the current thread
+  class Scope {
+  public:
+    // The phase name is used to sum up the CSV columns, detail is added to
+    // the name of the trace event (e.g. the attack context)
+    Scope(PhaseProfiler& profiler, const std::string& file, const std::string& phase,
+          const std::string& detail = "");
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    PhaseProfiler& m_profiler;
+    std::string m_file;
+    std::string m_phase;
+    std::string m_detail;
+    Clock::time_point m_start;
+    double m_cpu_start;
+  };
+
+  PhaseProfiler();
+  virtual ~PhaseProfiler();
+
+  void setEnabled(bool enabled) { m_enabled = enabled; }
+  bool isEnabled() const { return m_enabled; }
+
+  // Locks the mutex and records the time spent waiting for it
+  std::unique_lock<std::mutex> lock(std::mutex& mutex, const std::string& file);
+
+  // Records a phase which started at start with the thread CPU time cpu_start
+  // and ends now, an empty file only adds it to the trace
+  void addPhase(const std::string& file, const std::string& phase, Clock::time_point start,
+                double cpu_start, const std::string& detail = "");
+
+  // A task was posted to / taken from the thread pool
+  void taskQueued();
+  void taskStarted();
+
+  // Keeps the largest number of states and BDD nodes seen for the file
+  void addAutomaton(const std::string& file, const StrangerAutomaton* automaton);
+
+  // One row per depgraph with the time per phase in milliseconds
+  void writeCsv(std::ostream& os) const;
+  // Chrome trace event format, open with chrome://tracing or Perfetto
+  void writeTrace(std::ostream& os) const;
+
+  // CPU time of the calling thread in microseconds
+  static double threadCpuTime();
+
+  // Phases in the order of the CSV columns
+  static const std::vector<std::string> phases;
+
+private:
+  struct Event {
+    std::string name;
+    std::string file;
+    char type;
+    int thread;
+    double start_us;
+    double duration_us;
+    long value;
+  };
+
+  struct FileProfile {
+    FileProfile() : wall_us(), cpu_us(), lock_wait_us(0.0), peak_states(0), peak_bdd_nodes(0) {}
+    std::map<std::string, double> wall_us;
+    std::map<std::string, double> cpu_us;
+    double lock_wait_us;
+    int peak_states;
+    unsigned peak_bdd_nodes;
+  };
+
+  void addCounter(const std::string& name, long value);
+  double toTraceTime(Clock::time_point t) const;
+  // Small number of the calling thread, assumes m_mutex is held
+  int getThread();
+
+  bool m_enabled;
+  Clock::time_point m_start;
+  long m_queued;
+  std::map<std::string, FileProfile> m_files;
+  std::vector<Event> m_events;
+  std::map<std::thread::id, int> m_threads;
+  mutable std::mutex m_mutex;
+};
+
+#endif /* PHASE_PROFILER_HPP_ */
@@ -43,7 +43,7 @@ using namespace std;
 #define DEBUG_PRINT_FUNC(e) {}
 #endif
 
-int RegExp::id;
+std::atomic<int> RegExp::id(0);
 
 void RegExp::restID()
 {
@@ -29,6 +29,7 @@
 #include "StrangerAutomaton.hpp"
 #include "StringBuilder.hpp"
 
+#include <atomic>
 #include <stdexcept>
 #include <stdint.h>
 
@@ -177,7 +178,8 @@ private:
     bool more();
     char next() /* throws(IllegalArgumentException) */;
     bool check(int flag);
-    static int id;
+    // Shared by the analysis threads
+    static std::atomic<int> id;
 
     bool isShortHand();
     bool isBackreference();
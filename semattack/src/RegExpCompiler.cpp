@@ -0,0 +1,404 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * RegExpCompiler.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "RegExpCompiler.hpp"
+
+#include <algorithm>
+#include <memory>
+
+const std::size_t RegExpCompiler::max_nfa_states = 100000;
+const std::size_t RegExpCompiler::max_dfa_states = 10000;
+
+std::mutex RegExpCompiler::cache_mutex;
+std::map<std::string, StrangerAutomaton*> RegExpCompiler::cache;
+
+RegExpCompiler::RegExpCompiler()
+  : m_states()
+  , m_too_large(false)
+{
+}
+
+RegExpCompiler::~RegExpCompiler()
+{
+}
+
+StrangerAutomaton* RegExpCompiler::compilePattern(const std::string& pattern, int id)
+{
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto iter = cache.find(pattern);
+    if (iter != cache.end()) {
+      return iter->second->clone(id);
+    }
+  }
+
+  // Compile outside of the lock, two threads racing on the same pattern
+  // produce the same automaton and only the first one is kept
+  std::unique_ptr<RegExp> regExp(new RegExp(pattern, RegExp::NONE));
+  std::string regExpStringVal;
+  StrangerAutomaton::debug(stringbuilder() << id <<  ": regExToString = "
+                           << regExp->toStringBuilder(regExpStringVal));
+  RegExpCompiler compiler;
+  StrangerAutomaton* compiled = compiler.compile(regExp.get(), id);
+  if (compiled == nullptr) {
+    StrangerAutomaton::debug(stringbuilder() << id <<  ": falling back to RegExp::toAutomaton");
+    compiled = regExp->toAutomaton();
+  }
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto inserted = cache.insert(std::make_pair(pattern, compiled));
+  if (!inserted.second) {
+    delete compiled;
+  }
+  return inserted.first->second->clone(id);
+}
+
+StrangerAutomaton* RegExpCompiler::compile(RegExp* regExp, int id)
+{
+  m_states.clear();
+  m_too_large = false;
+  Fragment fragment;
+  if (!build(regExp, fragment) || m_too_large) {
+    return nullptr;
+  }
+  return determinize(fragment, id);
+}
+
+int RegExpCompiler::addState()
+{
+  if (m_states.size() >= max_nfa_states) {
+    m_too_large = true;
+  }
+  State state;
+  state.next = -1;
+  m_states.push_back(state);
+  return (int) m_states.size() - 1;
+}
+
+void RegExpCompiler::addEpsilon(int from, int to)
+{
+  m_states[from].epsilon.push_back(to);
+}
+
+RegExpCompiler::Fragment RegExpCompiler::makeChars(const CharSet& chars)
+{
+  Fragment fragment;
+  fragment.start = addState();
+  fragment.end = addState();
+  m_states[fragment.start].chars = chars;
+  m_states[fragment.start].next = fragment.end;
+  return fragment;
+}
+
+RegExpCompiler::Fragment RegExpCompiler::makeEmpty()
+{
+  Fragment fragment;
+  fragment.start = addState();
+  fragment.end = fragment.start;
+  return fragment;
+}
+
+RegExpCompiler::Fragment RegExpCompiler::makeConcatenation(const Fragment& first, const Fragment& second)
+{
+  addEpsilon(first.end, second.start);
+  Fragment fragment;
+  fragment.start = first.start;
+  fragment.end = second.end;
+  return fragment;
+}
+
+RegExpCompiler::Fragment RegExpCompiler::makeUnion(const Fragment& first, const Fragment& second)
+{
+  Fragment fragment;
+  fragment.start = addState();
+  fragment.end = addState();
+  addEpsilon(fragment.start, first.start);
+  addEpsilon(fragment.start, second.start);
+  addEpsilon(first.end, fragment.end);
+  addEpsilon(second.end, fragment.end);
+  return fragment;
+}
+
+RegExpCompiler::Fragment RegExpCompiler::makeOptional(const Fragment& fragment)
+{
+  return makeUnion(fragment, makeEmpty());
+}
+
+RegExpCompiler::Fragment RegExpCompiler::makeStar(const Fragment& fragment)
+{
+  Fragment star;
+  star.start = addState();
+  star.end = addState();
+  addEpsilon(star.start, fragment.start);
+  addEpsilon(star.start, star.end);
+  addEpsilon(fragment.end, fragment.start);
+  addEpsilon(fragment.end, star.end);
+  return star;
+}
+
+const RegExpCompiler::CharSet& RegExpCompiler::getAnyChar()
+{
+  // As dfaDot: every character but the two reserved ones (254 and 255)
+  static const CharSet anyChar = CharSet().set().reset(254).reset(255);
+  return anyChar;
+}
+
+bool RegExpCompiler::getCharSet(const RegExp* regExp, CharSet& chars) const
+{
+  CharSet other;
+  switch (regExp->kind) {
+  case RegExp::REGEXP_CHAR:
+    chars.reset();
+    chars.set((unsigned char) regExp->c);
+    return true;
+  case RegExp::REGEXP_CHAR_RANGE:
+    // Signed, as in dfa_construct_range
+    if (regExp->from > regExp->to) {
+      return false;
+    }
+    chars.reset();
+    for (int c = regExp->from; c <= regExp->to; c++) {
+      chars.set((unsigned char) c);
+    }
+    return true;
+  case RegExp::REGEXP_ANYCHAR:
+    chars = getAnyChar();
+    return true;
+  case RegExp::REGEXP_UNION:
+    if (!getCharSet(regExp->exp1, chars) || !getCharSet(regExp->exp2, other)) {
+      return false;
+    }
+    chars |= other;
+    return true;
+  case RegExp::REGEXP_INTERSECTION:
+    // Negated classes are parsed as the intersection of any character with
+    // the complement of the class
+    if (regExp->exp2->kind == RegExp::REGEXP_COMPLEMENT) {
+      if (!getCharSet(regExp->exp1, chars) || !getCharSet(regExp->exp2->exp1, other)) {
+        return false;
+      }
+      chars &= ~other;
+      return true;
+    }
+    if (!getCharSet(regExp->exp1, chars) || !getCharSet(regExp->exp2, other)) {
+      return false;
+    }
+    chars &= other;
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool RegExpCompiler::build(const RegExp* regExp, Fragment& fragment)
+{
+  if (m_too_large) {
+    return false;
+  }
+  CharSet chars;
+  if (getCharSet(regExp, chars)) {
+    fragment = makeChars(chars);
+    return true;
+  }
+
+  Fragment first, second;
+  switch (regExp->kind) {
+  case RegExp::REGEXP_UNION:
+    if (!build(regExp->exp1, first) || !build(regExp->exp2, second)) {
+      return false;
+    }
+    fragment = makeUnion(first, second);
+    return true;
+  case RegExp::REGEXP_CONCATENATION:
+    if (!build(regExp->exp1, first) || !build(regExp->exp2, second)) {
+      return false;
+    }
+    fragment = makeConcatenation(first, second);
+    return true;
+  case RegExp::REGEXP_OPTIONAL:
+    if (!build(regExp->exp1, first)) {
+      return false;
+    }
+    fragment = makeOptional(first);
+    return true;
+  case RegExp::REGEXP_REPEAT_STAR:
+    if (!build(regExp->exp1, first)) {
+      return false;
+    }
+    fragment = makeStar(first);
+    return true;
+  case RegExp::REGEXP_REPEAT_PLUS:
+    if (!build(regExp->exp1, first) || !build(regExp->exp1, second)) {
+      return false;
+    }
+    fragment = makeConcatenation(first, makeStar(second));
+    return true;
+  case RegExp::REGEXP_REPEAT_MIN:
+    // min copies followed by a star
+    fragment = makeEmpty();
+    for (int i = 0; i < regExp->min; i++) {
+      if (!build(regExp->exp1, first)) {
+        return false;
+      }
+      fragment = makeConcatenation(fragment, first);
+    }
+    if (!build(regExp->exp1, first)) {
+      return false;
+    }
+    fragment = makeConcatenation(fragment, makeStar(first));
+    return true;
+  case RegExp::REGEXP_REPEAT_MINMAX:
+    // toAutomaton gives the empty language for max < min
+    if (regExp->min < 0 || regExp->max < regExp->min) {
+      return false;
+    }
+    fragment = makeEmpty();
+    for (int i = 0; i < regExp->max; i++) {
+      if (!build(regExp->exp1, first)) {
+        return false;
+      }
+      fragment = makeConcatenation(fragment, i < regExp->min ? first : makeOptional(first));
+    }
+    return true;
+  case RegExp::REGEXP_EMPTY:
+    // Matches toAutomaton, which uses the empty string automaton
+    fragment = makeEmpty();
+    return true;
+  case RegExp::REGEXP_STRING:
+    fragment = makeEmpty();
+    for (std::string::const_iterator iter = regExp->s.begin(); iter != regExp->s.end(); ++iter) {
+      chars.reset();
+      chars.set((unsigned char) *iter);
+      fragment = makeConcatenation(fragment, makeChars(chars));
+    }
+    return true;
+  case RegExp::REGEXP_ANYSTRING:
+    fragment = makeStar(makeChars(getAnyChar()));
+    return true;
+  case RegExp::REGEXP_START_ANCHOR:
+  case RegExp::REGEXP_END_ANCHOR:
+    // Anchors are not implemented by toAutomaton either
+    return build(regExp->exp1, fragment);
+  default:
+    return false;
+  }
+}
+
+void RegExpCompiler::closure(std::vector<int>& states) const
+{
+  std::vector<bool> seen(m_states.size(), false);
+  std::vector<int> todo(states);
+  states.clear();
+  while (!todo.empty()) {
+    int state = todo.back();
+    todo.pop_back();
+    if (seen[state]) {
+      continue;
+    }
+    seen[state] = true;
+    states.push_back(state);
+    for (auto next : m_states[state].epsilon) {
+      if (!seen[next]) {
+        todo.push_back(next);
+      }
+    }
+  }
+  std::sort(states.begin(), states.end());
+}
+
+StrangerAutomaton* RegExpCompiler::determinize(const Fragment& fragment, int id)
+{
+  std::map<std::vector<int>, int> index;
+  std::vector<std::vector<int> > subsets;
+  std::vector<transition> transitions;
+  std::string accepting;
+
+  std::vector<int> initial(1, fragment.start);
+  closure(initial);
+  index[initial] = 0;
+  subsets.push_back(initial);
+
+  // Characters which no edge tells apart lead to the same states, so the
+  // subset construction only follows one character per class
+  AlphabetPartition alphabet;
+  for (const auto& state : m_states) {
+    if (state.next >= 0) {
+      alphabet.refine(state.chars);
+    }
+  }
+  std::vector<unsigned char> representatives;
+  for (unsigned int cls = 0; cls < alphabet.getClassCount(); cls++) {
+    representatives.push_back(alphabet.getRepresentative(cls));
+  }
+
+  for (std::size_t current = 0; current < subsets.size(); current++) {
+    // Copy, as subsets grows below
+    std::vector<int> subset = subsets[current];
+    accepting += std::binary_search(subset.begin(), subset.end(), fragment.end) ? '+' : '-';
+
+    std::vector<int> classDests(representatives.size(), -1);
+    for (std::size_t cls = 0; cls < representatives.size(); cls++) {
+      std::vector<int> targets;
+      for (auto state : subset) {
+        if (m_states[state].next >= 0 && m_states[state].chars.test(representatives[cls])) {
+          targets.push_back(m_states[state].next);
+        }
+      }
+      if (targets.empty()) {
+        continue;
+      }
+      closure(targets);
+      auto iter = index.find(targets);
+      if (iter == index.end()) {
+        if (subsets.size() >= max_dfa_states) {
+          return nullptr;
+        }
+        classDests[cls] = (int) subsets.size();
+        index[targets] = classDests[cls];
+        subsets.push_back(targets);
+      } else {
+        classDests[cls] = iter->second;
+      }
+    }
+
+    int previous = -1;
+    for (int c = 0; c < 256; c++) {
+      int dest = classDests[alphabet.getClass((unsigned char) c)];
+      // Extend the previous range if it has the same destination
+      if (dest >= 0 && dest == previous) {
+        transitions.back().last = (unsigned char) c;
+      } else if (dest >= 0) {
+        transition t;
+        t.source = (int) current;
+        t.dest = dest;
+        t.first = (unsigned char) c;
+        t.last = (unsigned char) c;
+        transitions.push_back(t);
+      }
+      previous = dest;
+    }
+  }
+
+  return StrangerAutomaton::makeFromTransitions((int) subsets.size(), transitions, accepting, id);
+}
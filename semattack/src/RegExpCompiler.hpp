@@ -0,0 +1,100 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * RegExpCompiler.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef REGEXP_COMPILER_HPP_
+#define REGEXP_COMPILER_HPP_
+
+#include <bitset>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AlphabetPartition.hpp"
+#include "RegExp.hpp"
+#include "StrangerAutomaton.hpp"
+
+// Compiles a parsed RegExp into one automaton. RegExp::toAutomaton builds and
+// minimizes an automaton for every node of the expression, here the whole
+// expression becomes an NFA with character set labels, which is determinized
+// by subset construction and minimized once. Character classes such as
+// [^<>'"&] are a single edge instead of a union of ~250 automata.
+class RegExpCompiler {
+
+public:
+  typedef std::bitset<256> CharSet;
+
+  RegExpCompiler();
+  virtual ~RegExpCompiler();
+
+  // Returns nullptr if the expression is not supported (intersections and
+  // complements other than negated character classes, named automata,
+  // intervals) or too large, callers then use RegExp::toAutomaton
+  StrangerAutomaton* compile(RegExp* regExp, int id);
+
+  // Automaton of an undelimited pattern, compiled once per process and
+  // shared between threads. The caller owns the returned automaton.
+  static StrangerAutomaton* compilePattern(const std::string& pattern, int id);
+
+  // Upper bounds on the NFA and DFA sizes before falling back
+  static const std::size_t max_nfa_states;
+  static const std::size_t max_dfa_states;
+
+private:
+  struct Fragment {
+    int start;
+    int end;
+  };
+
+  struct State {
+    std::vector<int> epsilon;
+    CharSet chars;
+    int next;
+  };
+
+  int addState();
+  void addEpsilon(int from, int to);
+  Fragment makeChars(const CharSet& chars);
+  Fragment makeEmpty();
+  Fragment makeConcatenation(const Fragment& first, const Fragment& second);
+  Fragment makeUnion(const Fragment& first, const Fragment& second);
+  Fragment makeOptional(const Fragment& fragment);
+  Fragment makeStar(const Fragment& fragment);
+
+  // False if the expression is not a single character set
+  bool getCharSet(const RegExp* regExp, CharSet& chars) const;
+  bool build(const RegExp* regExp, Fragment& fragment);
+  void closure(std::vector<int>& states) const;
+  StrangerAutomaton* determinize(const Fragment& fragment, int id);
+
+  static const CharSet& getAnyChar();
+
+  std::vector<State> m_states;
+  bool m_too_large;
+
+  static std::mutex cache_mutex;
+  static std::map<std::string, StrangerAutomaton*> cache;
+};
+
+#endif /* REGEXP_COMPILER_HPP_ */
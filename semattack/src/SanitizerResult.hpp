@@ -0,0 +1,77 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * SanitizerResult.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef SANITIZER_RESULT_HPP_
+#define SANITIZER_RESULT_HPP_
+
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "AttackContext.hpp"
+#include "exceptions/AnalysisError.hpp"
+
+// The analysis outcome for one unique sanitizer, as far as it is needed to
+// group sanitizers and to write the reports. Implemented by the live
+// CombinedAnalysisResult and by SanitizerRecord, which is read back from
+// the partial results of a shard.
+class SanitizerResult {
+
+public:
+  virtual ~SanitizerResult() {}
+
+  virtual std::string getFileName() const = 0;
+  virtual int getCountWithDuplicates() const = 0;
+  virtual int getCount() const = 0;
+  virtual bool isDone() const = 0;
+
+  // Forward analysis status
+  virtual bool isErrored() const = 0;
+  virtual AnalysisError getError() const = 0;
+
+  virtual bool isExploitSuccessful() const = 0;
+  virtual AttackContext getSinkContext() const = 0;
+  bool isSinkContext(const AttackContext& context) const { return (context == getSinkContext()); }
+
+  virtual bool isFilterSuccessful(const AttackContext& context) const = 0;
+  virtual bool isFilterContained(const AttackContext& context) const = 0;
+
+  virtual bool hasAtLeastOnePayload() const = 0;
+  virtual bool hasAtLeastOneVulnerablePayload() const = 0;
+  virtual bool hasAllErroredPayloads() const = 0;
+  virtual bool hasAtLeastOneBypass() const = 0;
+
+  virtual std::set<std::string> getUniqueDomains() const = 0;
+  virtual std::set<std::string> getUniqueDomainsWithPayload() const = 0;
+  virtual std::set<std::string> getVulnerableDomainsWithPayload() const = 0;
+  virtual std::set<int> getUniqueInjectionPoints() const = 0;
+
+  virtual void printHeader(std::ostream& os, const std::vector<AttackContext>& contexts) const = 0;
+  virtual void printResult(std::ostream& os, bool printHeader, const std::vector<AttackContext>& contexts) const = 0;
+  virtual void printGeneratedPayloads(std::ostream& os) const = 0;
+  virtual void printUnmatchedUuids(std::ostream& os) const = 0;
+};
+
+#endif /* SANITIZER_RESULT_HPP_ */
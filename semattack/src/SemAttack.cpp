@@ -38,15 +38,19 @@ CombinedAnalysisResult::CombinedAnalysisResult(const fs::path& target_dep_graph_
                                                DepGraph target_dep_graph_,
                                                const std::string& input_field_name,
                                                StrangerAutomaton* automaton)
-  : m_fwAnalysis(target_dep_graph_file_name, input_field_name, target_dep_graph_, automaton)
-  , m_bwAnalysisMap()
-  , m_inputfile(target_dep_graph_file_name)
+  : m_inputfile(target_dep_graph_file_name)
   , m_input_name(input_field_name)
-  , m_metadata()
-  , m_duplicate_count(1)
   , m_done(false)
+  , m_fwAnalysis(target_dep_graph_file_name, input_field_name, target_dep_graph_, automaton)
+  , m_bwAnalysisMap()
+  , m_metadata()
+  , m_finding_metadata_map()
   , m_metadataAnalysisMap()
   , m_stringAnalysisMap()
+  , m_atLeastOnePayloadVulnerable(false)
+  , m_allPayloadsVulnerable(true)
+  , m_allPayloadsErrored(true)
+  , m_duplicate_count(1)
 {
   m_metadata.push_back(target_dep_graph_.get_metadata());
 }
@@ -102,9 +106,11 @@ BackwardAnalysisResult* CombinedAnalysisResult::doBackwardAnalysisForPayload(con
   } else {
     std::cout << "Ouput: " << output_dir.string() <<": Doing backward analysis for payload: " << payload << std::endl;
     try {
-      StrangerAutomaton* a = StrangerAutomaton::makeContainsString(payload);
+      // The concrete candidate keeps the original characters
+      StrangerAutomaton* a = StrangerAutomaton::makeContainsString(m_fwAnalysis.compress(payload));
       //a->toDotAscii(1);
       bw = new BackwardAnalysisResult(m_fwAnalysis, a, payload);
+      bw->setCandidate(payload);
       bw->doAnalysis(computePreImage, singletonIntersection, attack_forward);
       if (bw && outputDotfiles) {
         bw->writeResultsToFile(output_dir);
@@ -120,55 +126,45 @@ BackwardAnalysisResult* CombinedAnalysisResult::doBackwardAnalysisForPayload(con
   return bw;
 }
 
-void CombinedAnalysisResult::doMetadataSpecificAnalysis(const fs::path& output_dir, bool computePreImage, bool singletonIntersection, bool outputDotfiles, bool attack_forward)
+std::vector<std::string> CombinedAnalysisResult::getPayloads(const Metadata& metadata)
 {
-  // Create a specific payload for each metadata entry
-  unsigned int i = 0;
   static std::vector<std::string> functions = { "taintfoxLog(\"xss\")", "taintfoxLog('xss')", "taintfoxLog`xss`" };
   static std::vector<bool> use_solidus = { false, true };
+  std::vector<std::string> payloads;
+  for (auto& f : functions) {
+    for (bool b : use_solidus) {
+      // Normal and attribute payload
+      payloads.push_back(metadata.generate_exploit_from_scratch(f, b));
+      payloads.push_back(metadata.generate_attribute_exploit_from_scratch(f, b));
+    }
+  }
+  return payloads;
+}
+
+void CombinedAnalysisResult::doMetadataSpecificAnalysis(const fs::path& output_dir, bool computePreImage, bool singletonIntersection, bool outputDotfiles, bool attack_forward)
+{
+  // Create a specific payload for each metadata entry
   const std::string file = getFileName();
-  m_atLeastOnePayloadVulnerable = false;
-  m_allPayloadsVulnerable = true;
-  m_allPayloadsErrored = true;
   for (const Metadata &m : m_metadata) {
+    if (m_metadataAnalysisMap.find(&m) != m_metadataAnalysisMap.end()) {
+      continue;
+    }
     std::vector<BackwardAnalysisResult*> bws;
-    for (auto& f : functions) {
-      for (bool b : use_solidus) {
-        BackwardAnalysisResult* bw = nullptr;
-        // Normal payload
-        std::string payload = m.generate_exploit_from_scratch(f, b);
-        bw = doBackwardAnalysisForPayload(payload, output_dir, computePreImage, singletonIntersection, outputDotfiles, attack_forward);
-        if (bw != nullptr) {
-          m_atLeastOnePayloadVulnerable |= bw->isVulnerable();
-          if (!bw->isVulnerable()) {
-            m_allPayloadsVulnerable = false;
-          } else {
-            std::cout << file << ": " << payload << " --> " << bw->get_preimage_example() << std::endl;
-          }
-          if (!bw->isErrored()) {
-            m_allPayloadsErrored = false;
-          } else {
-            std::cout << "doMetadataSpecificAnalysis::ERROR computing pre-image for payload:" << payload << " file: " << file << std::endl;
-          }
-          bws.push_back(bw);
+    for (const std::string& payload : getPayloads(m)) {
+      BackwardAnalysisResult* bw = doBackwardAnalysisForPayload(payload, output_dir, computePreImage, singletonIntersection, outputDotfiles, attack_forward);
+      if (bw != nullptr) {
+        m_atLeastOnePayloadVulnerable |= bw->isVulnerable();
+        if (!bw->isVulnerable()) {
+          m_allPayloadsVulnerable = false;
+        } else {
+          std::cout << file << ": " << payload << " --> " << bw->get_preimage_example() << std::endl;
         }
-        // Attribute payload
-        std::string attr_payload = m.generate_attribute_exploit_from_scratch(f, b);
-        bw = doBackwardAnalysisForPayload(attr_payload, output_dir, computePreImage, singletonIntersection, outputDotfiles, attack_forward);
-        if (bw != nullptr) {
-          m_atLeastOnePayloadVulnerable |= bw->isVulnerable();
-          if (!bw->isVulnerable()) {
-            m_allPayloadsVulnerable = false;
-          } else {
-            std::cout << file << ": " << attr_payload << " --> " << bw->get_preimage_example() << std::endl;
-          }
-          if (!bw->isErrored()) {
-            m_allPayloadsErrored = false;
-          } else {
-            std::cout << "doMetadataSpecificAnalysis::ERROR computing pre-image for payload:" << payload << " file: " << file << std::endl;
-          }
-          bws.push_back(bw);
+        if (!bw->isErrored()) {
+          m_allPayloadsErrored = false;
+        } else {
+          std::cout << "doMetadataSpecificAnalysis::ERROR computing pre-image for payload:" << payload << " file: " << file << std::endl;
         }
+        bws.push_back(bw);
       }
     }
     // Add to map
@@ -176,6 +172,31 @@ void CombinedAnalysisResult::doMetadataSpecificAnalysis(const fs::path& output_d
   }
 }
 
+bool CombinedAnalysisResult::needsMetadataAnalysis() const
+{
+  for (const Metadata &m : m_metadata) {
+    if (m_metadataAnalysisMap.find(&m) == m_metadataAnalysisMap.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CombinedAnalysisResult::needsForwardAnalysisForMetadata() const
+{
+  for (const Metadata &m : m_metadata) {
+    if (m_metadataAnalysisMap.find(&m) != m_metadataAnalysisMap.end()) {
+      continue;
+    }
+    for (const std::string& payload : getPayloads(m)) {
+      if (!payload.empty() && (m_stringAnalysisMap.find(payload) == m_stringAnalysisMap.end())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void CombinedAnalysisResult::printHeader(std::ostream& os, const std::vector<AttackContext>& contexts) const
 {
   for (auto c : contexts) {
@@ -249,7 +270,7 @@ void CombinedAnalysisResult::printUnmatchedUuids(std::ostream& os) const
 {
   if (!getFwAnalysis().isErrored()) {
     if (!hasAtLeastOnePayload()) {
-      for (auto& m : m_metadata) {
+      for (const Metadata &m : m_metadata) {
         os << m.get_uuid() << std::endl;
       }
     }
@@ -287,7 +308,7 @@ std::set<std::string> CombinedAnalysisResult::getUniqueDomains() const
   std::set<std::string> s;
 
   if (!getFwAnalysis().isErrored()) {
-      for (auto m : m_metadata) {
+      for (const Metadata &m : m_metadata) {
         s.insert(m.get_base_domain());
       }
   }
@@ -299,7 +320,7 @@ std::set<std::string> CombinedAnalysisResult::getUniqueDomainsWithPayload() cons
   std::set<std::string> s;
 
   if (!getFwAnalysis().isErrored()) {
-    for (auto m : m_metadata) {
+    for (const Metadata &m : m_metadata) {
       if (m.has_valid_exploit()) {
         s.insert(m.get_base_domain());
       }
@@ -335,7 +356,7 @@ std::set<int> CombinedAnalysisResult::getUniqueInjectionPoints() const
 
   // Depending on how the metadata is added in addMetadata, the
   // domains might be already unique, but loop anyway in case this changes
-  for (auto m : m_metadata) {
+  for (const Metadata &m : m_metadata) {
     ids.insert(m.get_twenty_five_million_flows_id());
   }
   return ids;
@@ -365,10 +386,26 @@ bool CombinedAnalysisResult::isFilterContained(const AttackContext& context) con
   return success;
 }
 
+void CombinedAnalysisResult::releaseAutomata()
+{
+  getFwAnalysis().releaseAutomata();
+  // The verdicts and examples of the backward analyses are kept for the
+  // reports, their automata are usually freed already unless they failed
+  for (auto bwResult : m_bwAnalysisMap) {
+    bwResult.second->finishAnalysis();
+  }
+  for (auto bwResult : m_stringAnalysisMap) {
+    if (bwResult.second != nullptr) {
+      bwResult.second->finishAnalysis();
+    }
+  }
+  m_done = true;
+}
+
 void CombinedAnalysisResult::finishAnalysis()
 {
+  releaseAutomata();
   getFwAnalysis().finishAnalysis();
-  m_done = true;
 }
 
 BackwardAnalysisResult::BackwardAnalysisResult(
@@ -384,6 +421,9 @@ BackwardAnalysisResult::BackwardAnalysisResult(
   , m_isErrored(true)
   , m_isSafe(false)
   , m_isContained(false)
+  , m_preimage_confirmed(false)
+  , m_post_attack_concrete(false)
+  , m_candidate()
 {
 }
 
@@ -396,9 +436,13 @@ BackwardAnalysisResult::BackwardAnalysisResult(
   , m_intersection(nullptr)
   , m_preimage(nullptr)
   , m_post_attack(nullptr)
+  , m_error(AnalysisError::None)
   , m_isErrored(true)
   , m_isSafe(false)
   , m_isContained(false)
+  , m_preimage_confirmed(false)
+  , m_post_attack_concrete(false)
+  , m_candidate()
 {
 }
 
@@ -410,32 +454,66 @@ BackwardAnalysisResult::~BackwardAnalysisResult()
 void BackwardAnalysisResult::doAnalysis(bool computePreImage, bool singletonIntersection, bool doPostAttack)
 {
   const StrangerAutomaton* postImage = m_fwResult.getPostImage();
-  m_intersection = this->getAttack()->computeAttackPatternOverlap(postImage, m_attack);
   m_isErrored = true;
   m_isSafe = false;
   m_isContained = false;
-  if ((m_intersection) && (!m_intersection->isNull())) {
+  m_preimage_confirmed = false;
+  m_post_attack_concrete = false;
+  if ((postImage) && (!postImage->isNull()) && (m_attack) && (!m_attack->isNull())) {
+    std::string example;
+    if (!m_candidate.empty() && confirmBypass(m_candidate, example)) {
+      // The candidate is a bypass by itself, so neither the intersection
+      // nor the pre-image automaton is needed for the examples
+      m_isErrored = false;
+      m_isContained = postImage->checkInclusion(m_attack);
+      m_intersection_example = example;
+      m_preimage_example = computePreImage ? m_candidate : "N/A";
+      m_preimage_confirmed = computePreImage;
+      return;
+    }
+    // Search the product on the fly, most pairs are safe and the
+    // intersection automaton is never needed for them
+    bool overlap = this->getAttack()->checkAttackPatternOverlap(postImage, m_attack, example);
     m_isErrored = false;
+    // As for the intersection automaton, an overlap only containing the empty
+    // string is considered safe (the shortest example is empty in that case)
+    m_isSafe = !overlap || example.empty();
     if (this->isVulnerable()) {
       // Only compute BW analysis if vulnerable
-      m_isSafe = false;
       m_isContained = postImage->checkInclusion(m_attack);
       // Cache examples for printing
-      m_intersection_example = m_intersection->generateSatisfyingExample();
+      m_intersection_example = example;
       if (computePreImage) {
         try {
+          // The intersection is only materialized for the pre-image
+          m_intersection = this->getAttack()->computeAttackPatternOverlap(postImage, m_attack);
+          if ((m_intersection == nullptr) || m_intersection->isNull()) {
+            throw StrangerException(AnalysisError::MonaException, "Null DFA pointer returned from MONA");
+          }
+          // Contexts with the same intersection share the backward pass
+          const StrangerAutomaton* preimage = m_fwResult.findPreImage(m_intersection, m_preimage_example);
           AnalysisResult result;
-          if (singletonIntersection) {
-            StrangerAutomaton* singleton = m_intersection->generateSatisfyingSingleton();
-            result = this->getAttack()->computePreImage(singleton, m_fwResult.getFwAnalysisResult());
-            delete singleton;
-          } else {
-            result = this->getAttack()->computePreImage(m_intersection, m_fwResult.getFwAnalysisResult());
+          if (preimage == nullptr) {
+            if (singletonIntersection) {
+              StrangerAutomaton* singleton = m_intersection->generateSatisfyingSingleton();
+              result = this->getAttack()->computePreImage(singleton, m_fwResult.getFwAnalysisResult());
+              delete singleton;
+            } else {
+              result = this->getAttack()->computePreImage(m_intersection, m_fwResult.getFwAnalysisResult());
+            }
+            preimage = this->getAttack()->getPreImage(result);
+            if (preimage != nullptr) {
+              m_preimage_example = preimage->generateSatisfyingExample();
+              m_fwResult.addPreImage(m_intersection, preimage, m_preimage_example);
+            }
           }
-          const StrangerAutomaton* preimage = this->getAttack()->getPreImage(result);
           if (preimage != nullptr) {
-            m_preimage = new StrangerAutomaton(this->getAttack()->getPreImage(result));
-            m_preimage_example = m_preimage->generateSatisfyingExample();
+            m_preimage = new StrangerAutomaton(preimage);
+            std::string output;
+            m_preimage_confirmed = confirmBypass(m_preimage_example, output);
+            if (!m_preimage_confirmed && DEBUG_ENABLED_RESULTS != 0) {
+              DEBUG_MESSAGE("Pre-image example not confirmed concretely for: " + m_name);
+            }
           } else {
             m_preimage = nullptr;
             m_preimage_example = "ERROR";
@@ -452,8 +530,16 @@ void BackwardAnalysisResult::doAnalysis(bool computePreImage, bool singletonInte
         m_preimage_example = "N/A";
       }
     } else {
-      m_isSafe = true;
       if (doPostAttack) {
+        // Running an attack string through the depgraph is enough for the
+        // example, the symbolic analysis is only done if that fails. The
+        // attack post image then stays null.
+        ConcreteInterpreter::Values outputs;
+        if (evaluateConcrete(m_attack->generateSatisfyingExample(), outputs)) {
+          m_post_attack_example = *outputs.begin();
+          m_post_attack_concrete = true;
+          return;
+        }
         // Otherwise see what happens if attack pattern is used for a forward analysis
         try {
           AnalysisResult result = this->getAttack()->computeTargetFWAnalysis(m_attack);
@@ -475,6 +561,32 @@ void BackwardAnalysisResult::doAnalysis(bool computePreImage, bool singletonInte
   }
 }
 
+bool BackwardAnalysisResult::evaluateConcrete(const std::string& input, ConcreteInterpreter::Values& outputs) const
+{
+  try {
+    outputs = this->getAttack()->evaluate(input);
+  } catch (std::exception const &e) {
+    // Any failure of the interpreter falls back to the symbolic analysis
+    outputs.clear();
+  }
+  return !outputs.empty();
+}
+
+bool BackwardAnalysisResult::confirmBypass(const std::string& input, std::string& output) const
+{
+  ConcreteInterpreter::Values outputs;
+  if (evaluateConcrete(input, outputs)) {
+    for (const auto& value : outputs) {
+      // As for the intersection, the empty string is not an attack
+      if (!value.empty() && m_attack->checkMembership(value)) {
+        output = value;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void BackwardAnalysisResult::finishAnalysis()
 {
   if (m_preimage) {
@@ -585,26 +697,25 @@ ForwardAnalysisResult::ForwardAnalysisResult(const fs::path& target_dep_graph_fi
   : m_attack(new SemAttack(target_dep_graph_file_name, target_dep_graph_, input_field_name))
   , m_result()
   , m_error(AnalysisError::None)
+  , m_isErrored(true)
   , m_input(automaton->clone())
+  , m_alphabet()
   , m_postImage(nullptr)
+  , m_preimages()
+  , m_preimage_reuses(0)
 {
 }
 
 ForwardAnalysisResult::~ForwardAnalysisResult()
 {
   finishAnalysis();
-  delete m_input;
-  if (m_postImage) {
-    delete m_postImage;
-    m_postImage = nullptr;
-  }
+  releasePostImage();
 }
 void ForwardAnalysisResult::doAnalysis(bool doConcat)
 {
   try {
     m_result = m_attack->computeTargetFWAnalysis(m_input, doConcat);
   } catch (StrangerException const &e) {
-    m_postImage = nullptr;
     m_error = e.getError();
     throw;
   } catch (...) {
@@ -614,13 +725,31 @@ void ForwardAnalysisResult::doAnalysis(bool doConcat)
 
   const StrangerAutomaton* post = this->getAttack()->getPostImage(m_result);
   if (post) {
-    m_postImage = post->clone();
+    // A deep copy, the post-image is compared with others by other threads.
+    // When the analysis is run again, the first copy may be in use already.
+    if (m_postImage == nullptr) {
+      m_postImage = post->clone();
+    }
+    m_isErrored = false;
   } else {
     m_error = AnalysisError::MonaException;
-    m_postImage = nullptr;
   }
 }
 
+void ForwardAnalysisResult::compressAlphabet(const AlphabetPartition& alphabet)
+{
+  m_alphabet.reset(new AlphabetPartition(alphabet));
+  std::unique_ptr<StrangerAutomaton> representatives(alphabet.makeRepresentativeStrings(m_input->getID()));
+  StrangerAutomaton* restricted = m_input->intersect(representatives.get());
+  delete m_input;
+  m_input = restricted;
+}
+
+std::string ForwardAnalysisResult::compress(const std::string& s) const
+{
+  return m_alphabet ? m_alphabet->compress(s) : s;
+}
+
 void ForwardAnalysisResult::writeResultsToFile(const fs::path& dir) const
 {
   fs::create_directories(dir);
@@ -633,34 +762,102 @@ void ForwardAnalysisResult::writeResultsToFile(const fs::path& dir) const
   this->getPostImage()->exportToFile(output_file_bdd.string());
 }
 
+std::size_t ForwardAnalysisResult::getMemoryEstimate() const
+{
+  std::size_t total = m_result.get_memory_estimate();
+  if (m_input) {
+    total += m_input->get_memory_estimate();
+  }
+  if (m_postImage) {
+    total += m_postImage->get_memory_estimate();
+  }
+  for (const auto& entry : m_preimages) {
+    total += entry.intersection->get_memory_estimate() + entry.preimage->get_memory_estimate();
+  }
+  return total;
+}
+
+const StrangerAutomaton* ForwardAnalysisResult::findPreImage(const StrangerAutomaton* intersection, std::string& example) const
+{
+  AutomatonFingerprint fingerprint(intersection);
+  for (const auto& entry : m_preimages) {
+    if (entry.fingerprint.mayEqual(fingerprint) &&
+        (entry.fingerprint.mustEqual(fingerprint) || intersection->equals(entry.intersection.get()))) {
+      example = entry.example;
+      m_preimage_reuses++;
+      return entry.preimage.get();
+    }
+  }
+  return nullptr;
+}
+
+void ForwardAnalysisResult::addPreImage(const StrangerAutomaton* intersection, const StrangerAutomaton* preimage,
+                                        const std::string& example)
+{
+  PreImageEntry entry;
+  entry.fingerprint = AutomatonFingerprint(intersection);
+  entry.intersection.reset(intersection->share());
+  entry.preimage.reset(preimage->share());
+  entry.example = example;
+  m_preimages.push_back(std::move(entry));
+}
+
+void ForwardAnalysisResult::releaseAutomata() {
+  m_result.clear();
+  m_preimages.clear();
+}
+
 void ForwardAnalysisResult::finishAnalysis() {
   if (m_attack) {
     delete m_attack;
     m_attack = nullptr;
   }
-  m_result.clear();
+  releaseAutomata();
+  // The input is only needed for the forward analysis
+  if (m_input) {
+    delete m_input;
+    m_input = nullptr;
+  }
+}
+
+void ForwardAnalysisResult::releasePostImage() {
+  if (m_postImage) {
+    delete m_postImage;
+    m_postImage = nullptr;
+  }
+}
+
+void ForwardAnalysisResult::markErrored(AnalysisError error) {
+  m_isErrored = true;
+  if (m_error == AnalysisError::None) {
+    m_error = error;
+  }
 }
 
 bool ForwardAnalysisResult::isErrored() const {
-  return (m_postImage == nullptr);
+  return m_isErrored;
 }
 
 
 SemAttack::SemAttack(const fs::path& target_dep_graph_file_name, DepGraph target_dep_graph_, const string& input_field_name)
   : target_dep_graph_file_name(target_dep_graph_file_name)
   , input_field_name(input_field_name)
+  , target_dep_graph(target_dep_graph_)
   , m_print_dots(false)
   , m_print(true)
-  , target_dep_graph(target_dep_graph_)
+  , m_input_node_id(-1)
+  , m_shared(nullptr)
 {
 }
 
 SemAttack::SemAttack(const std::string& target_dep_graph_file_name, DepGraph target_dep_graph_, const string& input_field_name)
   : target_dep_graph_file_name(target_dep_graph_file_name)
   , input_field_name(input_field_name)
+  , target_dep_graph(target_dep_graph_)
   , m_print_dots(false)
   , m_print(true)
-  , target_dep_graph(target_dep_graph_)
+  , m_input_node_id(-1)
+  , m_shared(nullptr)
 {
 }
 
@@ -671,8 +868,18 @@ bool SemAttack::operator<(const SemAttack &other)
 
 void SemAttack::init()
 {
+    try {
+      target_dep_graph.checkOpArities();
+    } catch (std::invalid_argument const &e) {
+      throw StrangerException(AnalysisError::MalformedDepgraph, e.what());
+    }
+
     // initialize input nodes
-    this->target_uninit_field_node = target_dep_graph.findInputNode(input_field_name);
+    if (m_input_node_id >= 0) {
+      this->target_uninit_field_node = dynamic_cast<DepGraphUninitNode*>(target_dep_graph.getNode(m_input_node_id));
+    } else {
+      this->target_uninit_field_node = target_dep_graph.findInputNode(input_field_name);
+    }
     if (target_uninit_field_node == NULL) {
       throw StrangerException(AnalysisError::MalformedDepgraph, "Cannot find input node " + input_field_name + " in target dep graph.");
     }
@@ -750,6 +957,7 @@ AnalysisResult SemAttack::computeTargetFWAnalysis(const StrangerAutomaton* input
 {
     message("computing target sink post image...");
     AnalysisResult targetAnalysisResult;
+    targetAnalysisResult.reserve(target_dep_graph.getMaxNodeID() + 1);
     UninitNodesList targetUninitNodes = target_dep_graph.getUninitNodes();
 
     // Do some checks on the metadata information
@@ -770,6 +978,10 @@ AnalysisResult SemAttack::computeTargetFWAnalysis(const StrangerAutomaton* input
       }*/
     }
 
+    if (m_shared != nullptr) {
+      m_shared->seed(targetAnalysisResult);
+    }
+
     // initialize reference input nodes to bottom
     message("initializing reference inputs with bottom");
     for (auto uninit_node : targetUninitNodes) {
@@ -778,10 +990,10 @@ AnalysisResult SemAttack::computeTargetFWAnalysis(const StrangerAutomaton* input
     // initialize uninit node that we are interested in with sigma star
     message(stringbuilder() << "initializing input node(" << target_uninit_field_node->getID() << ") with sigma star");
 
-    // Copy the input
-    targetAnalysisResult.set(target_uninit_field_node->getID(), inputAuto->clone());
+    // Share the input
+    targetAnalysisResult.set(target_uninit_field_node->getID(), inputAuto->share());
 
-    ImageComputer targetAnalyzer(doConcat, false, inputAuto->clone());
+    ImageComputer targetAnalyzer(doConcat, false, inputAuto->share());
 
     try {
         message("starting forward aalysis for target...");
@@ -801,6 +1013,22 @@ AnalysisResult SemAttack::computeTargetFWAnalysis()
   return computeTargetFWAnalysis(StrangerAutomaton::makeAnyString(target_uninit_field_node->getID()));
 }
 
+ConcreteInterpreter::Values SemAttack::evaluate(const std::string& input) const
+{
+  ConcreteInterpreter interpreter;
+  return interpreter.evaluate(target_dep_graph, target_uninit_field_node, input);
+}
+
+AlphabetPartition SemAttack::computeAlphabet(const std::vector<AttackContext>& contexts)
+{
+  AlphabetPartition alphabet;
+  alphabet.addDepGraph(target_field_relevant_graph);
+  for (auto context : contexts) {
+    alphabet.addAttackContext(context);
+  }
+  return alphabet;
+}
+
 const StrangerAutomaton* SemAttack::getPostImage(const AnalysisResult& result) const
 {
   return result.get(target_dep_graph.getRoot()->getID());
@@ -848,6 +1076,25 @@ StrangerAutomaton* SemAttack::computeAttackPatternOverlap(const StrangerAutomato
   return intersection;
 }
 
+bool SemAttack::checkAttackPatternOverlap(const StrangerAutomaton* postImage,
+                                          const StrangerAutomaton* attackPattern,
+                                          std::string& example) const {
+  example.clear();
+  if (postImage == nullptr || attackPattern == nullptr) {
+    return false;
+  }
+  bool overlap = postImage->checkIntersection(attackPattern, example);
+  if (m_print_dots) {
+    if (overlap) {
+      message("Intersection between attack pattern and sanitizer!");
+      message(example);
+    } else {
+      message("No intersection, validation function is good!");
+    }
+  }
+  return overlap;
+}
+
 AnalysisResult SemAttack::computePreImage(const StrangerAutomaton* intersection,
                                           const AnalysisResult& result) const
 {
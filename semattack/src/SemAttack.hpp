@@ -26,15 +26,22 @@
 #ifndef SEMATTACK_HPP_
 #define SEMATTACK_HPP_
 
+#include <deque>
+#include <memory>
 #include <unordered_map>
 #include <boost/filesystem.hpp>
 #include "StrangerAutomaton.hpp"
+#include "AlphabetPartition.hpp"
+#include "AutomatonFingerprint.hpp"
 #include "AttackContext.hpp"
 #include "exceptions/AnalysisError.hpp"
+#include "ConcreteInterpreter.hpp"
 #include "ImageComputer.hpp"
+#include "InputIndependentResult.hpp"
 #include "SemRepairDebugger.hpp"
 #include "depgraph/DepGraph.hpp"
 #include "depgraph/Metadata.hpp"
+#include "SanitizerResult.hpp"
 
 namespace fs = boost::filesystem;
 
@@ -63,6 +70,12 @@ public:
     StrangerAutomaton* computeAttackPatternOverlap(const StrangerAutomaton* postImage,
                                                    const StrangerAutomaton* attackPattern) const;
 
+    // Check for an overlap between postImage and attack pattern without
+    // building the intersection, example is set to a shortest overlapping string
+    bool checkAttackPatternOverlap(const StrangerAutomaton* postImage,
+                                   const StrangerAutomaton* attackPattern,
+                                   std::string& example) const;
+
     // Compute the pre-image from the intersection and the previously computed
     // analysis result from computeTargetFWAnalysis()
     AnalysisResult computePreImage(const StrangerAutomaton* intersection,
@@ -70,11 +83,22 @@ public:
 
     const StrangerAutomaton* getPreImage(const AnalysisResult& result) const;
 
+    // Run the depgraph on a concrete input string, returns the possible sink values
+    ConcreteInterpreter::Values evaluate(const std::string& input) const;
+
+    // Character classes which the sanitizer and the attack patterns of the
+    // given contexts cannot tell apart
+    AlphabetPartition computeAlphabet(const std::vector<AttackContext>& contexts);
+
     void printResults() const;
     void writeResultsToFile(const fs::path& dir) const;
     
     void setPrintDots(bool print) { m_print_dots = print; }
     void setPrint(bool print) { m_print = print; }
+    // Analyse the uninit node with this ID instead of looking up the input field
+    void setInputNodeID(int id) { m_input_node_id = id; }
+    // Seed the forward analysis with automata computed for all inputs, not owned
+    void setInputIndependentResult(const InputIndependentResult* shared) { m_shared = shared; }
     
     std::string getFileName() const { return target_dep_graph_file_name.string(); }
     const fs::path& getFile() const { return target_dep_graph_file_name; }
@@ -97,6 +121,8 @@ private:
 
     bool m_print_dots;
     bool m_print;    
+    int m_input_node_id;
+    const InputIndependentResult* m_shared;
 };
 
 // Class containing all revelant forward analysis results
@@ -113,6 +139,12 @@ public:
 
     void doAnalysis(bool doConcat = false);
 
+    // Restricts the input to strings of the representatives of alphabet
+    // before doAnalysis(). Patterns other than the attack patterns of the
+    // alphabet must then be passed through compress().
+    void compressAlphabet(const AlphabetPartition& alphabet);
+    std::string compress(const std::string& s) const;
+
     const SemAttack* getAttack() const { return m_attack; }
     SemAttack* getAttack() { return m_attack; }
     const StrangerAutomaton* getPostImage() const { return m_postImage; }
@@ -122,13 +154,45 @@ public:
 
     void writeResultsToFile(const fs::path& dir) const;
 
+    // Approximate size of the automata currently held
+    std::size_t getMemoryEstimate() const;
+
+    // Frees the per node automata and cached pre-images, but keeps the
+    // attack and its input so that doAnalysis() can be run again
+    void releaseAutomata();
     void finishAnalysis();
+    // Drop the post-image once the backward analysis is done and nothing
+    // refers to it any more, the errored state is kept
+    void releasePostImage();
+    // A later step failed after the forward analysis succeeded
+    void markErrored(AnalysisError error);
+
+    // Many attack patterns have the same intersection with the post-image,
+    // their pre-images are only computed once. Returns the pre-image of an
+    // equal intersection computed before and sets its example, or nullptr.
+    // The backward analyses of a result run on one thread, so the cache is
+    // not locked.
+    const StrangerAutomaton* findPreImage(const StrangerAutomaton* intersection, std::string& example) const;
+    void addPreImage(const StrangerAutomaton* intersection, const StrangerAutomaton* preimage,
+                     const std::string& example);
+    unsigned int getPreImageReuses() const { return m_preimage_reuses; }
 private:
+  struct PreImageEntry {
+    AutomatonFingerprint fingerprint;
+    std::unique_ptr<StrangerAutomaton> intersection;
+    std::unique_ptr<StrangerAutomaton> preimage;
+    std::string example;
+  };
+
   SemAttack* m_attack;
   AnalysisResult m_result;
   AnalysisError m_error;
+  bool m_isErrored;
   StrangerAutomaton* m_input;
+  std::unique_ptr<AlphabetPartition> m_alphabet;
   StrangerAutomaton* m_postImage;
+  std::vector<PreImageEntry> m_preimages;
+  mutable unsigned int m_preimage_reuses;
 };
 
 // Class containing all revelant backward analysis results
@@ -147,9 +211,16 @@ public:
     void doAnalysis(bool computePreImage = true, bool singletonIntersection = false, bool doPostAttack = false);
     void finishAnalysis();
 
+    // Input which is tried concretely before any automaton is built, if its
+    // output is accepted by the attack pattern it is taken as the pre-image example
+    void setCandidate(const std::string& candidate) { m_candidate = candidate; }
+
     const StrangerAutomaton* getPreImage() const { return m_preimage; }
     const StrangerAutomaton* getIntersection() const { return m_intersection; }
     const StrangerAutomaton* getAttackPattern() const { return m_attack; }
+    // Null if the attack post image was not needed: when the attack pattern
+    // run concretely through the depgraph already gives an output, only that
+    // example is kept, see isPostAttackConcrete()
     const StrangerAutomaton* getAttackPostImage() const { return m_post_attack; }
 
     bool isErrored() const;
@@ -159,6 +230,8 @@ public:
     bool isVulnerable() const { return !isSafe(); }
 
     bool hasPostAttackImage() const { return m_post_attack != nullptr; }
+    // The post attack example comes from the concrete interpreter
+    bool isPostAttackConcrete() const { return m_post_attack_concrete; }
     const std::string& getName() const { return m_name; }
 
     void printResult(std::ostream& os, bool printHeader) const;
@@ -166,8 +239,15 @@ public:
 
     const std::string& get_intersection_example() const { return m_intersection_example; }
     const std::string& get_preimage_example() const { return m_preimage_example; }
+    // True if running the pre-image example through the depgraph gives an attack string
+    bool isPreImageConfirmed() const { return m_preimage_confirmed; }
 
 private:
+    // Concrete sink values for input, false if the depgraph cannot be evaluated
+    bool evaluateConcrete(const std::string& input, ConcreteInterpreter::Values& outputs) const;
+    // Checks whether input reaches the sink as an attack string, output is set to it
+    bool confirmBypass(const std::string& input, std::string& output) const;
+
     const SemAttack* getAttack() const { return m_fwResult.getAttack(); }
     SemAttack* getAttack() { return m_fwResult.getAttack(); }
     ForwardAnalysisResult& m_fwResult;
@@ -189,13 +269,16 @@ private:
     bool m_isErrored;
     bool m_isSafe;
     bool m_isContained;
+    bool m_preimage_confirmed;
+    bool m_post_attack_concrete;
 
+    std::string m_candidate;
     std::string m_intersection_example;
     std::string m_preimage_example;
     std::string m_post_attack_example;
 };
 
-class CombinedAnalysisResult {
+class CombinedAnalysisResult : public SanitizerResult {
 
 public:
 
@@ -211,7 +294,14 @@ public:
     BackwardAnalysisResult* addBackwardAnalysis(AttackContext context);
     bool hasBackwardanalysisResult(AttackContext context) const;
 
+    // Analyses the generated payloads of the metadata which was not analysed
+    // before, so it can be called again after metadata was added
     void doMetadataSpecificAnalysis(const fs::path& output_dir, bool computePreImage = true, bool singletonIntersection = false, bool outputDotfiles = true, bool attack_forward = false);
+    // Some metadata was added after the last doMetadataSpecificAnalysis()
+    bool needsMetadataAnalysis() const;
+    // As needsMetadataAnalysis(), and at least one of the payloads was not
+    // analysed before, so the forward analysis is needed for them
+    bool needsForwardAnalysisForMetadata() const;
 
     const SemAttack* getAttack() const { return m_fwAnalysis.getAttack(); }
     SemAttack* getAttack() { return m_fwAnalysis.getAttack(); }
@@ -219,40 +309,47 @@ public:
     const ForwardAnalysisResult& getFwAnalysis() const { return m_fwAnalysis; }
     ForwardAnalysisResult& getFwAnalysis() { return m_fwAnalysis; }
 
-    std::string getFileName() const { return m_inputfile.string(); }
+    std::string getFileName() const override { return m_inputfile.string(); }
     const fs::path& getInputPath() const { return m_inputfile; }
     
-    bool isFilterSuccessful(const AttackContext& context) const;
-    bool isFilterContained(const AttackContext& context) const;
+    bool isErrored() const override { return m_fwAnalysis.isErrored(); }
+    AnalysisError getError() const override { return m_fwAnalysis.getError(); }
+
+    bool isFilterSuccessful(const AttackContext& context) const override;
+    bool isFilterContained(const AttackContext& context) const override;
 
     const Metadata& getMetadata() const { return m_metadata.at(0); }
-    AttackContext getSinkContext() const { return AttackContextHelper::getContextFromMetadata(getMetadata()); }
-    bool isSinkContext(const AttackContext& context) const { return (context == getSinkContext()); }
+    bool isExploitSuccessful() const override { return getMetadata().is_exploit_successful(); }
+    AttackContext getSinkContext() const override { return AttackContextHelper::getContextFromMetadata(getMetadata()); }
 
-    int getCountWithDuplicates() const { return m_duplicate_count; }
-    int getCount() const { return m_metadata.size(); }
+    int getCountWithDuplicates() const override { return m_duplicate_count; }
+    int getCount() const override { return m_metadata.size(); }
     bool addMetadata(const Metadata& metadata);
-    std::set<std::string> getUniqueDomains() const;
-    std::set<std::string> getUniqueDomainsWithPayload() const;
-    std::set<std::string> getVulnerableDomainsWithPayload() const;
-    std::set<int> getUniqueInjectionPoints() const;
+    std::set<std::string> getUniqueDomains() const override;
+    std::set<std::string> getUniqueDomainsWithPayload() const override;
+    std::set<std::string> getVulnerableDomainsWithPayload() const override;
+    std::set<int> getUniqueInjectionPoints() const override;
 
     bool hasSuccessfulFwAnalysis() const { return !m_metadataAnalysisMap.empty(); }
-    bool hasAtLeastOnePayload() const { return !m_stringAnalysisMap.empty(); }
-    bool hasAtLeastOneVulnerablePayload() const { return m_atLeastOnePayloadVulnerable; }
-    bool hasAllErroredPayloads() const { return m_allPayloadsErrored; }
-    bool hasAtLeastOneBypass() const;
-
-    void printResult(std::ostream& os, bool printHeader, const std::vector<AttackContext>& contexts) const;
-    void printHeader(std::ostream& os, const std::vector<AttackContext>& contexts) const;
-    void printGeneratedPayloads(std::ostream& os) const;
+    bool hasAtLeastOnePayload() const override { return !m_stringAnalysisMap.empty(); }
+    bool hasAtLeastOneVulnerablePayload() const override { return m_atLeastOnePayloadVulnerable; }
+    bool hasAllErroredPayloads() const override { return m_allPayloadsErrored; }
+    bool hasAtLeastOneBypass() const override;
+
+    void printResult(std::ostream& os, bool printHeader, const std::vector<AttackContext>& contexts) const override;
+    void printHeader(std::ostream& os, const std::vector<AttackContext>& contexts) const override;
+    void printGeneratedPayloads(std::ostream& os) const override;
     static void printGeneratedPayloadHeader(std::ostream& os);
-    void printUnmatchedUuids(std::ostream& os) const;
+    void printUnmatchedUuids(std::ostream& os) const override;
+    // Frees the automata of the forward and backward analyses and marks the
+    // result as done, the attack is kept for metadata added later
+    void releaseAutomata();
     void finishAnalysis();
 
-    bool isDone() const { return m_done; }
+    bool isDone() const override { return m_done; }
 
 private:
+    static std::vector<std::string> getPayloads(const Metadata& metadata);
     BackwardAnalysisResult* doBackwardAnalysisForPayload(const std::string& payload, const fs::path& output_dir,
                                                          bool computePreImage, bool singletonIntersection, bool outputDotfiles, bool attack_forward);
     fs::path m_inputfile;
@@ -262,7 +359,8 @@ private:
     std::unordered_map<AttackContext, BackwardAnalysisResult*> m_bwAnalysisMap;
 
     // Keep track of metadata for this result
-    std::vector<Metadata> m_metadata;
+    // A deque, as the maps below point into it while metadata is added
+    std::deque<Metadata> m_metadata;
     std::map<int, const Metadata*> m_finding_metadata_map;
     // For context specific payloads, keep a map of metadata to backwardanalysis
     std::map<const Metadata*, std::vector<BackwardAnalysisResult*> > m_metadataAnalysisMap;
@@ -56,7 +56,7 @@ SemAttackBw::SemAttackBw(const string& target_dep_graph_file_name, const string&
 }
 
 SemAttackBw::~SemAttackBw() {
-    delete this->target_uninit_field_node;
+    // The input node is owned by the arena of the dependency graph
 }
 
 void SemAttackBw::message(const string& msg) {
@@ -25,25 +25,127 @@
 #include "ValidationImageComputer.hpp"
 #include "exceptions/StrangerException.hpp"
 
-PerfInfo& SemRepair::perfInfo = PerfInfo::getInstance();
+SemRepairReference::SemRepairReference(string reference_dep_graph_file_name, string input_field_name)
+	: reference_dep_graph_file_name(reference_dep_graph_file_name)
+	, input_field_name(input_field_name)
+	, reference_dep_graph()
+	, reference_field_relevant_graph()
+	, reference_uninit_field_node(NULL)
+	, mutex()
+	, rejected_auto()
+	, sink_auto() {
 
-SemRepair::SemRepair(string reference_dep_graph_file_name,string target_dep_graph_file_name, string input_field_name) {
-
-	this->reference_dep_graph_file_name = reference_dep_graph_file_name;
-	this->target_dep_graph_file_name = target_dep_graph_file_name;
-	this->input_field_name = input_field_name;
-
-	// read dep graphs
 	this->reference_dep_graph = DepGraph::parseDotFile(reference_dep_graph_file_name);
-	this->target_dep_graph = DepGraph::parseDotFile(target_dep_graph_file_name);
 
-	// initialize input nodes
 	this->reference_uninit_field_node = reference_dep_graph.findInputNode(input_field_name);
 	if (reference_uninit_field_node == NULL) {
 		throw StrangerException("Cannot find input node " + input_field_name + " in reference dep graph.");
 	}
 	message(stringbuilder() << "reference uninit node(" << reference_uninit_field_node->getID() << ") found for field " << input_field_name << ".");
 
+	this->reference_field_relevant_graph = reference_dep_graph.getInputRelevantGraph(reference_uninit_field_node);
+}
+
+SemRepairReference::~SemRepairReference() {
+	// The input node is owned by the arena of the dependency graph
+}
+
+void SemRepairReference::message(string msg) {
+	cout << endl << "~~~~~~~~~~~>>> SemRepair says: " << msg << endl;
+}
+
+void SemRepairReference::precompute() {
+	std::lock_guard<std::mutex> lock(mutex);
+	computeRejectedSet();
+	computeSinkAuto();
+}
+
+StrangerAutomaton* SemRepairReference::getRejectedSet() {
+	std::lock_guard<std::mutex> lock(mutex);
+	computeRejectedSet();
+	return rejected_auto->clone();
+}
+
+StrangerAutomaton* SemRepairReference::getSinkAuto() {
+	std::lock_guard<std::mutex> lock(mutex);
+	computeSinkAuto();
+	return sink_auto->clone();
+}
+
+void SemRepairReference::computeRejectedSet() {
+	if (!rejected_auto) {
+		PerfInfo& perfInfo = PerfInfo::getInstance();
+		message("extracting validation from reference");
+		boost::posix_time::ptime start_time = perfInfo.current_time();
+		ValidationImageComputer analyzer;
+		AnalysisResult reference_validationExtractionResults =
+				analyzer.doBackwardAnalysis_ValidationCase(reference_dep_graph, reference_field_relevant_graph, StrangerAutomaton::makeBottom());
+		rejected_auto.reset(reference_validationExtractionResults.get(reference_uninit_field_node->getID())->clone());
+		perfInfo.validation_reference_backward_time = perfInfo.current_time() - start_time;
+	}
+}
+
+void SemRepairReference::computeSinkAuto() {
+	if (!sink_auto) {
+		message("computing reference sink post image...");
+		AnalysisResult referenceAnalysisResult;
+		UninitNodesList referenceUninitNodes = reference_dep_graph.getUninitNodes();
+
+		// initialize reference input nodes to bottom
+		message("initializing reference inputs with bottom");
+		for (auto uninit_node : referenceUninitNodes) {
+			referenceAnalysisResult.set(uninit_node->getID(), StrangerAutomaton::makePhi(uninit_node->getID()));
+		}
+		// initialize uninit node that we are interested in with sigma star
+		message(stringbuilder() << "initializing input node(" << reference_uninit_field_node->getID() << ") with sigma star");
+		referenceAnalysisResult.set(reference_uninit_field_node->getID(), StrangerAutomaton::makeAnyString(reference_uninit_field_node->getID()));
+
+		ValidationImageComputer referenceAnalyzer;
+		message("starting forward analysis for reference...");
+		referenceAnalyzer.doForwardAnalysis_SingleInput(reference_dep_graph, reference_field_relevant_graph, referenceAnalysisResult);
+		message("...finished forward analysis for reference.");
+
+		sink_auto.reset(referenceAnalysisResult.get(reference_field_relevant_graph.getRoot()->getID())->clone());
+		message("...computed reference sink post image.");
+	}
+}
+
+//  ********************************************************************************
+
+SemRepair::SemRepair(string reference_dep_graph_file_name,string target_dep_graph_file_name, string input_field_name)
+	: reference(std::make_shared<SemRepairReference>(reference_dep_graph_file_name, input_field_name))
+	, target_dep_graph_file_name(target_dep_graph_file_name)
+	, input_field_name(input_field_name)
+	, target_uninit_field_node(NULL)
+	, reference_sink_auto(NULL)
+	, length_patch_auto(NULL)
+	, validation_patch_auto(NULL)
+	, sanitization_patch_auto(NULL)
+	, perfInfo(PerfInfo::getInstance()) {
+
+	// read dep graphs
+	this->target_dep_graph = DepGraph::parseDotFile(target_dep_graph_file_name);
+	initTarget();
+}
+
+SemRepair::SemRepair(std::shared_ptr<SemRepairReference> reference, string target_dep_graph_file_name, const DepGraph& target_dep_graph,
+					 PerfInfo& perfInfo)
+	: reference(reference)
+	, target_dep_graph_file_name(target_dep_graph_file_name)
+	, input_field_name(reference->getFieldName())
+	, target_uninit_field_node(NULL)
+	, reference_sink_auto(NULL)
+	, length_patch_auto(NULL)
+	, validation_patch_auto(NULL)
+	, sanitization_patch_auto(NULL)
+	, perfInfo(perfInfo) {
+
+	this->target_dep_graph = target_dep_graph;
+	initTarget();
+}
+
+void SemRepair::initTarget() {
+	// initialize input nodes
 	this->target_uninit_field_node = target_dep_graph.findInputNode(input_field_name);
 	if (target_uninit_field_node == NULL) {
 		throw StrangerException("Cannot find input node " + input_field_name + " in target dep graph.");
@@ -51,30 +153,25 @@ SemRepair::SemRepair(string reference_dep_graph_file_name,string target_dep_grap
 	message(stringbuilder() << "target uninit node(" << target_uninit_field_node->getID() << ") found for field " << input_field_name << ".");
 
 	// initialize input relevant graphs
-	this->reference_field_relevant_graph = reference_dep_graph.getInputRelevantGraph(reference_uninit_field_node);
 	this->target_field_relevant_graph = target_dep_graph.getInputRelevantGraph(target_uninit_field_node);
 
 	if (DEBUG_ENABLED_INIT != 0) {
 		DEBUG_MESSAGE("------------ Debugging Initalization ------------");
 
-//		DEBUG_MESSAGE("reference Dependency Graph");
-//		this->reference_dep_graph.toDot();
-//		DEBUG_MESSAGE("reference Field Relevant Dependency Graph");
-//		this->reference_field_relevant_graph.toDot();
-
 		DEBUG_MESSAGE("Target Dependency Graph");
 		this->target_dep_graph.toDot();
 		DEBUG_MESSAGE("Target Field Relevant Dependency Graph");
 		this->target_field_relevant_graph.toDot();
 
 	}
-
-		DEBUG_AUTO_TO_FILE_MN(validation_patch_auto, "");
 }
 
 SemRepair::~SemRepair() {
-	delete this->reference_uninit_field_node;
-	delete this->target_uninit_field_node;
+	// The input nodes are owned by the arenas of the dependency graphs
+	delete reference_sink_auto;
+	delete length_patch_auto;
+	delete validation_patch_auto;
+	delete sanitization_patch_auto;
 }
 
 void SemRepair::message(string msg) {
@@ -91,6 +188,7 @@ string SemRepair::generateOutputFilePath(string folder_name, bool unique_name) {
 	if (!unique_name) {
 		return stringbuilder() << output_dir.string() << "/";
 	}
+	const string& reference_dep_graph_file_name = reference->getFileName();
 	size_t ref_ext_index = reference_dep_graph_file_name.find_last_of('.');
 	if (ref_ext_index == string::npos) {
 		ref_ext_index = reference_dep_graph_file_name.length() - 1;
@@ -265,18 +363,15 @@ StrangerAutomaton* SemRepair::computeValidationPatch() {
 
     ValidationImageComputer analyzer;
 	boost::posix_time::ptime start_time;
-	try {
-		message("extracting validation from reference");
-		start_time = perfInfo.current_time();
-		AnalysisResult reference_validationExtractionResults =
-				analyzer.doBackwardAnalysis_ValidationCase(reference_dep_graph, reference_field_relevant_graph, StrangerAutomaton::makeBottom());
-		const StrangerAutomaton* reference_negVPatch = reference_validationExtractionResults.get(reference_uninit_field_node->getID());
+	{
+		// computed once per reference
+		StrangerAutomaton* reference_negVPatch = reference->getRejectedSet();
 		const StrangerAutomaton* reference_validation = reference_negVPatch;
 		if ( !calculate_rejected_set ) {
-			reference_validation = reference_negVPatch->complement(reference_uninit_field_node->getID());
+			reference_validation = reference_negVPatch->complement(reference->getFieldNodeID());
+			delete reference_negVPatch;
 		}
 
-		perfInfo.validation_reference_backward_time = perfInfo.current_time() - start_time;
 		if (DEBUG_ENABLED_VP != 0) {
 			DEBUG_MESSAGE("reference validation auto:");
 			DEBUG_AUTO(reference_validation);
@@ -287,8 +382,10 @@ StrangerAutomaton* SemRepair::computeValidationPatch() {
 		AnalysisResult target_validationExtractionResults =
 				analyzer.doBackwardAnalysis_ValidationCase(target_dep_graph, target_field_relevant_graph, StrangerAutomaton::makeBottom());
 		const StrangerAutomaton* target_negVPatch = target_validationExtractionResults.get(target_uninit_field_node->getID());
-		const StrangerAutomaton* target_validation = target_negVPatch;
+		// owned by the analysis result, deleted below
+		const StrangerAutomaton* target_validation = target_negVPatch->share(target_uninit_field_node->getID());
 		if ( !calculate_rejected_set ) {
+			delete target_validation;
 			target_validation = target_negVPatch->complement(target_uninit_field_node->getID());
 		}
 		perfInfo.validation_target_backward_time = perfInfo.current_time() - start_time;
@@ -360,10 +457,6 @@ StrangerAutomaton* SemRepair::computeValidationPatch() {
 		delete reference_validation;
 		delete target_validation;
 		delete diffAuto;
-
-	} catch (StrangerException const &e) {
-		cerr << e.what();
-		exit(EXIT_FAILURE);
 	}
 
 	perfInfo.calculate_total_validation_extraction_time();
@@ -375,34 +468,8 @@ StrangerAutomaton* SemRepair::computeValidationPatch() {
  * Computes sink post image for reference
  */
 StrangerAutomaton* SemRepair::computeReferenceFWAnalysis() {
-
-	message("computing reference sink post image...");
-	AnalysisResult referenceAnalysisResult;
-	UninitNodesList referenceUninitNodes = reference_dep_graph.getUninitNodes();
-
-	// initialize reference input nodes to bottom
-	message("initializing reference inputs with bottom");
-	for (auto uninit_node : referenceUninitNodes) {
-            referenceAnalysisResult.set(uninit_node->getID(), StrangerAutomaton::makePhi(uninit_node->getID()));
-	}
-	// initialize uninit node that we are interested in with sigma star
-	message(stringbuilder() << "initializing input node(" << reference_uninit_field_node->getID() << ") with sigma star");
-        referenceAnalysisResult.set(reference_uninit_field_node->getID(), StrangerAutomaton::makeAnyString(reference_uninit_field_node->getID()));
-
-    ValidationImageComputer referenceAnalyzer;
-
-	try {
-		message("starting forward analysis for reference...");
-		referenceAnalyzer.doForwardAnalysis_SingleInput(reference_dep_graph, reference_field_relevant_graph, referenceAnalysisResult);
-		message("...finished forward analysis for reference.");
-
-	} catch (StrangerException const &e) {
-        cerr << e.what();
-        exit(EXIT_FAILURE);
-    }
-
-	reference_sink_auto = referenceAnalysisResult.get(reference_field_relevant_graph.getRoot()->getID())->clone();
-	message("...computed reference sink post image.");
+	delete reference_sink_auto;
+	reference_sink_auto = reference->getSinkAuto();
 	return reference_sink_auto;
 }
 
@@ -423,22 +490,15 @@ AnalysisResult SemRepair::computeTargetFWAnalysis() {
 	if (calculate_rejected_set) {
             targetAnalysisResult.set(target_uninit_field_node->getID(), validation_patch_auto->complement(target_uninit_field_node->getID()));
 	} else {
-            targetAnalysisResult.set(target_uninit_field_node->getID(), validation_patch_auto);
+            targetAnalysisResult.set(target_uninit_field_node->getID(), validation_patch_auto->share(target_uninit_field_node->getID()));
 	}
 
 
     ValidationImageComputer targetAnalyzer;
 
-	try {
-
-		message("starting forward analysis for target...");
-		targetAnalyzer.doForwardAnalysis_SingleInput(target_dep_graph, target_field_relevant_graph, targetAnalysisResult);
-		message("...finished forward analysis for target.");
-
-	} catch (StrangerException const &e) {
-        cerr << e.what();
-        exit(EXIT_FAILURE);
-    }
+	message("starting forward analysis for target...");
+	targetAnalyzer.doForwardAnalysis_SingleInput(target_dep_graph, target_field_relevant_graph, targetAnalysisResult);
+	message("...finished forward analysis for target.");
 
 	return targetAnalysisResult;
 }
@@ -446,23 +506,18 @@ AnalysisResult SemRepair::computeTargetFWAnalysis() {
 StrangerAutomaton* SemRepair::computeTargetLengthPatch(StrangerAutomaton* initialAuto, AnalysisResult& fwAnalysisResult) {
 	message("starting a backward analysis to calculate length patch...");
     ValidationImageComputer targetAnalyzer;
-	try {
-                fwAnalysisResult.set(target_uninit_field_node->getID(), StrangerAutomaton::makeAnyString(-5));
-		boost::posix_time::ptime start_time = perfInfo.current_time();
-		AnalysisResult bwResult = targetAnalyzer.doBackwardAnalysis_GeneralCase(target_dep_graph, target_field_relevant_graph, initialAuto, fwAnalysisResult);
-		perfInfo.sanitization_length_backward_time = perfInfo.current_time() - start_time;
-		const StrangerAutomaton* negPatchAuto = bwResult.get(target_uninit_field_node->getID());
-		if ( calculate_rejected_set ) {
-			length_patch_auto = negPatchAuto->clone(-5);
-		} else {
-			length_patch_auto = negPatchAuto->complement(-5);
-		}
-//		fwAnalysisResult[target_uninit_field_node->getID()] = validation_patch_auto->intersect(length_patch_auto,-5);
-
-	} catch (StrangerException const &e) {
-        cerr << e.what();
-        exit(EXIT_FAILURE);
-    }
+	fwAnalysisResult.set(target_uninit_field_node->getID(), StrangerAutomaton::makeAnyString(-5));
+	boost::posix_time::ptime start_time = perfInfo.current_time();
+	AnalysisResult bwResult = targetAnalyzer.doBackwardAnalysis_GeneralCase(target_dep_graph, target_field_relevant_graph, initialAuto, fwAnalysisResult);
+	perfInfo.sanitization_length_backward_time = perfInfo.current_time() - start_time;
+	const StrangerAutomaton* negPatchAuto = bwResult.get(target_uninit_field_node->getID());
+	delete length_patch_auto;
+	if ( calculate_rejected_set ) {
+		length_patch_auto = negPatchAuto->clone(-5);
+	} else {
+		length_patch_auto = negPatchAuto->complement(-5);
+	}
+//	fwAnalysisResult[target_uninit_field_node->getID()] = validation_patch_auto->intersect(length_patch_auto,-5);
 	message("...length patch is generated");
 	return length_patch_auto;
 }
@@ -535,55 +590,49 @@ StrangerAutomaton* SemRepair::computeSanitizationPatch() {
 			DEBUG_AUTO(lengthRestrictAuto);
 		}
 
-		try {
-			// use negation of length restricted auto to solve the problem of overapproximation
-			StrangerAutomaton* negLengthRestrictAuto = lengthRestrictAuto->complement(-4);
-			StrangerAutomaton* rejectedLengthAuto = targetSinkAuto->intersect(negLengthRestrictAuto, -4);
-			delete negLengthRestrictAuto;
+		// use negation of length restricted auto to solve the problem of overapproximation
+		StrangerAutomaton* negLengthRestrictAuto = lengthRestrictAuto->complement(-4);
+		StrangerAutomaton* rejectedLengthAuto = targetSinkAuto->intersect(negLengthRestrictAuto, -4);
+		delete negLengthRestrictAuto;
 //			cout << "rejected length automaton: " << endl;
 //			rejectedLengthAuto->toDotAscii(0);
-			computeTargetLengthPatch(rejectedLengthAuto, targetAnalysisResult);
+		computeTargetLengthPatch(rejectedLengthAuto, targetAnalysisResult);
 
-			if (DEBUG_ENABLED_LP != 0) {
-				DEBUG_MESSAGE("Length patch automaton");
-				DEBUG_AUTO(length_patch_auto);
-			}
-			message("........................................END LENGTH_PATCH ANALYSIS PHASE");
-			message("CONTINUE SANITIZATION ANALYSIS PHASE........................................");
-			message("checking difference between reference and target after length restriction");
+		if (DEBUG_ENABLED_LP != 0) {
+			DEBUG_MESSAGE("Length patch automaton");
+			DEBUG_AUTO(length_patch_auto);
+		}
+		message("........................................END LENGTH_PATCH ANALYSIS PHASE");
+		message("CONTINUE SANITIZATION ANALYSIS PHASE........................................");
+		message("checking difference between reference and target after length restriction");
+		delete differenceAuto;
+		comp_time = perfInfo.current_time();
+		differenceAuto = lengthRestrictAuto->difference(reference_sink_auto, -3);
+		bool isDifferenceAutoEmpty = differenceAuto->isEmpty();
+		perfInfo.sanitization_comparison_time += perfInfo.current_time() - comp_time;
+		if (DEBUG_ENABLED_SP != 0) {
+			DEBUG_MESSAGE("Difference auto after length restriction");
+			DEBUG_AUTO(differenceAuto);
+		}
+
+		if (isDifferenceAutoEmpty) {
+			message("no difference, no sanitization patch required!");
 			delete differenceAuto;
-			comp_time = perfInfo.current_time();
-			differenceAuto = lengthRestrictAuto->difference(reference_sink_auto, -3);
-			bool isDifferenceAutoEmpty = differenceAuto->isEmpty();
-			perfInfo.sanitization_comparison_time += perfInfo.current_time() - comp_time;
+			sanitization_patch_auto = NULL;
+			is_sanitization_patch_required = false;
+			is_length_patch_required = true;
+		} else {
+			message("starting last backward analysis for sanitization patch with diff auto after length restriction...");
+			start_time = perfInfo.current_time();
+			sanitization_patch_auto = computeTargetSanitizationPatch(differenceAuto, targetAnalysisResult);
+			perfInfo.sanitization_patch_backward_time = perfInfo.current_time() - start_time;
 			if (DEBUG_ENABLED_SP != 0) {
-				DEBUG_MESSAGE("Difference auto after length restriction");
-				DEBUG_AUTO(differenceAuto);
+				DEBUG_MESSAGE("Sanitization patch auto");
+				DEBUG_AUTO(sanitization_patch_auto);
 			}
-
-			if (isDifferenceAutoEmpty) {
-				message("no difference, no sanitization patch required!");
-				delete differenceAuto;
-				sanitization_patch_auto = NULL;
-				is_sanitization_patch_required = false;
-				is_length_patch_required = true;
-			} else {
-				message("starting last backward analysis for sanitization patch with diff auto after length restriction...");
-				start_time = perfInfo.current_time();
-				sanitization_patch_auto = computeTargetSanitizationPatch(differenceAuto, targetAnalysisResult);
-				perfInfo.sanitization_patch_backward_time = perfInfo.current_time() - start_time;
-				if (DEBUG_ENABLED_SP != 0) {
-					DEBUG_MESSAGE("Sanitization patch auto");
-					DEBUG_AUTO(sanitization_patch_auto);
-				}
-				message("...finished last backward analysis for sanitization patch with diff after length restriction.");
-				is_sanitization_patch_required = true;
-				is_length_patch_required = true;
-			}
-
-		} catch (StrangerException const &e) {
-			cerr << e.what();
-			exit(EXIT_FAILURE);
+			message("...finished last backward analysis for sanitization patch with diff after length restriction.");
+			is_sanitization_patch_required = true;
+			is_length_patch_required = true;
 		}
 
 	} else {
@@ -607,7 +656,7 @@ StrangerAutomaton* SemRepair::computeSanitizationPatch() {
 }
 
 void SemRepair::testNewFunctions() {
-	this->reference_dep_graph.calculateSCCs();
+	this->target_dep_graph.calculateSCCs();
 }
 
 
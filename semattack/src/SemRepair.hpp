@@ -25,6 +25,8 @@
 #define SEMREPAIR_HPP_
 
 #include <boost/filesystem.hpp>
+#include <memory>
+#include <mutex>
 #include "StrangerAutomaton.hpp"
 #include "SemRepairDebugger.hpp"
 #include "depgraph/DepGraph.hpp"
@@ -32,9 +34,52 @@
 
 using namespace std;
 
+// The reference side of a repair only depends on the reference graph and the
+// input field. It is computed once and shared by the repairs of any number of
+// targets, see SemRepairBatch.
+class SemRepairReference {
+public:
+	SemRepairReference(string reference_dep_graph_file_name, string input_field_name);
+	virtual ~SemRepairReference();
+
+	// Computes the rejected set and the sink post image once, so that
+	// repairs running in parallel only copy them
+	void precompute();
+
+	// Both return a copy owned by the caller, MONA marks nodes while reading
+	// a DFA, so threads must not read the cached automata concurrently.
+	// Inputs rejected by the validation of the reference
+	StrangerAutomaton* getRejectedSet();
+	// Sink post image of the reference for any string in the input field
+	StrangerAutomaton* getSinkAuto();
+
+	const string& getFileName() const { return reference_dep_graph_file_name; }
+	const string& getFieldName() const { return input_field_name; }
+	int getFieldNodeID() const { return reference_uninit_field_node->getID(); }
+
+private:
+	string reference_dep_graph_file_name;
+	string input_field_name;
+
+	NodeOwningDepGraph reference_dep_graph;
+	DepGraph reference_field_relevant_graph;
+	DepGraphNode* reference_uninit_field_node;
+
+	std::mutex mutex;
+	std::unique_ptr<StrangerAutomaton> rejected_auto;
+	std::unique_ptr<StrangerAutomaton> sink_auto;
+
+	void computeRejectedSet();
+	void computeSinkAuto();
+	void message(string msg);
+};
+
 class SemRepair {
 public:
 	SemRepair(string reference_dep_graph_file_name, string target_dep_graph_file_name, string input_field_name);
+	// Repairs a parsed target against a shared reference, timings go to perfInfo
+	SemRepair(std::shared_ptr<SemRepairReference> reference, string target_dep_graph_file_name, const DepGraph& target_dep_graph,
+			  PerfInfo& perfInfo = PerfInfo::getInstance());
 	virtual ~SemRepair();
 
 	StrangerAutomaton* computeValidationPatch();
@@ -59,18 +104,14 @@ public:
 
 	bool calculate_rejected_set = false;
 
-	static PerfInfo& perfInfo;
 private:
-	string reference_dep_graph_file_name;
+	std::shared_ptr<SemRepairReference> reference;
 	string target_dep_graph_file_name;
 	string input_field_name;
 
-        NodeOwningDepGraph reference_dep_graph;
 	NodeOwningDepGraph target_dep_graph;
-	DepGraph reference_field_relevant_graph;
 	DepGraph target_field_relevant_graph;
 
-	DepGraphNode* reference_uninit_field_node;
 	DepGraphNode* target_uninit_field_node;
 
 	StrangerAutomaton* reference_sink_auto;
@@ -79,6 +120,9 @@ private:
 	StrangerAutomaton* validation_patch_auto;
 	StrangerAutomaton* sanitization_patch_auto;
 
+	PerfInfo& perfInfo;
+
+	void initTarget();
 	void message(string msg);
 	string generateOutputFilePath(string folder_name, bool unique_name);
 	void printAnalysisResults(AnalysisResult& result);
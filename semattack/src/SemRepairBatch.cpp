@@ -0,0 +1,159 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * SemRepairBatch.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "SemRepairBatch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include <boost/asio.hpp>
+
+#include "StringBuilder.hpp"
+#include "exceptions/StrangerException.hpp"
+
+namespace asio = boost::asio;
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+SemRepairBatch::SemRepairBatch(const std::string& reference_dep_graph_file_name, const std::string& input_field_name,
+                               const fs::path& targets, unsigned int threads)
+  : m_reference(std::make_shared<SemRepairReference>(reference_dep_graph_file_name, input_field_name))
+  , m_targets(targets)
+  , m_threads(std::max(1u, threads))
+  , m_rows_mutex()
+  , m_rows()
+{
+}
+
+SemRepairBatch::~SemRepairBatch()
+{
+}
+
+const std::vector<SemRepairBatch::Row>& SemRepairBatch::run()
+{
+  // Compute the reference side before the workers need it, the repairs
+  // only copy the cached results
+  m_reference->precompute();
+
+  std::unique_ptr<DepGraphSource> source = DepGraphSource::create(m_targets);
+  asio::thread_pool pool(m_threads);
+  // Only hold a few inputs per thread in memory (bundle members carry their contents)
+  BoundedQueue<DepGraphInput> queue(m_threads * 4);
+  std::cout << "Repairing targets with pool of " << m_threads << " threads." << std::endl;
+  for (unsigned int i = 0; i < m_threads; i++) {
+    asio::post(pool, [this, &queue]() { repairAll(queue); });
+  }
+  DepGraphInput input;
+  try {
+    while (source->next(input)) {
+      queue.push(std::move(input));
+      input = DepGraphInput();
+    }
+  } catch (std::exception const &e) {
+    std::cerr << "Error reading targets from " << m_targets.string() << ": " << e.what() << std::endl;
+  }
+  queue.close();
+  pool.join();
+
+  std::sort(m_rows.begin(), m_rows.end(), [](const Row& a, const Row& b) { return a.target < b.target; });
+  return m_rows;
+}
+
+void SemRepairBatch::repairAll(BoundedQueue<DepGraphInput>& queue)
+{
+  DepGraphInput input;
+  while (queue.pop(input)) {
+    repair(input);
+  }
+}
+
+void SemRepairBatch::repair(const DepGraphInput& input)
+{
+  Row row = { input.path.string(), false, 0, 0, false, 0, 0, false, 0, 0, 0.0, 0.0, 0.0, "" };
+  // The timings of this repair, added to the shared ones once it is done
+  PerfInfo perfInfo;
+  Clock::time_point start = Clock::now();
+  try {
+    SemRepair semRepair(m_reference, input.path.string(), input.parse(), perfInfo);
+    // As semrep for a single target
+    semRepair.calculate_rejected_set = true;
+
+    Clock::time_point phase_start = Clock::now();
+    semRepair.computeValidationPatch();
+    row.validation_ms = elapsed_ms(phase_start);
+    phase_start = Clock::now();
+    semRepair.computeSanitizationPatch();
+    row.sanitization_ms = elapsed_ms(phase_start);
+
+    row.validation_patch = semRepair.is_validation_patch_required;
+    if (row.validation_patch) {
+      row.validation_states = semRepair.getValidationPatchAuto()->get_num_of_states();
+      row.validation_bdd_nodes = semRepair.getValidationPatchAuto()->get_num_of_bdd_nodes();
+    }
+    row.length_patch = semRepair.is_length_patch_required;
+    if (row.length_patch) {
+      row.length_states = semRepair.getLengthPatchAuto()->get_num_of_states();
+      row.length_bdd_nodes = semRepair.getLengthPatchAuto()->get_num_of_bdd_nodes();
+    }
+    row.sanitization_patch = semRepair.is_sanitization_patch_required;
+    if (row.sanitization_patch) {
+      row.sanitization_states = semRepair.getSanitizationPatchAuto()->get_num_of_states();
+      row.sanitization_bdd_nodes = semRepair.getSanitizationPatchAuto()->get_num_of_bdd_nodes();
+    }
+  } catch (StrangerException const &e) {
+    row.error = AnalysisErrorHelper::getName(e.getError());
+    std::cerr << "Error repairing " << row.target << ": " << e.what() << std::endl;
+  } catch (std::exception const &e) {
+    row.error = AnalysisErrorHelper::getName(AnalysisError::Other);
+    std::cerr << "Error repairing " << row.target << ": " << e.what() << std::endl;
+  }
+  row.total_ms = elapsed_ms(start);
+
+  std::lock_guard<std::mutex> lock(m_rows_mutex);
+  m_rows.push_back(row);
+  PerfInfo::getInstance().add_extraction_times(perfInfo);
+}
+
+void SemRepairBatch::writeCsv(std::ostream& os) const
+{
+  os << "target, validation patch, validation states, validation bdd nodes, "
+     << "length patch, length states, length bdd nodes, "
+     << "sanitization patch, sanitization states, sanitization bdd nodes, "
+     << "validation ms, sanitization ms, total ms, error" << std::endl;
+  os << std::fixed << std::setprecision(3);
+  for (const auto& row : m_rows) {
+    os << csv_escape(row.target) << ", "
+       << row.validation_patch << ", " << row.validation_states << ", " << row.validation_bdd_nodes << ", "
+       << row.length_patch << ", " << row.length_states << ", " << row.length_bdd_nodes << ", "
+       << row.sanitization_patch << ", " << row.sanitization_states << ", " << row.sanitization_bdd_nodes << ", "
+       << row.validation_ms << ", " << row.sanitization_ms << ", " << row.total_ms << ", "
+       << row.error << std::endl;
+  }
+}
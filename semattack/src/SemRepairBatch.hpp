@@ -0,0 +1,81 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * SemRepairBatch.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef SEMREPAIR_BATCH_HPP_
+#define SEMREPAIR_BATCH_HPP_
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BoundedQueue.hpp"
+#include "DepGraphSource.hpp"
+#include "SemRepair.hpp"
+
+// Repairs many targets against one reference. The validation and sink
+// automata of the reference are computed once, the targets are analyzed in
+// parallel and summarized with one row each.
+class SemRepairBatch {
+
+public:
+  struct Row {
+    std::string target;
+    bool validation_patch;
+    int validation_states;
+    unsigned validation_bdd_nodes;
+    bool length_patch;
+    int length_states;
+    unsigned length_bdd_nodes;
+    bool sanitization_patch;
+    int sanitization_states;
+    unsigned sanitization_bdd_nodes;
+    double validation_ms;
+    double sanitization_ms;
+    double total_ms;
+    std::string error;
+  };
+
+  SemRepairBatch(const std::string& reference_dep_graph_file_name, const std::string& input_field_name,
+                 const fs::path& targets, unsigned int threads);
+  virtual ~SemRepairBatch();
+
+  // Runs all targets, then returns the rows sorted by target
+  const std::vector<Row>& run();
+  void writeCsv(std::ostream& os) const;
+
+private:
+  void repairAll(BoundedQueue<DepGraphInput>& queue);
+  void repair(const DepGraphInput& input);
+
+  std::shared_ptr<SemRepairReference> m_reference;
+  fs::path m_targets;
+  unsigned int m_threads;
+
+  std::mutex m_rows_mutex;
+  std::vector<Row> m_rows;
+};
+
+#endif /* SEMREPAIR_BATCH_HPP_ */
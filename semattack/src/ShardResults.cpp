@@ -0,0 +1,444 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * ShardResults.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#include "ShardResults.hpp"
+#include "MultiAttack.hpp"
+#include "StringBuilder.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+// Shard files are a sequence of length prefixed fields ("<size>:<data>\n"),
+// which keeps arbitrary file names and rendered CSV rows intact.
+namespace {
+
+  const std::string shard_magic = "semattack-shard-1";
+
+  void writeString(std::ostream& os, const std::string& s) {
+    os << s.size() << ':' << s << '\n';
+  }
+
+  std::string readString(std::istream& is) {
+    std::size_t size = 0;
+    char sep = 0;
+    if (!(is >> size) || !is.get(sep) || sep != ':') {
+      throw std::runtime_error("malformed shard file: expected field length");
+    }
+    std::string s(size, '\0');
+    if (size > 0 && !is.read(&s[0], size)) {
+      throw std::runtime_error("malformed shard file: truncated field");
+    }
+    if (!is.get(sep) || sep != '\n') {
+      throw std::runtime_error("malformed shard file: missing field terminator");
+    }
+    return s;
+  }
+
+  void writeInt(std::ostream& os, long value) {
+    writeString(os, std::to_string(value));
+  }
+
+  long readInt(std::istream& is) {
+    std::string s = readString(is);
+    try {
+      return std::stol(s);
+    } catch (std::exception&) {
+      throw std::runtime_error(stringbuilder() << "malformed shard file: not a number: " << s);
+    }
+  }
+
+  void writeBool(std::ostream& os, bool value) {
+    writeInt(os, value ? 1 : 0);
+  }
+
+  bool readBool(std::istream& is) {
+    return readInt(is) != 0;
+  }
+
+  void writeStringSet(std::ostream& os, const std::set<std::string>& values) {
+    writeInt(os, values.size());
+    for (const auto& v : values) {
+      writeString(os, v);
+    }
+  }
+
+  std::set<std::string> readStringSet(std::istream& is) {
+    std::set<std::string> values;
+    long size = readInt(is);
+    for (long i = 0; i < size; i++) {
+      values.insert(readString(is));
+    }
+    return values;
+  }
+
+  void writeIntSet(std::ostream& os, const std::set<int>& values) {
+    writeInt(os, values.size());
+    for (int v : values) {
+      writeInt(os, v);
+    }
+  }
+
+  std::set<int> readIntSet(std::istream& is) {
+    std::set<int> values;
+    long size = readInt(is);
+    for (long i = 0; i < size; i++) {
+      values.insert(readInt(is));
+    }
+    return values;
+  }
+
+  template<typename F>
+  std::string render(F f) {
+    std::ostringstream ss;
+    f(ss);
+    return ss.str();
+  }
+
+}
+
+SanitizerRecord::SanitizerRecord()
+  : m_file_name()
+  , m_count_with_duplicates(0)
+  , m_count(0)
+  , m_done(false)
+  , m_errored(false)
+  , m_error(AnalysisError::None)
+  , m_exploit_successful(false)
+  , m_sink_context(AttackContext::None)
+  , m_filter_successful()
+  , m_filter_contained()
+  , m_payload(false)
+  , m_vulnerable_payload(false)
+  , m_all_errored_payloads(false)
+  , m_bypass(false)
+  , m_domains()
+  , m_domains_with_payload()
+  , m_vulnerable_domains_with_payload()
+  , m_injection_points()
+  , m_header()
+  , m_result()
+  , m_result_with_header()
+  , m_generated_payloads()
+  , m_unmatched_uuids()
+{
+}
+
+SanitizerRecord::SanitizerRecord(const SanitizerResult& result, const std::vector<AttackContext>& contexts)
+  : m_file_name(result.getFileName())
+  , m_count_with_duplicates(result.getCountWithDuplicates())
+  , m_count(result.getCount())
+  , m_done(result.isDone())
+  , m_errored(result.isErrored())
+  , m_error(result.getError())
+  , m_exploit_successful(result.isExploitSuccessful())
+  , m_sink_context(result.getSinkContext())
+  , m_filter_successful()
+  , m_filter_contained()
+  , m_payload(result.hasAtLeastOnePayload())
+  , m_vulnerable_payload(result.hasAtLeastOneVulnerablePayload())
+  , m_all_errored_payloads(result.hasAllErroredPayloads())
+  , m_bypass(result.hasAtLeastOneBypass())
+  , m_domains(result.getUniqueDomains())
+  , m_domains_with_payload(result.getUniqueDomainsWithPayload())
+  , m_vulnerable_domains_with_payload(result.getVulnerableDomainsWithPayload())
+  , m_injection_points(result.getUniqueInjectionPoints())
+  , m_header(render([&](std::ostream& os) { result.printHeader(os, contexts); }))
+  , m_result(render([&](std::ostream& os) { result.printResult(os, false, contexts); }))
+  , m_result_with_header(render([&](std::ostream& os) { result.printResult(os, true, contexts); }))
+  , m_generated_payloads(render([&](std::ostream& os) { result.printGeneratedPayloads(os); }))
+  , m_unmatched_uuids(render([&](std::ostream& os) { result.printUnmatchedUuids(os); }))
+{
+  // The group summaries query every context, not only the analysed ones
+  for (AttackContext context : AttackContextHelper::getContexts()) {
+    int c = static_cast<int>(context);
+    if (result.isFilterSuccessful(context)) {
+      m_filter_successful.insert(c);
+    }
+    if (result.isFilterContained(context)) {
+      m_filter_contained.insert(c);
+    }
+  }
+}
+
+void SanitizerRecord::write(std::ostream& os) const
+{
+  writeString(os, m_file_name);
+  writeInt(os, m_count_with_duplicates);
+  writeInt(os, m_count);
+  writeBool(os, m_done);
+  writeBool(os, m_errored);
+  writeInt(os, static_cast<int>(m_error));
+  writeBool(os, m_exploit_successful);
+  writeInt(os, static_cast<int>(m_sink_context));
+  writeIntSet(os, m_filter_successful);
+  writeIntSet(os, m_filter_contained);
+  writeBool(os, m_payload);
+  writeBool(os, m_vulnerable_payload);
+  writeBool(os, m_all_errored_payloads);
+  writeBool(os, m_bypass);
+  writeStringSet(os, m_domains);
+  writeStringSet(os, m_domains_with_payload);
+  writeStringSet(os, m_vulnerable_domains_with_payload);
+  writeIntSet(os, m_injection_points);
+  writeString(os, m_header);
+  writeString(os, m_result);
+  writeString(os, m_result_with_header);
+  writeString(os, m_generated_payloads);
+  writeString(os, m_unmatched_uuids);
+}
+
+void SanitizerRecord::read(std::istream& is)
+{
+  m_file_name = readString(is);
+  m_count_with_duplicates = readInt(is);
+  m_count = readInt(is);
+  m_done = readBool(is);
+  m_errored = readBool(is);
+  m_error = static_cast<AnalysisError>(readInt(is));
+  m_exploit_successful = readBool(is);
+  m_sink_context = static_cast<AttackContext>(readInt(is));
+  m_filter_successful = readIntSet(is);
+  m_filter_contained = readIntSet(is);
+  m_payload = readBool(is);
+  m_vulnerable_payload = readBool(is);
+  m_all_errored_payloads = readBool(is);
+  m_bypass = readBool(is);
+  m_domains = readStringSet(is);
+  m_domains_with_payload = readStringSet(is);
+  m_vulnerable_domains_with_payload = readStringSet(is);
+  m_injection_points = readIntSet(is);
+  m_header = readString(is);
+  m_result = readString(is);
+  m_result_with_header = readString(is);
+  m_generated_payloads = readString(is);
+  m_unmatched_uuids = readString(is);
+}
+
+bool SanitizerRecord::isFilterSuccessful(const AttackContext& context) const
+{
+  return m_filter_successful.count(static_cast<int>(context)) > 0;
+}
+
+bool SanitizerRecord::isFilterContained(const AttackContext& context) const
+{
+  return m_filter_contained.count(static_cast<int>(context)) > 0;
+}
+
+void SanitizerRecord::printHeader(std::ostream& os, const std::vector<AttackContext>& /* contexts */) const
+{
+  os << m_header;
+}
+
+void SanitizerRecord::printResult(std::ostream& os, bool printHeader, const std::vector<AttackContext>& /* contexts */) const
+{
+  os << (printHeader ? m_result_with_header : m_result);
+}
+
+void SanitizerRecord::printGeneratedPayloads(std::ostream& os) const
+{
+  os << m_generated_payloads;
+}
+
+void SanitizerRecord::printUnmatchedUuids(std::ostream& os) const
+{
+  os << m_unmatched_uuids;
+}
+
+const std::string ShardResults::shard_file_name = "semattack_shard.dat";
+const std::string ShardResults::shard_group_dir = "semattack_shard_groups";
+
+ShardResults::ShardResults()
+  : m_automata()
+  , m_records()
+  , m_groups()
+  , m_contexts()
+  , m_seen_shards()
+  , m_shards(0)
+  , m_shards_read(0)
+  , m_dot_count(0)
+  , m_threads(0)
+{
+  MultiAttack::fillCommonPatterns(m_groups, m_automata);
+}
+
+ShardResults::~ShardResults()
+{
+  for (auto iter : m_automata) {
+    delete iter;
+  }
+  m_automata.clear();
+}
+
+void ShardResults::write(const fs::path& dir, unsigned int shard, unsigned int shards,
+                         const AutomatonGroups& groups, const std::vector<const SanitizerResult*>& results,
+                         const std::vector<AttackContext>& contexts, unsigned int dot_count, unsigned int threads)
+{
+  fs::path group_dir(dir / fs::path(shard_group_dir));
+  fs::create_directories(group_dir);
+
+  fs::path output(dir / fs::path(shard_file_name));
+  std::ofstream ofs(output.string(), std::ofstream::out | std::ofstream::binary);
+  if (!ofs) {
+    throw std::runtime_error(stringbuilder() << "Could not open shard file " << output.string());
+  }
+
+  writeString(ofs, shard_magic);
+  writeInt(ofs, shard);
+  writeInt(ofs, shards);
+  writeInt(ofs, dot_count);
+  writeInt(ofs, threads);
+  writeInt(ofs, contexts.size());
+  for (auto c : contexts) {
+    writeInt(ofs, static_cast<int>(c));
+  }
+
+  std::unordered_map<const SanitizerResult*, long> index;
+  writeInt(ofs, results.size());
+  for (auto result : results) {
+    index.insert(std::make_pair(result, static_cast<long>(index.size())));
+    SanitizerRecord(*result, contexts).write(ofs);
+  }
+
+  writeInt(ofs, groups.getGroups().size());
+  for (const auto& group : groups.getGroups()) {
+    writeInt(ofs, group.getId());
+    writeString(ofs, group.getName());
+    const StrangerAutomaton* automaton = group.getAutomaton();
+    writeBool(ofs, automaton != nullptr);
+    if (automaton != nullptr) {
+      automaton->exportToFile((group_dir / fs::path(std::to_string(group.getId()) + ".bdd")).string());
+    }
+    const auto& members = group.getMembers();
+    writeInt(ofs, members.size());
+    for (auto member : members) {
+      auto search = index.find(member);
+      if (search == index.end()) {
+        throw std::runtime_error(stringbuilder() << "Group " << group.getName() << " refers to an unknown result");
+      }
+      writeInt(ofs, search->second);
+    }
+  }
+  ofs.close();
+}
+
+void ShardResults::addShard(const fs::path& dir)
+{
+  fs::path input(dir / fs::path(shard_file_name));
+  std::ifstream ifs(input.string(), std::ifstream::in | std::ifstream::binary);
+  if (!ifs) {
+    throw std::runtime_error(stringbuilder() << "Could not open shard file " << input.string());
+  }
+
+  if (readString(ifs) != shard_magic) {
+    throw std::runtime_error(stringbuilder() << input.string() << " is not a multiattack shard file");
+  }
+  unsigned int shard = readInt(ifs);
+  unsigned int shards = readInt(ifs);
+  unsigned int dot_count = readInt(ifs);
+  unsigned int threads = readInt(ifs);
+  std::vector<AttackContext> contexts;
+  long nContexts = readInt(ifs);
+  for (long i = 0; i < nContexts; i++) {
+    contexts.push_back(static_cast<AttackContext>(readInt(ifs)));
+  }
+
+  if (m_shards_read == 0) {
+    m_shards = shards;
+    m_contexts = contexts;
+  } else if (shards != m_shards) {
+    throw std::runtime_error(stringbuilder() << input.string() << " is shard " << shard << "/" << shards
+                             << ", expected a shard of " << m_shards);
+  } else if (contexts != m_contexts) {
+    throw std::runtime_error(stringbuilder() << input.string() << " was computed with different attack patterns");
+  }
+  if (!m_seen_shards.insert(shard).second) {
+    throw std::runtime_error(stringbuilder() << "Shard " << shard << "/" << shards << " was given twice");
+  }
+  // Every shard enumerates all inputs, so the count is the same for all of them
+  m_dot_count = std::max(m_dot_count, dot_count);
+  m_threads = std::max(m_threads, threads);
+
+  std::size_t first = m_records.size();
+  long nRecords = readInt(ifs);
+  for (long i = 0; i < nRecords; i++) {
+    std::unique_ptr<SanitizerRecord> record(new SanitizerRecord());
+    record->read(ifs);
+    m_records.push_back(std::move(record));
+  }
+
+  fs::path group_dir(dir / fs::path(shard_group_dir));
+  long nGroups = readInt(ifs);
+  for (long i = 0; i < nGroups; i++) {
+    int id = readInt(ifs);
+    std::string name = readString(ifs);
+    bool hasAutomaton = readBool(ifs);
+    std::vector<long> members;
+    long nMembers = readInt(ifs);
+    for (long j = 0; j < nMembers; j++) {
+      long member = readInt(ifs);
+      if (member < 0 || member >= nRecords) {
+        throw std::runtime_error(stringbuilder() << "Group " << name << " in " << input.string() << " refers to an unknown result");
+      }
+      members.push_back(member);
+    }
+    // The common patterns are already present, nothing to add for empty groups
+    if (members.empty()) {
+      continue;
+    }
+
+    StrangerAutomaton* automaton = nullptr;
+    if (hasAutomaton) {
+      automaton = StrangerAutomaton::importFromFile((group_dir / fs::path(std::to_string(id) + ".bdd")).string());
+    }
+    AutomatonGroup* group = m_groups.getGroupForAutomaton(automaton);
+    if (group) {
+      delete automaton;
+    } else {
+      m_automata.push_back(automaton);
+      group = m_groups.addGroup(automaton);
+    }
+    for (long member : members) {
+      m_groups.addResult(group, m_records.at(first + member).get());
+    }
+  }
+  m_shards_read++;
+}
+
+void ShardResults::writeResultsToFile(const fs::path& dir) const
+{
+  if (m_shards_read != m_shards) {
+    std::cerr << "Warning: merging " << m_shards_read << " of " << m_shards << " shards, results are incomplete" << std::endl;
+  }
+  std::vector<const SanitizerResult*> results;
+  results.reserve(m_records.size());
+  for (const auto& record : m_records) {
+    results.push_back(record.get());
+  }
+  MultiAttack::writeResultsToFile(dir, m_groups, results, m_contexts, m_dot_count, m_threads);
+}
@@ -0,0 +1,149 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * ShardResults.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef SHARD_RESULTS_HPP_
+#define SHARD_RESULTS_HPP_
+
+#define BOOST_FILESYSTEM_VERSION 3
+#define BOOST_FILESYSTEM_NO_DEPRECATED
+#include <boost/filesystem.hpp>
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "AutomatonGroups.hpp"
+#include "SanitizerResult.hpp"
+#include "StrangerAutomaton.hpp"
+
+namespace fs = boost::filesystem;
+
+// A snapshot of a finished sanitizer analysis which can be written to and
+// read back from a shard result file. The report rows are rendered when the
+// snapshot is taken, so the merged reports match those of a single run.
+class SanitizerRecord : public SanitizerResult {
+
+public:
+  SanitizerRecord();
+  SanitizerRecord(const SanitizerResult& result, const std::vector<AttackContext>& contexts);
+
+  void write(std::ostream& os) const;
+  void read(std::istream& is);
+
+  std::string getFileName() const override { return m_file_name; }
+  int getCountWithDuplicates() const override { return m_count_with_duplicates; }
+  int getCount() const override { return m_count; }
+  bool isDone() const override { return m_done; }
+
+  bool isErrored() const override { return m_errored; }
+  AnalysisError getError() const override { return m_error; }
+
+  bool isExploitSuccessful() const override { return m_exploit_successful; }
+  AttackContext getSinkContext() const override { return m_sink_context; }
+
+  bool isFilterSuccessful(const AttackContext& context) const override;
+  bool isFilterContained(const AttackContext& context) const override;
+
+  bool hasAtLeastOnePayload() const override { return m_payload; }
+  bool hasAtLeastOneVulnerablePayload() const override { return m_vulnerable_payload; }
+  bool hasAllErroredPayloads() const override { return m_all_errored_payloads; }
+  bool hasAtLeastOneBypass() const override { return m_bypass; }
+
+  std::set<std::string> getUniqueDomains() const override { return m_domains; }
+  std::set<std::string> getUniqueDomainsWithPayload() const override { return m_domains_with_payload; }
+  std::set<std::string> getVulnerableDomainsWithPayload() const override { return m_vulnerable_domains_with_payload; }
+  std::set<int> getUniqueInjectionPoints() const override { return m_injection_points; }
+
+  // The rendered rows are only valid for the contexts the shard was run with
+  void printHeader(std::ostream& os, const std::vector<AttackContext>& contexts) const override;
+  void printResult(std::ostream& os, bool printHeader, const std::vector<AttackContext>& contexts) const override;
+  void printGeneratedPayloads(std::ostream& os) const override;
+  void printUnmatchedUuids(std::ostream& os) const override;
+
+private:
+  std::string m_file_name;
+  int m_count_with_duplicates;
+  int m_count;
+  bool m_done;
+  bool m_errored;
+  AnalysisError m_error;
+  bool m_exploit_successful;
+  AttackContext m_sink_context;
+  std::set<int> m_filter_successful;
+  std::set<int> m_filter_contained;
+  bool m_payload;
+  bool m_vulnerable_payload;
+  bool m_all_errored_payloads;
+  bool m_bypass;
+  std::set<std::string> m_domains;
+  std::set<std::string> m_domains_with_payload;
+  std::set<std::string> m_vulnerable_domains_with_payload;
+  std::set<int> m_injection_points;
+
+  std::string m_header;
+  std::string m_result;
+  std::string m_result_with_header;
+  std::string m_generated_payloads;
+  std::string m_unmatched_uuids;
+};
+
+// Reads and writes the partial results of a sharded multiattack run.
+// A shard directory holds semattack_shard.dat with the records and group
+// memberships, and one .bdd file per group automaton.
+class ShardResults {
+
+public:
+  ShardResults();
+  virtual ~ShardResults();
+
+  static void write(const fs::path& dir, unsigned int shard, unsigned int shards,
+                    const AutomatonGroups& groups, const std::vector<const SanitizerResult*>& results,
+                    const std::vector<AttackContext>& contexts, unsigned int dot_count, unsigned int threads);
+
+  // Adds the groups and records of a shard written by write()
+  void addShard(const fs::path& dir);
+  void writeResultsToFile(const fs::path& dir) const;
+
+  unsigned int getShards() const { return m_shards_read; }
+
+  static const std::string shard_file_name;
+  static const std::string shard_group_dir;
+
+private:
+  // Owns the imported automata and records, the groups only refer to them
+  std::vector<StrangerAutomaton*> m_automata;
+  std::vector<std::unique_ptr<SanitizerRecord> > m_records;
+  AutomatonGroups m_groups;
+  std::vector<AttackContext> m_contexts;
+  std::set<unsigned int> m_seen_shards;
+  unsigned int m_shards;
+  unsigned int m_shards_read;
+  unsigned int m_dot_count;
+  unsigned int m_threads;
+};
+
+#endif /* SHARD_RESULTS_HPP_ */
@@ -25,6 +25,9 @@
  */
 #include "StrangerAutomaton.hpp"
 #include "exceptions/StrangerException.hpp"
+#include "RegExpCompiler.hpp"
+#include <algorithm>
+#include <set>
 
 using namespace std;
 
@@ -32,12 +35,17 @@ StrangerAutomaton::StrangerAutomaton(DFA* dfa)
 {
 	init();
 	this->dfa = dfa;
+	if (dfa != NULL) {
+		this->dfa_owner.reset(dfa, dfaFree);
+	}
 }
 
 StrangerAutomaton::StrangerAutomaton(const StrangerAutomaton* other)
 {
-	init();        
-	this->dfa = dfaCopy(other->dfa);
+	init();
+	this->dfa = other->dfa;
+	this->dfa_owner = other->dfa_owner;
+	this->minimized = other->minimized;
 }
 
 StrangerAutomaton::StrangerAutomaton()
@@ -48,16 +56,16 @@ void StrangerAutomaton::init()
 {
     top = false;
     bottom = false;
+    minimized = true;
+    this->dfa = NULL;
     this->ID = -1;
     this->autoTraceID = traceID++;
 }
 
 StrangerAutomaton::~StrangerAutomaton()
 {
-    if (this->dfa != NULL ){
-        dfaFree(this->dfa);
-        this->dfa = NULL;
-    }
+    // The DFA is freed with its last handle
+    this->dfa = NULL;
 }
 
 // some static members
@@ -82,6 +90,8 @@ char StrangerAutomaton::slash = '/';
 
 bool StrangerAutomaton::coarseWidening = false;
 
+int StrangerAutomaton::deferredMinimization = 0;
+
 PerfInfo* StrangerAutomaton::perfInfo = &PerfInfo::getInstance();
 
 
@@ -100,6 +110,7 @@ StrangerAutomaton* StrangerAutomaton::clone(int id) const
         else {
 		debugToFile(stringbuilder() << "M[" << traceID << "] = dfaCopy(M["  << this->autoTraceID << "]);//" << id << " = clone(" << this->ID << ")");
 		StrangerAutomaton* retMe = new StrangerAutomaton(dfaCopy(this->dfa));
+		retMe->minimized = this->minimized;
 		{
 			retMe->setID(id);
 			retMe->debugAutomaton();
@@ -113,6 +124,80 @@ StrangerAutomaton* StrangerAutomaton::clone() const
     return this->clone(-1);
 }
 
+StrangerAutomaton* StrangerAutomaton::share(int id) const
+{
+	debug(stringbuilder() << id << " = share(" << this->ID << ")");
+	// Replaying the trace needs a DFA per automaton
+	debugToFile(stringbuilder() << "M[" << traceID << "] = dfaCopy(M["  << this->autoTraceID << "]);//" << id << " = share(" << this->ID << ")");
+	StrangerAutomaton* retMe = new StrangerAutomaton(this);
+	retMe->top = this->top;
+	retMe->bottom = this->bottom;
+	retMe->setID(id);
+	return retMe;
+}
+
+StrangerAutomaton* StrangerAutomaton::share() const
+{
+    return this->share(-1);
+}
+
+bool StrangerAutomaton::isMinimized() const
+{
+    return this->minimized;
+}
+
+StrangerAutomaton* StrangerAutomaton::minimize(int id) const
+{
+	if (this->minimized || this->isNull()) {
+		return this->share(id);
+	}
+	debug(stringbuilder() << id << " = minimize(" << this->ID << ")");
+	debugToFile(stringbuilder() << "M[" << traceID << "] = dfaMinimize(M["  << this->autoTraceID << "]);//" << id << " = minimize(" << this->ID << ")");
+	boost::posix_time::ptime start_time = perfInfo->current_time();
+	StrangerAutomaton* retMe = new StrangerAutomaton(dfaMinimize(this->dfa));
+	perfInfo->minimize_total_time += perfInfo->current_time() - start_time;
+	perfInfo->num_of_minimize++;
+	{
+		retMe->setID(id);
+		retMe->debugAutomaton();
+	}
+	return retMe;
+}
+
+StrangerAutomaton* StrangerAutomaton::minimize() const
+{
+    return this->minimize(this->ID);
+}
+
+std::shared_ptr<DFA> StrangerAutomaton::getMinimalDfa() const
+{
+    if (this->minimized || this->isNull()) {
+        return this->dfa_owner;
+    }
+    boost::posix_time::ptime start_time = perfInfo->current_time();
+    std::shared_ptr<DFA> retMe(dfaMinimize(this->dfa), dfaFree);
+    perfInfo->minimize_total_time += perfInfo->current_time() - start_time;
+    perfInfo->num_of_minimize++;
+    return retMe;
+}
+
+// The dfa_*_deferred functions return results with at most max_states states
+// as they are
+void StrangerAutomaton::setMinimizedBy(int max_states)
+{
+    this->minimized = (max_states <= 0) || (this->dfa->ns > max_states);
+}
+
+void StrangerAutomaton::setDeferredMinimization(int max_states)
+{
+    deferredMinimization = max_states;
+}
+
+int StrangerAutomaton::getDeferredMinimization()
+{
+    return deferredMinimization;
+}
+
 
 
 /**
@@ -495,6 +580,44 @@ StrangerAutomaton* StrangerAutomaton::makePhi() {
     return makePhi(traceID);
 }
 
+/**
+ * Builds an automaton from an explicit transition table, such as the result
+ * of a subset construction. Characters leading to the same state are stored
+ * as shared BDD paths, so large character classes stay small.
+ * @param n_states: number of states, state 0 is the initial state
+ * @param transitions: character ranges between states
+ * @param accepting: '+' for accepting and '-' for rejecting states
+ * @param id
+ *            : id of node associated with this auto; used for debugging
+ *            purposes only
+ * @return
+ */
+StrangerAutomaton* StrangerAutomaton::makeFromTransitions(int n_states, std::vector<transition>& transitions,
+                                                          const std::string& accepting, int id) {
+    debug(stringbuilder() << id <<  " = makeFromTransitions(" << n_states << " states, "
+          << transitions.size() << " transitions)");
+    if (n_states <= 0 || accepting.size() != (std::size_t) n_states) {
+        throw StrangerException(AnalysisError::InvalidArgument, stringbuilder()
+                                << "makeFromTransitions: " << accepting.size()
+                                << " acceptance flags for " << n_states << " states");
+    }
+    std::vector<char> accept(accepting.begin(), accepting.end());
+    accept.push_back('\0');
+    DFA* built = dfa_construct_from_ranges(n_states, (int) transitions.size(),
+                                           transitions.empty() ? NULL : &transitions[0],
+                                           &accept[0], num_ascii_track, indices_main);
+    if (built == NULL) {
+        throw StrangerException(AnalysisError::MonaException, "Null DFA pointer returned from MONA");
+    }
+    StrangerAutomaton* retMe = new StrangerAutomaton(dfaMinimize(built));
+    dfaFree(built);
+    {
+        retMe->setID(id);
+        retMe->debugAutomaton();
+    }
+    return retMe;
+}
+
 std::string StrangerAutomaton::generateSatisfyingExample() const
 {
     std::string str;
@@ -872,10 +995,12 @@ StrangerAutomaton* StrangerAutomaton::union_(const StrangerAutomaton* otherAuto,
         return this->clone(id);
     
     
-    debugToFile(stringbuilder() << "M[" << traceID << "] = dfa_union_with_emptycheck(M[" << this->autoTraceID << "], M["<< otherAuto->autoTraceID  << "], NUM_ASCII_TRACKS, indices_main);//"<<id << " = union_("  << this->ID <<  ", " << otherAuto->ID << ")");
+    const int max_states = deferredMinimization;
+    debugToFile(stringbuilder() << "M[" << traceID << "] = dfa_union_with_emptycheck_deferred(M[" << this->autoTraceID << "], M["<< otherAuto->autoTraceID  << "], NUM_ASCII_TRACKS, indices_main, " << max_states << ");//"<<id << " = union_("  << this->ID <<  ", " << otherAuto->ID << ")");
 
     boost::posix_time::ptime start_time = perfInfo->current_time();
-    StrangerAutomaton* retMe = new StrangerAutomaton(dfa_union_with_emptycheck(this->dfa, otherAuto->dfa, num_ascii_track, indices_main));
+    StrangerAutomaton* retMe = new StrangerAutomaton(dfa_union_with_emptycheck_deferred(this->dfa, otherAuto->dfa, num_ascii_track, indices_main, max_states));
+    retMe->setMinimizedBy(max_states);
     perfInfo->union_total_time += perfInfo->current_time() - start_time;
     perfInfo->num_of_union++;
     
@@ -946,10 +1071,12 @@ StrangerAutomaton* StrangerAutomaton::intersect(const StrangerAutomaton* otherAu
     else if (otherAuto->isTop())
         return this->clone(id);
     
-    debugToFile(stringbuilder() << "M[" << traceID << "] = dfa_intersect(M[" << this->autoTraceID << "], M["<< otherAuto->autoTraceID  << "]);//"<<id << " = intersect("  << this->ID <<  ", " << otherAuto->ID << ")");
+    const int max_states = deferredMinimization;
+    debugToFile(stringbuilder() << "M[" << traceID << "] = dfa_intersect_deferred(M[" << this->autoTraceID << "], M["<< otherAuto->autoTraceID  << "], " << max_states << ");//"<<id << " = intersect("  << this->ID <<  ", " << otherAuto->ID << ")");
 
     boost::posix_time::ptime start_time = perfInfo->current_time();
-    StrangerAutomaton* retMe = new StrangerAutomaton(dfa_intersect(this->dfa, otherAuto->dfa));
+    StrangerAutomaton* retMe = new StrangerAutomaton(dfa_intersect_deferred(this->dfa, otherAuto->dfa, max_states));
+    retMe->setMinimizedBy(max_states);
     perfInfo->intersect_total_time += perfInfo->current_time() - start_time;
     perfInfo->num_of_intersect++;
     
@@ -1027,7 +1154,9 @@ StrangerAutomaton* StrangerAutomaton::preciseWiden(const StrangerAutomaton* othe
     debugToFile(stringbuilder() << "M[" << traceID << "] = dfaWiden(M[" << this->autoTraceID << "], M["<< otherAuto->autoTraceID  << "]);//"<<id << " = precise_widen("  << this->ID <<  ", " << otherAuto->ID << ")");
 
     boost::posix_time::ptime start_time = perfInfo->current_time();
-    StrangerAutomaton* retMe = new StrangerAutomaton(dfaWiden(this->dfa, otherAuto->dfa));
+    std::shared_ptr<DFA> thisDfa = this->getMinimalDfa();
+    std::shared_ptr<DFA> otherDfa = otherAuto->getMinimalDfa();
+    StrangerAutomaton* retMe = new StrangerAutomaton(dfaWiden(thisDfa.get(), otherDfa.get()));
     perfInfo->precisewiden_total_time += perfInfo->current_time() - start_time;
     perfInfo->num_of_precisewiden++;
     
@@ -1079,7 +1208,9 @@ StrangerAutomaton* StrangerAutomaton::coarseWiden(const StrangerAutomaton* other
     debugToFile(stringbuilder() << "M[" << traceID << "] = dfaWiden(M[" << this->autoTraceID << "], M["<< otherAuto->autoTraceID  << "]);//"<<id << " = coarse_widen("  << this->ID <<  ", " << otherAuto->ID << ")");
 
     boost::posix_time::ptime start_time = perfInfo->current_time();
-    StrangerAutomaton* retMe = new StrangerAutomaton(dfaWiden(this->dfa, otherAuto->dfa));
+    std::shared_ptr<DFA> thisDfa = this->getMinimalDfa();
+    std::shared_ptr<DFA> otherDfa = otherAuto->getMinimalDfa();
+    StrangerAutomaton* retMe = new StrangerAutomaton(dfaWiden(thisDfa.get(), otherDfa.get()));
     perfInfo->coarsewiden_total_time += perfInfo->current_time() - start_time;
     perfInfo->num_of_coarsewiden++;
     {
@@ -1127,12 +1258,13 @@ StrangerAutomaton* StrangerAutomaton::concatenate(const StrangerAutomaton* other
     else if (this->isBottom() || otherAuto->isBottom())
         return makeBottom(id);
     
-    debugToFile(stringbuilder() << "M[" << traceID << "] = dfa_concat(M[" << this->autoTraceID << "], M["<< otherAuto->autoTraceID  << "], NUM_ASCII_TRACKS, indices_main);//"<<id << " = concatenate("  << this->ID <<  ", " << otherAuto->ID << ")");
+    const int max_states = deferredMinimization;
+    debugToFile(stringbuilder() << "M[" << traceID << "] = dfa_concat_deferred(M[" << this->autoTraceID << "], M["<< otherAuto->autoTraceID  << "], NUM_ASCII_TRACKS, indices_main, " << max_states << ");//"<<id << " = concatenate("  << this->ID <<  ", " << otherAuto->ID << ")");
 
     boost::posix_time::ptime start_time = perfInfo->current_time();
     // dfa_concat_extrabit returns new dfa structure in memory so no need to
     // worry about the two dfas of this and auto
-    StrangerAutomaton* retMe = new StrangerAutomaton(dfa_concat(this->dfa, otherAuto->dfa, num_ascii_track, indices_main));
+    StrangerAutomaton* retMe = new StrangerAutomaton(dfa_concat_deferred(this->dfa, otherAuto->dfa, num_ascii_track, indices_main, max_states));
     perfInfo->concat_total_time += perfInfo->current_time() - start_time;
     perfInfo->num_of_concat++;
 
@@ -1143,6 +1275,7 @@ StrangerAutomaton* StrangerAutomaton::concatenate(const StrangerAutomaton* other
     if (retMe->isNull()) {
         throw StrangerException(AnalysisError::MonaException, "Null DFA pointer returned from MONA");
     }
+    retMe->setMinimizedBy(max_states);
     return retMe;
 }
 
@@ -1406,12 +1539,8 @@ StrangerAutomaton* StrangerAutomaton::regExToAuto(std::string phpRegexOrig,
         }
         RegExp::restID();// for debugging purposes only
         try {
-            RegExp* regExp = new RegExp(phpRegexOrig, RegExp::NONE);
-            std::string regExpStringVal;
-            debug(stringbuilder() << id <<  ": regExToString = "
-                  << regExp->toStringBuilder(regExpStringVal));
-            retMe = regExp->toAutomaton();
-            delete regExp;
+            // Compiled once per pattern and shared between threads
+            retMe = RegExpCompiler::compilePattern(phpRegexOrig, id);
         } catch (...) {
             std::cout << "Exception thrown parsing RegExp: " << phpRegexOrig << std::endl;
             throw;
@@ -1912,6 +2041,58 @@ bool StrangerAutomaton::checkIntersection(const StrangerAutomaton* otherAuto) {
     return this->checkIntersection(otherAuto, -1, -1);
 }
 
+/**
+ * returns true if L(this auto) intersect L(auto) != phi (empty language).
+ * The product is explored state pair by state pair and the search stops
+ * at the first pair accepting in both automata, so no intersection automaton
+ * is built. If the intersection is not empty, example is set to a shortest
+ * string in it (which might be the empty string).
+ * @param auto
+ * @param example
+ * @return
+ */
+bool StrangerAutomaton::checkIntersection(const StrangerAutomaton* otherAuto, std::string& example) const {
+    std::string debugStr = stringbuilder() << "checkIntersection("  << this->ID <<  ", " << otherAuto->ID << ") = ";
+    example.clear();
+
+    if (this->isBottom() || otherAuto->isBottom()) {
+        debug(stringbuilder() << debugStr << "false");
+        return false;
+    } else if (this->isTop() || otherAuto->isTop()) {
+        // Top has no meaningful dfa, fall back to the other automaton
+        const StrangerAutomaton* other = this->isTop() ? otherAuto : this;
+        if (other->isTop()) {
+            debug(stringbuilder() << debugStr << "true");
+            return true;
+        }
+        bool result = !other->isEmpty();
+        if (result) {
+            example = other->generateSatisfyingExample();
+        }
+        debug(stringbuilder() << debugStr << result);
+        return result;
+    } else if (this->isNull() || otherAuto->isNull()) {
+        throw StrangerException(AnalysisError::MonaException,
+                                "Null DFA pointer in checkIntersection for StrangerAutomaton.");
+    }
+
+    debugToFile(stringbuilder() << "check_intersection_example(M[" << this->autoTraceID << "],M["<< otherAuto->autoTraceID  << "], NUM_ASCII_TRACKS, u_indices_main, &example, &length);//check_intersection("  << this->ID <<  ", " << otherAuto->ID << ")");
+    boost::posix_time::ptime start_time = perfInfo->current_time();
+    char* result_example = nullptr;
+    int length = 0;
+    int result = check_intersection_example(this->dfa, otherAuto->dfa, num_ascii_track,
+                                            u_indices_main, &result_example, &length);
+    perfInfo->intersect_check_total_time += perfInfo->current_time() - start_time;
+    perfInfo->num_of_intersect_check++;
+
+    if (result_example != nullptr) {
+        example.assign(result_example, length);
+        free(result_example);
+    }
+    debug(stringbuilder() << debugStr <<  (result == 0 ? false : true));
+    return (result != 0);
+}
+
 /**
  * return true if parameter auto includes this otherAuto-> i.e. returns true if L(this auto)
  * is_subset_of L(parameter auto)
@@ -1925,10 +2106,28 @@ bool StrangerAutomaton::checkIntersection(const StrangerAutomaton* otherAuto) {
  *            purposes only * @return
  */
 bool StrangerAutomaton::checkInclusion(const StrangerAutomaton* otherAuto, int id1, int id2) const {
-    std::string debugStr = stringbuilder() << "checkInclusion("  << this->ID <<  ", " << otherAuto->ID << ") = ";
+    std::string counterexample;
+    return this->checkInclusion(otherAuto, counterexample);
+}
+
+/**
+ * return true if parameter auto includes this otherAuto-> i.e. returns true if L(this auto)
+ * is_subset_of L(parameter auto). The product of both autos is explored
+ * pair by pair and the search stops at the first pair accepting in this auto
+ * only, so neither the complement nor the product is built. Otherwise
+ * counterexample is set to a shortest string of L(this auto) \ L(auto).
+ *
+ * @param auto
+ * @param counterexample
+ * @return
+ */
+bool StrangerAutomaton::checkInclusion(const StrangerAutomaton* otherAuto, std::string& counterexample) const {
+    counterexample.clear();
     if ((otherAuto == nullptr) || this->isNull() || otherAuto->isNull()) {
         return false;
-    } else if (this->isBottom() || otherAuto->isTop()){
+    }
+    std::string debugStr = stringbuilder() << "checkInclusion("  << this->ID <<  ", " << otherAuto->ID << ") = ";
+    if (this->isBottom() || otherAuto->isTop()){
         // phi is always a subset of any other set, top is always superset of anything
         debug(stringbuilder() << debugStr << "true");
         return true;
@@ -1938,22 +2137,20 @@ bool StrangerAutomaton::checkInclusion(const StrangerAutomaton* otherAuto, int i
     }
     
     debugToFile(stringbuilder() << "check_inclusion(M[" << this->autoTraceID << "],M["<< otherAuto->autoTraceID  << "], NUM_ASCII_TRACKS, indices_main);//check_inclusion("  << this->ID <<  ", " << otherAuto->ID << ")");
-    int result = check_inclusion(this->dfa,
-                                 otherAuto->dfa, num_ascii_track,
-                                 indices_main);
-    
-    {
-        debug(stringbuilder() << debugStr <<  (result == 0 ? false : true));
-    }
-    
-    if (result == 0) {
-        return false;
-    } else if (result == 1) {
-        return true;
-    } else {
-        throw StrangerException(AnalysisError::MonaException,
-                                "Error in checkInclusion result for StrangerAutomaton.");
+    boost::posix_time::ptime start_time = perfInfo->current_time();
+    char* result_example = nullptr;
+    int length = 0;
+    int result = check_inclusion_example(this->dfa, otherAuto->dfa, num_ascii_track,
+                                         u_indices_main, &result_example, &length);
+    perfInfo->inclusion_check_total_time += perfInfo->current_time() - start_time;
+    perfInfo->num_of_inclusion_check++;
+
+    if (result_example != nullptr) {
+        counterexample.assign(result_example, length);
+        free(result_example);
     }
+    debug(stringbuilder() << debugStr <<  (result == 0 ? false : true));
+    return (result != 0);
 }
 
 /**
@@ -1967,6 +2164,120 @@ bool StrangerAutomaton::checkInclusion(const StrangerAutomaton* otherAuto) const
     return this->checkInclusion(otherAuto, -1, -1);
 }
 
+/**
+ * returns true if s is in L(this auto). The string is run through the dfa
+ * directly, no automaton is built for it. Strings containing NUL characters
+ * are never reported as members.
+ */
+bool StrangerAutomaton::checkMembership(const std::string& s) const {
+    if (this->isNull() || this->isBottom()) {
+        return false;
+    } else if (this->isTop()) {
+        return true;
+    } else if (s.find('\0') != std::string::npos) {
+        // Strings are NUL terminated for the stranger library
+        return false;
+    }
+    std::vector<char> str(s.begin(), s.end());
+    str.push_back('\0');
+    return (::checkMembership(this->dfa, str.data(), num_ascii_track, indices_main) == 1);
+}
+
+/**
+ * Refines a partition of the characters: afterwards two characters share a
+ * class only if they did before and this auto moves on both of them to the
+ * same state from every state. Top and bottom autos distinguish nothing.
+ * @param classes: class of every character, renumbered in place
+ * @return number of classes
+ */
+int StrangerAutomaton::refineCharClasses(std::vector<int>& classes) const {
+    if (classes.size() != 256) {
+        throw StrangerException(AnalysisError::InvalidArgument, stringbuilder()
+                                << "refineCharClasses: expected 256 classes, got " << classes.size());
+    }
+    if (this->isNull() || this->isTop() || this->isBottom()) {
+        std::set<int> distinct(classes.begin(), classes.end());
+        return (int) distinct.size();
+    }
+    return dfaRefineCharClasses(this->dfa, num_ascii_track, indices_main, classes.data());
+}
+
+/**
+ * Returns the set of characters which occur in at least one string accepted
+ * by this auto. The reserved characters are never part of top.
+ */
+std::bitset<256> StrangerAutomaton::getUsedChars() const {
+    std::bitset<256> retMe;
+    if (this->isNull() || this->isBottom()) {
+        return retMe;
+    } else if (this->isTop()) {
+        for (int c = 0; c < 254; c++) {
+            retMe.set(c);
+        }
+        return retMe;
+    }
+    std::vector<char> used(256, 0);
+    dfaUsedChars(this->dfa, num_ascii_track, indices_main, used.data());
+    for (int c = 0; c < 256; c++) {
+        if (used[c]) {
+            retMe.set(c);
+        }
+    }
+    return retMe;
+}
+
+/**
+ * Flattens the dfa of this auto: table[s * 256 + c] is the state reached from
+ * state s by character c, or -1 if there is none, and accepting[s] tells
+ * whether s accepts. Returns the start state, or -1 if the auto accepts
+ * nothing. Top is a single accepting state looping on all characters but the
+ * reserved ones.
+ */
+int StrangerAutomaton::getTransitionTable(std::vector<int>& table, std::vector<bool>& accepting) const {
+    table.clear();
+    accepting.clear();
+    if (this->isNull() || this->isBottom()) {
+        return -1;
+    } else if (this->isTop()) {
+        table.assign(256, 0);
+        table[254] = table[255] = -1;
+        accepting.assign(1, true);
+        return 0;
+    }
+    int n_chars = (num_ascii_track < 8) ? (1 << num_ascii_track) : 256;
+    std::vector<int> dests(this->dfa->ns * n_chars);
+    dfaTransitionTable(this->dfa, num_ascii_track, indices_main, dests.data());
+    table.assign(this->dfa->ns * 256, -1);
+    accepting.resize(this->dfa->ns);
+    for (int s = 0; s < this->dfa->ns; s++) {
+        std::copy(dests.begin() + s * n_chars, dests.begin() + (s + 1) * n_chars, table.begin() + s * 256);
+        accepting[s] = (this->dfa->f[s] == 1);
+    }
+    return this->dfa->s;
+}
+
+/**
+ * Returns a form of this auto which is the same for all autos whose dfas are
+ * equal up to the numbering of states and BDD nodes, see dfaCanonicalForm.
+ * Top and bottom autos only equal autos with the same flag, as in
+ * checkEquivalence.
+ */
+std::vector<int> StrangerAutomaton::getCanonicalForm() const {
+    std::vector<int> retMe;
+    if (this->isNull()) {
+        return retMe;
+    } else if (this->isTop() || this->isBottom()) {
+        retMe.push_back(this->isTop() ? -1 : -2);
+        return retMe;
+    }
+    int* form = nullptr;
+    std::shared_ptr<DFA> minimal = this->getMinimalDfa();
+    int length = dfaCanonicalForm(minimal.get(), &form);
+    retMe.assign(form, form + length);
+    free(form);
+    return retMe;
+}
+
 /**
  * returns true if this auto is equivalent to parameter otherAuto-> i.e. returns true if
  * L(parameter auto) == L(this auto)
@@ -1980,7 +2291,24 @@ bool StrangerAutomaton::checkInclusion(const StrangerAutomaton* otherAuto) const
  *            purposes only * @return
  */
 bool StrangerAutomaton::checkEquivalence(const StrangerAutomaton* otherAuto, int id1, int id2) const {
+    std::string counterexample;
+    return this->checkEquivalence(otherAuto, counterexample);
+}
+
+/**
+ * returns true if this auto is equivalent to parameter otherAuto-> i.e. returns true if
+ * L(parameter auto) == L(this auto). Pairs of states are explored on the fly
+ * and merged with union-find (Hopcroft-Karp), the search stops at the first
+ * pair accepting in only one auto. Otherwise counterexample is set to a
+ * string in exactly one of the languages.
+ *
+ * @param auto
+ * @param counterexample
+ * @return
+ */
+bool StrangerAutomaton::checkEquivalence(const StrangerAutomaton* otherAuto, std::string& counterexample) const {
     std::string debugStr = stringbuilder() << "checkEquivalence("  << this->ID <<  ", " << otherAuto->ID << ") = ";
+    counterexample.clear();
     
     if ((this->isTop() && otherAuto->isTop()) || (this->isBottom() && otherAuto->isBottom())){
         debug(stringbuilder() << debugStr << "true");
@@ -1992,26 +2320,20 @@ bool StrangerAutomaton::checkEquivalence(const StrangerAutomaton* otherAuto, int
     }
     
     debugToFile(stringbuilder() << "check_equivalence(M[" << this->autoTraceID << "],M["<< otherAuto->autoTraceID  << "], NUM_ASCII_TRACKS, indices_main);//check_equivalence("  << this->ID <<  ", " << otherAuto->ID << ")");
-    int result = check_equivalence(this->dfa,
-                                   otherAuto->dfa,
-                                   num_ascii_track,
-                                   indices_main);
-    
-    {
-        debug(stringbuilder() << debugStr << (result == 0 ? false : true));
-    }
-    
-    if (result == 0) {
-        return false;
-    } else if (result == 1) {
-        // They should both either include or exclude empty string
-        //			return (this->empty == otherAuto->empty);
-        return true;
-    } else {
-        // TODO: we should have our own exception for StrangerAutomaton
-        throw StrangerException(AnalysisError::MonaException,
-                                "Error in checkInclusion result for StrangerAutomaton.");
+    boost::posix_time::ptime start_time = perfInfo->current_time();
+    char* result_example = nullptr;
+    int length = 0;
+    int result = check_equivalence_example(this->dfa, otherAuto->dfa, num_ascii_track,
+                                           u_indices_main, &result_example, &length);
+    perfInfo->equivalence_check_total_time += perfInfo->current_time() - start_time;
+    perfInfo->num_of_equivalence_check++;
+
+    if (result_example != nullptr) {
+        counterexample.assign(result_example, length);
+        free(result_example);
     }
+    debug(stringbuilder() << debugStr << (result == 0 ? false : true));
+    return (result != 0);
 }
 
 /**
@@ -2031,7 +2353,8 @@ bool StrangerAutomaton::checkEquivalence(const StrangerAutomaton* otherAuto) con
  */
 bool StrangerAutomaton::isLengthFinite() const {
     std::string debugString = stringbuilder() << "isLengthFinite("  << this->ID << ") = ";
-    int result = ::isLengthFiniteTarjan(this->dfa, num_ascii_track, indices_main);
+    std::shared_ptr<DFA> minimal = this->getMinimalDfa();
+    int result = ::isLengthFiniteTarjan(minimal.get(), num_ascii_track, indices_main);
     debug(stringbuilder() << debugString << ( result == 0 ? false : true ));
     if (result == 0)
         return false;
@@ -2047,7 +2370,8 @@ unsigned StrangerAutomaton::getMaxLength() const {
             throw StrangerException(AnalysisError::InfiniteLength, "Length of this automaton is infinite! ID: " + this->ID);
 	}
 
-	P_DFAFiniteLengths finiteLengths = dfaGetLengthsFiniteLang(this->dfa, num_ascii_track, indices_main);
+	std::shared_ptr<DFA> minimal = this->getMinimalDfa();
+	P_DFAFiniteLengths finiteLengths = dfaGetLengthsFiniteLang(minimal.get(), num_ascii_track, indices_main);
 	const unsigned size = finiteLengths->size;
 	unsigned *lengths = finiteLengths->lengths;
 	unsigned max_length = lengths[size-1];
@@ -2067,7 +2391,8 @@ unsigned StrangerAutomaton::getMinLength() const {
             throw StrangerException(AnalysisError::InfiniteLength, "Length of this automaton is infinite! ID: " + this->ID);
 	}
 
-	P_DFAFiniteLengths finiteLengths = dfaGetLengthsFiniteLang(this->dfa, num_ascii_track, indices_main);
+	std::shared_ptr<DFA> minimal = this->getMinimalDfa();
+	P_DFAFiniteLengths finiteLengths = dfaGetLengthsFiniteLang(minimal.get(), num_ascii_track, indices_main);
 	unsigned *lengths = finiteLengths->lengths;
 	unsigned min_length = lengths[0];
 
@@ -2155,7 +2480,8 @@ bool StrangerAutomaton::checkEmptyString() const {
 }
 
 bool StrangerAutomaton::isSingleton() const {
-  char *s = ::isSingleton(this->dfa, num_ascii_track, indices_main);
+  std::shared_ptr<DFA> minimal = this->getMinimalDfa();
+  char *s = ::isSingleton(minimal.get(), num_ascii_track, indices_main);
   if (s == NULL) {
     return false;
   } else {
@@ -2165,7 +2491,8 @@ bool StrangerAutomaton::isSingleton() const {
 }
 
 string StrangerAutomaton::getStr() const {
-    char* result = ::isSingleton(this->dfa, num_ascii_track, indices_main);
+    std::shared_ptr<DFA> minimal = this->getMinimalDfa();
+    char* result = ::isSingleton(minimal.get(), num_ascii_track, indices_main);
     if (result == NULL){
         throw StrangerException(AnalysisError::MonaException, "Trying to get a string for an automaton with a nonSingleton language.");
     }
@@ -34,6 +34,9 @@
 #include "stranger/stranger.h"
 #undef export
 
+#include <algorithm>
+#include <bitset>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -42,11 +45,32 @@ class RegExp;
 class StrangerAutomaton
 {
 public:
+    // Shares the DFA of other, see share()
     StrangerAutomaton(const StrangerAutomaton* other);
+    // Takes ownership of dfa
     StrangerAutomaton(DFA* dfa);
     virtual ~StrangerAutomaton();
+    // Deep copy of the DFA, safe to hand to another thread
     StrangerAutomaton* clone(int id) const;
     StrangerAutomaton* clone() const;
+    // A new handle to the same DFA, which is freed with the last handle.
+    // Operations never modify their input DFAs, so this is as good as a
+    // clone, but MONA marks BDD nodes while reading a DFA: handles of one
+    // DFA must only be used by one thread at a time.
+    StrangerAutomaton* share(int id) const;
+    StrangerAutomaton* share() const;
+    // False for results of operations which skipped their final
+    // minimization, see setDeferredMinimization
+    bool isMinimized() const;
+    // The minimal auto of the same language, a share() if this auto is
+    // minimized already
+    StrangerAutomaton* minimize(int id) const;
+    StrangerAutomaton* minimize() const;
+    // intersect, union_ and concatenate leave results with at most
+    // max_states states unminimized, so chains of operations only minimize
+    // once. 0 (the default) minimizes every result.
+    static void setDeferredMinimization(int max_states);
+    static int getDeferredMinimization();
     int getID() const;
     void setID(int id);
     DFA* getDfa();
@@ -72,6 +96,10 @@ public:
     static StrangerAutomaton* makeDot();
     static StrangerAutomaton* makePhi(int id);
     static StrangerAutomaton* makePhi();
+    // Minimized automaton with the given states, where state i accepts if
+    // accepting[i] is '+'. Missing transitions go to an added sink state.
+    static StrangerAutomaton* makeFromTransitions(int n_states, std::vector<transition>& transitions,
+                                                  const std::string& accepting, int id);
     std::string generateSatisfyingExample() const;
     StrangerAutomaton* generateSatisfyingSingleton() const;
     StrangerAutomaton* optional(int id);
@@ -145,10 +173,32 @@ public:
     };
     bool checkIntersection(const StrangerAutomaton* auto_, int id1, int id2);
     bool checkIntersection(const StrangerAutomaton* auto_);
+    // Checks L(this) intersect L(auto_) != phi on the fly, without building the
+    // intersection. If not empty, example is set to a shortest common string.
+    bool checkIntersection(const StrangerAutomaton* auto_, std::string& example) const;
     bool checkInclusion(const StrangerAutomaton* auto_, int id1, int id2) const;
     bool checkInclusion(const StrangerAutomaton* auto_) const;
+    // As checkInclusion, searching the product on the fly. If L(this) is not
+    // included, counterexample is set to a shortest string of L(this) \ L(auto_).
+    bool checkInclusion(const StrangerAutomaton* auto_, std::string& counterexample) const;
+    bool checkMembership(const std::string& s) const;
+    // Splits the character classes (one entry per character) so that
+    // characters this automaton tells apart are in different classes.
+    // Returns the number of classes.
+    int refineCharClasses(std::vector<int>& classes) const;
+    // The characters which occur in some string of the language
+    std::bitset<256> getUsedChars() const;
+    // table[s * 256 + c] is the state reached from state s by c (-1 if none),
+    // accepting[s] is true for accepting states. Returns the start state, or
+    // -1 if the auto accepts nothing.
+    int getTransitionTable(std::vector<int>& table, std::vector<bool>& accepting) const;
+    // Structure of the dfa independent of state and BDD node numbering, equal
+    // for minimized autos of the same language. Empty for a null auto.
+    std::vector<int> getCanonicalForm() const;
     bool checkEquivalence(const StrangerAutomaton* auto_, int id1, int id2) const;
     bool checkEquivalence(const StrangerAutomaton* auto_) const;
+    // If the languages differ, counterexample is set to a string in only one of them
+    bool checkEquivalence(const StrangerAutomaton* auto_, std::string& counterexample) const;
     bool isLengthFinite() const;
     unsigned getMaxLength() const;
     unsigned getMinLength() const;
@@ -278,6 +328,18 @@ public:
         return bdd_size(this->dfa->bddm);
     }
 
+    // Rough number of bytes held by the automaton: a MONA bdd node record
+    // is four words, every state has an entry in the q and f arrays. A
+    // shared DFA is split evenly between its handles.
+    std::size_t get_memory_estimate() const {
+        if (this->isNull()) {
+            return sizeof(*this);
+        }
+        std::size_t handles = std::max<long>(1, this->dfa_owner.use_count());
+        return sizeof(*this) + (4 * sizeof(unsigned) * this->get_num_of_bdd_nodes()
+                                + 2 * sizeof(int) * this->get_num_of_states()) / handles;
+    }
+
     static PerfInfo* perfInfo;
 
     StrangerAutomaton* restrict(const StrangerAutomaton* otherAuto, int id){
@@ -329,11 +391,14 @@ public:
     };
     DFA* dfa;
 private:
+    // Owns dfa together with all handles sharing it
+    std::shared_ptr<DFA> dfa_owner;
 
     int ID;
     int autoTraceID;
     bool top;
     bool bottom;
+    bool minimized;
     static int num_ascii_track;
     static int* indices_main;
     static unsigned* u_indices_main;
@@ -343,9 +408,14 @@ private:
     static int baseTempTraceID;
     static int debugLevel;
     static bool coarseWidening;
+    static int deferredMinimization;
     static char slash;
 	StrangerAutomaton();
 	void init();
+    // dfa, or a minimized copy of it for queries which depend on the
+    // structure of the dfa
+    std::shared_ptr<DFA> getMinimalDfa() const;
+    void setMinimizedBy(int max_states);
     static bool& initialized();
     static void resetTraceID();
     static std::string escapeSpecialChars(std::string s);
@@ -24,6 +24,7 @@
 #ifndef STRINGBUILDER_HPP_
 #define STRINGBUILDER_HPP_
 
+#include <iomanip>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -40,5 +41,38 @@ struct stringbuilder
    operator std::string() { return ss.str(); }
 };
 
+// Escapes s for use inside a JSON string literal
+inline std::string json_escape(const std::string& s)
+{
+  std::stringstream ss;
+  for (unsigned char c : s) {
+    if (c == '"' || c == '\\') {
+      ss << '\\' << c;
+    } else if (c < 0x20) {
+      ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+    } else {
+      ss << c;
+    }
+  }
+  return ss.str();
+}
+
+// Quotes s for a CSV field if it contains a separator, quote or newline
+inline std::string csv_escape(const std::string& s)
+{
+  if (s.find_first_of(",\"\n") == std::string::npos) {
+    return s;
+  }
+  std::string retMe("\"");
+  for (char c : s) {
+    if (c == '"') {
+      retMe.push_back('"');
+    }
+    retMe.push_back(c);
+  }
+  retMe.push_back('"');
+  return retMe;
+}
+
 
 #endif /* STRINGBUILDER_HPP_ */
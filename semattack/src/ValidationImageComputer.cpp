@@ -1,4 +1,6 @@
 #include "ValidationImageComputer.hpp"
+#include "FixPointEngine.hpp"
+#include "FunctionModels.hpp"
 #include "exceptions/StrangerException.hpp"
 
 ValidationImageComputer::ValidationImageComputer() : ImageComputer() {
@@ -41,7 +43,7 @@ AnalysisResult ValidationImageComputer::doBackwardAnalysis_ValidationCase(DepGra
             if (dynamic_cast< DepGraphNormalNode*>(curr) || dynamic_cast< DepGraphUninitNode*>(curr) || dynamic_cast< DepGraphOpNode*>(curr)) {
                 if (dynamic_cast< DepGraphOpNode*>(curr) ) {
                     DepGraphOpNode* op = dynamic_cast< DepGraphOpNode*>(curr);
-                    if (op->getName().find("__vlab_restrict") != string::npos) {
+                    if (op->getKind() == OpKind::VlabRestrict) {
                         has_validation = true;
                         message = "validation function found!!!";
                     }
@@ -142,82 +144,19 @@ void ValidationImageComputer::doPreImageComputation_ValidationCase(DepGraph& ori
  * Pre Image computation for cycles (loops) during validation phase
  */
 void ValidationImageComputer::doPreImageComputationForSCC_ValidationCase(DepGraph& origDepGraph, DepGraphNode* node, AnalysisResult& bwAnalysisResult) {
-    // TODO add to command line options as an optional parameter
-    int precise_widening_limit = 5;
-    int coarse_widening_limit = 20;
-
-    int scc_id = origDepGraph.getSCCID(node);
-
-    map<int, int> visit_count;
-    NodesList current_scc_nodes = origDepGraph.getSCCNodes(scc_id);
-
-    queue<DepGraphNode*> worklist;
-    set<DepGraphNode*> visited;
-
-    // initialize all scc_nodes to phi
-    for (auto& scc_node : current_scc_nodes) {
-        bwAnalysisResult.set(scc_node->getID(), StrangerAutomaton::makePhi(scc_node->getID()));
-        visit_count[scc_node->getID()] = 0;
-    }
-
-    // add the predecessors to the worklist
-    for ( auto pred_node : origDepGraph.getPredecessors(node)) {
-        worklist.push(pred_node);
-        visited.insert(pred_node);
-    }
-
-    int iteration = 0;
-
-    do {
-        DepGraphNode* curr_node = worklist.front();
-        worklist.pop();
-        // calculate the values for predecessors (in a depgraph predecessors are children during forward analysis)
-        for (auto succ_node : origDepGraph.getSuccessors(curr_node)) {
-            // ignore nodes that are not part of the current scc
-            if (!origDepGraph.isSCCElement(succ_node) || origDepGraph.getSCCID(succ_node) != scc_id)
-                continue;
-
-            const StrangerAutomaton* prev_auto = bwAnalysisResult.get(succ_node->getID()); // may need clone
-            const StrangerAutomaton* tmp_auto = nullptr;
-            StrangerAutomaton* new_auto = nullptr;
-
-            if (dynamic_cast<DepGraphNormalNode*>(curr_node) != nullptr) {
-                tmp_auto = bwAnalysisResult.get(curr_node->getID()); // may need clone
+    FixPointEngine engine(origDepGraph, origDepGraph.getSCCID(node), FixPointEngine::Direction::Backward);
+    // calculate the values for successors (in a depgraph predecessors are parents during backward analysis)
+    engine.run(bwAnalysisResult,
+        [&](DepGraphNode* succ_node, DepGraphNode* curr_node) -> StrangerAutomaton* {
+            if (bwAnalysisResult.find(curr_node->getID()) == bwAnalysisResult.end()) {
+                return nullptr;
+            } else if (dynamic_cast<DepGraphNormalNode*>(curr_node) != nullptr) {
+                return bwAnalysisResult.get(curr_node->getID())->clone();
             } else if (dynamic_cast<DepGraphOpNode*>(curr_node) != nullptr) {
-                tmp_auto = makePreImageForOpChild_ValidationCase(origDepGraph, dynamic_cast< DepGraphOpNode*>(curr_node), succ_node, bwAnalysisResult);
-            } else {
-                throw StrangerException(stringbuilder() << "Node cannot be an element of SCC component!, node id: " << node->getID());
-            }
-
-            if (tmp_auto == nullptr) {
-                throw StrangerException(stringbuilder() << "Could not calculate the corresponding automaton!, node id: " << node->getID());
-            }
-
-            new_auto = tmp_auto->union_(prev_auto, succ_node->getID());
-
-            int new_visit_count = visit_count[succ_node->getID()] + 1;
-            if (new_visit_count > iteration)
-                iteration = new_visit_count;
-
-            // decide whether to do widening operations
-            if (new_visit_count > coarse_widening_limit) {
-                new_auto = prev_auto->coarseWiden(new_auto, succ_node->getID());
-            } else if (new_visit_count > precise_widening_limit) {
-                new_auto = prev_auto->preciseWiden(new_auto, succ_node->getID());
+                return makePreImageForOpChild_ValidationCase(origDepGraph, dynamic_cast< DepGraphOpNode*>(curr_node), succ_node, bwAnalysisResult);
             }
-
-            if (!new_auto->checkInclusion(prev_auto, new_auto->getID(), prev_auto->getID())) {
-                auto isVisited = visited.insert(succ_node);
-                if (isVisited.second) {
-                    worklist.push(succ_node);
-                }
-
-                bwAnalysisResult.set(succ_node->getID(), new_auto);
-                visit_count[succ_node->getID()] = new_visit_count;
-            }
-        }
-
-    } while( !worklist.empty() && iteration < 30000 );
+            throw StrangerException(stringbuilder() << "Node cannot be an element of SCC component!, node id: " << node->getID());
+        });
 }
 
 
@@ -231,9 +170,11 @@ StrangerAutomaton* ValidationImageComputer::makePreImageForOpChild_ValidationCas
     NodesList successors = depGraph.getSuccessors(opNode);
     const StrangerAutomaton* opAuto = bwAnalysisResult.get(opNode->getID());
     string opName = opNode->getName();
+    OpKind kind = opNode->getKind();
+    const FunctionModels::UnaryModel* model = FunctionModels::getUnaryModel(kind);
 
     // __vlab_restrict
-    if (opName.find("__vlab_restrict") != string::npos) {
+    if (kind == OpKind::VlabRestrict) {
         boost::posix_time::ptime start_time = perfInfo->current_time();
         if (successors.size() != 3) {
             throw StrangerException(stringbuilder() << "__vlab_restrict invalid number of arguments");
@@ -262,91 +203,20 @@ StrangerAutomaton* ValidationImageComputer::makePreImageForOpChild_ValidationCas
         } else {
             throw StrangerException(stringbuilder() << "child node (" << childNode->getID() << ") of __vlab_restrict (" << opNode->getID() << ") is not in backward path");
         }
-    }  else if (opName == ".") {
+    }  else if (kind == OpKind::Concat) {
         // CONCAT
         throw StrangerException( "concats are not handled here until we really need");
-    } else if (opName == "addslashes") {
-        // only has one parameter ==>  string addslashes  ( string $str  )
-        StrangerAutomaton* sigmaStar = StrangerAutomaton::makeAnyString(opNode->getID());
-        StrangerAutomaton* forward = StrangerAutomaton::addslashes(sigmaStar, opNode->getID());
-        StrangerAutomaton* intersection = opAuto->intersect(forward, childNode->getID());
-        retMe = StrangerAutomaton::pre_addslashes(intersection, childNode->getID());
-        delete sigmaStar;
-        delete forward;
-        delete intersection;
-
-    } else if (opName == "trim" ) {
-        // only has one parameter ==>  string trim  ( string $str  )
-        StrangerAutomaton* sigmaStar = StrangerAutomaton::makeAnyString(opNode->getID());
-        StrangerAutomaton* forward = sigmaStar->trimSpaces(opNode->getID());
-        StrangerAutomaton* intersection = opAuto->intersect(forward, childNode->getID());
-        retMe = intersection->preTrimSpaces(childNode->getID());
-
-        delete sigmaStar;
-        delete forward;
-        delete intersection;
-
-    } else if (opName == "ltrim" ) {
-        // only has one parameter ==>  string trim  ( string $str  )
-        StrangerAutomaton* sigmaStar = StrangerAutomaton::makeAnyString(opNode->getID());
-        StrangerAutomaton* forward = sigmaStar->trimSpacesLeft(opNode->getID());
-        StrangerAutomaton* intersection = opAuto->intersect(forward, childNode->getID());
-        retMe = intersection->preTrimSpacesLeft(childNode->getID());
-        delete sigmaStar;
-        delete forward;
-        delete intersection;
-
-    }  else if (opName == "rtrim" ) {
-        // only has one parameter ==>  string trim  ( string $str  )
-        StrangerAutomaton* sigmaStar = StrangerAutomaton::makeAnyString(opNode->getID());
-        StrangerAutomaton* forward = sigmaStar->trimSpacesRight(opNode->getID());
-        StrangerAutomaton* intersection = opAuto->intersect(forward, childNode->getID());
-        retMe = intersection->preTrimSpacesRigth(childNode->getID());
-        delete sigmaStar;
-        delete forward;
-        delete intersection;
-
-    } else if (opName == "strtoupper" ) {
-        // only has one parameter ==> string strtoupper  ( string $str  )
-        StrangerAutomaton* sigmaStar = StrangerAutomaton::makeAnyString(opNode->getID());
-        StrangerAutomaton* forward = sigmaStar->toUpperCase(opNode->getID());
-        StrangerAutomaton* intersection = opAuto->intersect(forward, childNode->getID());
-        retMe = intersection->preToUpperCase(childNode->getID());
-        delete sigmaStar;
-        delete forward;
-        delete intersection;
-
-    }  else if (opName == "strtolower" ) {
-        // only has one parameter ==> string strtolower  ( string $str  )
-        StrangerAutomaton* sigmaStar = StrangerAutomaton::makeAnyString(opNode->getID());
-        StrangerAutomaton* forward = sigmaStar->toLowerCase(opNode->getID());
-        StrangerAutomaton* intersection = opAuto->intersect(forward, childNode->getID());
-        retMe = intersection->preToLowerCase(childNode->getID());
-        delete sigmaStar;
-        delete forward;
-        delete intersection;
-
-    } else if (opName == "mysql_escape_string") {
-        // has one parameter
-        StrangerAutomaton* sigmaStar = StrangerAutomaton::makeAnyString(opNode->getID());
-        StrangerAutomaton* forward = StrangerAutomaton::mysql_escape_string(sigmaStar, opNode->getID());
-        StrangerAutomaton* intersection = opAuto->intersect(forward, childNode->getID());
-        retMe = StrangerAutomaton::pre_mysql_escape_string(intersection, childNode->getID());
-        delete sigmaStar;
-        delete forward;
-        delete intersection;
-
-    } else if (opName == "mysql_real_escape_string") {
-        // has one parameter
+    } else if ((model != nullptr) && (model->preimage != nullptr)) {
+        // only has one parameter, restrict to the image of the function first
         StrangerAutomaton* sigmaStar = StrangerAutomaton::makeAnyString(opNode->getID());
-        StrangerAutomaton* forward = StrangerAutomaton::mysql_real_escape_string(sigmaStar, opNode->getID());
+        StrangerAutomaton* forward = model->forward(sigmaStar, opNode->getID());
         StrangerAutomaton* intersection = opAuto->intersect(forward, childNode->getID());
-        retMe = StrangerAutomaton::pre_mysql_real_escape_string(intersection, childNode->getID());
+        retMe = model->preimage(intersection, childNode->getID());
         delete sigmaStar;
         delete forward;
         delete intersection;
 
-    } else if (opName == "htmlspecialchars") {
+    } else if (kind == OpKind::Htmlspecialchars) {
         if (childNode->equals(successors[0])) {
             string flagString = "ENT_COMPAT";
             if (successors.size() > 1) {
@@ -363,7 +233,7 @@ StrangerAutomaton* ValidationImageComputer::makePreImageForOpChild_ValidationCas
             throw StrangerException(stringbuilder() << "SNH: child node (" << childNode->getID() << ") of htmlspecialchars (" << opNode->getID() << ") is not in backward path,\ncheck implementation");
         }
 
-    } else if (opName == "preg_replace" || opName == "ereg_replace" || opName == "str_replace") {
+    } else if (kind == OpKind::Replace) {
 
         if (successors.size() != 3) {
             throw StrangerException(stringbuilder() << "replace invalid number of arguments");
@@ -409,7 +279,7 @@ StrangerAutomaton* ValidationImageComputer::makePreImageForOpChild_ValidationCas
             throw StrangerException(stringbuilder() << "SNH: child node (" << childNode->getID() << ") of preg_replace (" << opNode->getID() << ") is not in backward path,\ncheck implementation: "
                                                                                                                                                               "makeBackwardAutoForOpChild_ValidationPhase()");
         }
-    }  else if (opName == "substr"){
+    }  else if (kind == OpKind::Substr) {
 
         if (successors.size() != 3) {
             throw StrangerException(stringbuilder() << "SNH: substr invalid number of arguments: "
@@ -440,7 +310,7 @@ StrangerAutomaton* ValidationImageComputer::makePreImageForOpChild_ValidationCas
 
     } else if (opName == "") {
 
-    } else if (opName == "md5") {
+    } else if (kind == OpKind::Md5) {
         retMe = StrangerAutomaton::makeAnyString(childNode->getID());
     } else {
         throw StrangerException( "Not implemented yet for validation phase: " + opName);
@@ -0,0 +1,245 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * WitnessEnumerator.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "WitnessEnumerator.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <queue>
+#include <utility>
+
+WitnessEnumerator::WitnessEnumerator(const StrangerAutomaton* automaton)
+  : m_table()
+  , m_accepting()
+  , m_start(-1)
+  , m_states(0)
+  , m_min_length(0)
+  , m_max_length(std::numeric_limits<unsigned int>::max())
+  , m_chars()
+{
+  if (automaton != nullptr) {
+    m_start = automaton->getTransitionTable(m_table, m_accepting);
+    m_states = m_accepting.size();
+  }
+  // The reserved characters never occur in strings
+  m_chars.set();
+  m_chars.reset(254);
+  m_chars.reset(255);
+}
+
+WitnessEnumerator::~WitnessEnumerator()
+{
+}
+
+void WitnessEnumerator::setLengthBounds(unsigned int min, unsigned int max)
+{
+  m_min_length = min;
+  m_max_length = max;
+}
+
+unsigned int WitnessEnumerator::getLengthLimit(unsigned int k) const
+{
+  // An infinite language has a string whose length n is ns <= n < 2 ns,
+  // pumping it gives another string within every ns lengths
+  unsigned long long limit = std::max<unsigned long long>(m_min_length, 2ull * m_states)
+    + (unsigned long long) m_states * k;
+  return (unsigned int) std::min<unsigned long long>(limit, m_max_length);
+}
+
+void WitnessEnumerator::addSuffixCounts(SuffixCounts& counts, unsigned int cap) const
+{
+  std::vector<unsigned int> level(m_states, 0);
+  for (unsigned int s = 0; s < m_states; s++) {
+    if (counts.empty()) {
+      level[s] = m_accepting[s] ? 1 : 0;
+      continue;
+    }
+    const std::vector<unsigned int>& previous = counts.back();
+    for (unsigned int c = 0; (c < 256) && (level[s] < cap); c++) {
+      int next = m_table[s * 256 + c];
+      if ((next >= 0) && m_chars.test(c)) {
+        level[s] = std::min(cap, level[s] + previous[next]);
+      }
+    }
+  }
+  counts.push_back(level);
+}
+
+void WitnessEnumerator::enumerate(int state, unsigned int remaining, const SuffixCounts& counts, unsigned int k,
+                                  std::string& prefix, std::vector<std::string>& results) const
+{
+  if (remaining == 0) {
+    results.push_back(prefix);
+    return;
+  }
+  for (unsigned int c = 0; (c < 256) && (results.size() < k); c++) {
+    int next = m_table[state * 256 + c];
+    // Only follow characters which lead to an accepted string of the length
+    if ((next < 0) || !m_chars.test(c) || (counts[remaining - 1][next] == 0)) {
+      continue;
+    }
+    prefix.push_back((char) c);
+    enumerate(next, remaining - 1, counts, k, prefix, results);
+    prefix.pop_back();
+  }
+}
+
+std::vector<std::string> WitnessEnumerator::shortest(unsigned int k) const
+{
+  std::vector<std::string> results;
+  if ((m_start < 0) || (k == 0)) {
+    return results;
+  }
+  unsigned int limit = getLengthLimit(k);
+  SuffixCounts counts;
+  std::string prefix;
+  for (unsigned int length = 0; (length <= limit) && (results.size() < k); length++) {
+    addSuffixCounts(counts, k);
+    const std::vector<unsigned int>& level = counts.back();
+    if (std::all_of(level.begin(), level.end(), [](unsigned int n) { return n == 0; })) {
+      // There are no longer strings either
+      break;
+    }
+    if ((length >= m_min_length) && (level[m_start] > 0)) {
+      enumerate(m_start, length, counts, k, prefix, results);
+    }
+  }
+  return results;
+}
+
+bool WitnessEnumerator::findCheapest(const CharSet& used, std::string& witness) const
+{
+  if (m_start < 0) {
+    return false;
+  }
+  // Dijkstra over pairs of state and length. Lengths above the minimum are
+  // merged unless there is a maximum length.
+  bool bounded = (m_max_length != std::numeric_limits<unsigned int>::max());
+  unsigned int cap = bounded ? m_max_length : m_min_length;
+  std::size_t nodes = (std::size_t) m_states * (cap + 1);
+  // The number of used characters decides, then the length
+  typedef unsigned long long Cost;
+  const Cost per_used = nodes + 1;
+  std::vector<Cost> cost(nodes, std::numeric_limits<Cost>::max());
+  std::vector<std::size_t> parent(nodes, nodes);
+  std::vector<char> symbol(nodes, 0);
+  typedef std::pair<Cost, std::size_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+
+  std::size_t start = (std::size_t) m_start * (cap + 1);
+  cost[start] = 0;
+  queue.push(std::make_pair(0, start));
+  while (!queue.empty()) {
+    Entry entry = queue.top();
+    queue.pop();
+    if (entry.first != cost[entry.second]) {
+      continue;
+    }
+    unsigned int state = entry.second / (cap + 1);
+    unsigned int length = entry.second % (cap + 1);
+    if (m_accepting[state] && (length >= m_min_length)) {
+      witness.clear();
+      for (std::size_t n = entry.second; n != start; n = parent[n]) {
+        witness.push_back(symbol[n]);
+      }
+      std::reverse(witness.begin(), witness.end());
+      return true;
+    }
+    if (bounded && (length == cap)) {
+      continue;
+    }
+    unsigned int next_length = std::min(length + 1, cap);
+    for (unsigned int c = 0; c < 256; c++) {
+      int next = m_table[state * 256 + c];
+      if ((next < 0) || !m_chars.test(c)) {
+        continue;
+      }
+      std::size_t n = (std::size_t) next * (cap + 1) + next_length;
+      Cost next_cost = entry.first + 1 + (used.test(c) ? per_used : 0);
+      if (next_cost < cost[n]) {
+        cost[n] = next_cost;
+        parent[n] = entry.second;
+        symbol[n] = (char) c;
+        queue.push(std::make_pair(next_cost, n));
+      }
+    }
+  }
+  return false;
+}
+
+std::vector<std::string> WitnessEnumerator::diverse(unsigned int k) const
+{
+  std::vector<std::string> results;
+  CharSet used;
+  std::string witness;
+  while ((results.size() < k) && findCheapest(used, witness)) {
+    if (std::find(results.begin(), results.end(), witness) != results.end()) {
+      // The cheapest string was already found, take the cheapest one of the
+      // next shortest strings instead
+      std::size_t best_cost = std::numeric_limits<std::size_t>::max();
+      for (const auto& candidate : shortest(results.size() + k)) {
+        if (std::find(results.begin(), results.end(), candidate) != results.end()) {
+          continue;
+        }
+        std::size_t candidate_cost = std::count_if(candidate.begin(), candidate.end(),
+                                                   [&used](char c) { return used.test((unsigned char) c); });
+        if (candidate_cost < best_cost) {
+          best_cost = candidate_cost;
+          witness = candidate;
+        }
+      }
+      if (best_cost == std::numeric_limits<std::size_t>::max()) {
+        break;
+      }
+    }
+    results.push_back(witness);
+    for (unsigned char c : witness) {
+      used.set(c);
+    }
+  }
+  return results;
+}
+
+void WitnessEnumerator::write(std::ostream& os, const std::vector<std::string>& witnesses)
+{
+  for (const auto& witness : witnesses) {
+    for (unsigned char c : witness) {
+      if (c == '\\') {
+        os << "\\\\";
+      } else if (c == '\n') {
+        os << "\\n";
+      } else if (c == '\r') {
+        os << "\\r";
+      } else if (c == '\t') {
+        os << "\\t";
+      } else if ((c < 0x20) || (c > 0x7e)) {
+        os << "\\x" << std::hex << std::setw(2) << std::setfill('0') << (int) c << std::dec;
+      } else {
+        os << c;
+      }
+    }
+    os << std::endl;
+  }
+}
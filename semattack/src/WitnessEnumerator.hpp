@@ -0,0 +1,83 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * WitnessEnumerator.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef WITNESS_ENUMERATOR_HPP_
+#define WITNESS_ENUMERATOR_HPP_
+
+#include <bitset>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "StrangerAutomaton.hpp"
+
+// Enumerates strings accepted by an automaton, e.g. several bypasses from
+// one pre-image. The transitions are flattened into a table once, all
+// searches then walk the table and no further automata are built.
+class WitnessEnumerator {
+
+public:
+  typedef std::bitset<256> CharSet;
+
+  explicit WitnessEnumerator(const StrangerAutomaton* automaton);
+  virtual ~WitnessEnumerator();
+
+  // Only strings with min <= length <= max are enumerated
+  void setLengthBounds(unsigned int min, unsigned int max = std::numeric_limits<unsigned int>::max());
+  // Only strings made of these characters, by default all but the reserved ones
+  void setChars(const CharSet& chars) { m_chars = chars; }
+
+  // Up to k accepted strings, shortest first, strings of the same length in
+  // order of their character codes
+  std::vector<std::string> shortest(unsigned int k) const;
+  // Up to k distinct accepted strings, each with as few characters of the
+  // previous ones as possible. The first one is a shortest string.
+  std::vector<std::string> diverse(unsigned int k) const;
+
+  // One witness per line, non-printable characters are escaped
+  static void write(std::ostream& os, const std::vector<std::string>& witnesses);
+
+private:
+  // Number of accepted suffixes of each length from each state, capped
+  typedef std::vector<std::vector<unsigned int> > SuffixCounts;
+
+  // Longest strings considered when looking for k of them
+  unsigned int getLengthLimit(unsigned int k) const;
+  void addSuffixCounts(SuffixCounts& counts, unsigned int cap) const;
+  void enumerate(int state, unsigned int remaining, const SuffixCounts& counts, unsigned int k,
+                 std::string& prefix, std::vector<std::string>& results) const;
+  // Accepted string with the fewest characters in used, false if there is none
+  bool findCheapest(const CharSet& used, std::string& witness) const;
+
+  std::vector<int> m_table;
+  std::vector<bool> m_accepting;
+  int m_start;
+  unsigned int m_states;
+  unsigned int m_min_length;
+  unsigned int m_max_length;
+  CharSet m_chars;
+};
+
+#endif /* WITNESS_ENUMERATOR_HPP_ */
@@ -0,0 +1,97 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_alphabet.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// The analysis restricted to class representatives gives the same verdicts
+// as the analysis over all characters
+
+#include "semattack_check.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AlphabetPartition.hpp"
+#include "AttackContext.hpp"
+#include "AttackPatterns.hpp"
+#include "SemAttack.hpp"
+#include "StrangerAutomaton.hpp"
+
+typedef std::unique_ptr<StrangerAutomaton> AutoPtr;
+
+static bool overlaps(SemAttack& attack, const StrangerAutomaton* post, const StrangerAutomaton* pattern)
+{
+  std::string example;
+  return attack.checkAttackPatternOverlap(post, pattern, example);
+}
+
+SEMATTACK_CHECK(check_compressed_alphabet)
+{
+  const std::vector<std::string> files = {
+    "no_sanitizer.dot", "html_special_chars.dot", "encodeTextFragment.dot",
+    "single_replace.dot", "str_replace.dot", "script_filter.dot"
+  };
+  const std::vector<AttackContext> contexts = {
+    AttackContext::LessThan, AttackContext::Quote, AttackContext::SingleQuote,
+    AttackContext::Ampersand, AttackContext::Script
+  };
+  const std::vector<std::string> payloads = {
+    "<script>alert(1)</script>", "\"><img src=x onerror=taintfoxLog('xss')>", "&lt;"
+  };
+
+  for (const std::string& name : files) {
+    fs::path file = check_test_dir() / name;
+    DepGraph dep_graph = DepGraph::parseDotFile(file.string());
+    SemAttack attack(file.string(), dep_graph, "x");
+    attack.init();
+
+    AutoPtr input(StrangerAutomaton::makeAnyString());
+    AlphabetPartition alphabet = attack.computeAlphabet(contexts);
+    alphabet.refine(input.get());
+    AutoPtr representatives(alphabet.makeRepresentativeStrings(-1));
+    AutoPtr restricted(input->intersect(representatives.get()));
+
+    AnalysisResult full_result = attack.computeTargetFWAnalysis(input.get());
+    AnalysisResult compressed_result = attack.computeTargetFWAnalysis(restricted.get());
+    const StrangerAutomaton* full = attack.getPostImage(full_result);
+    const StrangerAutomaton* compressed = attack.getPostImage(compressed_result);
+    check(full != nullptr && compressed != nullptr, "post-images of " + name);
+    if (full == nullptr || compressed == nullptr) {
+      continue;
+    }
+
+    for (auto context : contexts) {
+      AutoPtr pattern(AttackPatterns::getAttackPatternForContext(context));
+      check(overlaps(attack, full, pattern.get()) == overlaps(attack, compressed, pattern.get()),
+            name + ": verdict for " + AttackContextHelper::getName(context));
+    }
+    for (const std::string& payload : payloads) {
+      AutoPtr pattern(StrangerAutomaton::makeContainsString(payload));
+      AutoPtr compressed_pattern(StrangerAutomaton::makeContainsString(alphabet.compress(payload)));
+      check(overlaps(attack, full, pattern.get()) == overlaps(attack, compressed, compressed_pattern.get()),
+            name + ": verdict for payload " + payload);
+    }
+  }
+}
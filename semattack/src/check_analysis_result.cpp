@@ -0,0 +1,111 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_analysis_result.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// The dense per-node store of AnalysisResult and the node IDs it relies on
+
+#include "semattack_check.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include "AnalysisResult.hpp"
+#include "depgraph/DepGraph.hpp"
+
+SEMATTACK_CHECK(check_analysis_result_store)
+{
+  AnalysisResult result;
+  check(result.begin() == result.end(), "new analysis result is empty");
+  check(result.get(0) == nullptr && result.find(3) == result.end(), "lookup in empty analysis result");
+
+  result.set(5, StrangerAutomaton::makeString("five"));
+  result.set(2, StrangerAutomaton::makeString("two"));
+  check(result.get(5) != nullptr && result.get(5)->checkMembership("five"), "get after set");
+  check(result.get(4) == nullptr && result.get(-1) == nullptr && result.get(100) == nullptr,
+        "get of unset, negative and out of range nodes");
+  check(result.find(4) == result.end() && result.find(2) != result.end(), "find skips empty slots");
+
+  // Iteration visits the set nodes in order of their IDs
+  std::vector<int> nodes;
+  for (const auto& entry : result) {
+    nodes.push_back(entry.first);
+  }
+  check(nodes == std::vector<int>({ 2, 5 }), "iteration over set nodes");
+
+  result.set(5, StrangerAutomaton::makeString("other"));
+  check(result.get(5)->checkMembership("other") && !result.get(5)->checkMembership("five"), "set replaces");
+
+  // Growing the store keeps the entries, shrinking is ignored
+  const StrangerAutomaton* two = result.get(2);
+  result.reserve(1000);
+  check(result.get(2) == two, "reserve keeps entries");
+  result.set(999, StrangerAutomaton::makeAnyString());
+  result.reserve(1);
+  check(result.get(999) != nullptr && result.get(2) == two, "reserve never shrinks");
+
+  bool thrown = false;
+  try {
+    result.set(-1, StrangerAutomaton::makeAnyString());
+  } catch (std::out_of_range const &) {
+    thrown = true;
+  }
+  check(thrown, "set of a negative node ID throws");
+
+  AnalysisResult moved(std::move(result));
+  check(moved.get(2) == two, "move keeps entries");
+  moved.clear();
+  check(moved.begin() == moved.end() && moved.get(2) == nullptr, "clear");
+}
+
+SEMATTACK_CHECK(check_compact_node_ids)
+{
+  // Sparse and unordered IDs in the dot file
+  DepGraph depGraph = DepGraph::parseString(
+    "digraph cfg {\n"
+    "  n17 [shape=doubleoctagon, label=\"Return: x\"];\n"
+    "  n3 [shape=box, label=\"Var: x\"];\n"
+    "  n120 [shape=house, label=\"Input: x\"];\n"
+    "  n17 -> n3;\n"
+    "  n3 -> n120;\n"
+    "}\n");
+  check(depGraph.getNumOfNodes() == 3 && depGraph.getMaxNodeID() == 2, "node IDs are renumbered densely");
+  for (int id = 0; id <= depGraph.getMaxNodeID(); id++) {
+    check(depGraph.getNode(id) != nullptr, "node with compacted ID exists");
+  }
+  check(depGraph.getRoot() != nullptr && depGraph.getRoot()->getID() == 0, "IDs follow the order in the file");
+  check(depGraph.getNumOfEdges() == 2, "edges of renumbered nodes");
+
+  bool thrown = false;
+  try {
+    DepGraph::parseString(
+      "digraph cfg {\n"
+      "  n1 [shape=doubleoctagon, label=\"Return: x\"];\n"
+      "  n1 [shape=house, label=\"Input: x\"];\n"
+      "}\n");
+  } catch (std::exception const &) {
+    thrown = true;
+  }
+  check(thrown, "duplicate dot node IDs are rejected");
+}
@@ -0,0 +1,87 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_backward_wave.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// The backward analysis computing independent pre-images in parallel gives
+// the same pre-images as the sequential one
+
+#include "semattack_check.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AttackContext.hpp"
+#include "AttackPatterns.hpp"
+#include "ImageComputer.hpp"
+#include "SemAttack.hpp"
+#include "StrangerAutomaton.hpp"
+
+typedef std::unique_ptr<StrangerAutomaton> AutoPtr;
+
+// Pre-image of the Html attack pattern computed with the given number of
+// backward threads, nullptr if the post-image does not overlap
+static StrangerAutomaton* compute_pre_image(const fs::path& file, unsigned int threads)
+{
+  ImageComputer::setBackwardThreads(threads);
+  DepGraph dep_graph = DepGraph::parseDotFile(file.string());
+  SemAttack attack(file.string(), dep_graph, "x");
+  attack.init();
+
+  AutoPtr input(StrangerAutomaton::makeAnyString());
+  AnalysisResult fw_result = attack.computeTargetFWAnalysis(input.get());
+  const StrangerAutomaton* post = attack.getPostImage(fw_result);
+  check(post != nullptr, "post-image of " + file.filename().string());
+  if (post == nullptr) {
+    return nullptr;
+  }
+  AutoPtr pattern(AttackPatterns::getAttackPatternForContext(AttackContext::Html));
+  AutoPtr intersection(attack.computeAttackPatternOverlap(post, pattern.get()));
+  if (intersection->isEmpty()) {
+    return nullptr;
+  }
+  AnalysisResult bw_result = attack.computePreImage(intersection.get(), fw_result);
+  const StrangerAutomaton* pre = attack.getPreImage(bw_result);
+  check(pre != nullptr, "pre-image of " + file.filename().string());
+  return (pre != nullptr) ? pre->clone() : nullptr;
+}
+
+SEMATTACK_CHECK(check_parallel_backward_wave)
+{
+  const std::vector<std::string> files = {
+    "no_sanitizer.dot", "double_replace.dot", "multiple_replace.dot",
+    "split.dot", "substr.dot", "reference_depgraph.dot"
+  };
+  for (const std::string& name : files) {
+    fs::path file = check_test_dir() / name;
+    AutoPtr sequential(compute_pre_image(file, 1));
+    AutoPtr parallel(compute_pre_image(file, 4));
+    ImageComputer::setBackwardThreads(1);
+    check((sequential == nullptr) == (parallel == nullptr), name + ": same overlap with 1 and 4 backward threads");
+    if ((sequential != nullptr) && (parallel != nullptr)) {
+      check(sequential->checkEquivalence(parallel.get()), name + ": same pre-image with 1 and 4 backward threads");
+    }
+  }
+}
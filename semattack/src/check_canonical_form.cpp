@@ -0,0 +1,58 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_canonical_form.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// Canonical forms of minimized automata and their interning
+
+#include "semattack_check.hpp"
+
+#include <memory>
+
+#include "AutomatonFingerprint.hpp"
+#include "StrangerAutomaton.hpp"
+
+typedef std::unique_ptr<StrangerAutomaton> AutoPtr;
+
+SEMATTACK_CHECK(check_canonical_forms)
+{
+  AutoPtr a(StrangerAutomaton::makeString("a"));
+  AutoPtr b(StrangerAutomaton::makeString("b"));
+  AutoPtr ab(a->union_(b.get()));
+  AutoPtr ba(b->union_(a.get()));
+  // (a|b)* built two ways
+  AutoPtr star(ab->closure());
+  AutoPtr chars(StrangerAutomaton::makeCharRange('a', 'b'));
+  AutoPtr star_chars(chars->closure());
+
+  check(ab->getCanonicalForm() == ba->getCanonicalForm(), "canonical form of a|b and b|a");
+  check(star->getCanonicalForm() == star_chars->getCanonicalForm(), "canonical form of (a|b)* and [a-b]*");
+  check(ab->getCanonicalForm() != star->getCanonicalForm(), "canonical form of a|b and (a|b)*");
+
+  std::shared_ptr<const CanonicalFormStore::Form> first = CanonicalFormStore::intern(ab->getCanonicalForm());
+  std::shared_ptr<const CanonicalFormStore::Form> second = CanonicalFormStore::intern(ba->getCanonicalForm());
+  std::shared_ptr<const CanonicalFormStore::Form> other = CanonicalFormStore::intern(star->getCanonicalForm());
+  check(first == second, "interned canonical forms of a|b and b|a");
+  check(first != other, "interned canonical forms of a|b and (a|b)*");
+}
@@ -0,0 +1,130 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_depgraph.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// Dependency graphs sharing their arena with input relevant sub graphs
+
+#include "semattack_check.hpp"
+
+#include "depgraph/DepGraph.hpp"
+#include "SemAttack.hpp"
+#include "exceptions/StrangerException.hpp"
+
+// x and y are concatenated, x flows into both arguments of a second concat
+static const char* two_inputs =
+  "digraph cfg {\n"
+  "  n1 [shape=doubleoctagon, label=\"Return: r\"];\n"
+  "  n2 [shape=ellipse, label=\".\"];\n"
+  "  n3 [shape=ellipse, label=\".\"];\n"
+  "  n4 [shape=box, label=\"Var: y\"];\n"
+  "  n5 [shape=box, label=\"Var: x\"];\n"
+  "  n6 [shape=box, label=\"Var: x\"];\n"
+  "  n7 [shape=house, label=\"Input: x\"];\n"
+  "  n8 [shape=house, label=\"Input: y\"];\n"
+  "  n1 -> n2;\n"
+  "  n2 -> n4;\n"
+  "  n2 -> n3;\n"
+  "  n3 -> n5;\n"
+  "  n3 -> n6;\n"
+  "  n4 -> n8;\n"
+  "  n5 -> n7;\n"
+  "  n6 -> n7;\n"
+  "}\n";
+
+static std::vector<int> ids(const NodesList& nodes)
+{
+  std::vector<int> retMe;
+  for (auto node : nodes) {
+    retMe.push_back(node->getID());
+  }
+  return retMe;
+}
+
+SEMATTACK_CHECK(check_input_relevant_graph)
+{
+  DepGraph sub;
+  {
+    DepGraph depGraph = DepGraph::parseString(two_inputs);
+    // Node IDs follow the order of the file, n7 is Input: x
+    DepGraphNode* x = depGraph.getNode(6);
+    check(x != nullptr && dynamic_cast<DepGraphUninitNode*>(x) != nullptr, "input node x");
+    sub = depGraph.getInputRelevantGraph(x);
+
+    check(sub.getNumOfNodes() == 6, "relevant graph of x has all nodes but y");
+    check(!sub.containsNode(depGraph.getNode(3)) && !sub.containsNode(depGraph.getNode(7)), "y is not relevant for x");
+    check(sub.getNumOfEdges() == 6, "relevant graph of x keeps the edges between its nodes");
+    // Both arguments of the inner concat, in order
+    check(ids(sub.getSuccessors(depGraph.getNode(2))) == ids(depGraph.getSuccessors(depGraph.getNode(2))),
+          "arguments of the inner concat keep their order");
+    check(ids(sub.getSuccessors(depGraph.getNode(1))) == std::vector<int>({ 2 }), "y argument of outer concat is dropped");
+    check(sub.getNode(2) == depGraph.getNode(2), "relevant graph shares the nodes");
+  }
+  // The arena keeps the nodes alive after the parsed graph is gone
+  check(sub.getRoot() != nullptr && sub.getRoot()->getID() == 0, "relevant graph outlives the parsed graph");
+  check(sub.getPredecessors(sub.getNode(6)).size() == 2, "predecessors in the relevant graph");
+}
+
+// str_replace with a single argument
+static const char* bad_arity =
+  "digraph cfg {\n"
+  "  n1 [shape=doubleoctagon, label=\"Return: r\"];\n"
+  "  n2 [shape=ellipse, label=\"str_replace\"];\n"
+  "  n3 [shape=box, label=\"Var: x\"];\n"
+  "  n4 [shape=house, label=\"Input: x\"];\n"
+  "  n1 -> n2;\n"
+  "  n2 -> n3;\n"
+  "  n3 -> n4;\n"
+  "}\n";
+
+SEMATTACK_CHECK(check_op_arities)
+{
+  // Parsing succeeds, the analysis reports the graph as malformed
+  DepGraph depGraph = DepGraph::parseString(bad_arity);
+  bool thrown = false;
+  try {
+    depGraph.checkOpArities();
+  } catch (std::invalid_argument const &e) {
+    thrown = true;
+  }
+  check(thrown, "wrong arity is detected");
+
+  SemAttack attack(std::string("bad_arity.dot"), depGraph, "x");
+  AnalysisError error = AnalysisError::None;
+  try {
+    attack.init();
+  } catch (StrangerException const &e) {
+    error = e.getError();
+  }
+  check(error == AnalysisError::MalformedDepgraph, "wrong arity is reported as a malformed depgraph");
+
+  DepGraph valid = DepGraph::parseString(two_inputs);
+  thrown = false;
+  try {
+    valid.checkOpArities();
+  } catch (std::invalid_argument const &e) {
+    thrown = true;
+  }
+  check(!thrown, "valid arities are accepted");
+}
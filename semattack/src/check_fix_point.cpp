@@ -0,0 +1,117 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_fix_point.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// Loop analysis of the fix point engine under different widening limits
+
+#include "semattack_check.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "FixPointEngine.hpp"
+#include "SemAttack.hpp"
+#include "StrangerAutomaton.hpp"
+
+typedef std::unique_ptr<StrangerAutomaton> AutoPtr;
+
+// Rows of the loop statistics recorded so far, without the header
+static std::vector<std::string> statistics_rows()
+{
+  std::stringstream statistics;
+  FixPointEngine::writeStatistics(statistics);
+  std::vector<std::string> rows;
+  std::string line;
+  getline(statistics, line);
+  while (getline(statistics, line)) {
+    rows.push_back(line);
+  }
+  return rows;
+}
+
+// label,direction,scc,nodes,iterations,skipped,updates,widenings,converged,ms
+static bool converged(const std::string& row)
+{
+  std::size_t ms = row.rfind(',');
+  std::size_t converged = row.rfind(',', ms - 1);
+  return row.substr(converged + 1, ms - converged - 1) == "1";
+}
+
+// x = "b"; loop { x = x . "a" }, the post-image is b a*. Returns the
+// statistics rows of this analysis.
+static std::vector<std::string> check_loop_post_image(const WideningLimits& limits, bool sound, const std::string& what)
+{
+  fs::path file = check_test_dir() / "loop_concat.dot";
+  FixPointEngine::setLimits(limits);
+  FixPointEngine::setRecordStatistics(true);
+  std::size_t before = statistics_rows().size();
+
+  DepGraph dep_graph = DepGraph::parseDotFile(file.string());
+  SemAttack attack(file.string(), dep_graph, "x");
+  attack.init();
+  AutoPtr input(StrangerAutomaton::makeString("b"));
+  AnalysisResult result = attack.computeTargetFWAnalysis(input.get());
+  const StrangerAutomaton* post = attack.getPostImage(result);
+  check(post != nullptr, what + ": post-image of loop_concat.dot");
+  if ((post != nullptr) && sound) {
+    for (const std::string& s : std::vector<std::string>{ "b", "ba", "baa", std::string("b") + std::string(100, 'a') }) {
+      check(post->checkMembership(s), what + ": post-image of loop_concat.dot contains \"" + s + "\"");
+    }
+  }
+
+  FixPointEngine::setLimits(WideningLimits());
+  FixPointEngine::setRecordStatistics(false);
+  std::vector<std::string> rows = statistics_rows();
+  rows.erase(rows.begin(), rows.begin() + before);
+  check(!rows.empty(), what + ": loop_concat.dot has a loop");
+  return rows;
+}
+
+SEMATTACK_CHECK(check_loop_convergence)
+{
+  for (const std::string& row : check_loop_post_image(WideningLimits(), true, "default limits")) {
+    check(converged(row), "loop analysis converged: " + row);
+  }
+}
+
+SEMATTACK_CHECK(check_widening_limits)
+{
+  // Widening from the first updates on still converges to a sound result
+  WideningLimits eager;
+  eager.precise = 1;
+  eager.coarse = 2;
+  for (const std::string& row : check_loop_post_image(eager, true, "eager widening")) {
+    check(converged(row), "loop analysis with eager widening converged: " + row);
+  }
+
+  // Hitting the update limit is reported as not converged
+  WideningLimits stopped;
+  stopped.max_updates = 1;
+  for (const std::string& row : check_loop_post_image(stopped, false, "update limit")) {
+    check(!converged(row), "loop analysis stopped at the update limit: " + row);
+  }
+}
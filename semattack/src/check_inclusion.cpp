@@ -0,0 +1,89 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_inclusion.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// Inclusion and equivalence checks searching the product on the fly,
+// compared with the complement construction
+
+#include "semattack_check.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AttackPatterns.hpp"
+#include "StrangerAutomaton.hpp"
+
+typedef std::unique_ptr<StrangerAutomaton> AutoPtr;
+
+// L(a) subset of L(b), computed as L(a) intersect complement(L(b)) == phi
+static bool included(const StrangerAutomaton* a, const StrangerAutomaton* b)
+{
+  AutoPtr complement(b->complement());
+  AutoPtr difference(a->intersect(complement.get()));
+  return difference->checkEmptiness();
+}
+
+static std::vector<std::pair<std::string, AutoPtr> > make_inputs()
+{
+  std::vector<std::pair<std::string, AutoPtr> > inputs;
+  inputs.emplace_back("sigma_star", AutoPtr(StrangerAutomaton::makeAnyString()));
+  inputs.emplace_back("empty_string", AutoPtr(StrangerAutomaton::makeEmptyString()));
+  inputs.emplace_back("abc", AutoPtr(StrangerAutomaton::makeString("abc")));
+  inputs.emplace_back("contains_lt", AutoPtr(StrangerAutomaton::makeContainsString("<")));
+  inputs.emplace_back("digits", AutoPtr(StrangerAutomaton::makeCharRange('0', '9')));
+  AutoPtr ab(StrangerAutomaton::makeString("ab"));
+  inputs.emplace_back("ab_star", AutoPtr(ab->closure()));
+  inputs.emplace_back("Html", AutoPtr(AttackPatterns::getAttackPatternForContext(AttackContext::Html)));
+  inputs.emplace_back("Url", AutoPtr(AttackPatterns::getAttackPatternForContext(AttackContext::Url)));
+  return inputs;
+}
+
+SEMATTACK_CHECK(check_inclusion_and_equivalence)
+{
+  std::vector<std::pair<std::string, AutoPtr> > inputs = make_inputs();
+  for (const auto& a : inputs) {
+    for (const auto& b : inputs) {
+      std::string name = a.first + ", " + b.first;
+      bool expected = included(a.second.get(), b.second.get());
+      std::string counterexample;
+      bool result = a.second->checkInclusion(b.second.get(), counterexample);
+      check(result == expected, "checkInclusion(" + name + ")");
+      if (!result) {
+        check(a.second->checkMembership(counterexample) && !b.second->checkMembership(counterexample),
+              "checkInclusion(" + name + ") counterexample \"" + counterexample + "\"");
+      }
+
+      expected = expected && included(b.second.get(), a.second.get());
+      result = a.second->checkEquivalence(b.second.get(), counterexample);
+      check(result == expected, "checkEquivalence(" + name + ")");
+      if (!result) {
+        check(a.second->checkMembership(counterexample) != b.second->checkMembership(counterexample),
+              "checkEquivalence(" + name + ") counterexample \"" + counterexample + "\"");
+      }
+    }
+  }
+}
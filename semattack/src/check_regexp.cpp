@@ -0,0 +1,88 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_regexp.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// Regular expressions compiled by subset construction, compared with the
+// automata built per node and with boost::regex on sample strings
+
+#include "semattack_check.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/regex.hpp>
+
+#include "RegExp.hpp"
+#include "RegExpCompiler.hpp"
+#include "StrangerAutomaton.hpp"
+
+typedef std::unique_ptr<StrangerAutomaton> AutoPtr;
+
+// Patterns written in the common subset of both syntaxes
+static const std::vector<std::string> patterns = {
+  "abc",
+  "a|bc",
+  "(ab)*c",
+  "[a-z]+[0-9]?",
+  "[^<>'\"&]*",
+  "x(y|z)+",
+  "a\\.b",
+  "(a|b)*abb",
+};
+
+static const std::vector<std::string> samples = {
+  "", "a", "c", "abc", "bc", "ababc", "abab", "hello", "hello7", "hello77",
+  "<script>", "it's", "x", "xy", "xyzzy", "a.b", "aXb", "abb", "babb", "abba",
+};
+
+SEMATTACK_CHECK(check_regexp_compiler)
+{
+  for (const std::string& pattern : patterns) {
+    std::unique_ptr<RegExp> regExp(new RegExp(pattern, RegExp::NONE));
+    RegExpCompiler compiler;
+    AutoPtr compiled(compiler.compile(regExp.get(), -1));
+    check(compiled != nullptr, "subset construction supports " + pattern);
+    if (compiled == nullptr) {
+      continue;
+    }
+    AutoPtr reference(regExp->toAutomaton());
+    std::string counterexample;
+    check(compiled->checkEquivalence(reference.get(), counterexample),
+          "compiled and per node automata of " + pattern + " differ on \"" + counterexample + "\"");
+
+    // The pattern cache hands out equivalent copies
+    AutoPtr cached(RegExpCompiler::compilePattern(pattern, -1));
+    AutoPtr again(RegExpCompiler::compilePattern(pattern, -1));
+    check(cached->checkEquivalence(compiled.get()) && again->checkEquivalence(compiled.get()),
+          "cached automaton of " + pattern);
+
+    boost::regex expected(pattern);
+    for (const std::string& sample : samples) {
+      check(compiled->checkMembership(sample) == boost::regex_match(sample, expected),
+            "membership of \"" + sample + "\" in " + pattern);
+    }
+  }
+}
@@ -0,0 +1,105 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_shard_results.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// Shard records written by one multiattack run and read back by
+// multiattack-merge. test/shard_roundtrip.sh checks the merged reports.
+
+#include "semattack_check.hpp"
+
+#include <sstream>
+
+#include "ShardResults.hpp"
+
+namespace {
+
+// Filters succeed for every third context and are contained in every
+// second one, including the last context
+class FakeResult : public SanitizerResult {
+
+public:
+  std::string getFileName() const override { return "some/dir/file, with comma.dot"; }
+  int getCountWithDuplicates() const override { return 7; }
+  int getCount() const override { return 3; }
+  bool isDone() const override { return true; }
+  bool isErrored() const override { return false; }
+  AnalysisError getError() const override { return AnalysisError::None; }
+  bool isExploitSuccessful() const override { return true; }
+  AttackContext getSinkContext() const override { return AttackContext::HtmlAttr; }
+  bool isFilterSuccessful(const AttackContext& context) const override { return static_cast<int>(context) % 3 == 0; }
+  bool isFilterContained(const AttackContext& context) const override { return static_cast<int>(context) % 2 == 0; }
+  bool hasAtLeastOnePayload() const override { return true; }
+  bool hasAtLeastOneVulnerablePayload() const override { return false; }
+  bool hasAllErroredPayloads() const override { return false; }
+  bool hasAtLeastOneBypass() const override { return true; }
+  std::set<std::string> getUniqueDomains() const override { return { "a.example", "b.example" }; }
+  std::set<std::string> getUniqueDomainsWithPayload() const override { return { "a.example" }; }
+  std::set<std::string> getVulnerableDomainsWithPayload() const override { return {}; }
+  std::set<int> getUniqueInjectionPoints() const override { return { 0, 12 }; }
+  void printHeader(std::ostream& os, const std::vector<AttackContext>&) const override { os << "header"; }
+  void printResult(std::ostream& os, bool printHeader, const std::vector<AttackContext>&) const override {
+    os << (printHeader ? "header\n" : "") << "row\n";
+  }
+  void printGeneratedPayloads(std::ostream& os) const override { os << "payload\n"; }
+  void printUnmatchedUuids(std::ostream& os) const override { os << "uuid\n"; }
+};
+
+}
+
+SEMATTACK_CHECK(check_shard_record_round_trip)
+{
+  const std::vector<AttackContext>& contexts = AttackContextHelper::getContexts();
+  check(!contexts.empty() && contexts.back() == AttackContext::None, "all attack contexts are listed");
+
+  FakeResult result;
+  SanitizerRecord record(result, { AttackContext::Html, AttackContext::Url });
+  std::stringstream ss;
+  record.write(ss);
+  SanitizerRecord read;
+  read.read(ss);
+
+  check(read.getFileName() == result.getFileName(), "record file name");
+  check(read.getCountWithDuplicates() == 7 && read.getCount() == 3 && read.isDone(), "record counts");
+  check(!read.isErrored() && read.getError() == AnalysisError::None, "record error");
+  check(read.isExploitSuccessful() && read.getSinkContext() == AttackContext::HtmlAttr, "record exploit");
+  for (AttackContext context : contexts) {
+    check(read.isFilterSuccessful(context) == result.isFilterSuccessful(context),
+          std::string("record filter successful for ") + AttackContextHelper::getName(context));
+    check(read.isFilterContained(context) == result.isFilterContained(context),
+          std::string("record filter contained for ") + AttackContextHelper::getName(context));
+  }
+  check(read.hasAtLeastOnePayload() && !read.hasAtLeastOneVulnerablePayload() &&
+        !read.hasAllErroredPayloads() && read.hasAtLeastOneBypass(), "record payload flags");
+  check(read.getUniqueDomains() == result.getUniqueDomains() &&
+        read.getUniqueDomainsWithPayload() == result.getUniqueDomainsWithPayload() &&
+        read.getVulnerableDomainsWithPayload().empty(), "record domains");
+  check(read.getUniqueInjectionPoints() == result.getUniqueInjectionPoints(), "record injection points");
+
+  std::stringstream rows;
+  read.printResult(rows, true, { AttackContext::Html, AttackContext::Url });
+  read.printGeneratedPayloads(rows);
+  read.printUnmatchedUuids(rows);
+  check(rows.str() == "header\nrow\npayload\nuuid\n", "record rendered rows");
+}
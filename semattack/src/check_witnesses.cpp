@@ -0,0 +1,115 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * check_witnesses.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ *
+ * Authors: Thomas Barber
+ */
+
+// Witness enumeration: only distinct members of the language, at most k
+
+#include "semattack_check.hpp"
+
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "StrangerAutomaton.hpp"
+#include "WitnessEnumerator.hpp"
+
+typedef std::unique_ptr<StrangerAutomaton> AutoPtr;
+
+static void check_witnesses(const StrangerAutomaton* automaton, const std::vector<std::string>& witnesses,
+                            unsigned int k, const std::string& what)
+{
+  check(witnesses.size() <= k, what + ": at most k witnesses");
+  std::set<std::string> distinct(witnesses.begin(), witnesses.end());
+  check(distinct.size() == witnesses.size(), what + ": witnesses are distinct");
+  for (const std::string& witness : witnesses) {
+    check(automaton->checkMembership(witness), what + ": \"" + witness + "\" is accepted");
+  }
+}
+
+SEMATTACK_CHECK(check_witnesses_finite)
+{
+  AutoPtr a(StrangerAutomaton::makeString("a"));
+  AutoPtr ab(StrangerAutomaton::makeString("ab"));
+  AutoPtr abc(StrangerAutomaton::makeString("abc"));
+  AutoPtr a_ab(a->union_(ab.get()));
+  AutoPtr language(a_ab->union_(abc.get()));
+
+  WitnessEnumerator enumerator(language.get());
+  std::vector<std::string> shortest = enumerator.shortest(10);
+  check_witnesses(language.get(), shortest, 10, "shortest of {a, ab, abc}");
+  check(shortest == std::vector<std::string>{ "a", "ab", "abc" }, "shortest of {a, ab, abc} finds all in order");
+  std::vector<std::string> diverse = enumerator.diverse(10);
+  check_witnesses(language.get(), diverse, 10, "diverse of {a, ab, abc}");
+  check(diverse.size() == 3, "diverse of {a, ab, abc} finds all");
+  check(!diverse.empty() && (diverse.front() == "a"), "diverse of {a, ab, abc} starts with a shortest string");
+  check_witnesses(language.get(), enumerator.diverse(2), 2, "two diverse of {a, ab, abc}");
+
+  enumerator.setLengthBounds(2, 2);
+  check(enumerator.shortest(10) == std::vector<std::string>{ "ab" }, "length bounds of {a, ab, abc}");
+}
+
+SEMATTACK_CHECK(check_witnesses_infinite)
+{
+  AutoPtr open(StrangerAutomaton::makeString("<"));
+  AutoPtr any(StrangerAutomaton::makeAnyString());
+  AutoPtr language(open->concatenate(any.get()));
+
+  WitnessEnumerator enumerator(language.get());
+  std::vector<std::string> shortest = enumerator.shortest(5);
+  check_witnesses(language.get(), shortest, 5, "shortest of <.*");
+  check(shortest.size() == 5, "shortest of <.* finds k");
+  check(!shortest.empty() && (shortest.front() == "<"), "shortest of <.* starts with <");
+  for (std::size_t i = 1; i < shortest.size(); i++) {
+    check(shortest[i - 1].size() <= shortest[i].size(), "shortest of <.* are ordered by length");
+  }
+  std::vector<std::string> diverse = enumerator.diverse(5);
+  check_witnesses(language.get(), diverse, 5, "diverse of <.*");
+  check(diverse.size() == 5, "diverse of <.* finds k");
+
+  WitnessEnumerator::CharSet letters;
+  letters.set('<');
+  letters.set('a');
+  enumerator.setChars(letters);
+  for (const std::string& witness : enumerator.shortest(5)) {
+    check(witness.find_first_not_of("<a") == std::string::npos, "shortest of <.* only uses the given characters");
+  }
+}
+
+SEMATTACK_CHECK(check_witnesses_empty)
+{
+  AutoPtr language(StrangerAutomaton::makePhi());
+  WitnessEnumerator enumerator(language.get());
+  check(enumerator.shortest(3).empty(), "no shortest witnesses of the empty language");
+  check(enumerator.diverse(3).empty(), "no diverse witnesses of the empty language");
+}
+
+SEMATTACK_CHECK(check_witnesses_write)
+{
+  std::stringstream out;
+  WitnessEnumerator::write(out, std::vector<std::string>{ "a\nb", "\\", std::string(1, '\x01') });
+  check(out.str() == "a\\nb\n\\\\\n\\x01\n", "witnesses are written one per line, escaped");
+}
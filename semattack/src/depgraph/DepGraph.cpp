@@ -47,6 +47,23 @@ DepGraph::DepGraph(const DepGraph& other)  : metadata(other.metadata) {
     this->labelloc = other.labelloc;
     this->scc_components = other.scc_components;
     this->scc_map = other.scc_map;
+    this->arena = other.arena;
+}
+
+DepGraph::DepGraph(DepGraph&& other)
+  : label(std::move(other.label))
+  , labelloc(std::move(other.labelloc))
+  , nodes(std::move(other.nodes))
+  , root(other.root)
+  , topLeaf(other.topLeaf)
+  , edges(std::move(other.edges))
+  , scc_components(std::move(other.scc_components))
+  , scc_map(std::move(other.scc_map))
+  , metadata(std::move(other.metadata))
+  , arena(std::move(other.arena))
+{
+    other.root = nullptr;
+    other.topLeaf = nullptr;
 }
 
 DepGraph& DepGraph::operator=(const DepGraph &other) {
@@ -62,6 +79,26 @@ DepGraph& DepGraph::operator=(const DepGraph &other) {
     this->scc_components = other.scc_components;
     this->scc_map = other.scc_map;
     this->metadata = other.metadata;
+    this->arena = other.arena;
+    return *this;
+}
+
+DepGraph& DepGraph::operator=(DepGraph &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    this->root = other.root;
+    this->nodes = std::move(other.nodes);
+    this->topLeaf = other.topLeaf;
+    this->edges = std::move(other.edges);
+    this->label = std::move(other.label);
+    this->labelloc = std::move(other.labelloc);
+    this->scc_components = std::move(other.scc_components);
+    this->scc_map = std::move(other.scc_map);
+    this->metadata = std::move(other.metadata);
+    this->arena = std::move(other.arena);
+    other.root = nullptr;
+    other.topLeaf = nullptr;
     return *this;
 }
 
@@ -176,30 +213,52 @@ DepGraphUninitNode* DepGraph::findPixyInputNode(string name){
 
 
 DepGraph DepGraph::getInputRelevantGraph(DepGraphNode* inputNode) {
+	// Predecessors of all nodes at once, getPredecessors scans every edge
+	std::map<int, NodesList> preds;
+	for (const auto& edge : edges) {
+		for (auto to : edge.second) {
+			preds[to->getID()].push_back(const_cast<DepGraphNode*>(edge.first));
+		}
+	}
+
+	// The input node and every node it flows into
+	NodesMap relevant;
+	relevant[inputNode->getID()] = inputNode;
+	NodesList work(1, inputNode);
+	while (!work.empty()) {
+		DepGraphNode* node = work.back();
+		work.pop_back();
+		for (auto pred : preds[node->getID()]) {
+			if (relevant.insert(std::make_pair(pred->getID(), pred)).second) {
+				work.push_back(pred);
+			}
+		}
+	}
+
 	DepGraph inputDepGraph(this->getRoot());
-	inputDepGraph.addNode(inputNode);
-	this->doGetInputRelevantGraph(inputNode, inputDepGraph);
+	// The sub graph only refers to the nodes, keep them alive with it
+	inputDepGraph.arena = this->arena;
+	inputDepGraph.nodes.insert(relevant.begin(), relevant.end());
+	// Every edge between relevant nodes, successors keep the order of the
+	// operation arguments
+	for (const auto& edge : edges) {
+		if (relevant.find(edge.first->getID()) == relevant.end()) {
+			continue;
+		}
+		NodesList successors;
+		for (auto to : edge.second) {
+			if (relevant.find(to->getID()) != relevant.end()) {
+				successors.push_back(to);
+			}
+		}
+		if (!successors.empty()) {
+			inputDepGraph.edges[edge.first] = successors;
+		}
+	}
 	inputDepGraph.setTopLeaf(this->root);
 	return inputDepGraph;
 }
 
-void DepGraph::doGetInputRelevantGraph(DepGraphNode* node,
-	    			DepGraph& inputDepGraph)
-{
-	NodesList preds = this->getPredecessors(node);
-
-    for (auto pred : preds) {
-	   // if this node has already been added to the inputDepGraph graph...
-	   if (inputDepGraph.containsNode(pred)) {
-		inputDepGraph.addEdge(const_cast<DepGraphNode*>(pred), const_cast<DepGraphNode*>(node));
-		   continue;
-	   }
-	   inputDepGraph.addNode(const_cast<DepGraphNode*>(pred));
-	   inputDepGraph.addEdge(const_cast<DepGraphNode*>(pred), const_cast<DepGraphNode*>(node));
-	   doGetInputRelevantGraph(pred, inputDepGraph);
-   }
-}
-
 void DepGraph::addEdge(DepGraphNode* from, DepGraphNode* to) {
         if (!from || !to) {
 		throw runtime_error(stringbuilder() << "Null pointers given to addEdge");
@@ -252,6 +311,28 @@ std::string DepGraph::escapeLiteral(const std::string& litValue)
     return result;
 }
 
+// Node IDs in dot files are not guaranteed to be contiguous, renumber them in
+// order of appearance so that IDs can be used to index flat per-node tables
+int DepGraph::compactNodeID(std::map<int, int>& nodeIDs, int dotID)
+{
+    auto it = nodeIDs.find(dotID);
+    if (it != nodeIDs.end()) {
+        throw runtime_error(stringbuilder() << "Can not add Node n" << dotID << " to dep graph. It already exists.");
+    }
+    int nodeID = (int) nodeIDs.size();
+    nodeIDs[dotID] = nodeID;
+    return nodeID;
+}
+
+DepGraphNode* DepGraph::lookupDotNode(DepGraph& depGraph, const std::map<int, int>& nodeIDs, int dotID)
+{
+    auto it = nodeIDs.find(dotID);
+    if (it == nodeIDs.end()) {
+        return NULL;
+    }
+    return depGraph.getNode(it->second);
+}
+
 DepGraph DepGraph::parseDotFile(const std::string& fname) {
     std::ifstream ifs;
     try {
@@ -308,6 +389,7 @@ DepGraph DepGraph::parseStream(std::istream &stream) {
     string litValue;
     string opName;        
     string inputLine;
+    std::map<int, int> nodeIDs;
 
     std::stringstream cout_local;
     
@@ -317,7 +399,7 @@ DepGraph DepGraph::parseStream(std::istream &stream) {
         if (boost::regex_match(inputLine, sm, regxNode)){
 
             //process node
-            nodeID = std::stoi(sm[1]) - 1;
+            nodeID = compactNodeID(nodeIDs, std::stoi(sm[1]));
             nodeDescription = sm[2];
 
             if (boost::regex_match(nodeDescription, sm, regxNodeDescription)) {
@@ -325,35 +407,35 @@ DepGraph DepGraph::parseStream(std::istream &stream) {
                 nodeLabel = sm[2];
                 DepGraphNode* node = NULL;
                 if (boost::regex_match(nodeLabel, sm, regxNodeUninit)){
-                    node = new DepGraphUninitNode(nodeID, -1, -1);
+                    node = depGraph.create<DepGraphUninitNode>(nodeID, -1, -1);
                     depGraph.addNode(node);
                 } else if (boost::regex_match(nodeLabel, sm, regxNodeVar)){
                     varName = sm[1];
-                    TacPlace* place = new Variable(varName, "noFunc");
-                    node = new DepGraphNormalNode("noFile", -1, nodeID, -1, -1, place);
+                    TacPlace* place = depGraph.create<Variable>(varName, "noFunc");
+                    node = depGraph.create<DepGraphNormalNode>("noFile", -1, nodeID, -1, -1, place, false);
                     depGraph.addNode(node);
                 } else if (boost::regex_match(nodeLabel, sm, regxNodeReturn)){
                     varName = sm[1];
-                    TacPlace* place = new Variable(varName, "noFunc");
-                    node = new DepGraphNormalNode("noFile", -1, nodeID, -1, -1, place);
+                    TacPlace* place = depGraph.create<Variable>(varName, "noFunc");
+                    node = depGraph.create<DepGraphNormalNode>("noFile", -1, nodeID, -1, -1, place, false);
                     depGraph.addNode(node);
                 } else if (boost::regex_match(nodeLabel, sm, regxNodeRegExp)){
                     litValue = sm[1];
                     cout_local << "RegExp litval:  " << litValue << endl;
-                    TacPlace* place = new RegExpNode(litValue);
-                    node = new DepGraphNormalNode("noFile", -1, nodeID, -1, -1, place);
+                    TacPlace* place = depGraph.create<RegExpNode>(litValue);
+                    node = depGraph.create<DepGraphNormalNode>("noFile", -1, nodeID, -1, -1, place, false);
                     depGraph.addNode(node);
                 } else if (boost::regex_match(nodeLabel, sm, regxNodeLit)){
                     litValue = sm[1];
                     cout_local << "litval original:  " << litValue << endl;
                     litValue = DepGraph::escapeLiteral(litValue);
                     cout_local << "result litval:  " << litValue << endl;
-                    TacPlace* place = new Literal(litValue);
-                    node = new DepGraphNormalNode("noFile", -1, nodeID, -1, -1, place);
+                    TacPlace* place = depGraph.create<Literal>(litValue);
+                    node = depGraph.create<DepGraphNormalNode>("noFile", -1, nodeID, -1, -1, place, false);
                     depGraph.addNode(node);
                 } else if (boost::regex_match(nodeLabel, sm, regxNodeOp)){
                     opName = sm[1];
-                    node = new DepGraphOpNode("noFile", -1, nodeID, -1, -1, opName, false);
+                    node = depGraph.create<DepGraphOpNode>("noFile", -1, nodeID, -1, -1, opName, false);
                     depGraph.addNode(node);
                     cout_local << "Op: " << opName << endl;
                 }
@@ -370,10 +452,10 @@ DepGraph DepGraph::parseStream(std::istream &stream) {
             }
         } else if (boost::regex_match(inputLine, sm, regxEdge)) {
             //process edge
-            fromNodeID = std::stoi(sm[1]) - 1;
-            toNodeID = std::stoi(sm[2]) - 1;
-            DepGraphNode* fromNode = depGraph.getNode(fromNodeID);
-            DepGraphNode* toNode = depGraph.getNode(toNodeID);
+            fromNodeID = std::stoi(sm[1]);
+            toNodeID = std::stoi(sm[2]);
+            DepGraphNode* fromNode = lookupDotNode(depGraph, nodeIDs, fromNodeID);
+            DepGraphNode* toNode = lookupDotNode(depGraph, nodeIDs, toNodeID);
             depGraph.addEdge(fromNode, toNode);
             cout_local << "Found edge: " << fromNodeID << "(" << fromNode << ") --> " << toNodeID << "(" << toNode << ")" << endl;
         } else if (boost::regex_match(inputLine, sm, regxComment)) {
@@ -433,6 +515,7 @@ DepGraph DepGraph::parsePixyDotFile(std::string fname) {
         bool builtinFunc;
 
         string inputLine;
+        std::map<int, int> nodeIDs;
         while (ifs.good()) {
             getline(ifs, inputLine);
 //            cout << "\t parsing : " << inputLine << endl;
@@ -445,7 +528,7 @@ DepGraph DepGraph::parsePixyDotFile(std::string fname) {
             else if (boost::regex_match(inputLine, sm, regxNode)){
 
                 //process node
-                nodeID = std::stoi(sm[1]) - 1;
+                nodeID = compactNodeID(nodeIDs, std::stoi(sm[1]));
                 nodeDescription = sm[2];
 
                 if (boost::regex_match(nodeDescription, sm, regxNodeDescription)) {
@@ -458,7 +541,7 @@ DepGraph DepGraph::parsePixyDotFile(std::string fname) {
                     nodeOrder = -1;
                     DepGraphNode* node = NULL;
                     if (boost::regex_match(nodeLabel, sm, regxNodeUninit)){
-                        node = new DepGraphUninitNode(nodeID, nodeOrder, nodeSCCID);
+                        node = depGraph.create<DepGraphUninitNode>(nodeID, nodeOrder, nodeSCCID);
                         depGraph.addNode(node);
                     }
                     else if (boost::regex_match(nodeLabel, sm, regxNodeVar)){
@@ -467,23 +550,23 @@ DepGraph DepGraph::parsePixyDotFile(std::string fname) {
                         nodeLineNumber = std::stoi(sm[2]);
                         varName = sm[3];
                         funcName = sm[4];
-                        TacPlace* place = new Variable(varName, funcName);
-                        node = new DepGraphNormalNode(nodeFileName, nodeLineNumber, nodeID, nodeSCCID, nodeOrder, place);
+                        TacPlace* place = depGraph.create<Variable>(varName, funcName);
+                        node = depGraph.create<DepGraphNormalNode>(nodeFileName, nodeLineNumber, nodeID, nodeSCCID, nodeOrder, place, false);
                         depGraph.addNode(node);
 
                     }else if (boost::regex_match(nodeLabel, sm, regxNodeLit)){
                         nodeFileName = sm[1];
                         nodeLineNumber = std::stoi(sm[2]);
                         litValue = sm[3];
-                        TacPlace* place = new Literal(litValue);
-                        node = new DepGraphNormalNode(nodeFileName, nodeLineNumber, nodeID, nodeSCCID, nodeOrder, place);
+                        TacPlace* place = depGraph.create<Literal>(litValue);
+                        node = depGraph.create<DepGraphNormalNode>(nodeFileName, nodeLineNumber, nodeID, nodeSCCID, nodeOrder, place, false);
                         depGraph.addNode(node);
                     }else if(boost::regex_match(nodeLabel, sm, regxConstant)){
                     	nodeFileName = sm[1];
                     	nodeLineNumber = std::stoi(sm[2]);
                     	string constValue = sm[3];
-                    	TacPlace* place = new Constant(constValue);
-                    	node = new DepGraphNormalNode(nodeFileName, nodeLineNumber, nodeID, nodeSCCID, nodeOrder, place);
+                    	TacPlace* place = depGraph.create<Constant>(constValue);
+                    	node = depGraph.create<DepGraphNormalNode>(nodeFileName, nodeLineNumber, nodeID, nodeSCCID, nodeOrder, place, false);
                     	depGraph.addNode(node);
 
                     } else if (boost::regex_match(nodeLabel, sm, regxNodeOp)){
@@ -492,7 +575,7 @@ DepGraph DepGraph::parsePixyDotFile(std::string fname) {
                         nodeLineNumber = std::stoi(sm[2]);
                         builtinFunc = (sm[3] == "builtin function");
                         opName = sm[4];
-                        node = new DepGraphOpNode(nodeFileName, nodeLineNumber, nodeID, nodeSCCID, nodeOrder, opName, builtinFunc);
+                        node = depGraph.create<DepGraphOpNode>(nodeFileName, nodeLineNumber, nodeID, nodeSCCID, nodeOrder, opName, builtinFunc);
                         depGraph.addNode(node);
 
                     }
@@ -508,15 +591,14 @@ DepGraph DepGraph::parsePixyDotFile(std::string fname) {
                 }
             } else if (boost::regex_match(inputLine, sm, regxEdge)) {
                 //process edge
-                fromNodeID = std::stoi(sm[1]) - 1;
-                toNodeID = std::stoi(sm[2]) - 1;
-                DepGraphNode* fromNode = depGraph.getNode(fromNodeID);
-                DepGraphNode* toNode = depGraph.getNode(toNodeID);
+                fromNodeID = std::stoi(sm[1]);
+                toNodeID = std::stoi(sm[2]);
+                DepGraphNode* fromNode = lookupDotNode(depGraph, nodeIDs, fromNodeID);
+                DepGraphNode* toNode = lookupDotNode(depGraph, nodeIDs, toNodeID);
                 depGraph.addEdge(fromNode, toNode);
             }
         }
         ifs.close();
-
     } catch (exception const &e) {
         cerr << "Can not construct depGraph from file " << fname << ". Following exception happened:\n" << e.what();
         if (ifs.is_open())
@@ -529,6 +611,27 @@ DepGraph DepGraph::parsePixyDotFile(std::string fname) {
     return depGraph;
 }
 
+void DepGraph::checkOpArities() const {
+    for (const auto& entry : nodes) {
+        const DepGraphOpNode* opNode = dynamic_cast<const DepGraphOpNode*>(entry.second);
+        if (opNode == nullptr) {
+            continue;
+        }
+        OpKind kind = opNode->getKind();
+        std::size_t args = getSuccessors(opNode).size();
+        if (!OpKindHelper::isValidArity(kind, args)) {
+            stringbuilder expected;
+            if (OpKindHelper::getMaxArgs(kind) < 0) {
+                expected << "at least " << OpKindHelper::getMinArgs(kind);
+            } else {
+                expected << OpKindHelper::getMinArgs(kind) << " to " << OpKindHelper::getMaxArgs(kind);
+            }
+            throw invalid_argument(stringbuilder() << opNode->getName() << " (" << opNode->getID() << ") has " << args
+                                   << " arguments, expected " << std::string(expected));
+        }
+    }
+}
+
 std::string DepGraph::toDot() const{
     std::stringstream ss;
     NodesMapConstIterator citNodes;
@@ -676,24 +779,37 @@ const Metadata& DepGraph::get_metadata() const {
     return this->metadata;
 }
 
+DepGraphArena& DepGraph::getArena() {
+    if (!this->arena) {
+        this->arena = std::make_shared<DepGraphArena>();
+    }
+    return *this->arena;
+}
+
 
 NodeOwningDepGraph::NodeOwningDepGraph(const DepGraph& other) :
     DepGraph(other)
 {
 }
 
+NodeOwningDepGraph::NodeOwningDepGraph(DepGraph&& other) :
+    DepGraph(std::move(other))
+{
+}
+
 NodeOwningDepGraph& NodeOwningDepGraph::operator=(const DepGraph &other)
 {
     DepGraph::operator=(other);
     return *this;
 }
 
+NodeOwningDepGraph& NodeOwningDepGraph::operator=(DepGraph &&other)
+{
+    DepGraph::operator=(std::move(other));
+    return *this;
+}
+
 NodeOwningDepGraph::~NodeOwningDepGraph() {
-    for (auto node : nodes) {
-        if (node.second) {
-            delete node.second;
-            node.second = nullptr;
-        }
-    }
+    // Nodes are freed in bulk by the arena once no graph refers to them
     nodes.clear();
 }
@@ -26,6 +26,7 @@
 #ifndef DEPGRAPH_HPP_
 #define DEPGRAPH_HPP_
 
+#include "DepGraphArena.hpp"
 #include "DepGraphNode.hpp"
 #include "DepGraphSccNode.hpp"
 #include "DepGraphUninitNode.hpp"
@@ -34,6 +35,7 @@
 #include "Metadata.hpp"
 
 #include <map>
+#include <memory>
 #include <vector>
 #include <stack>
 #include <queue>
@@ -87,7 +89,9 @@ public:
     DepGraph();
     DepGraph(DepGraphNormalNode* root) : metadata() { this->root = root; this->addNode(root); this->topLeaf = nullptr;};
     DepGraph(const DepGraph& other);
+    DepGraph(DepGraph&& other);
     DepGraph& operator=(const DepGraph &other);
+    DepGraph& operator=(DepGraph &&other);
     bool operator<(const DepGraph &other);
     virtual ~DepGraph() {};
 
@@ -126,12 +130,29 @@ public:
         return num;
     };
 
+    // Largest node ID in the graph or -1 if empty, node IDs assigned by the
+    // parsers are dense so this bounds per-node tables indexed by ID
+    int getMaxNodeID() const {
+        return nodes.empty() ? -1 : nodes.rbegin()->first;
+    };
+
     NodesList getNodes();
     const Metadata& get_metadata() const;
+
+    // Nodes and places are allocated in an arena which is shared by all
+    // copies and input relevant sub graphs, it is freed with the last of them
+    DepGraphArena& getArena();
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        return getArena().create<T>(std::forward<Args>(args)...);
+    }
     UninitNodesList getUninitNodes() ;
 
     OpNodesList getFuncsNodes(const std::vector<std::string> funcsNames) ;
 
+    // The nodes the input flows into and the edges between them. The nodes
+    // are shared with this graph through the arena, the node and edge maps
+    // are filtered copies built in one pass over the edges.
     DepGraph getInputRelevantGraph(DepGraphNode* inputNode) ;
 
     DepGraphUninitNode* findInputNode(string name);
@@ -159,11 +180,16 @@ public:
     static DepGraph parseDotFile(const std::string& fname);
     static DepGraph parseString(const std::string& s);
     static DepGraph parsePixyDotFile(std::string fname);
+    static DepGraph parseStream(std::istream &stream);
+
+    // throws invalid_argument if a modeled operation has the wrong number of
+    // arguments. Not done while parsing, so that the analysis can report the
+    // graph as malformed instead of dropping the file.
+    void checkOpArities() const;
     
     std::string label;
     std::string labelloc;
 protected:
-    static DepGraph parseStream(std::istream &stream);
 // map from a node to *the same* node;
 	NodesMap nodes;
 
@@ -188,24 +214,29 @@ protected:
 
 	Metadata metadata;
 
+	std::shared_ptr<DepGraphArena> arena;
+
 	void dfsSCC(DepGraphNode* node, int& time_count, map<int, int>& lowlink, map<int, bool>& used, stack<int>& process_stack);
 
 	void printSCCInfo();
 
-	void doGetInputRelevantGraph(DepGraphNode* node,
-				DepGraph& inputDepGraph) ;
-
 private:
         static std::string escapeLiteral(const std::string& litValue);
+        static int compactNodeID(std::map<int, int>& nodeIDs, int dotID);
+        static DepGraphNode* lookupDotNode(DepGraph& depGraph, const std::map<int, int>& nodeIDs, int dotID);
 };
 
-// Like a Depgraph, but owns its node pointers (and deletes the in the descrutor)
+// Like a Depgraph, but keeps its nodes alive for its own lifetime. The nodes
+// are owned by the arena, which every DepGraph now shares with its copies, so
+// this only remains to document ownership at the declaration site.
 class NodeOwningDepGraph : public DepGraph {
 
 public:
     NodeOwningDepGraph() : DepGraph() {}
     NodeOwningDepGraph(const DepGraph& other);
+    NodeOwningDepGraph(DepGraph&& other);
     NodeOwningDepGraph& operator=(const DepGraph &other);
+    NodeOwningDepGraph& operator=(DepGraph &&other);
     virtual ~NodeOwningDepGraph();
 
 };
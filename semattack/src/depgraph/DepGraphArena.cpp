@@ -0,0 +1,69 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * DepGraphArena.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#include "DepGraphArena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+// Large enough for the nodes of a typical dependency graph
+const std::size_t DepGraphArena::block_size = 8 * 1024;
+
+DepGraphArena::DepGraphArena()
+  : m_blocks()
+  , m_objects()
+  , m_current(nullptr)
+  , m_remaining(0)
+  , m_allocated(0)
+{
+}
+
+DepGraphArena::~DepGraphArena()
+{
+  // Destroy in reverse order of construction, the memory goes with the blocks
+  for (auto it = m_objects.rbegin(); it != m_objects.rend(); ++it) {
+    it->second(it->first);
+  }
+  m_objects.clear();
+  m_blocks.clear();
+}
+
+void* DepGraphArena::allocate(std::size_t size, std::size_t alignment)
+{
+  std::size_t padding = m_current ? (alignment - reinterpret_cast<std::uintptr_t>(m_current) % alignment) % alignment : 0;
+  if (m_current == nullptr || padding + size > m_remaining) {
+    // Oversized objects get a block of their own
+    std::size_t new_size = std::max(block_size, size + alignment);
+    m_blocks.emplace_back(new char[new_size]);
+    m_current = m_blocks.back().get();
+    m_remaining = new_size;
+    m_allocated += new_size;
+    padding = (alignment - reinterpret_cast<std::uintptr_t>(m_current) % alignment) % alignment;
+  }
+  void* memory = m_current + padding;
+  m_current += padding + size;
+  m_remaining -= padding + size;
+  return memory;
+}
@@ -0,0 +1,78 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * DepGraphArena.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#ifndef DEPGRAPH_ARENA_HPP_
+#define DEPGRAPH_ARENA_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Owns the nodes and places of a parsed dependency graph. Objects are
+// placement constructed into large blocks and destroyed all at once when the
+// arena dies, instead of one new/delete per node. Not thread safe, each
+// graph is built by a single parser thread.
+class DepGraphArena {
+
+public:
+  DepGraphArena();
+  ~DepGraphArena();
+
+  DepGraphArena(const DepGraphArena&) = delete;
+  DepGraphArena& operator=(const DepGraphArena&) = delete;
+
+  template<typename T, typename... Args>
+  T* create(Args&&... args) {
+    void* memory = allocate(sizeof(T), alignof(T));
+    T* object = new (memory) T(std::forward<Args>(args)...);
+    m_objects.emplace_back(object, &DepGraphArena::destroy<T>);
+    return object;
+  }
+
+  std::size_t getObjectCount() const { return m_objects.size(); }
+  std::size_t getAllocatedBytes() const { return m_allocated; }
+
+private:
+  typedef void (*Destructor)(void*);
+
+  template<typename T>
+  static void destroy(void* object) {
+    static_cast<T*>(object)->~T();
+  }
+
+  void* allocate(std::size_t size, std::size_t alignment);
+
+  std::vector<std::unique_ptr<char[]> > m_blocks;
+  std::vector<std::pair<void*, Destructor> > m_objects;
+  char* m_current;
+  std::size_t m_remaining;
+  std::size_t m_allocated;
+
+  static const std::size_t block_size;
+};
+
+#endif /* DEPGRAPH_ARENA_HPP_ */
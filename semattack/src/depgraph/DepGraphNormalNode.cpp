@@ -31,7 +31,9 @@
 //}
 
 DepGraphNormalNode::~DepGraphNormalNode() {
-	delete place;
+	if (ownsPlace) {
+		delete place;
+	}
 }
 
 
@@ -33,13 +33,14 @@
 
 class DepGraphNormalNode: public DepGraphNode {
 public:
-	DepGraphNormalNode(std::string filename, int origLineno, int id, int order, int sccID, TacPlace* place) : DepGraphNode(filename, origLineno, id, order, sccID), place(place)
+	// ownsPlace is false if the place lives in the same DepGraphArena as the node
+	DepGraphNormalNode(std::string filename, int origLineno, int id, int order, int sccID, TacPlace* place, bool ownsPlace = true) : DepGraphNode(filename, origLineno, id, order, sccID), place(place), ownsPlace(ownsPlace)
     {
         isTainted = false;
     };
 
 	DepGraphNormalNode(const DepGraphNormalNode& other)
-		: DepGraphNode(other), isTainted(other.isTainted){
+		: DepGraphNode(other), ownsPlace(true), isTainted(other.isTainted){
 		place = other.place->clone();
 	};
 	virtual ~DepGraphNormalNode();
@@ -54,6 +55,7 @@ public:
 
 private:
 	TacPlace* place;
+	bool ownsPlace;
 	bool isTainted;
 
 
@@ -25,15 +25,18 @@
 #define DEPGRAPHOPNODE_HPP_
 
 #include "DepGraphNode.hpp"
+#include "OpKind.hpp"
 
 class DepGraphOpNode: public DepGraphNode {
 public:
-	DepGraphOpNode(std::string filename, int origLineno, int id, int order, int sccID, std::string opname, bool builtin) : DepGraphNode(filename, origLineno, id, order, sccID), name(opname), builtin(builtin){};
+	DepGraphOpNode(std::string filename, int origLineno, int id, int order, int sccID, std::string opname, bool builtin) : DepGraphNode(filename, origLineno, id, order, sccID), name(opname), kind(OpKindHelper::fromName(opname)), builtin(builtin){};
 	DepGraphOpNode(const DepGraphOpNode& other)
-			: DepGraphNode(other), name(other.name), builtin(other.builtin) {	};
+			: DepGraphNode(other), name(other.name), kind(other.kind), builtin(other.builtin) {	};
 	virtual ~DepGraphOpNode();
 	std::string dotNameShortest() const;
 	std::string getName() const {return this->name;};
+	// Resolved once from the name, Unknown if the function has no model
+	OpKind getKind() const {return this->kind;};
 	bool isBuiltin() const {return this->builtin;};
 	bool equals (const DepGraphNode* compX) const;
 	std::string dotName() const;
@@ -43,6 +46,7 @@ public:
 
 private:
     std::string name;
+	OpKind kind;
 	bool builtin;    // builtin function?
 
 };
@@ -68,32 +68,41 @@ namespace {
 Metadata::Metadata()
     : uuid(),
     url(),
-    sink(),
-    source(),
+    parentloc(),
+    base_domain(emptyString()),
+    sink(emptyString()),
+    source(emptyString()),
     sanitizer_score(0),
     taint_range_index(0),
     start_index(0),
+    hash(0),
+    sanitizer_hash(0),
+    twenty_five_million_flows_id(0),
     end_index(0),
     initialized(false),
+    script(emptyString()),
+    domain(),
     exploit_method(Unknown),
     exploit_status(Error),
     exploit_type(Undefined),
-    hash(0),
-    sanitizer_hash(0),
-    twenty_five_million_flows_id(0),
-    domain(),
-    valid_exploit(false),
-    break_in(),
-    break_out(),
+    exploit_content(),
+    exploit_token(),
+    exploit_tag(),
+    exploit_quote_type(),
+    break_out(emptyString()),
+    break_in(emptyString()),
     payload(),
+    sanitizer_name(),
+    sanitizer_loc(),
+    valid_exploit(false),
     begin_taint_url(-1),
     end_taint_url(-1),
-    replace_begin_param(-1),
-    replace_end_param(-1),
     replace_begin_url(-1),
     replace_end_url(-1),
-    max_encode_text_fragment_chain_length(0),
-    max_encode_attr_chain_length(0)
+    replace_begin_param(-1),
+    replace_end_param(-1),
+    max_encode_attr_chain_length(0),
+    max_encode_text_fragment_chain_length(0)
     {
 
 }
@@ -102,23 +111,23 @@ std::string Metadata::get_uuid() const {
     return this->uuid;
 }
 
-std::string Metadata::get_url() const {
+const std::string& Metadata::get_url() const {
     return this->url;
 }
 
 std::string Metadata::get_comma_escaped_url() const {
     // In some cases the url is in the parent loc and not the url
-    std::string encoded = (this->url == "about:blank") ? this->parentloc : this->url;
+    std::string encoded = (get_url() == "about:blank") ? get_parent_loc() : get_url();
     replaceAll(encoded, ",", "%2C");
     return encoded;
 }
 
-std::string Metadata::get_sink() const {
-    return this->sink;
+const std::string& Metadata::get_sink() const {
+    return *this->sink;
 }
 
-std::string Metadata::get_source() const {
-    return this->source;
+const std::string& Metadata::get_source() const {
+    return *this->source;
 }
 
 int Metadata::get_sanitizer_score() const {
@@ -156,7 +165,7 @@ bool Metadata::set_field(const std::string& key, const std::string& value) {
     }
     if(key == "Finding.base_domain") {
         this->initialized = true;
-        this->base_domain = value;
+        this->base_domain = intern(value);
         return true;
     }
     if(key == "Finding.parentloc") {
@@ -166,12 +175,12 @@ bool Metadata::set_field(const std::string& key, const std::string& value) {
     }
     if(key == "Finding.sink") {
         this->initialized = true;
-        this->sink = value;
+        this->sink = intern(value);
         return true;
     }
     if(key == "Finding.source") {
         this->initialized = true;
-        this->source = value;
+        this->source = intern(value);
         return true;
     }
     if(key == "Finding.begin") {
@@ -186,7 +195,7 @@ bool Metadata::set_field(const std::string& key, const std::string& value) {
     }
     if(key == "Finding.script") {
         this->initialized = true;
-        this->script = value;
+        this->script = intern(value);
         return true;
     }
     if(key == "Sanitizer.score") {
@@ -319,13 +328,13 @@ bool Metadata::set_field(const std::string& key, const std::string& value) {
         return true;
     }
     if(key == "Exploit.break_in") {
-        this->break_in = value;
+        this->break_in = intern(value);
         this->initialized = true;
         this->valid_exploit = true;
         return true;
     }
     if(key == "Exploit.break_out") {
-        this->break_out = value;
+        this->break_out = intern(value);
         this->initialized = true;
         this->valid_exploit = true;
         return true;
@@ -432,17 +441,31 @@ bool Metadata::set_field(const std::string& key, const std::string& value) {
 
 void Metadata::to_dot(std::stringstream &ss) const {
     ss << "// Finding: " << this->uuid << "\n";
-    ss << "// Finding.url: " << this->url << "\n";
-    ss << "// Finding.sink: " << this->sink << "\n";
-    ss << "// Finding.source: " << this->source << "\n";
+    ss << "// Finding.url: " << get_url() << "\n";
+    ss << "// Finding.sink: " << get_sink() << "\n";
+    ss << "// Finding.source: " << get_source() << "\n";
     ss << "// Finding.begin: " << this->start_index << "\n";
     ss << "// Finding.end: " << this->end_index << "\n";
     ss << "// Finding.original_uuid: " << this->original_uuid << "\n";
-    ss << "// Finding.script: " << this->script << "\n";
+    ss << "// Finding.script: " << get_script() << "\n";
     ss << "// Finding.line: " << this->line << "\n";
 
 }
 
+StringPool& Metadata::strings() {
+    static StringPool pool;
+    return pool;
+}
+
+const std::string* Metadata::intern(const std::string& value) {
+    return &strings().store(value);
+}
+
+const std::string* Metadata::emptyString() {
+    static const std::string* empty = intern("");
+    return empty;
+}
+
 const std::string &Metadata::get_exploit_uuid() const {
     return exploit_uuid;
 }
@@ -464,19 +487,19 @@ Exploit_Type Metadata::get_exploit_type() const {
 }
 
 const std::string &Metadata::get_exploit_content() const {
-    return exploit_content;
+    return this->exploit_content;
 }
 
 const std::string &Metadata::get_exploit_token() const {
-    return exploit_token;
+    return this->exploit_token;
 }
 
 const std::string &Metadata::get_exploit_tag() const {
-    return exploit_tag;
+    return this->exploit_tag;
 }
 
 const std::string &Metadata::get_exploit_quote_type() const {
-    return exploit_quote_type;
+    return this->exploit_quote_type;
 }
 
 int Metadata::get_hash() const {
@@ -484,7 +507,7 @@ int Metadata::get_hash() const {
 }
 
 const std::string &Metadata::get_script() const {
-    return this->script;
+    return *this->script;
 }
 
 int Metadata::get_line() const {
@@ -495,19 +518,19 @@ std::string Metadata::get_original_uuid() const {
     return this->original_uuid;
 }
 
-std::string Metadata::get_domain() const {
+const std::string& Metadata::get_domain() const {
     return this->domain;
 }
-std::string Metadata::get_base_domain() const {
-    return this->base_domain;
+const std::string& Metadata::get_base_domain() const {
+    return *this->base_domain;
 }
-std::string Metadata::get_sanitizer_name() const {
+const std::string& Metadata::get_sanitizer_name() const {
     return this->sanitizer_name;
 }
-std::string Metadata::get_sanitizer_location() const {
+const std::string& Metadata::get_sanitizer_location() const {
     return this->sanitizer_loc;
 }
-std::string Metadata::get_parent_loc() const {
+const std::string& Metadata::get_parent_loc() const {
     return this->parentloc;
 }
 int Metadata::get_twenty_five_million_flows_id() const {
@@ -533,15 +556,15 @@ bool Metadata::has_valid_exploit() const {
     return this->valid_exploit;
 }
 
-std::string Metadata::get_break_out() const {
-    return this->break_out;
+const std::string& Metadata::get_break_out() const {
+    return *this->break_out;
 }
 
-std::string Metadata::get_break_in() const {
-    return this->break_in;
+const std::string& Metadata::get_break_in() const {
+    return *this->break_in;
 }
 
-std::string Metadata::get_payload() const {
+const std::string& Metadata::get_payload() const {
     return this->payload;
 }
 
@@ -29,6 +29,8 @@
 
 #include <string>
 
+#include "StringPool.hpp"
+
 enum Exploit_Method {
     A,
     B,
@@ -57,11 +59,11 @@ public:
     bool set_field(const std::string& key, const std::string& value);
 
     std::string get_uuid() const;
-    std::string get_url() const;
+    const std::string& get_url() const;
     // This is just needed to stop the csv output from breaking
     std::string get_comma_escaped_url() const;
-    std::string get_sink() const;
-    std::string get_source() const;
+    const std::string& get_sink() const;
+    const std::string& get_source() const;
     int get_sanitizer_score() const;
     int get_taint_range_index() const;
     int get_start_index() const;
@@ -69,9 +71,9 @@ public:
     bool has_valid_exploit() const;
     const std::string &get_exploit_uuid() const;
 
-    std::string get_break_out() const;
-    std::string get_break_in() const;
-    std::string get_payload() const;
+    const std::string& get_break_out() const;
+    const std::string& get_break_in() const;
+    const std::string& get_payload() const;
 
     bool is_exploit_successful() const;
 
@@ -93,11 +95,11 @@ public:
     int get_line() const;
 
     std::string get_original_uuid() const;
-    std::string get_domain() const;
-    std::string get_base_domain() const;
-    std::string get_parent_loc() const;
-    std::string get_sanitizer_name() const;
-    std::string get_sanitizer_location() const;
+    const std::string& get_domain() const;
+    const std::string& get_base_domain() const;
+    const std::string& get_parent_loc() const;
+    const std::string& get_sanitizer_name() const;
+    const std::string& get_sanitizer_location() const;
     int get_twenty_five_million_flows_id() const;
     int get_sanitizer_hash() const;
     int get_hash() const;
@@ -139,7 +141,19 @@ public:
     void print(std::ostream& os) const;
     static void printHeader(std::ostream& os);
 
+    // Pool shared by all instances for the few fields which take only a
+    // handful of values over a run (base domains, sinks, sources, scripts,
+    // break in and break out). Urls and everything else which is nearly
+    // unique per finding stays inline, so the pool stays small.
+    static StringPool& strings();
+
 private:
+    // Pooled fields hold pointers rather than StringPool handles: the
+    // pointers are stable, so the getters return references without taking
+    // the pool lock.
+    static const std::string* intern(const std::string& value);
+    static const std::string* emptyString();
+
     static std::string UriEncode(const std::string & sSrc);
     static bool replaceAll( std::string &s, const std::string &search, const std::string &replace );
     static std::string default_payload;
@@ -147,9 +161,9 @@ private:
     std::string uuid;
     std::string url;
     std::string parentloc;
-    std::string base_domain;
-    std::string sink;
-    std::string source;
+    const std::string* base_domain;
+    const std::string* sink;
+    const std::string* source;
     int sanitizer_score;
     int taint_range_index;
     int start_index;
@@ -160,7 +174,7 @@ private:
     bool initialized;
     std::string exploit_uuid;
     std::string original_uuid;
-    std::string script;
+    const std::string* script;
     std::string domain;
     int line{};
     bool exploit_success{};
@@ -171,8 +185,8 @@ private:
     std::string exploit_token;
     std::string exploit_tag;
     std::string exploit_quote_type;
-    std::string break_out;
-    std::string break_in;
+    const std::string* break_out;
+    const std::string* break_in;
     std::string payload;
     std::string sanitizer_name;
     std::string sanitizer_loc;
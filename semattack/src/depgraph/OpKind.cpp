@@ -0,0 +1,113 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * OpKind.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#include "OpKind.hpp"
+
+#include <unordered_map>
+
+#define MAKE_STRINGS(VAR, MIN, MAX) #VAR,
+const char* OpKindHelper::OpKindName[] = {
+    OP_KIND_ENUM(MAKE_STRINGS)
+};
+#undef MAKE_STRINGS
+
+#define MAKE_MIN(VAR, MIN, MAX) MIN,
+const int OpKindHelper::OpKindMinArgs[] = {
+    OP_KIND_ENUM(MAKE_MIN)
+};
+#undef MAKE_MIN
+
+#define MAKE_MAX(VAR, MIN, MAX) MAX,
+const int OpKindHelper::OpKindMaxArgs[] = {
+    OP_KIND_ENUM(MAKE_MAX)
+};
+#undef MAKE_MAX
+
+// Names used by the depgraph generators for each kind
+static const std::unordered_map<std::string, OpKind> op_names = {
+  { ".", OpKind::Concat },
+  { "concat", OpKind::Concat },
+  { "preg_replace", OpKind::Replace },
+  { "ereg_replace", OpKind::Replace },
+  { "str_replace", OpKind::Replace },
+  { "str_replace_once", OpKind::StrReplaceOnce },
+  { "regex_match", OpKind::RegexMatch },
+  { "regex_exec", OpKind::RegexMatch },
+  { "split", OpKind::Split },
+  { "addslashes", OpKind::Addslashes },
+  { "stripslashes", OpKind::Stripslashes },
+  { "mysql_escape_string", OpKind::MysqlEscapeString },
+  { "mysql_real_escape_string", OpKind::MysqlRealEscapeString },
+  { "htmlspecialchars", OpKind::Htmlspecialchars },
+  { "nl2br", OpKind::Nl2br },
+  { "substr", OpKind::Substr },
+  { "strtoupper", OpKind::Strtoupper },
+  { "strtolower", OpKind::Strtolower },
+  { "trim", OpKind::Trim },
+  { "rtrim", OpKind::Rtrim },
+  { "ltrim", OpKind::Ltrim },
+  { "md5", OpKind::Md5 },
+  { "encodeURIComponent", OpKind::EncodeURIComponent },
+  { "decodeURIComponent", OpKind::DecodeURIComponent },
+  { "encodeURI", OpKind::EncodeURI },
+  { "decodeURI", OpKind::DecodeURI },
+  { "escape", OpKind::Escape },
+  { "unescape", OpKind::Unescape },
+  { "JSON.stringify", OpKind::JsonStringify },
+  { "JSON.parse", OpKind::JsonParse },
+  { "encodeTextFragment", OpKind::EncodeTextFragment },
+  { "encodeAttrString", OpKind::EncodeAttrString },
+};
+
+const char* OpKindHelper::getName(OpKind kind)
+{
+  return OpKindName[static_cast<int>(kind)];
+}
+
+OpKind OpKindHelper::fromName(const std::string& name)
+{
+  // __vlab_restrict can appear anywhere in the name
+  if (name.find("__vlab_restrict") != std::string::npos) {
+    return OpKind::VlabRestrict;
+  }
+  auto iter = op_names.find(name);
+  return (iter != op_names.end()) ? iter->second : OpKind::Unknown;
+}
+
+int OpKindHelper::getMinArgs(OpKind kind)
+{
+  return OpKindMinArgs[static_cast<int>(kind)];
+}
+
+int OpKindHelper::getMaxArgs(OpKind kind)
+{
+  return OpKindMaxArgs[static_cast<int>(kind)];
+}
+
+bool OpKindHelper::isValidArity(OpKind kind, std::size_t args)
+{
+  int max = getMaxArgs(kind);
+  return (args >= static_cast<std::size_t>(getMinArgs(kind))) &&
+    ((max < 0) || (args <= static_cast<std::size_t>(max)));
+}
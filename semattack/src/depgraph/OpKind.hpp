@@ -0,0 +1,88 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * OpKind.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef OP_KIND_HPP_
+#define OP_KIND_HPP_
+
+#include <cstddef>
+#include <string>
+
+// Operations with a model in the analysis and their number of arguments,
+// -1 for no upper bound. Several depgraph names can map to one kind.
+#define OP_KIND_ENUM(DO)                       \
+  DO(Unknown, 0, -1)                           \
+  DO(VlabRestrict, 3, 3)                       \
+  DO(Concat, 1, -1)                            \
+  DO(Replace, 3, 3)                            \
+  DO(StrReplaceOnce, 3, 3)                     \
+  DO(RegexMatch, 3, 3)                         \
+  DO(Split, 2, 2)                              \
+  DO(Addslashes, 1, 1)                         \
+  DO(Stripslashes, 1, 1)                       \
+  DO(MysqlEscapeString, 1, 2)                  \
+  DO(MysqlRealEscapeString, 1, 2)              \
+  DO(Htmlspecialchars, 1, 4)                   \
+  DO(Nl2br, 1, 2)                              \
+  DO(Substr, 2, 3)                             \
+  DO(Strtoupper, 1, 1)                         \
+  DO(Strtolower, 1, 1)                         \
+  DO(Trim, 1, 2)                               \
+  DO(Rtrim, 1, 2)                              \
+  DO(Ltrim, 1, 2)                              \
+  DO(Md5, 1, 2)                                \
+  DO(EncodeURIComponent, 1, 1)                 \
+  DO(DecodeURIComponent, 1, 1)                 \
+  DO(EncodeURI, 1, 1)                          \
+  DO(DecodeURI, 1, 1)                          \
+  DO(Escape, 1, 1)                             \
+  DO(Unescape, 1, 1)                           \
+  DO(JsonStringify, 1, 3)                      \
+  DO(JsonParse, 1, 2)                          \
+  DO(EncodeTextFragment, 1, 2)                 \
+  DO(EncodeAttrString, 1, 2)
+
+#define MAKE_ENUM(VAR, MIN, MAX) VAR,
+enum class OpKind {
+    OP_KIND_ENUM(MAKE_ENUM)
+};
+#undef MAKE_ENUM
+
+class OpKindHelper {
+
+public:
+  static const char* getName(OpKind kind);
+  // Kind of a depgraph operation name, Unknown for unmodeled functions
+  static OpKind fromName(const std::string& name);
+  static int getMinArgs(OpKind kind);
+  static int getMaxArgs(OpKind kind);
+  static bool isValidArity(OpKind kind, std::size_t args);
+
+private:
+  static const char* OpKindName[];
+  static const int OpKindMinArgs[];
+  static const int OpKindMaxArgs[];
+
+};
+
+#endif /* OP_KIND_HPP_ */
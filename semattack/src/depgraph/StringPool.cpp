@@ -0,0 +1,71 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * StringPool.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#include "StringPool.hpp"
+
+#include <stdexcept>
+
+const StringPool::Handle StringPool::empty = 0;
+
+StringPool::StringPool()
+  : m_mutex()
+  , m_handles()
+  , m_strings()
+{
+  intern("");
+}
+
+StringPool::Handle StringPool::intern(const std::string& s)
+{
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  auto search = m_handles.find(s);
+  if (search != m_handles.end()) {
+    return search->second;
+  }
+  Handle handle = m_strings.size();
+  auto inserted = m_handles.insert(std::make_pair(s, handle));
+  m_strings.push_back(&inserted.first->first);
+  return handle;
+}
+
+const std::string& StringPool::store(const std::string& s)
+{
+  return get(intern(s));
+}
+
+const std::string& StringPool::get(Handle handle) const
+{
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  if (handle >= m_strings.size()) {
+    throw std::out_of_range("Unknown string pool handle");
+  }
+  return *m_strings[handle];
+}
+
+std::size_t StringPool::size() const
+{
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_strings.size();
+}
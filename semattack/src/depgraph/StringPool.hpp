@@ -0,0 +1,65 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * StringPool.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#ifndef STRING_POOL_HPP_
+#define STRING_POOL_HPP_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Interns strings which repeat many times over a run (domains, sinks, script
+// urls, ...) so that they can be stored and compared as small integer
+// handles. Thread safe, handles and references stay valid as long as the pool.
+class StringPool {
+
+public:
+  typedef unsigned int Handle;
+
+  StringPool();
+
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  Handle intern(const std::string& s);
+  const std::string& get(Handle handle) const;
+  // The pooled copy of s, valid as long as the pool. Reading it needs no
+  // lock, unlike get().
+  const std::string& store(const std::string& s);
+  std::size_t size() const;
+
+  // The empty string always has handle 0
+  static const Handle empty;
+
+private:
+  mutable std::mutex m_mutex;
+  // Each string is only stored once, as a key of the map. Keys of an
+  // unordered_map do not move on rehashing, so the pointers stay valid.
+  std::unordered_map<std::string, Handle> m_handles;
+  std::vector<const std::string*> m_strings;
+};
+
+#endif /* STRING_POOL_HPP_ */
@@ -23,7 +23,10 @@
  */
 
 #include <boost/program_options.hpp>
+#include <boost/thread.hpp>
+#include <fstream>
 #include "SemRepair.hpp"
+#include "SemRepairBatch.hpp"
 #include "AnalysisResult.hpp"
 #include "exceptions/StrangerException.hpp"
 
@@ -57,6 +60,23 @@ void call_sem_repair(string reference_name, string target_name, string field_nam
 }
 
 
+void call_sem_repair_batch(string reference_name, string targets, string field_name, string output_name, unsigned int threads){
+	try {
+		cout << endl << "\t------ Starting Batch Analysis for: " << field_name << " ------" << endl;
+		cout << endl << "\t       Reference: " << reference_name  << endl;
+		cout << endl << "\t       Targets: " << targets  << endl;
+		SemRepairBatch batch(reference_name, field_name, targets, threads);
+		const vector<SemRepairBatch::Row>& rows = batch.run();
+
+		ofstream ofs(output_name, ofstream::out);
+		batch.writeCsv(ofs);
+		cout << endl << "\t------ Wrote " << rows.size() << " results to " << output_name << " ------" << endl;
+	} catch (StrangerException const &e) {
+		cerr << e.what();
+		exit(EXIT_FAILURE);
+	}
+}
+
 // A helper function to simplify the main part.
 template<class T>
 ostream& operator<<(ostream& os, const vector<T>& v)
@@ -72,9 +92,12 @@ int main(int argc, char *argv[]) {
         desc.add_options()
             ("help", "produce help message")
             ("verbose", po::value<string>()->implicit_value("0"), "verbosity level")
-            ("target,t", po::value<string>()->required(), "Path to dependency graph file for repair target function.")
+            ("target,t", po::value<string>(), "Path to dependency graph file for repair target function.")
             ("reference,r", po::value<string>()->required(), "Path to dependency graph file for repair reference function.")
-            ("fieldname,f", po::value<string>()->required(), "Name of the input field for which sanitization code needs to be repaired.");
+            ("fieldname,f", po::value<string>()->required(), "Name of the input field for which sanitization code needs to be repaired.")
+            ("batch,b", po::value<string>(), "Repair every target in a directory, manifest file or tar/zip bundle of dependency graphs instead of --target.")
+            ("output,o", po::value<string>()->default_value("semrep_batch.csv"), "Path to the CSV file with one row per target in batch mode.")
+            ("threads,j", po::value<unsigned int>()->default_value(0), "Number of threads in batch mode (0 uses all hardware threads)");
 
         po::positional_options_description p;
         p.add("target", 1);
@@ -89,6 +112,7 @@ int main(int argc, char *argv[]) {
         if (vm.count("help"))
         {
             cout << "Usage: SemRep [options] <target> <reference> <fieldname>\n";
+            cout << "       SemRep [options] --batch <targets> --reference <reference> --fieldname <fieldname>\n";
             cout << "<target> is Path to dependency graph file for repair target function.\n";
             cout << "<reference> is Path to dependency graph file for repair reference function.\n";
             cout << "<fieldname> is Name of the input field for which sanitization code needs to be repaired.\n";
@@ -98,7 +122,16 @@ int main(int argc, char *argv[]) {
 
         po::notify(vm);
 
-        if (vm.count("target") && vm.count("reference") && vm.count("fieldname"))
+        if (vm.count("batch") && vm.count("reference") && vm.count("fieldname"))
+        {
+            unsigned int threads = vm["threads"].as<unsigned int>();
+            if (threads == 0) {
+                threads = boost::thread::hardware_concurrency();
+            }
+            call_sem_repair_batch(vm["reference"].as<string>(), vm["batch"].as<string>(), vm["fieldname"].as<string>(),
+                                  vm["output"].as<string>(), threads);
+        }
+        else if (vm.count("target") && vm.count("reference") && vm.count("fieldname"))
         {
             call_sem_repair(vm["reference"].as<string>(), vm["target"].as<string>(), vm["fieldname"].as<string>());
         }
@@ -25,7 +25,10 @@
  */
 
 #include <boost/program_options.hpp>
+#include <boost/thread.hpp>
 #include "SemAttack.hpp"
+#include "ImageComputer.hpp"
+#include "MultiInputAttack.hpp"
 #include "AttackPatterns.hpp"
 #include "exceptions/StrangerException.hpp"
 #include "main_attack.hpp"
@@ -93,6 +96,46 @@ std::tuple<ResultStatus, std::string> call_sem_attack(const std::string& target_
     return {ResultStatus::ERROR, AnalysisErrorHelper::getName(AnalysisError::None)};
 }
 
+static AttackContext context_from_name(const string& name)
+{
+#define MAKE_CONTEXT(VAR) AttackContext::VAR,
+    static const vector<AttackContext> contexts = { SOME_ENUM(MAKE_CONTEXT) };
+#undef MAKE_CONTEXT
+    for (auto context : contexts) {
+        if (name == AttackContextHelper::getName(context)) {
+            return context;
+        }
+    }
+    throw po::validation_error(po::validation_error::invalid_option_value, "context", name);
+}
+
+void call_sem_attack_all_inputs(const std::string& target_name, const std::string& dep_graph,
+                                const std::vector<std::string>& context_names, unsigned int threads){
+    try {
+        cout << endl << "\t------ Starting Analysis for all inputs ------" << endl;
+        cout << endl << "\t       Target: " << target_name  << endl;
+        DepGraph target_dep_graph;
+        if (dep_graph != "") {
+            target_dep_graph = DepGraph::parseString(dep_graph);
+        } else
+        {
+            target_dep_graph = DepGraph::parseDotFile(target_name);
+        }
+
+        MultiInputAttack attack(target_name, target_dep_graph, threads);
+        for (const auto& name : context_names) {
+            attack.addAttackPattern(context_from_name(name));
+        }
+        attack.compute();
+
+        cout << endl << "\t------ OVERALL RESULT for all inputs ------" << endl;
+        attack.printResults(cout);
+        cout << endl << "\t------ END RESULT for all inputs ------" << endl;
+    } catch (const StrangerException &e) {
+        cerr << e.what();
+        cout << AnalysisErrorHelper::getName(e.getError());
+    }
+}
 
 // A helper function to simplify the main part.
 template<class T>
@@ -107,6 +150,7 @@ void usage() {
     cout << "<target> is Path to dependency graph file for repair target function.\n";
     cout << "<digraph> is the dependency graph object in string format.\n";
     cout << "<fieldname> is Name of the input field for which sanitization code needs to be repaired.\n";
+    cout << "With --all-inputs, every input of the dependency graph is analysed and no <fieldname> is needed.\n";
 }
 
 int main(int argc, char *argv[]) {
@@ -118,7 +162,13 @@ int main(int argc, char *argv[]) {
             ("verbose", po::value<string>()->implicit_value("0"), "verbosity level")
             ("target,t", po::value<string>()->required(), "Path to dependency graph file for target function.")
             ("digraph,d", po::value<string>(), "the dependency graph object in string format.")
-            ("fieldname,f", po::value<string>(), "Name of the input field for which sanitization code needs to be repaired.");
+            ("fieldname,f", po::value<string>(), "Name of the input field for which sanitization code needs to be repaired.")
+            ("all-inputs,a", po::bool_switch()->default_value(false),
+                             "Analyse all inputs of the dependency graph in parallel, input independent nodes are only computed once")
+            ("context,c", po::value<vector<string> >()->default_value(vector<string>{ "Html", "JavaScript", "Url" }, "Html JavaScript Url"),
+                          "Attack patterns checked with --all-inputs, by context name")
+            ("threads,j", po::value<unsigned int>()->default_value(0), "Number of threads with --all-inputs (0 uses all hardware threads)")
+            ("backward-threads", po::value<unsigned int>()->default_value(1), "Number of threads computing independent pre-images of the backward analysis (0 uses all hardware threads)");
 
         po::positional_options_description p;
         p.add("target", 1);
@@ -140,7 +190,20 @@ int main(int argc, char *argv[]) {
 
         std::string exploit = "";
 
-        if (vm.count("digraph") && vm.count("fieldname") && !vm.count("target"))
+        unsigned int backward_threads = vm["backward-threads"].as<unsigned int>();
+        ImageComputer::setBackwardThreads((backward_threads == 0) ? boost::thread::hardware_concurrency() : backward_threads);
+
+        if (vm["all-inputs"].as<bool>() && !(vm.count("digraph") && vm.count("target")))
+        {
+            unsigned int threads = vm["threads"].as<unsigned int>();
+            if (threads == 0) {
+                threads = boost::thread::hardware_concurrency();
+            }
+            call_sem_attack_all_inputs(vm.count("target") ? vm["target"].as<string>() : "",
+                                       vm.count("digraph") ? vm["digraph"].as<string>() : "",
+                                       vm["context"].as<vector<string> >(), threads);
+        }
+        else if (vm.count("digraph") && vm.count("fieldname") && !vm.count("target"))
         {
             call_sem_attack("", vm["digraph"].as<string>(), vm["fieldname"].as<string>(), exploit);
         }
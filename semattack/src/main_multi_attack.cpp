@@ -27,6 +27,9 @@
 #include <boost/program_options.hpp>
 #include "MultiAttack.hpp"
 #include "AttackContext.hpp"
+#include "AutomatonFingerprint.hpp"
+#include "FixPointEngine.hpp"
+#include "ImageComputer.hpp"
 #include "StrangerAutomaton.hpp"
 #include "exceptions/StrangerException.hpp"
 
@@ -37,12 +40,21 @@ namespace po = boost::program_options;
 
 void call_sem_attack(const string& target_name, const string& output_dir, const string& field_name, int max,
                      bool concats, bool singleton_intersection, bool preImage, bool encode, bool payload,
-                     bool attackPatterns, bool attack_forward, bool dotfiles)
+                     bool attackPatterns, bool attack_forward, bool dotfiles, unsigned int parsers,
+                     unsigned int shard, unsigned int shards, unsigned int memory, bool alphabet, bool compress_alphabet, bool profile,
+                     bool canonical, const WideningLimits& widening, unsigned int witnesses,
+                     int defer_minimization, unsigned int backward_threads)
 {
     try {
         cout << endl << "\t------ Starting Analysis for: " << field_name << " ------" << endl;
         cout << endl << "\t       Target: " << target_name  << endl;
 
+        AutomatonFingerprint::setCanonicalForms(canonical);
+        FixPointEngine::setLimits(widening);
+        FixPointEngine::setRecordStatistics(profile);
+        StrangerAutomaton::setDeferredMinimization(defer_minimization);
+        ImageComputer::setBackwardThreads(backward_threads);
+
         StrangerAutomaton* input = StrangerAutomaton::makeAnyString();
         if (encode) {
           StrangerAutomaton* encoded = input->encodeURI(input);
@@ -59,6 +71,17 @@ void call_sem_attack(const string& target_name, const string& output_dir, const
         attack.setPayloadAnalysis(payload);
         attack.setDoForwardAnalysisWithAttackPattern(attack_forward);
         attack.setDotFiles(dotfiles);
+        if (parsers > 0) {
+          attack.setParserThreads(parsers);
+        }
+        if (shards > 1) {
+          attack.setShard(shard, shards);
+        }
+        attack.setMemoryBudget(static_cast<std::size_t>(memory) << 20);
+        attack.setAlphabetAnalysis(alphabet);
+        attack.setCompressAlphabet(compress_alphabet);
+        attack.setProfile(profile);
+        attack.setWitnesses(witnesses);
 
         if (attackPatterns) {
           attack.addAttackPattern(AttackContext::LessThan);
@@ -94,6 +117,9 @@ void call_sem_attack(const string& target_name, const string& output_dir, const
 
         cout << endl << "\t------ OVERALL RESULT for: " << field_name << " ------" << endl;
         cout << "\t    Target: " << target_name << endl;
+        if (shards > 1) {
+          cout << "\t    Shard: " << shard << "/" << shards << " (partial result)" << endl;
+        }
 
         attack.printResults();
 
@@ -106,6 +132,31 @@ void call_sem_attack(const string& target_name, const string& output_dir, const
 }
 
 
+// Parses a shard given as "i/N", with 0 <= i < N
+void parse_shard(const string& value, unsigned int& shard, unsigned int& shards)
+{
+    size_t pos = value.find('/');
+    try {
+        if (pos == string::npos) {
+            throw std::invalid_argument(value);
+        }
+        size_t end = 0;
+        shard = std::stoul(value.substr(0, pos), &end);
+        if (end != pos) {
+            throw std::invalid_argument(value);
+        }
+        shards = std::stoul(value.substr(pos + 1), &end);
+        if (end != value.size() - pos - 1) {
+            throw std::invalid_argument(value);
+        }
+    } catch (std::logic_error&) {
+        throw po::validation_error(po::validation_error::invalid_option_value, "shard", value);
+    }
+    if (shards == 0 || shard >= shards) {
+        throw po::validation_error(po::validation_error::invalid_option_value, "shard", value);
+    }
+}
+
 // A helper function to simplify the main part.
 template<class T>
 ostream& operator<<(ostream& os, const vector<T>& v)
@@ -121,7 +172,7 @@ int main(int argc, char *argv[]) {
         desc.add_options()
           ("help",         "produce help message")
           ("verbose,v",    po::value<string>()->implicit_value("0"), "verbosity level")
-          ("target,t",     po::value<string>()->required(), "Path to dependency graph file for target function.")
+          ("target,t",     po::value<string>()->required(), "Path to dependency graph file, directory, manifest file or tar/zip bundle of dependency graphs.")
           ("output,o",     po::value<string>()->required(), "Path to output directory.")
           ("fieldname,f",  po::value<string>()->required(), "Name of the input field for which sanitization code needs to be repaired.")
           ("concat,c",     po::value<bool>()->default_value(false), "Compute concat operations")
@@ -132,7 +183,20 @@ int main(int argc, char *argv[]) {
           ("payload,y",    po::value<bool>()->default_value(true), "Use payload string attack patterns")
           ("attack,a",     po::value<bool>()->default_value(true), "Use fixed attack patterns")
           ("attackfw,k",   po::value<bool>()->default_value(false), "Do forward analysis with attack pattern if there is no intersection with post image")
-          ("dotfiles,d",   po::value<bool>()->default_value(true), "Output all dot output files to disk");
+          ("dotfiles,d",   po::value<bool>()->default_value(true), "Output all dot output files to disk")
+          ("parsers,j",    po::value<unsigned int>()->default_value(0), "Number of dependency graph parser threads (0 uses half the hardware threads), the analysis uses the remaining threads while loading")
+          ("shard",        po::value<string>()->default_value("0/1"), "Only analyse shard i/N of the sanitizers and write partial results for multiattack-merge")
+          ("memory,m",     po::value<unsigned int>()->default_value(0), "Memory budget in MB for automata kept between forward and backward analysis (0 is unlimited)")
+          ("alphabet,l",   po::value<bool>()->default_value(false), "Write the character classes each sanitizer and the attack patterns distinguish to alphabet.txt")
+          ("compress-alphabet", po::value<bool>()->default_value(false), "Analyse only strings of one representative character per class of --alphabet, automata and examples then only use the representatives")
+          ("profile",      po::value<bool>()->default_value(false), "Write the time per phase and depgraph to semattack_profile.csv and a timeline to semattack_trace.json")
+          ("canonical",    po::value<bool>()->default_value(false), "Intern canonical forms of the post-images, so equal minimized automata are grouped without equivalence checks")
+          ("widen-precise", po::value<int>()->default_value(5), "Updates of a loop node before its values are widened precisely")
+          ("widen-coarse", po::value<int>()->default_value(20), "Updates of a loop node before its values are widened coarsely")
+          ("loop-limit",   po::value<int>()->default_value(30000), "Updates of a loop node after which the loop analysis stops")
+          ("witnesses,w",  po::value<unsigned int>()->default_value(0), "Write up to this many diverse examples of each pre-image to pre_image_<context>_witnesses.txt")
+          ("defer-minimization", po::value<int>()->default_value(0), "Skip minimizing results of intersections, unions and concatenations with at most this many states until they are stored (0 always minimizes)")
+          ("backward-threads", po::value<unsigned int>()->default_value(1), "Threads shared by all backward analyses for independent pre-images within one dependency graph");
 
         po::positional_options_description p;
         p.add("target", 1);
@@ -151,6 +215,15 @@ int main(int argc, char *argv[]) {
 
         po::notify(vm);
 
+        unsigned int shard = 0;
+        unsigned int shards = 1;
+        parse_shard(vm["shard"].as<string>(), shard, shards);
+
+        WideningLimits widening;
+        widening.precise = vm["widen-precise"].as<int>();
+        widening.coarse = vm["widen-coarse"].as<int>();
+        widening.max_updates = vm["loop-limit"].as<int>();
+
         if (vm.count("target") && vm.count("fieldname")) {
           cout << boolalpha
                << "Calling multiattack with target: " << vm["target"].as<string>()
@@ -164,6 +237,16 @@ int main(int argc, char *argv[]) {
                << ", Fixed attack patterns: " << vm["payload"].as<bool>()
                << ", Do forward analysis with attack pattern if there is no intersection with post image: " << vm["attackfw"].as<bool>()
                << ", Output dot files: " << vm["dotfiles"].as<bool>()
+               << ", Shard: " << shard << "/" << shards
+               << ", Memory budget (MB): " << vm["memory"].as<unsigned int>()
+               << ", Alphabet analysis: " << vm["alphabet"].as<bool>()
+               << ", Compressed alphabet: " << vm["compress-alphabet"].as<bool>()
+               << ", Profile: " << vm["profile"].as<bool>()
+               << ", Canonical forms: " << vm["canonical"].as<bool>()
+               << ", Widening: " << widening.precise << "/" << widening.coarse << "/" << widening.max_updates
+               << ", Witnesses: " << vm["witnesses"].as<unsigned int>()
+               << ", Deferred minimization: " << vm["defer-minimization"].as<int>()
+               << ", Backward threads: " << vm["backward-threads"].as<unsigned int>()
                << "\n";
 
             call_sem_attack(vm["target"].as<string>(),
@@ -177,7 +260,19 @@ int main(int argc, char *argv[]) {
                             vm["payload"].as<bool>(),
                             vm["attack"].as<bool>(),
                             vm["attackfw"].as<bool>(),
-                            vm["dotfiles"].as<bool>()
+                            vm["dotfiles"].as<bool>(),
+                            vm["parsers"].as<unsigned int>(),
+                            shard,
+                            shards,
+                            vm["memory"].as<unsigned int>(),
+                            vm["alphabet"].as<bool>(),
+                            vm["compress-alphabet"].as<bool>(),
+                            vm["profile"].as<bool>(),
+                            vm["canonical"].as<bool>(),
+                            widening,
+                            vm["witnesses"].as<unsigned int>(),
+                            vm["defer-minimization"].as<int>(),
+                            vm["backward-threads"].as<unsigned int>()
               );
         }
         else {
@@ -0,0 +1,81 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * Main multi attack merge
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+#include <boost/program_options.hpp>
+#include "ShardResults.hpp"
+#include "exceptions/StrangerException.hpp"
+
+using namespace std;
+namespace po = boost::program_options;
+
+int main(int argc, char *argv[]) {
+    try {
+
+        po::options_description desc("Allowed options");
+        desc.add_options()
+          ("help",         "produce help message")
+          ("output,o",     po::value<string>()->required(), "Path to output directory for the merged results.")
+          ("shards",       po::value<vector<string> >()->required(), "Output directories of the multiattack --shard runs.");
+
+        po::positional_options_description p;
+        p.add("shards", -1);
+
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv).
+                  options(desc).positional(p).run(), vm);
+
+        if (vm.count("help"))
+        {
+            cout << desc << "\n";
+            return 0;
+        }
+
+        po::notify(vm);
+
+        ShardResults results;
+        for (const auto& dir : vm["shards"].as<vector<string> >()) {
+            cout << "Merging shard results from: " << dir << endl;
+            results.addShard(fs::path(dir));
+        }
+
+        fs::path output(vm["output"].as<string>());
+        fs::create_directories(output);
+        results.writeResultsToFile(output);
+        cout << "Merged " << results.getShards() << " shards into: " << output.string() << endl;
+
+    } catch (StrangerException const &e) {
+        cerr << e.what();
+        exit(EXIT_FAILURE);
+    } catch(std::exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        exit(EXIT_FAILURE);
+    }
+    catch(...)
+    {
+        cerr << "Unknown error!" << "\n";
+        exit(EXIT_FAILURE);
+    }
+
+}
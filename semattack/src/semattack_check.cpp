@@ -0,0 +1,94 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * semattack_check.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+// Runs the checks registered by the check_*.cpp files. The depgraphs are
+// read from the test directory next to src, or from the directory given as
+// the first argument.
+
+#include "semattack_check.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "exceptions/StrangerException.hpp"
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+static int failures = 0;
+static fs::path test_dir;
+
+static vector<pair<string, CheckFunction> >& registered_checks()
+{
+  static vector<pair<string, CheckFunction> > checks;
+  return checks;
+}
+
+CheckRegistration::CheckRegistration(const char* name, CheckFunction function)
+{
+  registered_checks().emplace_back(name, function);
+}
+
+void check(bool condition, const string& what)
+{
+  if (!condition) {
+    cerr << "FAIL: " << what << endl;
+    failures++;
+  }
+}
+
+const fs::path& check_test_dir()
+{
+  return test_dir;
+}
+
+int main(int argc, char *argv[]) {
+  // make check runs the tests in the build directory and sets srcdir
+  const char* srcdir = getenv("srcdir");
+  test_dir = (argc > 1) ? fs::path(argv[1]) : fs::path(srcdir ? srcdir : ".") / ".." / "test";
+
+  for (const auto& entry : registered_checks()) {
+    int failures_before = failures;
+    try {
+      entry.second();
+    } catch (StrangerException const &e) {
+      cerr << "FAIL: " << entry.first << ": " << e.what() << endl;
+      failures++;
+    } catch (std::exception const &e) {
+      cerr << "FAIL: " << entry.first << ": " << e.what() << endl;
+      failures++;
+    }
+    cout << ((failures == failures_before) ? "PASS: " : "FAIL: ") << entry.first << endl;
+  }
+
+  if (failures > 0) {
+    cerr << failures << " checks failed" << endl;
+    return EXIT_FAILURE;
+  }
+  cout << "All checks passed" << endl;
+  return EXIT_SUCCESS;
+}
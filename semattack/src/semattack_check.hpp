@@ -0,0 +1,55 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * semattack_check.hpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+#ifndef SEMATTACK_CHECK_HPP_
+#define SEMATTACK_CHECK_HPP_
+
+#define BOOST_FILESYSTEM_VERSION 3
+#define BOOST_FILESYSTEM_NO_DEPRECATED
+#include <boost/filesystem.hpp>
+
+#include <string>
+
+// Checks run by "make check". Each check_*.cpp file registers its checks
+// with SEMATTACK_CHECK, semattack_check runs all of them and fails if any
+// condition passed to check() did not hold.
+
+typedef void (*CheckFunction)();
+
+struct CheckRegistration {
+  CheckRegistration(const char* name, CheckFunction function);
+};
+
+#define SEMATTACK_CHECK(NAME)                                           \
+  static void NAME();                                                   \
+  static CheckRegistration NAME##_registration(#NAME, NAME);            \
+  static void NAME()
+
+// Records a failure if condition does not hold
+void check(bool condition, const std::string& what);
+
+// Directory of the sample dependency graphs (semattack/test)
+const boost::filesystem::path& check_test_dir();
+
+#endif /* SEMATTACK_CHECK_HPP_ */
@@ -0,0 +1,280 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/*
+ * stranger_bench.cpp
+ *
+ * Copyright (C) 2020 SAP SE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the  Free Software
+ * Foundation, Inc., 51 Franklin Street, Suite 500, Boston, MA 02110-1335,
+ * USA.
+ *
+ * Authors: Thomas Barber
+ */
+
+// Times the stranger function models and the core StrangerAutomaton
+// operations on fixed inputs and writes the results as JSON, so runs
+// against different stranger revisions can be compared.
+
+#include <boost/program_options.hpp>
+#define BOOST_FILESYSTEM_VERSION 3
+#define BOOST_FILESYSTEM_NO_DEPRECATED
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <sstream>
+
+#include "AttackContext.hpp"
+#include "AttackPatterns.hpp"
+#include "StrangerAutomaton.hpp"
+#include "StringBuilder.hpp"
+#include "exceptions/StrangerException.hpp"
+
+using namespace std;
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+// Version of the output format, bump when fields change meaning
+static const int bench_format_version = 2;
+
+struct BenchInput {
+  string name;
+  unique_ptr<StrangerAutomaton> automaton;
+};
+
+struct BenchResult {
+  string op;
+  vector<string> inputs;
+  vector<double> times_us;
+  int states;
+  unsigned bdd_nodes;
+  string error;
+};
+
+typedef function<StrangerAutomaton*()> BenchOp;
+
+static AttackContext context_from_name(const string& name)
+{
+  for (auto context : AttackContextHelper::getContexts()) {
+    if (name == AttackContextHelper::getName(context)) {
+      return context;
+    }
+  }
+  throw po::validation_error(po::validation_error::invalid_option_value, "pattern", name);
+}
+
+// Runs op warmup + iterations times and records the time of each measured run
+static BenchResult run(const string& name, const vector<string>& inputs, const BenchOp& op,
+                       unsigned int iterations, unsigned int warmup)
+{
+  BenchResult result;
+  result.op = name;
+  result.inputs = inputs;
+  result.states = -1;
+  result.bdd_nodes = 0;
+  try {
+    for (unsigned int i = 0; i < warmup + iterations; i++) {
+      auto start = chrono::steady_clock::now();
+      unique_ptr<StrangerAutomaton> out(op());
+      auto end = chrono::steady_clock::now();
+      if (i >= warmup) {
+        result.times_us.push_back(chrono::duration<double, micro>(end - start).count());
+      }
+      if (out && !out->isNull()) {
+        result.states = out->get_num_of_states();
+        result.bdd_nodes = out->get_num_of_bdd_nodes();
+      }
+    }
+  } catch (StrangerException const &e) {
+    result.error = AnalysisErrorHelper::getName(e.getError());
+  }
+  cerr << name << "(";
+  for (size_t i = 0; i < inputs.size(); i++) {
+    cerr << (i > 0 ? ", " : "") << inputs[i];
+  }
+  cerr << "): " << (result.error.empty() ? "done" : result.error) << endl;
+  return result;
+}
+
+static void write_json(ostream& os, const vector<BenchResult>& results, unsigned int iterations, unsigned int warmup)
+{
+  os << fixed << setprecision(3);
+  os << "{" << endl;
+  os << "  \"format\": " << bench_format_version << "," << endl;
+  os << "  \"iterations\": " << iterations << "," << endl;
+  os << "  \"warmup\": " << warmup << "," << endl;
+  os << "  \"defer_minimization\": " << StrangerAutomaton::getDeferredMinimization() << "," << endl;
+  os << "  \"results\": [" << endl;
+  for (size_t r = 0; r < results.size(); r++) {
+    const BenchResult& result = results[r];
+    vector<double> times(result.times_us);
+    sort(times.begin(), times.end());
+    os << "    { \"op\": \"" << json_escape(result.op) << "\", \"inputs\": [";
+    for (size_t i = 0; i < result.inputs.size(); i++) {
+      os << (i > 0 ? ", " : "") << "\"" << json_escape(result.inputs[i]) << "\"";
+    }
+    os << "]";
+    if (!result.error.empty() || times.empty()) {
+      os << ", \"error\": \"" << json_escape(result.error) << "\"";
+    } else {
+      double mean = accumulate(times.begin(), times.end(), 0.0) / times.size();
+      os << ", \"min_us\": " << times.front()
+         << ", \"median_us\": " << times[times.size() / 2]
+         << ", \"mean_us\": " << mean
+         << ", \"max_us\": " << times.back()
+         << ", \"states\": " << result.states
+         << ", \"bdd_nodes\": " << result.bdd_nodes;
+    }
+    os << " }" << (r + 1 < results.size() ? "," : "") << endl;
+  }
+  os << "  ]" << endl;
+  os << "}" << endl;
+}
+
+static vector<BenchResult> run_all(const vector<BenchInput>& inputs, const string& filter,
+                                   unsigned int iterations, unsigned int warmup)
+{
+  vector<BenchResult> results;
+  auto add = [&](const string& name, const vector<string>& names, const BenchOp& op) {
+    if (filter.empty() || name.find(filter) != string::npos) {
+      results.push_back(run(name, names, op, iterations, warmup));
+    }
+  };
+
+  unique_ptr<StrangerAutomaton> lessThan(StrangerAutomaton::makeString("<"));
+  unique_ptr<StrangerAutomaton> entity(StrangerAutomaton::makeString("&lt;"));
+  unique_ptr<StrangerAutomaton> script(StrangerAutomaton::makeString("<script"));
+  unique_ptr<StrangerAutomaton> containsScript(StrangerAutomaton::makeContainsString("<script"));
+  unique_ptr<StrangerAutomaton> noScript(containsScript->complement());
+
+  for (const auto& input : inputs) {
+    const StrangerAutomaton* a = input.automaton.get();
+    vector<string> names = { input.name };
+    // Function models, post and pre-images
+    add("complement", names, [=]() { return a->complement(); });
+    add("htmlSpecialChars", names, [=]() { return StrangerAutomaton::htmlSpecialChars(a, "ENT_QUOTES"); });
+    add("preHtmlSpecialChars", names, [=]() { return StrangerAutomaton::preHtmlSpecialChars(a, "ENT_QUOTES"); });
+    add("encodeURIComponent", names, [=]() { return StrangerAutomaton::encodeURIComponent(a); });
+    add("decodeURIComponent", names, [=]() { return StrangerAutomaton::decodeURIComponent(a); });
+    add("replace_char_with_string", names, [&, a]() {
+        return StrangerAutomaton::general_replace(lessThan.get(), entity.get(), a, -1); });
+    add("replace_extrabit", names, [&, a]() { return StrangerAutomaton::reg_replace(script.get(), "", a); });
+    add("preReplace", names, [&, a]() { return a->preReplace(script.get(), ""); });
+    // A chain of operations as in a depgraph, minimized once at the end as
+    // before storing in an AnalysisResult
+    add("concat_chain", names, [&, a]() {
+        unique_ptr<StrangerAutomaton> chain(a->share());
+        for (int i = 0; i < 4; i++) {
+          unique_ptr<StrangerAutomaton> prefixed(lessThan->concatenate(chain.get()));
+          unique_ptr<StrangerAutomaton> concatenated(prefixed->concatenate(a));
+          unique_ptr<StrangerAutomaton> both(concatenated->union_(a));
+          chain.reset(both->intersect(noScript.get()));
+        }
+        return chain->minimize(); });
+
+    for (const auto& other : inputs) {
+      const StrangerAutomaton* b = other.automaton.get();
+      vector<string> pair = { input.name, other.name };
+      add("intersect", pair, [=]() { return a->intersect(b); });
+      add("union", pair, [=]() { return a->union_(b); });
+      add("concatenate", pair, [=]() { return a->concatenate(b); });
+      add("leftPreConcat", pair, [=]() { return a->leftPreConcat(b); });
+      add("rightPreConcat", pair, [=]() { return a->rightPreConcat(b); });
+      add("checkEquivalence", pair, [=]() -> StrangerAutomaton* { a->checkEquivalence(b); return nullptr; });
+    }
+  }
+
+  // Stable order, independent of the order of the command line inputs
+  stable_sort(results.begin(), results.end(), [](const BenchResult& x, const BenchResult& y) {
+      return (x.op < y.op) || ((x.op == y.op) && (x.inputs < y.inputs));
+    });
+  return results;
+}
+
+int main(int argc, char *argv[]) {
+    try {
+
+        po::options_description desc("Allowed options");
+        desc.add_options()
+          ("help",          "produce help message")
+          ("output,o",      po::value<string>()->required(), "Path to the JSON output file.")
+          ("iterations,i",  po::value<unsigned int>()->default_value(10), "Number of timed runs of each operation")
+          ("warmup,w",      po::value<unsigned int>()->default_value(1), "Number of untimed runs before the timed ones")
+          ("pattern,p",     po::value<vector<string> >()->default_value(vector<string>{ "Html", "JavaScript", "Url" }, "Html JavaScript Url"),
+                            "Attack patterns used as inputs, by context name")
+          ("bdd,b",         po::value<vector<string> >()->default_value(vector<string>(), ""),
+                            "Automata exported as .bdd files used as inputs, e.g. post-images, named by their path without extension")
+          ("filter,f",      po::value<string>()->default_value(""), "Only run operations whose name contains this string")
+          ("defer,d",       po::value<int>()->default_value(0),
+                            "Leave intersections, unions and concatenations with at most this many states unminimized");
+
+        po::positional_options_description p;
+        p.add("bdd", -1);
+
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv).
+                  options(desc).positional(p).run(), vm);
+
+        if (vm.count("help"))
+        {
+            cout << "Usage: stranger_bench [options] --output results.json [post_image.bdd ...]\n";
+            cout << desc << "\n";
+            return 0;
+        }
+
+        po::notify(vm);
+
+        StrangerAutomaton::setDeferredMinimization(vm["defer"].as<int>());
+
+        vector<BenchInput> inputs;
+        inputs.push_back({ "sigma_star", unique_ptr<StrangerAutomaton>(StrangerAutomaton::makeAnyString()) });
+        for (const auto& name : vm["pattern"].as<vector<string> >()) {
+            inputs.push_back({ name, unique_ptr<StrangerAutomaton>(
+                AttackPatterns::getAttackPatternForContext(context_from_name(name))) });
+        }
+        for (const auto& file : vm["bdd"].as<vector<string> >()) {
+            // Every exported post-image is called post_image.bdd, so the
+            // directory is part of the name
+            inputs.push_back({ fs::path(file).replace_extension().generic_string(),
+                               unique_ptr<StrangerAutomaton>(StrangerAutomaton::importFromFile(file)) });
+        }
+
+        unsigned int iterations = vm["iterations"].as<unsigned int>();
+        unsigned int warmup = vm["warmup"].as<unsigned int>();
+        vector<BenchResult> results = run_all(inputs, vm["filter"].as<string>(), iterations, warmup);
+
+        ofstream ofs(vm["output"].as<string>(), ofstream::out);
+        write_json(ofs, results, iterations, warmup);
+        cerr << "Wrote " << results.size() << " results to " << vm["output"].as<string>() << endl;
+
+    } catch (StrangerException const &e) {
+        cerr << e.what();
+        exit(EXIT_FAILURE);
+    } catch(std::exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        exit(EXIT_FAILURE);
+    }
+    catch(...)
+    {
+        cerr << "Unknown error!" << "\n";
+        return false;
+    }
+
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Runs multiattack over the sample dependency graphs once as a whole and once
+# as two shards combined by multiattack-merge. The merged reports must match
+# those of the single run, up to the order of their rows.
+#
+# Run by "make check" from semattack/src, which sets srcdir.
+
+set -e
+
+testdir="${srcdir:-.}/../test"
+out=$(mktemp -d)
+trap 'rm -rf "$out"' EXIT
+
+./multiattack -t "$testdir" -o "$out/single" -f x -d 0 > "$out/single.log" 2>&1
+./multiattack -t "$testdir" -o "$out/shard0" -f x -d 0 --shard 0/2 > "$out/shard0.log" 2>&1
+./multiattack -t "$testdir" -o "$out/shard1" -f x -d 0 --shard 1/2 > "$out/shard1.log" 2>&1
+./multiattack-merge -o "$out/merged" "$out/shard0" "$out/shard1" > "$out/merge.log" 2>&1
+
+status=0
+for report in semattack_summary.csv semattack_summary_percent.csv semattack_error_summary.csv \
+              semattack_injection_histo.csv semattack_domain_histo.csv \
+              semattack_sanitizers_per_group_histo.csv semattack_files.csv; do
+  # The first column of the file list only numbers the rows
+  if [ "$report" = semattack_files.csv ]; then
+    cut -d, -f2- "$out/single/$report" | sort > "$out/expected"
+    cut -d, -f2- "$out/merged/$report" | sort > "$out/actual"
+  else
+    sort "$out/single/$report" > "$out/expected"
+    sort "$out/merged/$report" > "$out/actual"
+  fi
+  if ! cmp -s "$out/expected" "$out/actual"; then
+    echo "FAIL: $report differs after merging shards"
+    diff "$out/expected" "$out/actual" || true
+    status=1
+  fi
+done
+exit $status
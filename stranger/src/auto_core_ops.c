@@ -263,6 +263,210 @@ DFA *dfa_construct_from_automaton(int n_states, int n_trans, transition* transit
 }
 
 
+// Largest aligned block of characters starting at c with the same destination
+static int dfa_char_cube_size(const int *dests, int c, int n_chars){
+  int size = 1;
+  int i;
+  while ((c % (size * 2)) == 0 && c + size * 2 <= n_chars) {
+    for (i = c + size; i < c + size * 2; i++)
+      if (dests[i] != dests[c])
+        return size;
+    size *= 2;
+  }
+  return size;
+}
+
+//Construct DFA From another automaton, same arguments as dfa_construct_from_automaton
+// Instead of one exception per character, the characters of a state which go to the
+// same destination are stored as cubes: aligned blocks of 2^k characters whose k low
+// bits are don't cares. A character class like [^<>] thus becomes a handful of BDD
+// paths instead of ~250. The transitions do not need to be sorted, for overlapping
+// ranges of the same source the last transition wins.
+DFA *dfa_construct_from_ranges(int n_states, int n_trans, transition* transitions, char* accept_states, int var, int *indices){
+  int n_chars = (var < 8) ? (1 << var) : 256;
+  int *dests = (int *) malloc(n_states * n_chars * sizeof(int));
+  int i, c, k, size, num_trans;
+  char *cube;
+  DFABuilder *b;
+
+  for (i = 0; i < n_states * n_chars; i++)
+    dests[i] = -1;
+  for (i = 0; i < n_trans; i++) {
+    assert(transitions[i].source >= 0 && transitions[i].source < n_states);
+    for (c = transitions[i].first; c <= transitions[i].last && c < n_chars; c++)
+      dests[transitions[i].source * n_chars + c] = transitions[i].dest;
+  }
+
+  b = dfaSetup(n_states+1, var, indices);
+  for (i = 0; i < n_states; i++) {
+    int *state_dests = dests + i * n_chars;
+    num_trans = 0;
+    for (c = 0; c < n_chars; c += size) {
+      size = dfa_char_cube_size(state_dests, c, n_chars);
+      if (state_dests[c] >= 0)
+        num_trans++;
+    }
+    dfaAllocExceptions(b, num_trans);
+    for (c = 0; c < n_chars; c += size) {
+      size = dfa_char_cube_size(state_dests, c, n_chars);
+      if (state_dests[c] < 0)
+        continue;
+      cube = bintostr(c, var);
+      for (k = 0; (1 << k) < size; k++)
+        cube[var - 1 - k] = 'X';
+      dfaStoreException(b, state_dests[c], cube);
+      free(cube);
+    }
+    dfaStoreState(b, n_states);
+  }
+  dfaAllocExceptions(b, 0);
+  dfaStoreState(b, n_states);
+  free(dests);
+
+  char* acceptance_string = (char*)malloc((n_states+2) * sizeof(char));
+  strncpy(acceptance_string, accept_states, n_states);
+  acceptance_string[n_states] = '-';
+  acceptance_string[n_states+1] = '\0';
+  DFA *result = dfaBuild(b, acceptance_string);
+  free(acceptance_string);
+  return result;
+}
+
+// Renumber classes so that two characters share a class only if they did
+// before and have the same entry in dests. Returns the number of classes.
+static int dfa_split_char_classes(int *classes, const int *dests, int n_chars){
+  int renumbered[256];
+  int c, d, n_classes = 0;
+  for (c = 0; c < n_chars; c++) {
+    for (d = 0; d < c; d++) {
+      if (classes[d] == classes[c] && dests[d] == dests[c])
+        break;
+    }
+    renumbered[c] = (d < c) ? renumbered[d] : n_classes++;
+  }
+  for (c = 0; c < n_chars; c++)
+    classes[c] = renumbered[c];
+  return n_classes;
+}
+
+// True if character c agrees with every bit fixed on the path trace
+static int dfa_path_has_char(trace_descr trace, int c, int var, int *indices){
+  int j;
+  trace_descr tp;
+  for (tp = trace; tp; tp = tp->next) {
+    for (j = 0; j < var && indices[j] != tp->index; j++);
+    if (j < var && (int) ((c >> (var - 1 - j)) & 1) != (tp->value ? 1 : 0))
+      return 0;
+  }
+  return 1;
+}
+
+// Refine a partition of the alphabet by the transitions of M
+// classes holds the class of each character (2^var entries, at most 256).
+// Afterwards two characters are in the same class only if they were before
+// and lead from every state of M to the same state, i.e. M cannot tell them
+// apart. Classes are numbered from 0 in the order of their first character.
+// Returns the number of classes.
+int dfaRefineCharClasses(DFA *M, int var, int *indices, int *classes){
+  int n_chars = (var < 8) ? (1 << var) : 256;
+  int dests[256];
+  int i, c, n_classes = 0;
+  paths state_paths, pp;
+
+  for (c = 0; c < n_chars; c++)
+    dests[c] = 0;
+  n_classes = dfa_split_char_classes(classes, dests, n_chars);
+
+  for (i = 0; i < M->ns; i++) {
+    for (c = 0; c < n_chars; c++)
+      dests[c] = -1;
+    state_paths = pp = make_paths(M->bddm, M->q[i]);
+    while (pp) {
+      for (c = 0; c < n_chars; c++) {
+        if (dfa_path_has_char(pp->trace, c, var, indices))
+          dests[c] = pp->to;
+      }
+      pp = pp->next;
+    }
+    kill_paths(state_paths);
+    n_classes = dfa_split_char_classes(classes, dests, n_chars);
+  }
+  return n_classes;
+}
+
+// Mark the characters which occur in some word accepted by M: used[c] is set
+// to 1 if c leads from a state to another state, both of which can still
+// reach an accepting state, and to 0 otherwise (2^var entries, at most 256).
+// Returns the number of used characters.
+int dfaUsedChars(DFA *M, int var, int *indices, char *used){
+  int n_chars = (var < 8) ? (1 << var) : 256;
+  int i, c, changed, n_used = 0;
+  paths *state_paths = (paths *) malloc(M->ns * sizeof(paths));
+  char *live = (char *) malloc(M->ns * sizeof(char));
+  paths pp;
+
+  for (i = 0; i < M->ns; i++) {
+    state_paths[i] = make_paths(M->bddm, M->q[i]);
+    live[i] = (M->f[i] == 1);
+  }
+  // Backwards reachability of the accepting states
+  do {
+    changed = 0;
+    for (i = 0; i < M->ns; i++) {
+      for (pp = state_paths[i]; pp && !live[i]; pp = pp->next) {
+        if (live[pp->to]) {
+          live[i] = 1;
+          changed = 1;
+        }
+      }
+    }
+  } while (changed);
+
+  for (c = 0; c < n_chars; c++)
+    used[c] = 0;
+  for (i = 0; i < M->ns; i++) {
+    for (pp = state_paths[i]; pp && live[i]; pp = pp->next) {
+      if (!live[pp->to])
+        continue;
+      for (c = 0; c < n_chars; c++) {
+        if (!used[c] && dfa_path_has_char(pp->trace, c, var, indices)) {
+          used[c] = 1;
+          n_used++;
+        }
+      }
+    }
+    kill_paths(state_paths[i]);
+  }
+  free(state_paths);
+  free(live);
+  return n_used;
+}
+
+// Flatten the transition bdds of M: dests[i * 2^var + c] is set to the state
+// reached from state i by character c (ns * 2^var entries). Bits of other
+// tracks are taken as 0.
+void dfaTransitionTable(DFA *M, int var, int *indices, int *dests){
+  int n_chars = (var < 8) ? (1 << var) : 256;
+  int i, c, j;
+  unsigned index;
+  bdd_ptr p;
+
+  for (i = 0; i < M->ns; i++) {
+    for (c = 0; c < n_chars; c++) {
+      p = M->q[i];
+      while (!bdd_is_leaf(M->bddm, p)) {
+        index = bdd_ifindex(M->bddm, p);
+        for (j = 0; j < var && indices[j] != (int) index; j++);
+        if (j < var && ((c >> (var - 1 - j)) & 1))
+          p = bdd_then(M->bddm, p);
+        else
+          p = bdd_else(M->bddm, p);
+      }
+      dests[i * n_chars + c] = bdd_leaf_value(M->bddm, p);
+    }
+  }
+}
+
 void test_dfa_construct_from_automaton(int var, int *indices){
   transition* t = (transition*) malloc(2 * sizeof(transition));
   t[0].source = 0;t[0].dest = 1; t[0].first = 'a'; t[0].last = 'd';
@@ -985,6 +1189,18 @@ DFA *dfa_union_empty_M(DFA *M, int var, int *indices) {
   return result;
 }
 
+// Minimize M unless minimization is deferred for automata with at most
+// max_states states (max_states <= 0 always minimizes). M is consumed, the
+// caller minimizes deferred results before relying on their structure.
+DFA *dfaMinimizeAbove(DFA *M, int max_states){
+  DFA *result;
+  if (max_states > 0 && M->ns <= max_states)
+    return M;
+  result = dfaMinimize(M);
+  dfaFree(M);
+  return result;
+}
+
 // DO NOT USE. Does not handle empty string correctly.
 // use dfa_union_with_emptycheck instead
 DFA *dfa_union(M1, M2)
@@ -1002,11 +1218,15 @@ DFA *M1;DFA *M2; {
  * regardless.
  */
 DFA *dfa_union_with_emptycheck(DFA* M1, DFA* M2, int var, int* indices){
+  return dfa_union_with_emptycheck_deferred(M1, M2, var, indices, 0);
+}
+
+DFA *dfa_union_with_emptycheck_deferred(DFA* M1, DFA* M2, int var, int* indices, int max_states){
   DFA* tmpM = dfaProduct(M1, M2, dfaOR);
   if( DEBUG_SIZE_INFO )
     printf("\t peak : union : states %d : bddnodes %u \n", tmpM->ns, bdd_size(tmpM->bddm) );
-  DFA *result = dfaMinimize(tmpM);
-  dfaFree(tmpM);tmpM = NULL;
+  DFA *result = dfaMinimizeAbove(tmpM, max_states);
+  tmpM = NULL;
   if(checkEmptyString(M1)||checkEmptyString(M2)){
     tmpM = dfa_union_empty_M(result, var, indices);
     dfaFree(result); result = NULL;
@@ -1028,13 +1248,15 @@ DFA *dfa_product_impl(M1, M2)
 
 DFA *dfa_intersect(M1, M2)
   DFA *M1;DFA *M2; {
-  DFA *result, *tmpM;
+  return dfa_intersect_deferred(M1, M2, 0);
+}
+
+DFA *dfa_intersect_deferred(DFA *M1, DFA *M2, int max_states){
+  DFA *tmpM;
   tmpM = dfaProduct(M1, M2, dfaAND);
   if( DEBUG_SIZE_INFO )
     printf("\t peak : intersect : states %d : bddnodes %u \n", tmpM->ns, bdd_size(tmpM->bddm) );
-  result = dfaMinimize(tmpM);
-  dfaFree(tmpM);
-  return result;
+  return dfaMinimizeAbove(tmpM, max_states);
 }
 
 DFA *dfa_negate(M1, var, indices)
@@ -1223,6 +1445,11 @@ DFA *dfa_concat_extrabit(M1, M2, var, indices)
   DFA *M2;
   int var;
   int *indices;
+{
+  return dfa_concat_extrabit_deferred(M1, M2, var, indices, 0);
+}
+
+DFA *dfa_concat_extrabit_deferred(DFA *M1, DFA *M2, int var, int *indices, int max_states)
 {
   DFA *result;
   DFA *tmpM;
@@ -1434,9 +1661,7 @@ DFA *dfa_concat_extrabit(M1, M2, var, indices)
   dfaFree(tmpM);
   if( DEBUG_SIZE_INFO )
     printf("\t peak : concat : states %d : bddnodes %u : after projection \n", result->ns, bdd_size(result->bddm) );
-  tmpM = dfaMinimize(result);
-  dfaFree(result);
-  return tmpM;
+  return dfaMinimizeAbove(result, max_states);
 }//End of dfa_concat_extrabit
 
 
@@ -1579,6 +1804,11 @@ DFA *dfa_concat_extrabit(M1, M2, var, indices)
        DFA *M2;
        int var;
        int *indices;
+  {
+    return dfa_concat_deferred(M1, M2, var, indices, 0);
+  }
+
+  DFA *dfa_concat_deferred(DFA *M1, DFA *M2, int var, int *indices, int max_states)
   {
     DFA *tmp0 = NULL;
     DFA *tmp1 = NULL;
@@ -1598,15 +1828,15 @@ DFA *dfa_concat_extrabit(M1, M2, var, indices)
     if(checkEmptyString(M2)){
       if(state_reachable(M2, M2->s, var, indices)){
         tmp1 = dfa_shift_empty_M(M2, var, indices);
-        tmp0 = dfa_concat_extrabit(M1, tmp1, var, indices);
+        tmp0 = dfa_concat_extrabit_deferred(M1, tmp1, var, indices, max_states);
         dfaFree(tmp1);
       } else {
-        tmp0 =  dfa_concat_extrabit(M1, M2, var, indices);
+        tmp0 =  dfa_concat_extrabit_deferred(M1, M2, var, indices, max_states);
       }
-      tmp1 = dfa_union(tmp0, M1);
+      tmp1 = dfaMinimizeAbove(dfaProduct(tmp0, M1, dfaOR), max_states);
       dfaFree(tmp0);
     } else {
-      tmp1 = dfa_concat_extrabit(M1, M2, var, indices);
+      tmp1 = dfa_concat_extrabit_deferred(M1, M2, var, indices, max_states);
     }
     return tmp1;
   }
@@ -3282,27 +3512,318 @@ int check_intersection(M1, M2, var, indices)
   return result;
 }
 
-int check_equivalence(M1, M2, var, indices)
-  DFA *M1;DFA *M2;int var;int *indices; {
-  DFA *M[4];
-  int result, i;
+/*
+ * On-the-fly product search used by check_intersection_example,
+ * check_inclusion_example and check_equivalence_example.
+ * Pairs of states are numbered in the order they are discovered, which is
+ * breadth first, so following the parents from the pair found gives a
+ * shortest string leading to it.
+ */
+typedef enum {
+  PRODUCT_INTERSECTION,   // find a pair accepting in both automata
+  PRODUCT_INCLUSION,      // find a pair accepting in M1 only
+  PRODUCT_EQUIVALENCE     // find a pair accepting in exactly one automaton
+} product_mode;
+
+typedef struct {
+  int p;          // state of M1
+  int q;          // state of M2
+  int parent;     // predecessor pair, -1 for the start pair
+  char symbol;    // character read from the predecessor
+} product_pair;
+
+typedef struct {
+  DFA *M1;
+  DFA *M2;
+  int var;
+  int *position;        // bdd index -> bit of the character, -1 for other tracks
+  unsigned num_indices;
+  int *bits;            // bits fixed on the current bdd path, -1 if free
+  product_pair *pairs;
+  int num_pairs;
+  int size_pairs;
+  int *table;           // open addressing hash table of pair number + 1
+  unsigned size_table;
+  int current;          // pair whose successors are being computed
+  int found;            // first pair matching the mode, -1 if none found yet
+  product_mode mode;
+  int skip_reserved;    // do not follow the reserved characters
+  int *classes;         // union-find over the states of M1 and M2, or NULL
+} product_search;
+
+static unsigned product_hash(int p, int q) {
+  return ((unsigned) p * 2654435761u) ^ ((unsigned) q * 40503u);
+}
+
+static void product_rehash(product_search *ps) {
+  unsigned i, h, mask;
+  free(ps->table);
+  ps->size_table *= 2;
+  mask = ps->size_table - 1;
+  ps->table = (int *) calloc(ps->size_table, sizeof(int));
+  for (i = 0; i < (unsigned) ps->num_pairs; i++) {
+    h = product_hash(ps->pairs[i].p, ps->pairs[i].q) & mask;
+    while (ps->table[h] != 0)
+      h = (h + 1) & mask;
+    ps->table[h] = i + 1;
+  }
+}
 
-  if (M1 == M2) {
-      return 1;
+// Decode the bits of the current path like arr_to_ascii does for examples
+static char product_symbol(product_search *ps) {
+  int i, bit;
+  unsigned result = 0;
+  for (i = 0; i < ps->var; i++) {
+    bit = ps->bits[i];
+    if (bit < 0)
+      bit = (result < 33) ? 1 : 0;
+    result += bit << (ps->var - 1 - i);
   }
-  if (!M1 || !M2) {
+  return (char) result;
+}
+
+static int product_find(int *classes, int i) {
+  while (classes[i] != i) {
+    classes[i] = classes[classes[i]];
+    i = classes[i];
+  }
+  return i;
+}
+
+// The complement in dfa_negate excludes strings with reserved characters
+static int product_is_reserved(product_search *ps) {
+  int i;
+  for (i = 0; i < ps->var - 1; i++)
+    if (ps->bits[i] != 1)
       return 0;
+  return 1;
+}
+
+// Don't care states (status 0) are neither accepting nor rejecting, as
+// for the products built by dfaProduct
+static int product_matches(product_search *ps, int p, int q) {
+  int f1 = ps->M1->f[p];
+  int f2 = ps->M2->f[q];
+  switch (ps->mode) {
+  case PRODUCT_INCLUSION:
+    return (f1 == 1) && (f2 == -1);
+  case PRODUCT_EQUIVALENCE:
+    return ((f1 == 1) && (f2 == -1)) || ((f1 == -1) && (f2 == 1));
+  default:
+    return (f1 == 1) && (f2 == 1);
+  }
+}
+
+static void product_add(product_search *ps, int p, int q) {
+  unsigned h, mask;
+  int n, c1, c2;
+  if (ps->classes) {
+    // Hopcroft-Karp: pairs of states already known to be equivalent are
+    // not explored again
+    c1 = product_find(ps->classes, p);
+    c2 = product_find(ps->classes, ps->M1->ns + q);
+    if (c1 == c2)
+      return;
+    ps->classes[c1] = c2;
+  }
+  if ((unsigned) (ps->num_pairs + 1) * 2 > ps->size_table)
+    product_rehash(ps);
+  mask = ps->size_table - 1;
+  h = product_hash(p, q) & mask;
+  while ((n = ps->table[h]) != 0) {
+    if (ps->pairs[n - 1].p == p && ps->pairs[n - 1].q == q)
+      return;
+    h = (h + 1) & mask;
+  }
+  if (ps->num_pairs == ps->size_pairs) {
+    ps->size_pairs *= 2;
+    ps->pairs = (product_pair *) realloc(ps->pairs, ps->size_pairs * sizeof(product_pair));
+  }
+  n = ps->num_pairs++;
+  ps->table[h] = n + 1;
+  ps->pairs[n].p = p;
+  ps->pairs[n].q = q;
+  ps->pairs[n].parent = ps->current;
+  ps->pairs[n].symbol = (ps->current < 0) ? 0 : product_symbol(ps);
+  if (product_matches(ps, p, q))
+    ps->found = n;
+}
+
+// Walk both transition bdds in lock step and add all successor pairs
+static void product_successors(product_search *ps, bdd_ptr b1, bdd_ptr b2) {
+  bdd_manager *bddm1 = ps->M1->bddm;
+  bdd_manager *bddm2 = ps->M2->bddm;
+  int leaf1, leaf2, pos;
+  unsigned index1, index2, index;
+
+  if (ps->found >= 0)
+    return;
+  leaf1 = bdd_is_leaf(bddm1, b1);
+  leaf2 = bdd_is_leaf(bddm2, b2);
+  if (leaf1 && leaf2) {
+    if (!ps->skip_reserved || !product_is_reserved(ps))
+      product_add(ps, bdd_leaf_value(bddm1, b1), bdd_leaf_value(bddm2, b2));
+    return;
+  }
+  index1 = leaf1 ? (unsigned) -1 : bdd_ifindex(bddm1, b1);
+  index2 = leaf2 ? (unsigned) -1 : bdd_ifindex(bddm2, b2);
+  index = (index1 < index2) ? index1 : index2;
+  pos = (index < ps->num_indices) ? ps->position[index] : -1;
+
+  if (pos >= 0)
+    ps->bits[pos] = 0;
+  product_successors(ps, (index1 == index) ? bdd_else(bddm1, b1) : b1,
+      (index2 == index) ? bdd_else(bddm2, b2) : b2);
+  if (pos >= 0)
+    ps->bits[pos] = 1;
+  product_successors(ps, (index1 == index) ? bdd_then(bddm1, b1) : b1,
+      (index2 == index) ? bdd_then(bddm2, b2) : b2);
+  if (pos >= 0)
+    ps->bits[pos] = -1;
+}
+
+/*
+ * Explores the product of M1 and M2 from the start pair until a pair
+ * matching mode is found. Returns 1 if one is found, 0 otherwise. If example
+ * is not NULL and a pair is found, *example is set to a string leading to it
+ * (freed by the caller) and *length to its length, as the string may contain
+ * '\0' characters. The string is a shortest one unless classes are merged.
+ */
+static int product_search_run(DFA *M1, DFA *M2, int var, unsigned indices[], product_mode mode,
+    char **example, int *length) {
+  product_search ps;
+  int i, p, q, n, result;
+
+  ps.M1 = M1;
+  ps.M2 = M2;
+  ps.var = var;
+  ps.num_indices = 0;
+  for (i = 0; i < var; i++)
+    if (indices[i] + 1 > ps.num_indices)
+      ps.num_indices = indices[i] + 1;
+  ps.position = (int *) malloc(ps.num_indices * sizeof(int));
+  for (i = 0; i < (int) ps.num_indices; i++)
+    ps.position[i] = -1;
+  ps.bits = (int *) malloc(var * sizeof(int));
+  for (i = 0; i < var; i++) {
+    ps.position[indices[i]] = i;
+    ps.bits[i] = -1;
+  }
+  ps.size_pairs = 64;
+  ps.num_pairs = 0;
+  ps.pairs = (product_pair *) malloc(ps.size_pairs * sizeof(product_pair));
+  ps.size_table = 128;
+  ps.table = (int *) calloc(ps.size_table, sizeof(int));
+  ps.found = -1;
+  ps.mode = mode;
+  ps.skip_reserved = (mode != PRODUCT_INTERSECTION);
+  ps.classes = NULL;
+  if (mode == PRODUCT_EQUIVALENCE) {
+    ps.classes = (int *) malloc((M1->ns + M2->ns) * sizeof(int));
+    for (i = 0; i < M1->ns + M2->ns; i++)
+      ps.classes[i] = i;
   }
 
-  M[0] = dfaProduct(M1, M2, dfaIMPL);
-  M[1] = dfaProduct(M2, M1, dfaIMPL);
-  M[2] = dfa_intersect(M[0], M[1]);
-  M[3] = dfa_negate(M[2], var, indices);
-  result = check_emptiness(M[3], var, indices);
+  ps.current = -1;
+  product_add(&ps, M1->s, M2->s);
+  for (ps.current = 0; ps.found < 0 && ps.current < ps.num_pairs; ps.current++) {
+    p = ps.pairs[ps.current].p;
+    q = ps.pairs[ps.current].q;
+    product_successors(&ps, M1->q[p], M2->q[q]);
+  }
 
-  for (i = 0; i < 4; i++)
-    dfaFree(M[i]);
+  result = (ps.found >= 0) ? 1 : 0;
+  if (result && example) {
+    n = 0;
+    for (i = ps.found; ps.pairs[i].parent >= 0; i = ps.pairs[i].parent)
+      n++;
+    if (length)
+      *length = n;
+    *example = (char *) malloc(n + 1);
+    (*example)[n] = '\0';
+    for (i = ps.found; ps.pairs[i].parent >= 0; i = ps.pairs[i].parent)
+      (*example)[--n] = ps.pairs[i].symbol;
+  }
 
+  free(ps.position);
+  free(ps.bits);
+  free(ps.pairs);
+  free(ps.table);
+  free(ps.classes);
+  return result;
+}
+
+/*
+ * Checks if L(M1) intersect L(M2) is not empty without building the product
+ * automaton. The product is explored lazily from the start pair and the search
+ * stops at the first pair accepting in both automata.
+ * Returns 1 if the intersection is not empty, 0 otherwise. If example is not
+ * NULL and the intersection is not empty, *example is set to a shortest
+ * string of the intersection (freed by the caller) and *length to its length,
+ * as the string may contain '\0' characters.
+ */
+int check_intersection_example(DFA *M1, DFA *M2, int var, unsigned indices[], char **example, int *length) {
+  if (example)
+    *example = NULL;
+  if (length)
+    *length = 0;
+  if (!M1 || !M2)
+    return 0;
+  return product_search_run(M1, M2, var, indices, PRODUCT_INTERSECTION, example, length);
+}
+
+/*
+ * Checks L(M1) subset_of L(M2) on the fly, as L(M1) intersect the complement
+ * of L(M2) without building the complement or the product. Strings with
+ * reserved characters are ignored, as by dfa_negate.
+ * Returns 1 if M2 includes M1, 0 otherwise. If example is not NULL and M1 is
+ * not included, *example is set to a shortest string of L(M1) \ L(M2).
+ */
+int check_inclusion_example(DFA *M1, DFA *M2, int var, unsigned indices[], char **example, int *length) {
+  if (example)
+    *example = NULL;
+  if (length)
+    *length = 0;
+  if (M1 == M2)
+    return 1;
+  if (!M1 || !M2)
+    return 0;
+  return 1 - product_search_run(M1, M2, var, indices, PRODUCT_INCLUSION, example, length);
+}
+
+/*
+ * Checks L(M1) == L(M2) on the fly with the union-find algorithm of Hopcroft
+ * and Karp, so at most as many pairs as M1 and M2 have states are explored.
+ * Strings with reserved characters are ignored, as by dfa_negate.
+ * Returns 1 if the languages are equal, 0 otherwise. If example is not NULL
+ * and they differ, *example is set to a string in exactly one of them.
+ */
+int check_equivalence_example(DFA *M1, DFA *M2, int var, unsigned indices[], char **example, int *length) {
+  if (example)
+    *example = NULL;
+  if (length)
+    *length = 0;
+  if (M1 == M2)
+    return 1;
+  if (!M1 || !M2)
+    return 0;
+  return 1 - product_search_run(M1, M2, var, indices, PRODUCT_EQUIVALENCE, example, length);
+}
+
+static unsigned *to_unsigned_indices(int var, int *indices) {
+  int i;
+  unsigned *uindices = (unsigned *) malloc(var * sizeof(unsigned));
+  for (i = 0; i < var; i++)
+    uindices[i] = (indices[i] <= 0 ? 0 : indices[i]);
+  return uindices;
+}
+
+int check_equivalence(M1, M2, var, indices)
+  DFA *M1;DFA *M2;int var;int *indices; {
+  int result;
+  unsigned *uindices = to_unsigned_indices(var, indices);
+  result = check_equivalence_example(M1, M2, var, uindices, NULL, NULL);
+  free(uindices);
   return result;
 }
 
@@ -3312,16 +3833,147 @@ int check_equivalence(M1, M2, var, indices)
  */
 int check_inclusion(M1, M2, var, indices)
   DFA *M1;DFA *M2;int var;int *indices; {
-  DFA *M, *tmp;
   int result;
-  tmp = dfa_negate(M2, var, indices);
-  M = dfa_intersect(M1, tmp);
-  dfaFree(tmp); tmp = NULL;
-  result = check_emptiness(M, var, indices);
-  dfaFree(M);
+  unsigned *uindices = to_unsigned_indices(var, indices);
+  result = check_inclusion_example(M1, M2, var, uindices, NULL, NULL);
+  free(uindices);
   return result;
 }
 
+/*
+ * Serialization used by dfaCanonicalForm. States are numbered in the order
+ * they are first reached from the start state, BDD nodes in the order they
+ * are first visited, so the form only depends on the structure of the DFA.
+ */
+typedef struct {
+  DFA *M;
+  int *state_num;       // canonical number of each state, -1 if not reached
+  int *queue;           // states in canonical order
+  int num_states;
+  unsigned *node_keys;  // open addressing hash table of bdd nodes + 1
+  int *node_nums;
+  unsigned size_nodes;
+  int num_nodes;
+  int *form;
+  int length;
+  int size_form;
+} canonical_form;
+
+static void canonical_emit(canonical_form *cf, int value) {
+  if (cf->length == cf->size_form) {
+    cf->size_form *= 2;
+    cf->form = (int *) realloc(cf->form, cf->size_form * sizeof(int));
+  }
+  cf->form[cf->length++] = value;
+}
+
+// Returns the number of node, or -1 after numbering a node not seen before
+static int canonical_node(canonical_form *cf, bdd_ptr node) {
+  unsigned i, h, mask;
+  unsigned *keys;
+  int *nums;
+  if ((unsigned) (cf->num_nodes + 1) * 2 > cf->size_nodes) {
+    keys = cf->node_keys;
+    nums = cf->node_nums;
+    cf->size_nodes *= 2;
+    cf->node_keys = (unsigned *) calloc(cf->size_nodes, sizeof(unsigned));
+    cf->node_nums = (int *) malloc(cf->size_nodes * sizeof(int));
+    mask = cf->size_nodes - 1;
+    for (i = 0; i < cf->size_nodes / 2; i++) {
+      if (keys[i] != 0) {
+        h = product_hash(keys[i], 0) & mask;
+        while (cf->node_keys[h] != 0)
+          h = (h + 1) & mask;
+        cf->node_keys[h] = keys[i];
+        cf->node_nums[h] = nums[i];
+      }
+    }
+    free(keys);
+    free(nums);
+  }
+  mask = cf->size_nodes - 1;
+  h = product_hash(node + 1, 0) & mask;
+  while (cf->node_keys[h] != 0) {
+    if (cf->node_keys[h] == node + 1)
+      return cf->node_nums[h];
+    h = (h + 1) & mask;
+  }
+  cf->node_keys[h] = node + 1;
+  cf->node_nums[h] = cf->num_nodes++;
+  return -1;
+}
+
+static void canonical_bdd(canonical_form *cf, bdd_ptr node) {
+  bdd_manager *bddm = cf->M->bddm;
+  int num, state;
+  if (bdd_is_leaf(bddm, node)) {
+    state = bdd_leaf_value(bddm, node);
+    if (cf->state_num[state] < 0) {
+      cf->state_num[state] = cf->num_states;
+      cf->queue[cf->num_states++] = state;
+    }
+    canonical_emit(cf, 0);
+    canonical_emit(cf, cf->state_num[state]);
+    return;
+  }
+  num = canonical_node(cf, node);
+  if (num >= 0) {
+    canonical_emit(cf, 1);
+    canonical_emit(cf, num);
+    return;
+  }
+  canonical_emit(cf, 2);
+  canonical_emit(cf, bdd_ifindex(bddm, node));
+  canonical_bdd(cf, bdd_else(bddm, node));
+  canonical_bdd(cf, bdd_then(bddm, node));
+}
+
+/*
+ * Writes a form of M to *form (freed by the caller) which is the same for
+ * all DFAs which are equal up to the numbering of states and BDD nodes, and
+ * returns its length. BDDs are reduced and ordered, so two minimized DFAs of
+ * the same language over the same tracks have the same form, and equal forms
+ * always mean equal languages. Only states reachable from the start state
+ * are included.
+ */
+int dfaCanonicalForm(DFA *M, int **form) {
+  canonical_form cf;
+  int i, state;
+
+  *form = NULL;
+  if (!M)
+    return 0;
+  cf.M = M;
+  cf.state_num = (int *) malloc(M->ns * sizeof(int));
+  cf.queue = (int *) malloc(M->ns * sizeof(int));
+  for (i = 0; i < M->ns; i++)
+    cf.state_num[i] = -1;
+  cf.num_states = 0;
+  cf.size_nodes = 128;
+  cf.node_keys = (unsigned *) calloc(cf.size_nodes, sizeof(unsigned));
+  cf.node_nums = (int *) malloc(cf.size_nodes * sizeof(int));
+  cf.num_nodes = 0;
+  cf.size_form = 64;
+  cf.length = 0;
+  cf.form = (int *) malloc(cf.size_form * sizeof(int));
+
+  cf.state_num[M->s] = 0;
+  cf.queue[cf.num_states++] = M->s;
+  for (i = 0; i < cf.num_states; i++) {
+    state = cf.queue[i];
+    canonical_emit(&cf, 3);
+    canonical_emit(&cf, M->f[state]);
+    canonical_bdd(&cf, M->q[state]);
+  }
+
+  free(cf.state_num);
+  free(cf.queue);
+  free(cf.node_keys);
+  free(cf.node_nums);
+  *form = cf.form;
+  return cf.length;
+}
+
 /**
  * converts mona binary char representation into an ascii char
  * Example: input: "01000001" --> output: 'A'
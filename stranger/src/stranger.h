@@ -234,7 +234,24 @@ extern "C" {
     // The transition array must be sorted based on the source state
     // We create an extra sink state which is the state labeled n_states (so the constructed automaton has n_states+1 states)
     DFA *dfa_construct_from_automaton(int n_states,  int n_trans, transition* transitions, char* accept_states, int var, int *indices);
-    
+    // Same as dfa_construct_from_automaton, but the characters going to the same state are
+    // stored as cubes (aligned blocks with don't care low bits) rather than one by one.
+    // The transitions need not be sorted, for overlapping ranges the last one wins.
+    DFA *dfa_construct_from_ranges(int n_states, int n_trans, transition* transitions, char* accept_states, int var, int *indices);
+    // Refine the character classes (one entry per character) so that characters M cannot
+    // tell apart from any state stay together. Returns the number of classes.
+    int dfaRefineCharClasses(DFA *M, int var, int *indices, int *classes);
+    // Set used[c] to 1 for the characters which occur in some accepted word
+    // (2^var entries). Returns the number of such characters.
+    int dfaUsedChars(DFA *M, int var, int *indices, char *used);
+    // Set dests[i * 2^var + c] to the state reached from state i by character c
+    // (ns * 2^var entries)
+    void dfaTransitionTable(DFA *M, int var, int *indices, int *dests);
+    
+    // Minimize M unless it has at most max_states states (max_states <= 0
+    // always minimizes). M is consumed.
+    DFA *dfaMinimizeAbove(DFA *M, int max_states);
+
     // not needed anymore. better use the below dfa_union_with_emptycheck
     DFA *dfa_union(DFA *M1, DFA *M2);
     
@@ -244,21 +261,27 @@ extern "C" {
      * regardless.
      */
     DFA *dfa_union_with_emptycheck(DFA* M1, DFA* M2, int var, int* indices);
+    // The _deferred variants only minimize results with more than max_states
+    // states, see dfaMinimizeAbove
+    DFA *dfa_union_with_emptycheck_deferred(DFA* M1, DFA* M2, int var, int* indices, int max_states);
     
     //Given M, output a dfa accepting L(M) u \{\empty\}
     // not needed anymore. better use the above dfa_union_with_emptycheck
     DFA *dfa_union_add_empty_M(DFA *M, int var, int *indices);
     
     DFA *dfa_intersect(DFA *M1, DFA *M2);
+    DFA *dfa_intersect_deferred(DFA *M1, DFA *M2, int max_states);
 
     DFA *dfa_product_impl(DFA *M1, DFA *M2);
     
     DFA *dfa_negate(DFA *M1, int var, int *indices);
     
     DFA *dfa_concat(DFA *M1, DFA *M2, int var, int *indices);
+    DFA *dfa_concat_deferred(DFA *M1, DFA *M2, int var, int *indices, int max_states);
     
     // DO NOT USE THIS CONCAT. INSTEAD use dfa_concat. That one considers the empty string first then calls this one
     DFA *dfa_concat_extrabit(DFA *M1, DFA *M2, int var, int *indices);
+    DFA *dfa_concat_extrabit_deferred(DFA *M1, DFA *M2, int var, int *indices, int max_states);
     
     DFA *dfa_shift_empty_M(DFA *M, int var, int *indices);
 
@@ -328,12 +351,32 @@ extern "C" {
     int check_equivalence(DFA *M1, DFA *M2, int var, int *indices);
     
     int check_intersection(DFA *M1,DFA *M2,int var,int *indices);// added by Muath to be used by java StrangerLibrary
+
+    /*
+     * checks if L(M1) intersect L(M2) is not empty without building the
+     * product automaton, optionally returning a shortest common string
+     */
+    int check_intersection_example(DFA *M1, DFA *M2, int var, unsigned indices[], char **example, int *length);
     
     /*
      * returns true if M2 includes M1 i.e.
      * L(M1) subset_of L(M2)
      */
     int check_inclusion(DFA *M1,DFA *M2,int var,int *indices);// added by Muath to be used by java StrangerLibrary
+
+    /*
+     * on the fly versions of check_inclusion and check_equivalence, no
+     * complement or product automaton is built and the search stops at the
+     * first counterexample, which is optionally returned
+     */
+    int check_inclusion_example(DFA *M1, DFA *M2, int var, unsigned indices[], char **example, int *length);
+    int check_equivalence_example(DFA *M1, DFA *M2, int var, unsigned indices[], char **example, int *length);
+
+    /*
+     * form of M which is equal for DFAs equal up to state and BDD node
+     * numbering, in particular for minimized DFAs of the same language
+     */
+    int dfaCanonicalForm(DFA *M, int **form);
     
     /**
      if L(M) is a singleton set, it will return the string element